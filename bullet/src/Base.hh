@@ -23,6 +23,7 @@
 
 #include <assert.h>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -32,6 +33,8 @@
 #include <ignition/physics/Implements.hh>
 #include <ignition/math/eigen3/Conversions.hh>
 
+#include <sdf/Joint.hh>
+
 namespace ignition {
 namespace physics {
 namespace bullet {
@@ -46,6 +49,13 @@ namespace bullet {
 // TO-DO(): Consider using unique_ptrs instead of shared pointers
 // for Bullet internal objects
 
+// Speeds below which a body may go to sleep, in m/s and rad/s
+struct SleepThresholds
+{
+  double linearSpeed;
+  double angularSpeed;
+};
+
 // Note: For Bullet library it's important the order in which the elements
 // are destroyed. The current implementation relies on C++ destroying the
 // elements in the opposite order stated in the structure
@@ -56,7 +66,19 @@ struct WorldInfo
   std::shared_ptr<btCollisionDispatcher> dispatcher;
   std::shared_ptr<btBroadphaseInterface> broadphase;
   std::shared_ptr<btConstraintSolver> solver;
+  // Solver that a multithreaded world hands large islands to, or null
+  std::shared_ptr<btConstraintSolver> islandSolver;
   std::shared_ptr<btDiscreteDynamicsWorld> world;
+  // Bullet's default thresholds put slowly moving bodies to sleep, so the
+  // defaults only let bodies that are nearly at rest sleep
+  SleepThresholds sleepThresholds = {0.05, 0.05};
+  std::string solverName = "sequential_impulse";
+  // Threads that step a multithreaded world, or 0 for every thread of the
+  // task scheduler
+  // cppcheck-suppress unusedStructMember
+  std::size_t threadCount = 0u;
+  // Links whose pose changed since the last step reported them
+  std::vector<std::size_t> changedLinks = {};
 };
 
 struct ModelInfo
@@ -67,6 +89,48 @@ struct ModelInfo
   bool fixed;
   math::Pose3d pose;
   std::vector<std::size_t> links = {};
+  std::vector<std::size_t> joints = {};
+  // Number of joints in joints that are not fixed, i.e. that have a degree of
+  // freedom
+  std::size_t jointDofs = 0u;
+  // Thresholds of the links of this model, if they differ from the world's
+  std::optional<SleepThresholds> sleepThresholds = std::nullopt;
+};
+
+// Bullet hands the motion state of every awake body its new transform after
+// each step, so the motion state queues its link in the changed links of the
+// world. Bodies that sleep or are static are skipped, so finding the links
+// that moved does not visit every link. Bullet does not call the motion state
+// when a transform is set directly, so setters queue the link themselves.
+class LinkMotionState : public btDefaultMotionState
+{
+  public: LinkMotionState(
+      const btTransform &_transform, std::vector<std::size_t> &_changedLinks)
+    : btDefaultMotionState(_transform), changedLinks(_changedLinks)
+  {
+  }
+
+  public: void setWorldTransform(const btTransform &_transform) override
+  {
+    btDefaultMotionState::setWorldTransform(_transform);
+    this->MarkChanged();
+  }
+
+  /// \brief Queue the link, unless it is already queued
+  public: void MarkChanged()
+  {
+    if (this->changed)
+      return;
+    this->changed = true;
+    this->changedLinks.push_back(this->linkId);
+  }
+
+  // cppcheck-suppress unusedStructMember
+  public: std::size_t linkId = 0u;
+  // Whether the link is in the changed links of its world
+  // cppcheck-suppress unusedStructMember
+  public: bool changed = false;
+  private: std::vector<std::size_t> &changedLinks;
 };
 
 struct LinkInfo
@@ -78,9 +142,11 @@ struct LinkInfo
   // cppcheck-suppress unusedStructMember
   double mass;
   btVector3 inertia;
-  std::shared_ptr<btDefaultMotionState> motionState;
+  std::shared_ptr<LinkMotionState> motionState;
   std::shared_ptr<btCompoundShape> collisionShape;
   std::shared_ptr<btRigidBody> link;
+  // Pose of the link that ChangedWorldPoses last reported, if any
+  std::optional<math::Pose3d> reportedPose = std::nullopt;
 };
 
 struct CollisionInfo
@@ -92,7 +158,12 @@ struct CollisionInfo
   math::Pose3d pose;
   // cppcheck-suppress unusedStructMember
   bool isMesh;
-  std::shared_ptr<btTriangleMesh> mesh;
+  std::shared_ptr<btStridingMeshInterface> mesh;
+  // Children of a compound shape, which does not own them
+  std::vector<std::shared_ptr<btCollisionShape>> children = {};
+  // Bounding volume hierarchy of a triangle mesh that was read from the cache,
+  // which the mesh shape does not own
+  std::shared_ptr<btOptimizedBvh> bvh = nullptr;
 };
 
 struct JointInfo
@@ -238,6 +309,15 @@ class Base : public Implements3d<FeatureList<Feature>>
   {
     const auto id = this->GetNextEntity();
     this->joints[id] = std::make_shared<JointInfo>(_jointInfo);
+    const std::size_t modelId =
+      this->links.at(_jointInfo.childLinkId)->model.id;
+    auto &modelInfo = this->models.at(modelId);
+    modelInfo->joints.push_back(id);
+    if (_jointInfo.constraintType !=
+        static_cast<int>(::sdf::JointType::FIXED))
+    {
+      ++modelInfo->jointDofs;
+    }
 
     return this->GenerateIdentity(id, this->joints.at(id));
   }
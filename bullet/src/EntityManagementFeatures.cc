@@ -22,7 +22,7 @@
 #include <unordered_map>
 
 #include "EntityManagementFeatures.hh"
-#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+#include "WorldFeatures.hh"
 
 namespace ignition {
 namespace physics {
@@ -32,25 +32,10 @@ namespace bullet {
 Identity EntityManagementFeatures::ConstructEmptyWorld(
     const Identity &/*_engineID*/, const std::string &_name)
 {
-  // Create bullet empty multibody dynamics world
-  const auto collisionConfiguration =
-    std::make_shared<btDefaultCollisionConfiguration>();
-  const auto dispatcher =
-    std::make_shared<btCollisionDispatcher>(collisionConfiguration.get());
-  const auto broadphase = std::make_shared<btDbvtBroadphase>();
-  const auto solver =
-    std::make_shared<btSequentialImpulseConstraintSolver>();
-  const auto world = std::make_shared<btDiscreteDynamicsWorld>(
-    dispatcher.get(), broadphase.get(), solver.get(),
-    collisionConfiguration.get());
-
-  /* TO-DO(Lobotuerk): figure out what this line does*/
-  world->getSolverInfo().m_globalCfm = 0;
-
-  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher.get());
-
-  return this->AddWorld(
-    {_name, collisionConfiguration, dispatcher, broadphase, solver, world});
+  WorldInfo worldInfo;
+  worldInfo.name = _name;
+  BuildDynamicsWorld(worldInfo, false);
+  return this->AddWorld(worldInfo);
 }
 
 /////////////////////////////////////////////////
@@ -17,11 +17,31 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
+
 #include <ignition/plugin/Loader.hh>
 
 #include <ignition/math/eigen3/Conversions.hh>
 
+#include <ignition/physics/ForwardStep.hh>
+#include <ignition/physics/FrameSemantics.hh>
 #include <ignition/physics/RequestEngine.hh>
+#include <ignition/physics/mesh/MeshShape.hh>
+#include <ignition/physics/sdf/ConstructLink.hh>
+#include <ignition/physics/sdf/ConstructModel.hh>
+#include <ignition/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
 
 #include "EntityManagementFeatures.hh"
 #include "JointFeatures.hh"
@@ -50,6 +70,270 @@ TEST(EntityManagement_TEST, ConstructEmptyWorld)
   ASSERT_NE(nullptr, world);
 }
 
+struct MeshFeatureList : ignition::physics::FeatureList<
+    ignition::physics::ForwardStep,
+    ignition::physics::LinkFrameSemantics,
+    ignition::physics::mesh::AttachConvexMeshShapeFeature,
+    ignition::physics::sdf::ConstructSdfLink,
+    ignition::physics::sdf::ConstructSdfModel,
+    ignition::physics::sdf::ConstructSdfWorld
+> { };
+
+using MeshWorldPtr = ignition::physics::World3dPtr<MeshFeatureList>;
+using MeshLinkPtr = ignition::physics::Link3dPtr<MeshFeatureList>;
+
+/// \brief A world with a ground plane
+const char kGround[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <model name="ground">
+      <static>true</static>
+      <link name="link">
+        <collision name="collision">
+          <geometry>
+            <plane><normal>0 0 1</normal><size>10 10</size></plane>
+          </geometry>
+        </collision>
+      </link>
+    </model>
+  </world>
+</sdf>)";
+
+/// \brief A model without collisions, whose link falls from a height of 2 m
+const char kFalling[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <model name="falling">
+      <pose>0 0 2 0 0 0</pose>
+      <link name="link">
+        <inertial>
+          <mass>1</mass>
+          <inertia>
+            <ixx>0.1667</ixx><iyy>0.1667</iyy><izz>0.1667</izz>
+          </inertia>
+        </inertial>
+      </link>
+    </model>
+  </world>
+</sdf>)";
+
+/// \brief A static model without collisions
+const char kStatic[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <model name="static">
+      <static>true</static>
+      <link name="link"/>
+    </model>
+  </world>
+</sdf>)";
+
+/// \brief A unit cube centered at the origin
+ignition::common::Mesh CubeMesh()
+{
+  ignition::common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(ignition::common::SubMesh::TRIANGLES);
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    subMesh.AddVertex(
+        (corner & 1) ? 0.5 : -0.5,
+        (corner & 2) ? 0.5 : -0.5,
+        (corner & 4) ? 0.5 : -0.5);
+  }
+
+  // Corner i has x, y and z at the maximum for bits 0, 1 and 2 of i
+  const unsigned int triangles[12][3] = {
+      {0, 2, 1}, {1, 2, 3}, {4, 5, 6}, {5, 7, 6},
+      {0, 1, 4}, {1, 5, 4}, {2, 6, 3}, {3, 6, 7},
+      {0, 4, 2}, {2, 4, 6}, {1, 3, 5}, {3, 7, 5}};
+  for (const auto &triangle : triangles)
+  {
+    for (const unsigned int index : triangle)
+      subMesh.AddIndex(index);
+  }
+
+  ignition::common::Mesh mesh;
+  mesh.SetName("cube");
+  mesh.AddSubMesh(subMesh);
+  return mesh;
+}
+
+/// \brief Load a world with a ground plane
+MeshWorldPtr LoadMeshWorld(const std::string &_sdf)
+{
+  ignition::plugin::Loader loader;
+  loader.LoadLib(bullet_plugin_LIB);
+
+  ignition::plugin::PluginPtr bullet =
+      loader.Instantiate("ignition::physics::bullet::Plugin");
+
+  auto engine =
+      ignition::physics::RequestEngine3d<MeshFeatureList>::From(bullet);
+  EXPECT_NE(nullptr, engine);
+  if (!engine)
+    return nullptr;
+
+  sdf::Root root;
+  EXPECT_TRUE(root.LoadSdfString(_sdf).empty());
+  return engine->ConstructWorld(*root.WorldByIndex(0));
+}
+
+/// \brief Construct the link of a model in a world
+MeshLinkPtr ConstructLink(const MeshWorldPtr &_world, const std::string &_sdf)
+{
+  // Models are constructed on their own, since bullet cannot look them up
+  sdf::Root root;
+  EXPECT_TRUE(root.LoadSdfString(_sdf).empty());
+  const sdf::Model *sdfModel = root.WorldByIndex(0)->ModelByIndex(0);
+  auto model = _world->ConstructModel(*sdfModel);
+  EXPECT_NE(nullptr, model);
+  if (!model)
+    return nullptr;
+  return model->ConstructLink(*sdfModel->LinkByIndex(0));
+}
+
+/// \brief Step a world by 1 ms
+void StepWorld(const MeshWorldPtr &_world, const std::size_t _numSteps)
+{
+  ignition::physics::ForwardStep::Input input;
+  ignition::physics::ForwardStep::State state;
+  ignition::physics::ForwardStep::Output output;
+  input.Get<std::chrono::steady_clock::duration>() =
+      std::chrono::milliseconds(1);
+
+  for (std::size_t i = 0; i < _numSteps; ++i)
+    _world->Step(output, state, input);
+}
+
+/////////////////////////////////////////////////
+TEST(EntityManagement_TEST, ConvexMeshShape)
+{
+  auto world = LoadMeshWorld(kGround);
+  ASSERT_NE(nullptr, world);
+  auto link = ConstructLink(world, kFalling);
+  ASSERT_NE(nullptr, link);
+
+  // A flat mesh has no hull, so it collides as triangles
+  ignition::common::SubMesh flatSubMesh;
+  flatSubMesh.AddVertex(0, 0, 0);
+  flatSubMesh.AddVertex(1, 0, 0);
+  flatSubMesh.AddVertex(0, 1, 0);
+  flatSubMesh.AddIndex(0);
+  flatSubMesh.AddIndex(1);
+  flatSubMesh.AddIndex(2);
+  ignition::common::Mesh flatMesh;
+  flatMesh.AddSubMesh(flatSubMesh);
+  auto flat = link->AttachConvexMeshShape("flat", flatMesh,
+      Eigen::Isometry3d(Eigen::Translation3d(0, 0, 0.5)));
+  ASSERT_NE(nullptr, flat);
+  EXPECT_NE(nullptr, flat->CastToMeshShape());
+
+  // The hull of the cube lands on the ground
+  const ignition::common::Mesh cube = CubeMesh();
+  auto hull = link->AttachConvexMeshShape("hull", cube);
+  ASSERT_NE(nullptr, hull);
+  EXPECT_NE(nullptr, hull->CastToMeshShape());
+
+  StepWorld(world, 2000);
+  const Eigen::Vector3d position =
+      link->FrameDataRelativeToWorld().pose.translation();
+  EXPECT_NEAR(0.0, position.x(), 1e-2);
+  EXPECT_NEAR(0.0, position.y(), 1e-2);
+  EXPECT_NEAR(0.5, position.z(), 2e-2);
+}
+
+/// \brief Read a whole file
+std::string ReadFile(const std::string &_path)
+{
+  std::ifstream file(_path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+/// \brief Write a whole file
+void WriteFile(const std::string &_path, const std::string &_contents)
+{
+  std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+  file.write(_contents.data(), static_cast<std::streamsize>(_contents.size()));
+}
+
+/////////////////////////////////////////////////
+TEST(EntityManagement_TEST, StaticMeshShape)
+{
+  const std::string tempDir = ignition::common::createTempDirectory(
+      "bvh_cache", ignition::common::tempDirectoryPath());
+  ASSERT_FALSE(tempDir.empty());
+  const std::string cacheDir =
+      ignition::common::joinPaths(tempDir, "mesh_cache");
+  ASSERT_TRUE(
+      ignition::common::setenv("IGN_PHYSICS_MESH_CACHE_PATH", cacheDir));
+
+  // Drop a cube onto a static slab made of the same mesh, whose top is
+  // 0.5 m above the ground, and return where the cube comes to rest
+  const ignition::common::Mesh cube = CubeMesh();
+  const auto dropOnSlab = [&]() -> double
+  {
+    auto world = LoadMeshWorld(kGround);
+    EXPECT_NE(nullptr, world);
+    if (!world)
+      return 0.0;
+
+    auto slab = ConstructLink(world, kStatic);
+    EXPECT_NE(nullptr, slab);
+    if (!slab)
+      return 0.0;
+    auto slabShape = slab->AttachMeshShape("slab", cube,
+        Eigen::Isometry3d::Identity(), Eigen::Vector3d(4, 4, 1));
+    EXPECT_NE(nullptr, slabShape);
+    if (slabShape)
+      EXPECT_NE(nullptr, slabShape->CastToMeshShape());
+
+    auto falling = ConstructLink(world, kFalling);
+    EXPECT_NE(nullptr, falling);
+    if (!falling)
+      return 0.0;
+    falling->AttachConvexMeshShape("hull", cube);
+
+    StepWorld(world, 2000);
+    return falling->FrameDataRelativeToWorld().pose.translation().z();
+  };
+
+  // The bounding volume hierarchy of the slab is built and cached
+  EXPECT_NEAR(1.0, dropOnSlab(), 2e-2);
+  std::vector<std::string> bvhFiles;
+  for (ignition::common::DirIter it(cacheDir);
+       it != ignition::common::DirIter(); ++it)
+  {
+    const std::string path = *it;
+    if (path.size() > 4u && path.substr(path.size() - 4u) == ".bvh")
+      bvhFiles.push_back(path);
+  }
+  ASSERT_EQ(1u, bvhFiles.size());
+  const std::string bvhFile = bvhFiles[0];
+  const std::string contents = ReadFile(bvhFile);
+  ASSERT_FALSE(contents.empty());
+
+  // The cached hierarchy collides like the one it was built from
+  EXPECT_NEAR(1.0, dropOnSlab(), 2e-2);
+  EXPECT_EQ(contents, ReadFile(bvhFile));
+
+  // A corrupt cache file is rejected and replaced
+  std::string corrupt = contents;
+  const std::size_t middle = corrupt.size() / 2u;
+  corrupt[middle] = static_cast<char>(~corrupt[middle]);
+  WriteFile(bvhFile, corrupt);
+  EXPECT_NEAR(1.0, dropOnSlab(), 2e-2);
+  EXPECT_EQ(contents, ReadFile(bvhFile));
+
+  // So is a truncated one
+  WriteFile(bvhFile, contents.substr(0, contents.size() / 2u));
+  EXPECT_NEAR(1.0, dropOnSlab(), 2e-2);
+  EXPECT_EQ(contents, ReadFile(bvhFile));
+
+  ignition::common::unsetenv("IGN_PHYSICS_MESH_CACHE_PATH");
+  ignition::common::removeAll(tempDir);
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -71,11 +71,16 @@ void FreeGroupFeatures::SetFreeGroupWorldPose(
   baseTransform.setOrigin(convertVec(poseTranslation));
   baseTransform.setBasis(convertMat(poseLinear));
 
-  // Set base transform
+  // Set base transform, and wake the links up in case they were sleeping.
+  // Static bodies are never handed to their motion state, so the links are
+  // queued here for the next step to report
   const auto &model = this->models.at(_groupID);
   for (auto link : model->links)
   {
-    this->links.at(link)->link->setCenterOfMassTransform(baseTransform);
+    const auto &linkInfo = this->links.at(link);
+    linkInfo->link->setCenterOfMassTransform(baseTransform);
+    linkInfo->link->activate(true);
+    linkInfo->motionState->MarkChanged();
   }
 }
 
@@ -17,7 +17,6 @@
 
 #include "JointFeatures.hh"
 
-#include <algorithm>
 #include <sdf/Joint.hh>
 
 namespace ignition {
@@ -80,34 +79,7 @@ double JointFeatures::GetJointVelocity(
           btHingeAccumulatedAngleConstraint*>(jointInfo->joint.get());
         if (hinge)
         {
-          result = 0.0;
-          // Get the axis of the joint
-          btVector3 vec =
-            hinge->getRigidBodyA().getCenterOfMassTransform().getBasis() *
-            hinge->getFrameOffsetA().getBasis().getColumn(2);
-
-          math::Vector3 globalAxis(vec[0], vec[1], vec[2]);
-
-          if (this->links.find(jointInfo->childLinkId) != this->links.end())
-          {
-            btRigidBody *childLink =
-              this->links.at(jointInfo->childLinkId)->link.get();
-            btVector3 aux = childLink->getAngularVelocity();
-            math::Vector3 angularVelocity(aux[0], aux[1], aux[2]);
-            // result +=
-            // globalAxis.Dot(convertVec(childLink->getAngularVelocity()));
-            result += globalAxis.Dot(angularVelocity);
-          }
-          if (this->links.find(jointInfo->parentLinkId) != this->links.end())
-          {
-            btRigidBody *parentLink =
-              this->links.at(jointInfo->parentLinkId)->link.get();
-            btVector3 aux = parentLink->getAngularVelocity();
-            math::Vector3 angularVelocity(aux[0], aux[1], aux[2]);
-            // result -=
-            // globalAxis.Dot(convertVec(parentLink->getAngularVelocity()));
-            result -= globalAxis.Dot(angularVelocity);
-          }
+          result = this->HingeVelocity(*jointInfo, *hinge);
         }
         else
         {
@@ -306,28 +278,7 @@ void JointFeatures::SetJointForce(
           btHingeAccumulatedAngleConstraint*>(jointInfo->joint.get());
         if (hinge)
         {
-          // TO-DO (blast545): Find how to address limitation caused by
-          // https://pybullet.org/Bullet/BulletFull/btHingeConstraint_8cpp_source.html#l00318
-          // double thresholdValue = std::max(std::min(_value, 0.1), -0.1);
-
-          // z-axis of constraint frame
-          btVector3 hingeAxisLocalA =
-            hinge->getFrameOffsetA().getBasis().getColumn(2);
-          btVector3 hingeAxisLocalB =
-            hinge->getFrameOffsetB().getBasis().getColumn(2);
-
-          btVector3 hingeAxisWorldA =
-            hinge->getRigidBodyA().getWorldTransform().getBasis() *
-            hingeAxisLocalA;
-          btVector3 hingeAxisWorldB =
-            hinge->getRigidBodyB().getWorldTransform().getBasis() *
-            hingeAxisLocalB;
-
-          btVector3 hingeTorqueA = _value * hingeAxisWorldA;
-          btVector3 hingeTorqueB = _value * hingeAxisWorldB;
-
-          hinge->getRigidBodyA().applyTorque(hingeTorqueA);
-          hinge->getRigidBodyB().applyTorque(-hingeTorqueB);
+          ApplyHingeForce(*hinge, _value);
         }
       }
       break;
@@ -367,6 +318,7 @@ void JointFeatures::SetJointVelocityCommand(
       convertVec(ignition::math::eigen3::convert(jointInfo->axis)));
     btVector3 angular_vel = motion * _value;
     link->setAngularVelocity(angular_vel);
+    link->activate();
   }
   break;
   default:
@@ -458,6 +410,168 @@ AngularVector3d JointFeatures::GetRevoluteJointAxis(
   return AngularVector3d();
 }
 
+/////////////////////////////////////////////////
+double JointFeatures::HingeVelocity(const JointInfo &_jointInfo,
+    const btHingeAccumulatedAngleConstraint &_hinge) const
+{
+  double result = 0.0;
+  // Get the axis of the joint
+  btVector3 vec =
+    _hinge.getRigidBodyA().getCenterOfMassTransform().getBasis() *
+    _hinge.getFrameOffsetA().getBasis().getColumn(2);
+
+  math::Vector3 globalAxis(vec[0], vec[1], vec[2]);
+
+  auto childIt = this->links.find(_jointInfo.childLinkId);
+  if (childIt != this->links.end())
+  {
+    btVector3 aux = childIt->second->link->getAngularVelocity();
+    math::Vector3 angularVelocity(aux[0], aux[1], aux[2]);
+    // result +=
+    // globalAxis.Dot(convertVec(childLink->getAngularVelocity()));
+    result += globalAxis.Dot(angularVelocity);
+  }
+  auto parentIt = this->links.find(_jointInfo.parentLinkId);
+  if (parentIt != this->links.end())
+  {
+    btVector3 aux = parentIt->second->link->getAngularVelocity();
+    math::Vector3 angularVelocity(aux[0], aux[1], aux[2]);
+    // result -=
+    // globalAxis.Dot(convertVec(parentLink->getAngularVelocity()));
+    result -= globalAxis.Dot(angularVelocity);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::ApplyHingeForce(
+    btHingeAccumulatedAngleConstraint &_hinge, const double _value)
+{
+  // TO-DO (blast545): Find how to address limitation caused by
+  // https://pybullet.org/Bullet/BulletFull/btHingeConstraint_8cpp_source.html#l00318
+  // double thresholdValue = std::max(std::min(_value, 0.1), -0.1);
+
+  // z-axis of constraint frame
+  btVector3 hingeAxisLocalA =
+    _hinge.getFrameOffsetA().getBasis().getColumn(2);
+  btVector3 hingeAxisLocalB =
+    _hinge.getFrameOffsetB().getBasis().getColumn(2);
+
+  btVector3 hingeAxisWorldA =
+    _hinge.getRigidBodyA().getWorldTransform().getBasis() *
+    hingeAxisLocalA;
+  btVector3 hingeAxisWorldB =
+    _hinge.getRigidBodyB().getWorldTransform().getBasis() *
+    hingeAxisLocalB;
+
+  btVector3 hingeTorqueA = _value * hingeAxisWorldA;
+  btVector3 hingeTorqueB = _value * hingeAxisWorldB;
+
+  _hinge.getRigidBodyA().applyTorque(hingeTorqueA);
+  _hinge.getRigidBodyB().applyTorque(-hingeTorqueB);
+
+  // Sleeping bodies ignore forces, so the joint wakes its bodies up unless
+  // the force is zero
+  if (_value != 0.0)
+  {
+    _hinge.getRigidBodyA().activate();
+    _hinge.getRigidBodyB().activate();
+  }
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointStates(
+    const Identity &_modelID,
+    Eigen::VectorXd &_positions,
+    Eigen::VectorXd &_velocities) const
+{
+  auto modelIt = this->models.find(_modelID.id);
+  if (modelIt == this->models.end())
+  {
+    _positions.resize(0);
+    _velocities.resize(0);
+    return;
+  }
+
+  // All the joints are hinges. Fixed joints are hinges with a zero range and
+  // have no degrees of freedom.
+  const std::vector<std::size_t> &modelJoints = modelIt->second->joints;
+  _positions.resize(modelIt->second->jointDofs);
+  _velocities.resize(modelIt->second->jointDofs);
+  Eigen::Index index = 0;
+  for (const std::size_t jointId : modelJoints)
+  {
+    const JointInfoPtr &jointInfo = this->joints.at(jointId);
+    if (jointInfo->constraintType ==
+        static_cast<int>(::sdf::JointType::FIXED))
+    {
+      continue;
+    }
+
+    // Only revolute joints report a state, like GetJointPosition
+    if (jointInfo->constraintType ==
+        static_cast<int>(::sdf::JointType::REVOLUTE))
+    {
+      auto *hinge = static_cast<btHingeAccumulatedAngleConstraint *>(
+          jointInfo->joint.get());
+      _positions[index] = hinge->getAccumulatedHingeAngle();
+      _velocities[index] = this->HingeVelocity(*jointInfo, *hinge);
+    }
+    else
+    {
+      _positions[index] = ignition::math::NAN_D;
+      _velocities[index] = ignition::math::NAN_D;
+    }
+    ++index;
+  }
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointForces(
+    const Identity &_modelID, const Eigen::VectorXd &_forces)
+{
+  auto modelIt = this->models.find(_modelID.id);
+  if (modelIt == this->models.end())
+    return;
+
+  const std::vector<std::size_t> &modelJoints = modelIt->second->joints;
+  const std::size_t dofs = modelIt->second->jointDofs;
+  if (static_cast<std::size_t>(_forces.size()) != dofs)
+  {
+    ignerr << "Invalid number of joint forces [" << _forces.size()
+           << "] set on model [" << modelIt->second->name << "], which has ["
+           << dofs << "] degrees of freedom. The forces will be ignored\n";
+    return;
+  }
+
+  if (!_forces.allFinite())
+  {
+    ignerr << "Invalid joint force values set on model ["
+           << modelIt->second->name << "]. The values will be ignored\n";
+    return;
+  }
+
+  Eigen::Index index = 0;
+  for (const std::size_t jointId : modelJoints)
+  {
+    const JointInfoPtr &jointInfo = this->joints.at(jointId);
+    if (jointInfo->constraintType ==
+        static_cast<int>(::sdf::JointType::FIXED))
+    {
+      continue;
+    }
+
+    // Only revolute joints are actuated, like SetJointForce
+    if (jointInfo->constraintType ==
+        static_cast<int>(::sdf::JointType::REVOLUTE))
+    {
+      ApplyHingeForce(*static_cast<btHingeAccumulatedAngleConstraint *>(
+          jointInfo->joint.get()), _forces[index]);
+    }
+    ++index;
+  }
+}
+
 }  // namespace bullet
 }  // namespace physics
 }  // namespace ignition
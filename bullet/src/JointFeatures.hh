@@ -19,6 +19,7 @@
 #define IGNITION_PHYSICS_BULLET_SRC_JOINTFEATURES_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/physics/Joint.hh>
 #include <ignition/physics/FixedJoint.hh>
@@ -38,7 +39,9 @@ struct JointFeatureList : FeatureList<
 
   GetRevoluteJointProperties,
   FixedJointCast,
-  SetJointVelocityCommandFeature
+  SetJointVelocityCommandFeature,
+  GetModelJointStates,
+  SetModelJointForces
 > { };
 
 class JointFeatures :
@@ -103,6 +106,25 @@ class JointFeatures :
   public: void SetJointVelocityCommand(
       const Identity &_id, const std::size_t _dof,
       const double _value) override;
+
+  // ----- Model joint states -----
+  public: void GetModelJointStates(
+      const Identity &_modelID,
+      Eigen::VectorXd &_positions,
+      Eigen::VectorXd &_velocities) const override;
+
+  public: void SetModelJointForces(
+      const Identity &_modelID,
+      const Eigen::VectorXd &_forces) override;
+
+  /// \brief Angular velocity of the child link relative to the parent link
+  /// about the axis of a hinge
+  private: double HingeVelocity(const JointInfo &_jointInfo,
+      const btHingeAccumulatedAngleConstraint &_hinge) const;
+
+  /// \brief Apply equal and opposite torques about the axis of a hinge
+  private: static void ApplyHingeForce(
+      btHingeAccumulatedAngleConstraint &_hinge, const double _value);
 };
 
 }  // namespace bullet
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+
+#include <ignition/plugin/Loader.hh>
+
+#include <ignition/physics/ForwardStep.hh>
+#include <ignition/physics/Joint.hh>
+#include <ignition/physics/RequestEngine.hh>
+#include <ignition/physics/sdf/ConstructModel.hh>
+#include <ignition/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
+
+struct TestFeatureList : ignition::physics::FeatureList<
+    ignition::physics::ForwardStep,
+    ignition::physics::GetModelJointStates,
+    ignition::physics::SetModelJointForces,
+    ignition::physics::sdf::ConstructSdfModel,
+    ignition::physics::sdf::ConstructSdfWorld
+> { };
+
+/// \brief An empty world without gravity
+const char kEmpty[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <gravity>0 0 0</gravity>
+  </world>
+</sdf>)";
+
+/// \brief A chain of two arms that turn about the vertical axis, with a tip
+/// that is fixed to the second arm
+const char kChain[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <model name="chain">
+      <link name="arm1">
+        <pose>0.5 0 0 0 0 0</pose>
+        <inertial>
+          <mass>1</mass>
+          <inertia><ixx>0.1</ixx><iyy>0.1</iyy><izz>0.1</izz></inertia>
+        </inertial>
+      </link>
+      <link name="arm2">
+        <pose>1.5 0 0 0 0 0</pose>
+        <inertial>
+          <mass>1</mass>
+          <inertia><ixx>0.1</ixx><iyy>0.1</iyy><izz>0.1</izz></inertia>
+        </inertial>
+      </link>
+      <link name="tip">
+        <pose>2.1 0 0 0 0 0</pose>
+        <inertial>
+          <mass>0.1</mass>
+          <inertia><ixx>0.01</ixx><iyy>0.01</iyy><izz>0.01</izz></inertia>
+        </inertial>
+      </link>
+      <joint name="joint1" type="revolute">
+        <pose>-0.5 0 0 0 0 0</pose>
+        <parent>world</parent>
+        <child>arm1</child>
+        <axis>
+          <xyz>0 0 1</xyz>
+          <limit><lower>-1e16</lower><upper>1e16</upper></limit>
+        </axis>
+      </joint>
+      <joint name="joint2" type="revolute">
+        <pose>-0.5 0 0 0 0 0</pose>
+        <parent>arm1</parent>
+        <child>arm2</child>
+        <axis>
+          <xyz>0 0 1</xyz>
+          <limit><lower>-1e16</lower><upper>1e16</upper></limit>
+        </axis>
+      </joint>
+      <joint name="tip_joint" type="fixed">
+        <parent>arm2</parent>
+        <child>tip</child>
+      </joint>
+    </model>
+  </world>
+</sdf>)";
+
+/////////////////////////////////////////////////
+// Test reading and writing all the joints of a model at once
+TEST(JointFeatures_TEST, ModelJointStates)
+{
+  ignition::plugin::Loader loader;
+  loader.LoadLib(bullet_plugin_LIB);
+
+  ignition::plugin::PluginPtr bullet =
+      loader.Instantiate("ignition::physics::bullet::Plugin");
+
+  auto engine =
+      ignition::physics::RequestEngine3d<TestFeatureList>::From(bullet);
+  ASSERT_NE(nullptr, engine);
+
+  sdf::Root emptyRoot;
+  ASSERT_TRUE(emptyRoot.LoadSdfString(kEmpty).empty());
+  auto world = engine->ConstructWorld(*emptyRoot.WorldByIndex(0));
+  ASSERT_NE(nullptr, world);
+
+  // The chain is constructed on its own, since bullet cannot look models up
+  sdf::Root chainRoot;
+  ASSERT_TRUE(chainRoot.LoadSdfString(kChain).empty());
+  auto model =
+      world->ConstructModel(*chainRoot.WorldByIndex(0)->ModelByIndex(0));
+  ASSERT_NE(nullptr, model);
+
+  ignition::physics::ForwardStep::Input input;
+  ignition::physics::ForwardStep::State state;
+  ignition::physics::ForwardStep::Output output;
+  input.Get<std::chrono::steady_clock::duration>() =
+      std::chrono::milliseconds(1);
+
+  // The fixed joint has no degree of freedom
+  Eigen::VectorXd positions;
+  Eigen::VectorXd velocities;
+  model->GetJointStates(positions, velocities);
+  ASSERT_EQ(2, positions.size());
+  ASSERT_EQ(2, velocities.size());
+  EXPECT_NEAR(0.0, positions[0], 1e-6);
+  EXPECT_NEAR(0.0, positions[1], 1e-6);
+
+  // Forces that don't match the model are ignored, so the chain stays at rest
+  model->SetJointForces(Eigen::VectorXd::Ones(3));
+  world->Step(output, state, input);
+  Eigen::VectorXd forces = Eigen::VectorXd::Ones(2);
+  forces[1] = std::numeric_limits<double>::quiet_NaN();
+  model->SetJointForces(forces);
+  world->Step(output, state, input);
+  model->GetJointStates(positions, velocities);
+  EXPECT_NEAR(0.0, velocities[0], 1e-6);
+  EXPECT_NEAR(0.0, velocities[1], 1e-6);
+
+  // A force on the first joint turns the chain the same way
+  forces << 1.0, 0.0;
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    model->SetJointForces(forces);
+    world->Step(output, state, input);
+  }
+  model->GetJointStates(positions, velocities);
+  EXPECT_LT(0.0, positions[0]);
+  EXPECT_LT(0.0, velocities[0]);
+}
@@ -171,15 +171,23 @@ Identity SDFFeatures::ConstructSdfLink(
     linkInertiaDiag = btVector3(0, 0, 0);
   }
 
-  auto myMotionState = std::make_shared<btDefaultMotionState>(baseTransform);
+  const auto &worldInfo = this->worlds.at(modelInfo->world);
+  auto myMotionState = std::make_shared<LinkMotionState>(
+    baseTransform, worldInfo->changedLinks);
   auto collisionShape = std::make_shared<btCompoundShape>();
   btRigidBody::btRigidBodyConstructionInfo
     rbInfo(mass, myMotionState.get(), collisionShape.get(), linkInertiaDiag);
 
   auto body = std::make_shared<btRigidBody>(rbInfo);
-  body.get()->setActivationState(DISABLE_DEACTIVATION);
 
-  const auto &world = this->worlds.at(modelInfo->world)->world;
+  // Bodies that stay below the sleep thresholds go to sleep, so stepping the
+  // world skips them until they are woken up
+  const SleepThresholds &sleepThresholds =
+    modelInfo->sleepThresholds.value_or(worldInfo->sleepThresholds);
+  body->setSleepingThresholds(
+    sleepThresholds.linearSpeed, sleepThresholds.angularSpeed);
+
+  const auto &world = worldInfo->world;
 
   // Links collide with everything except elements sharing a joint
   world->addRigidBody(body.get());
@@ -189,6 +197,10 @@ Identity SDFFeatures::ConstructSdfLink(
     this->AddLink(_modelID, {name, _modelID, pose, inertialPose,
     mass, linkInertiaDiag, myMotionState, collisionShape, body});
 
+  // The next step reports the new link, even if it never moves
+  myMotionState->linkId = linkIdentity.id;
+  myMotionState->MarkChanged();
+
   // Create associated collisions to this model
   for (std::size_t i = 0; i < _sdfLink.CollisionCount(); ++i)
   {
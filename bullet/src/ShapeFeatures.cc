@@ -16,71 +16,214 @@
 */
 
 #include "ShapeFeatures.hh"
+#include "TriangleMesh.hh"
 #include <BulletCollision/Gimpact/btGImpactShape.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/physics/mesh/CacheFile.hh>
 
 namespace ignition {
 namespace physics {
 namespace bullet {
 
+namespace {
 /////////////////////////////////////////////////
-Identity ShapeFeatures::AttachMeshShape(
-    const Identity &_linkID,
-    const std::string &_name,
-    const ignition::common::Mesh &_mesh,
-    const Pose3d &_pose,
-    const LinearVector3d &_scale)
+/// \brief Marks the start of a bounding volume hierarchy cache file
+constexpr char kBvhCacheMagic[8] = {'I', 'G', 'N', 'B', 'V', 'H', '\0', '\0'};
+
+/////////////////////////////////////////////////
+/// \brief Header of a bounding volume hierarchy cache file, which is followed
+/// by the hierarchy as serialized by Bullet
+struct BvhCacheHeader
 {
-  double *vertices = nullptr;
-  int *indices = nullptr;
-  _mesh.FillArrays(&vertices, &indices);
+  /// \brief kBvhCacheMagic
+  char magic[sizeof(kBvhCacheMagic)];
 
-  unsigned int numVertices = _mesh.VertexCount();
-  unsigned int numIndices = _mesh.IndexCount();
+  /// \brief Size of the serialized hierarchy
+  std::uint64_t size;
 
-  const auto mTriMesh = std::make_shared<btTriangleMesh>();
+  /// \brief HashBytes of the serialized hierarchy
+  std::uint64_t hash;
+};
 
-  for (unsigned int j = 0;  j < numVertices; ++j)
+/////////////////////////////////////////////////
+/// \brief Path of the file in which the bounding volume hierarchy of a
+/// triangle mesh is cached, or an empty string if IGN_PHYSICS_MESH_CACHE_PATH
+/// is not set. The file is named by a hash of the triangles and of the
+/// precision and version of Bullet, which determine the layout of the file.
+std::string BvhCachePath(const btStridingMeshInterface &_mesh)
+{
+  std::string cacheDirectory;
+  if (!common::env("IGN_PHYSICS_MESH_CACHE_PATH", cacheDirectory) ||
+      cacheDirectory.empty())
   {
-    // Scale the vertex data
-    vertices[j*3+0] = vertices[j*3+0] * _scale[0];
-    vertices[j*3+1] = vertices[j*3+1] * _scale[1];
-    vertices[j*3+2] = vertices[j*3+2] * _scale[2];
+    return "";
   }
 
-  // Create the Bullet trimesh
-  for (unsigned int j = 0; j < numIndices; j += 3)
+  const std::uint64_t version = BT_BULLET_VERSION;
+  const std::uint64_t scalarSize = sizeof(btScalar);
+  std::uint64_t hash = mesh::kHashBytesSeed;
+  hash = mesh::HashBytes(hash, &version, sizeof(version));
+  hash = mesh::HashBytes(hash, &scalarSize, sizeof(scalarSize));
+
+  const unsigned char *vertexBase = nullptr;
+  const unsigned char *indexBase = nullptr;
+  int vertexCount = 0;
+  int vertexStride = 0;
+  int triangleCount = 0;
+  int indexStride = 0;
+  PHY_ScalarType vertexType;
+  PHY_ScalarType indexType;
+  _mesh.getLockedReadOnlyVertexIndexBase(&vertexBase, vertexCount, vertexType,
+      vertexStride, &indexBase, indexStride, triangleCount, indexType);
+  hash = mesh::HashBytes(hash, vertexBase,
+      static_cast<std::size_t>(vertexCount) * vertexStride);
+  hash = mesh::HashBytes(hash, indexBase,
+      static_cast<std::size_t>(triangleCount) * indexStride);
+  _mesh.unLockReadOnlyVertexBase(0);
+
+  return common::joinPaths(cacheDirectory, mesh::CacheFileName(hash, "bvh"));
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a bounding volume hierarchy from the cache. The serialized
+/// hierarchy is checked against the size and hash in the header of the file,
+/// and copied into a new hierarchy, since Bullet deserializes it in place as
+/// a btQuantizedBvh.
+/// \return The hierarchy, or null if the file does not exist or is not a
+/// complete cache file
+std::shared_ptr<btOptimizedBvh> ReadBvhCache(const std::string &_path)
+{
+  std::ifstream file(_path, std::ios::binary);
+  if (!file)
+    return nullptr;
+
+  BvhCacheHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file ||
+      !std::equal(header.magic, header.magic + sizeof(header.magic),
+                  kBvhCacheMagic) ||
+      header.size < sizeof(btQuantizedBvh) ||
+      header.size > std::numeric_limits<unsigned int>::max())
   {
-    btVector3 bv0(vertices[indices[j]*3+0],
-                  vertices[indices[j]*3+1],
-                  vertices[indices[j]*3+2]);
+    return nullptr;
+  }
 
-    btVector3 bv1(vertices[indices[j+1]*3+0],
-                  vertices[indices[j+1]*3+1],
-                  vertices[indices[j+1]*3+2]);
+  // Bullet needs the hierarchy to be aligned like its own allocations
+  const auto size = static_cast<unsigned int>(header.size);
+  void *buffer = btAlignedAlloc(size, 16);
+  if (!file.read(static_cast<char *>(buffer), size) ||
+      file.peek() != std::ifstream::traits_type::eof() ||
+      mesh::HashBytes(mesh::kHashBytesSeed, buffer, size) != header.hash)
+  {
+    btAlignedFree(buffer);
+    return nullptr;
+  }
 
-    btVector3 bv2(vertices[indices[j+2]*3+0],
-                  vertices[indices[j+2]*3+1],
-                  vertices[indices[j+2]*3+2]);
+  const btQuantizedBvh *serialized =
+      btQuantizedBvh::deSerializeInPlace(buffer, size, false);
+  std::shared_ptr<btOptimizedBvh> bvh;
+  if (serialized)
+  {
+    bvh = std::make_shared<btOptimizedBvh>();
+    static_cast<btQuantizedBvh &>(*bvh) = *serialized;
+  }
+  btAlignedFree(buffer);
+  return bvh;
+}
 
-    mTriMesh.get()->addTriangle(bv0, bv1, bv2);
+/////////////////////////////////////////////////
+/// \brief Write a bounding volume hierarchy to the cache
+void WriteBvhCache(const std::string &_path, const btOptimizedBvh &_bvh)
+{
+  // The buffer is cleared, so that the padding that Bullet skips does not
+  // make the files of the same hierarchy differ
+  const unsigned int size = _bvh.calculateSerializeBufferSize();
+  void *buffer = btAlignedAlloc(size, 16);
+  std::memset(buffer, 0, size);
+  if (!_bvh.serializeInPlace(buffer, size, false))
+  {
+    btAlignedFree(buffer);
+    return;
   }
 
-  auto gimpactMeshShape =
-    std::make_shared<btGImpactMeshShape>(mTriMesh.get());
-  gimpactMeshShape.get()->updateBound();
+  BvhCacheHeader header;
+  std::copy(kBvhCacheMagic, kBvhCacheMagic + sizeof(kBvhCacheMagic),
+            header.magic);
+  header.size = size;
+  header.hash = mesh::HashBytes(mesh::kHashBytesSeed, buffer, size);
 
-  // TODO(lobotuerk) Save collision if needed
-  // collision->shape = gimpactMeshShape;
+  std::string contents(reinterpret_cast<const char *>(&header),
+                       sizeof(header));
+  contents.append(static_cast<const char *>(buffer), size);
+  btAlignedFree(buffer);
+
+  mesh::WriteCacheFile(_path, contents);
+}
+}
 
-  delete [] vertices;
-  delete [] indices;
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachMeshShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const ignition::common::Mesh &_mesh,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  // Shapes of the same mesh and scale share its triangles
+  const std::shared_ptr<TriangleMesh> mTriMesh =
+    TriangleMesh::Get(_mesh, _scale);
 
   const auto &linkInfo = this->links.at(_linkID);
   const auto &modelID = linkInfo->model;
   const auto &body = linkInfo->link.get();
 
+  // Static links never move, so their meshes are collided through a bounding
+  // volume hierarchy that is built once. Moving meshes need GImpact, which
+  // refits its hierarchy as the mesh moves and can collide with other meshes.
+  std::shared_ptr<btCollisionShape> meshShape;
+  std::shared_ptr<btOptimizedBvh> bvh;
+  if (body->isStaticObject())
+  {
+    const std::string cachePath = BvhCachePath(*mTriMesh);
+    if (!cachePath.empty())
+      bvh = ReadBvhCache(cachePath);
+
+    if (bvh)
+    {
+      auto bvhMeshShape = std::make_shared<btBvhTriangleMeshShape>(
+        mTriMesh.get(), true, false);
+      bvhMeshShape->setOptimizedBvh(bvh.get());
+      meshShape = bvhMeshShape;
+    }
+    else
+    {
+      auto bvhMeshShape = std::make_shared<btBvhTriangleMeshShape>(
+        mTriMesh.get(), true);
+      if (!cachePath.empty())
+        WriteBvhCache(cachePath, *bvhMeshShape->getOptimizedBvh());
+      meshShape = bvhMeshShape;
+    }
+  }
+  else
+  {
+    auto gimpactMeshShape =
+      std::make_shared<btGImpactMeshShape>(mTriMesh.get());
+    gimpactMeshShape.get()->updateBound();
+    meshShape = gimpactMeshShape;
+  }
+
   auto poseWithInertia =
     linkInfo->inertialPose.Inverse() * ignition::math::eigen3::convert(_pose);
   const auto poseIsometry = ignition::math::eigen3::convert(poseWithInertia);
@@ -91,19 +234,71 @@ Identity ShapeFeatures::AttachMeshShape(
   baseTransform.setBasis(convertMat(poseLinear));
 
   /* TO-DO(Lobotuerk): figure out if this line is needed */
-  // gimpactMeshShape->setMargin(btScalar(0.001));
+  // meshShape->setMargin(btScalar(0.001));
 
   dynamic_cast<btCompoundShape *>(
     body->getCollisionShape())->addChildShape(
-    baseTransform, gimpactMeshShape.get());
+    baseTransform, meshShape.get());
 
   auto identity = this->AddCollision(
-    _linkID, {_name, gimpactMeshShape, _linkID, modelID,
-    ignition::math::eigen3::convert(_pose), true, mTriMesh});
+    _linkID, {_name, meshShape, _linkID, modelID,
+    ignition::math::eigen3::convert(_pose), true, mTriMesh, {}, bvh});
   return identity;
 
 }
 
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexMeshShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const ignition::common::Mesh &_mesh,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale,
+    const mesh::ConvexDecompositionOptions &_options)
+{
+  // Shapes of the same mesh, scale and decomposition share its hulls
+  const std::shared_ptr<ConvexMesh> convexMesh =
+      ConvexMesh::Get(_mesh, _scale, _options);
+  if (!convexMesh)
+  {
+    ignwarn << "The mesh [" << _mesh.Path() << "] has no volume, so it has "
+            << "no convex hull. It will collide as triangles." << std::endl;
+    return this->AttachMeshShape(_linkID, _name, _mesh, _pose, _scale);
+  }
+
+  // Each hull is a child of one compound shape, so that convex collision
+  // algorithms are used for every part of the mesh. The children keep the
+  // shared hulls alive.
+  const auto compoundShape = std::make_shared<btCompoundShape>();
+  std::vector<std::shared_ptr<btCollisionShape>> hullShapes;
+  btTransform hullTransform;
+  hullTransform.setIdentity();
+  for (const auto &hull : convexMesh->Hulls())
+  {
+    compoundShape->addChildShape(hullTransform, hull.get());
+    hullShapes.emplace_back(convexMesh, hull.get());
+  }
+
+  const auto &linkInfo = this->links.at(_linkID);
+  const auto &modelID = linkInfo->model;
+  const auto &body = linkInfo->link.get();
+
+  auto poseWithInertia =
+    linkInfo->inertialPose.Inverse() * ignition::math::eigen3::convert(_pose);
+  const auto poseIsometry = ignition::math::eigen3::convert(poseWithInertia);
+  btTransform baseTransform;
+  baseTransform.setOrigin(convertVec(poseIsometry.translation()));
+  baseTransform.setBasis(convertMat(poseIsometry.linear()));
+
+  dynamic_cast<btCompoundShape *>(
+    body->getCollisionShape())->addChildShape(
+    baseTransform, compoundShape.get());
+
+  return this->AddCollision(
+    _linkID, {_name, compoundShape, _linkID, modelID,
+    ignition::math::eigen3::convert(_pose), true, nullptr, hullShapes});
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToMeshShape(
     const Identity &_shapeID) const
@@ -28,7 +28,8 @@ namespace physics {
 namespace bullet {
 
 struct ShapeFeatureList : ignition::physics::FeatureList<
-  mesh::AttachMeshShapeFeature
+  mesh::AttachMeshShapeFeature,
+  mesh::AttachConvexMeshShapeFeature
 > { };
 
 class ShapeFeatures :
@@ -42,6 +43,14 @@ class ShapeFeatures :
       const Pose3d &_pose,
       const LinearVector3d &_scale) override;
 
+  public: Identity AttachConvexMeshShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const ignition::common::Mesh &_mesh,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale,
+      const mesh::ConvexDecompositionOptions &_options) override;
+
   public: Identity CastToMeshShape(
       const Identity &_shapeID) const override;
 };
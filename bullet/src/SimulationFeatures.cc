@@ -16,6 +16,7 @@
 */
 
 #include "SimulationFeatures.hh"
+#include "WorldFeatures.hh"
 
 namespace ignition {
 namespace physics {
@@ -23,7 +24,7 @@ namespace bullet {
 
 void SimulationFeatures::WorldForwardStep(
     const Identity &_worldID,
-    ForwardStep::Output & /*_h*/,
+    ForwardStep::Output & _h,
     ForwardStep::State & /*_x*/,
     const ForwardStep::Input & _u)
 {
@@ -32,7 +33,118 @@ void SimulationFeatures::WorldForwardStep(
     auto *dtDur =
       _u.Query<std::chrono::steady_clock::duration>();
     std::chrono::duration<double> dt = *dtDur;
+    UseWorldThreads(*worldInfo);
     worldInfo->world->stepSimulation(dt.count(), 1, dt.count());
+
+    this->WriteChangedPoses(*worldInfo, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteChangedPoses(
+    WorldInfo &_worldInfo,
+    ChangedWorldPoses &_changedPoses)
+{
+  _changedPoses.entries.clear();
+  _changedPoses.entries.reserve(_worldInfo.changedLinks.size());
+
+  for (const std::size_t linkId : _worldInfo.changedLinks)
+  {
+    // Links may have been removed since they were queued
+    const auto it = this->links.find(linkId);
+    if (it == this->links.end())
+      continue;
+
+    const LinkInfoPtr &linkInfo = it->second;
+    linkInfo->motionState->changed = false;
+
+    // The motion state lags a step behind the body when Bullet interpolates
+    // it, so the pose is read from the body
+    const btTransform &trans = linkInfo->link->getCenterOfMassTransform();
+    Eigen::Isometry3d poseIsometry;
+    poseIsometry.linear() = convert(trans.getBasis());
+    poseIsometry.translation() = convert(trans.getOrigin());
+
+    WorldPose wp;
+    wp.pose = ignition::math::eigen3::convert(poseIsometry) *
+        linkInfo->inertialPose.Inverse();
+    wp.body = linkId;
+
+    // Bullet hands every awake body to its motion state, even if it rests, so
+    // links are only reported if they moved since they were last reported
+    if (!linkInfo->reportedPose ||
+        !linkInfo->reportedPose->Pos().Equal(wp.pose.Pos(), 1e-6) ||
+        !linkInfo->reportedPose->Rot().Equal(wp.pose.Rot(), 1e-6))
+    {
+      _changedPoses.entries.push_back(wp);
+      linkInfo->reportedPose = wp.pose;
+    }
+  }
+  _worldInfo.changedLinks.clear();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldSleepThresholds(
+    const Identity &_worldID,
+    const double _linearSpeed,
+    const double _angularSpeed)
+{
+  const WorldInfoPtr &worldInfo = this->worlds.at(_worldID);
+  worldInfo->sleepThresholds = {_linearSpeed, _angularSpeed};
+
+  // Models with thresholds of their own keep them
+  for (const auto &[modelId, modelInfo] : this->models)
+  {
+    (void) modelId;
+    if (modelInfo->world.id == _worldID.id && !modelInfo->sleepThresholds)
+      this->ApplySleepThresholds(*modelInfo, worldInfo->sleepThresholds);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepThresholds(
+    const Identity &_modelID,
+    const double _linearSpeed,
+    const double _angularSpeed)
+{
+  const ModelInfoPtr &modelInfo = this->models.at(_modelID);
+  modelInfo->sleepThresholds = SleepThresholds{_linearSpeed, _angularSpeed};
+  this->ApplySleepThresholds(*modelInfo, *modelInfo->sleepThresholds);
+}
+
+/////////////////////////////////////////////////
+GetSleepStatisticsFeature::SleepStatistics
+SimulationFeatures::GetSleepStatistics(const Identity &_worldID) const
+{
+  GetSleepStatisticsFeature::SleepStatistics statistics;
+  const auto &world = this->worlds.at(_worldID)->world;
+  const btCollisionObjectArray &objects = world->getCollisionObjectArray();
+  for (int i = 0; i < objects.size(); ++i)
+  {
+    const btRigidBody *body = btRigidBody::upcast(objects[i]);
+    if (!body || body->isStaticObject())
+      continue;
+
+    if (body->isActive())
+      ++statistics.activeBodies;
+    else
+      ++statistics.sleepingBodies;
+  }
+  return statistics;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ApplySleepThresholds(
+    const ModelInfo &_modelInfo,
+    const SleepThresholds &_thresholds)
+{
+  for (const std::size_t linkId : _modelInfo.links)
+  {
+    const auto &body = this->links.at(linkId)->link;
+    body->setSleepingThresholds(
+      _thresholds.linearSpeed, _thresholds.angularSpeed);
+    if (!body->isStaticObject())
+      body->activate(true);
+  }
 }
 
 }  // namespace bullet
@@ -20,6 +20,7 @@
 
 #include <vector>
 #include <ignition/physics/ForwardStep.hh>
+#include <ignition/physics/Sleep.hh>
 
 #include "Base.hh"
 
@@ -28,7 +29,9 @@ namespace physics {
 namespace bullet {
 
 struct SimulationFeatureList : ignition::physics::FeatureList<
-  ForwardStep
+  ForwardStep,
+  SetSleepThresholdsFeature,
+  GetSleepStatisticsFeature
 > { };
 
 class SimulationFeatures :
@@ -40,6 +43,33 @@ class SimulationFeatures :
       ForwardStep::Output &_h,
       ForwardStep::State &_x,
       const ForwardStep::Input &_u) override;
+
+  public: void SetWorldSleepThresholds(
+      const Identity &_worldID,
+      double _linearSpeed,
+      double _angularSpeed) override;
+
+  public: void SetModelSleepThresholds(
+      const Identity &_modelID,
+      double _linearSpeed,
+      double _angularSpeed) override;
+
+  public: GetSleepStatisticsFeature::SleepStatistics GetSleepStatistics(
+      const Identity &_worldID) const override;
+
+  /// \brief Write the poses of the links that changed since the last step,
+  /// and clear the changed links of the world
+  /// \param[in,out] _worldInfo The world
+  /// \param[out] _changedPoses Poses of the links that changed
+  private: void WriteChangedPoses(
+      WorldInfo &_worldInfo,
+      ChangedWorldPoses &_changedPoses);
+
+  /// \brief Set the sleep thresholds of the links of a model, and wake them
+  /// up so that they go to sleep again by the new thresholds
+  private: void ApplySleepThresholds(
+      const ModelInfo &_modelInfo,
+      const SleepThresholds &_thresholds);
 };
 
 }  // namespace bullet
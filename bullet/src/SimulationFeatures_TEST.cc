@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include <ignition/plugin/Loader.hh>
+
+#include <ignition/physics/ForwardStep.hh>
+#include <ignition/physics/FreeGroup.hh>
+#include <ignition/physics/RequestEngine.hh>
+#include <ignition/physics/Sleep.hh>
+#include <ignition/physics/World.hh>
+#include <ignition/physics/sdf/ConstructModel.hh>
+#include <ignition/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
+
+struct TestFeatureList : ignition::physics::FeatureList<
+    ignition::physics::ForwardStep,
+    ignition::physics::FindFreeGroupFeature,
+    ignition::physics::SetFreeGroupWorldPose,
+    ignition::physics::SetSleepThresholdsFeature,
+    ignition::physics::GetSleepStatisticsFeature,
+    ignition::physics::Solver,
+    ignition::physics::ThreadCount,
+    ignition::physics::sdf::ConstructSdfModel,
+    ignition::physics::sdf::ConstructSdfWorld
+> { };
+
+using TestWorldPtr = ignition::physics::World3dPtr<TestFeatureList>;
+
+/// \brief A world with a ground plane
+const char kGround[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <model name="ground">
+      <static>true</static>
+      <link name="link">
+        <collision name="collision">
+          <geometry>
+            <plane><normal>0 0 1</normal><size>10 10</size></plane>
+          </geometry>
+        </collision>
+      </link>
+    </model>
+  </world>
+</sdf>)";
+
+/// \brief A box that rests on the ground plane
+const char kBox[] = R"(
+<sdf version="1.7">
+  <world name="default">
+    <model name="box">
+      <pose>0 0 0.5 0 0 0</pose>
+      <link name="link">
+        <inertial>
+          <mass>1</mass>
+          <inertia>
+            <ixx>0.1667</ixx><iyy>0.1667</iyy><izz>0.1667</izz>
+          </inertia>
+        </inertial>
+        <collision name="collision">
+          <geometry>
+            <box><size>1 1 1</size></box>
+          </geometry>
+        </collision>
+      </link>
+    </model>
+  </world>
+</sdf>)";
+
+/// \brief Load the world, with the box in it
+/// \param[out] _box The box
+TestWorldPtr LoadWorld(ignition::physics::Model3dPtr<TestFeatureList> &_box)
+{
+  ignition::plugin::Loader loader;
+  loader.LoadLib(bullet_plugin_LIB);
+
+  ignition::plugin::PluginPtr bullet =
+      loader.Instantiate("ignition::physics::bullet::Plugin");
+
+  auto engine =
+      ignition::physics::RequestEngine3d<TestFeatureList>::From(bullet);
+  EXPECT_NE(nullptr, engine);
+
+  sdf::Root groundRoot;
+  EXPECT_TRUE(groundRoot.LoadSdfString(kGround).empty());
+  auto world = engine->ConstructWorld(*groundRoot.WorldByIndex(0));
+  EXPECT_NE(nullptr, world);
+
+  // The box is constructed on its own, since bullet cannot look models up
+  sdf::Root boxRoot;
+  EXPECT_TRUE(boxRoot.LoadSdfString(kBox).empty());
+  if (world)
+    _box = world->ConstructModel(*boxRoot.WorldByIndex(0)->ModelByIndex(0));
+  return world;
+}
+
+/// \brief Step a world by 1 ms
+void StepWorld(const TestWorldPtr &_world, const std::size_t _numSteps)
+{
+  ignition::physics::ForwardStep::Input input;
+  ignition::physics::ForwardStep::State state;
+  ignition::physics::ForwardStep::Output output;
+  input.Get<std::chrono::steady_clock::duration>() =
+      std::chrono::milliseconds(1);
+
+  for (std::size_t i = 0; i < _numSteps; ++i)
+    _world->Step(output, state, input);
+}
+
+/////////////////////////////////////////////////
+TEST(SimulationFeatures_TEST, Sleep)
+{
+  ignition::physics::Model3dPtr<TestFeatureList> box;
+  auto world = LoadWorld(box);
+  ASSERT_NE(nullptr, world);
+  ASSERT_NE(nullptr, box);
+
+  // The static ground is not counted
+  auto statistics = world->GetSleepStatistics();
+  EXPECT_EQ(1u, statistics.activeBodies);
+  EXPECT_EQ(0u, statistics.sleepingBodies);
+
+  // Bullet puts bodies to sleep after they rest for two seconds
+  StepWorld(world, 3000);
+  statistics = world->GetSleepStatistics();
+  EXPECT_EQ(0u, statistics.activeBodies);
+  EXPECT_EQ(1u, statistics.sleepingBodies);
+
+  // Moving the box wakes it up
+  auto freeGroup = box->FindFreeGroup();
+  ASSERT_NE(nullptr, freeGroup);
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(0, 0, 0.5);
+  freeGroup->SetWorldPose(pose);
+  statistics = world->GetSleepStatistics();
+  EXPECT_EQ(1u, statistics.activeBodies);
+  EXPECT_EQ(0u, statistics.sleepingBodies);
+
+  // Thresholds of zero keep the box awake
+  box->SetSleepThresholds(0.0, 0.0);
+  StepWorld(world, 3000);
+  statistics = world->GetSleepStatistics();
+  EXPECT_EQ(1u, statistics.activeBodies);
+  EXPECT_EQ(0u, statistics.sleepingBodies);
+
+  // The box has thresholds of its own, so those of the world do not apply
+  world->SetSleepThresholds(0.05, 0.05);
+  StepWorld(world, 3000);
+  EXPECT_EQ(1u, world->GetSleepStatistics().activeBodies);
+
+  box->SetSleepThresholds(0.05, 0.05);
+  StepWorld(world, 3000);
+  EXPECT_EQ(1u, world->GetSleepStatistics().sleepingBodies);
+}
+
+/////////////////////////////////////////////////
+TEST(SimulationFeatures_TEST, MultithreadedSolver)
+{
+  ignition::physics::Model3dPtr<TestFeatureList> box;
+  auto world = LoadWorld(box);
+  ASSERT_NE(nullptr, world);
+  ASSERT_NE(nullptr, box);
+  EXPECT_EQ("sequential_impulse", world->GetSolver());
+  EXPECT_EQ(1u, world->GetThreadCount());
+
+  world->SetSolver("unknown");
+  EXPECT_EQ("sequential_impulse", world->GetSolver());
+
+  // Bullet may be built without multithreading support, in which case the
+  // solver stays the same
+  world->SetSolver("sequential_impulse_mt");
+  if (world->GetSolver() == "sequential_impulse_mt")
+  {
+    EXPECT_LE(1u, world->GetThreadCount());
+    world->SetThreadCount(1u);
+    EXPECT_EQ(1u, world->GetThreadCount());
+    world->SetThreadCount(0u);
+  }
+
+  // The box moved to the new world, so it still rests on the ground and
+  // goes to sleep
+  StepWorld(world, 3000);
+  auto statistics = world->GetSleepStatistics();
+  EXPECT_EQ(0u, statistics.activeBodies);
+  EXPECT_EQ(1u, statistics.sleepingBodies);
+
+  world->SetSolver("sequential_impulse");
+  EXPECT_EQ("sequential_impulse", world->GetSolver());
+  EXPECT_EQ(1u, world->GetThreadCount());
+  EXPECT_EQ(1u, world->GetSleepStatistics().sleepingBodies);
+}
+
+/////////////////////////////////////////////////
+TEST(SimulationFeatures_TEST, ChangedWorldPoses)
+{
+  ignition::physics::Model3dPtr<TestFeatureList> box;
+  auto world = LoadWorld(box);
+  ASSERT_NE(nullptr, world);
+  ASSERT_NE(nullptr, box);
+
+  ignition::physics::ForwardStep::Input input;
+  ignition::physics::ForwardStep::State state;
+  ignition::physics::ForwardStep::Output output;
+  input.Get<std::chrono::steady_clock::duration>() =
+      std::chrono::milliseconds(1);
+
+  // The first step reports every link, including the static ground
+  world->Step(output, state, input);
+  EXPECT_EQ(2u,
+      output.Get<ignition::physics::ChangedWorldPoses>().entries.size());
+
+  // A box that rests on the ground stays awake for a while, but it is only
+  // reported when it moves, so it is not reported every step
+  StepWorld(world, 500);
+  ASSERT_EQ(1u, world->GetSleepStatistics().activeBodies);
+  std::size_t reported = 0u;
+  for (std::size_t i = 0; i < 100u; ++i)
+  {
+    world->Step(output, state, input);
+    reported +=
+        output.Get<ignition::physics::ChangedWorldPoses>().entries.size();
+  }
+  EXPECT_GT(100u, reported);
+
+  // A box that sleeps does not move
+  StepWorld(world, 3000);
+  ASSERT_EQ(1u, world->GetSleepStatistics().sleepingBodies);
+  world->Step(output, state, input);
+  EXPECT_TRUE(
+      output.Get<ignition::physics::ChangedWorldPoses>().entries.empty());
+
+  // Moving the box reports its new pose
+  auto freeGroup = box->FindFreeGroup();
+  ASSERT_NE(nullptr, freeGroup);
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(1, 0, 2);
+  freeGroup->SetWorldPose(pose);
+  world->Step(output, state, input);
+  const auto &entries =
+      output.Get<ignition::physics::ChangedWorldPoses>().entries;
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_NEAR(1.0, entries[0].pose.Pos().X(), 1e-6);
+  EXPECT_NEAR(2.0, entries[0].pose.Pos().Z(), 1e-3);
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TriangleMesh.hh"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <ignition/physics/mesh/MeshKey.hh>
+#include <ignition/physics/mesh/WeakValueCache.hh>
+
+namespace ignition {
+namespace physics {
+namespace bullet {
+
+namespace {
+/////////////////////////////////////////////////
+using MeshCache =
+    mesh::WeakValueCache<mesh::MeshKey, TriangleMesh, mesh::MeshKeyHash>;
+
+/////////////////////////////////////////////////
+using ConvexMeshCache =
+    mesh::WeakValueCache<mesh::ConvexMeshKey, ConvexMesh,
+                         mesh::ConvexMeshKeyHash>;
+
+/////////////////////////////////////////////////
+MeshCache &GetMeshCache()
+{
+  static MeshCache cache;
+  return cache;
+}
+
+/////////////////////////////////////////////////
+ConvexMeshCache &GetConvexMeshCache()
+{
+  static ConvexMeshCache cache;
+  return cache;
+}
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<TriangleMesh> TriangleMesh::Get(
+    const ignition::common::Mesh &_input,
+    const Eigen::Vector3d &_scale)
+{
+  return GetMeshCache().Get(mesh::MeshKey(_input, _scale), [&]()
+  {
+    return new TriangleMesh(_input, _scale);
+  });
+}
+
+/////////////////////////////////////////////////
+std::size_t TriangleMesh::CacheSize()
+{
+  return GetMeshCache().Size();
+}
+
+/////////////////////////////////////////////////
+TriangleMesh::TriangleMesh(
+    const ignition::common::Mesh &_input,
+    const Eigen::Vector3d &_scale)
+{
+  double *vertexArray = nullptr;
+  int *indexArray = nullptr;
+  _input.FillArrays(&vertexArray, &indexArray);
+
+  const unsigned int numVertices = _input.VertexCount();
+  const unsigned int numIndices = _input.IndexCount() - _input.IndexCount() % 3;
+
+  this->vertices.resize(3 * numVertices);
+  for (unsigned int j = 0; j < numVertices; ++j)
+  {
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+      this->vertices[3 * j + k] =
+          static_cast<btScalar>(vertexArray[3 * j + k] * _scale[k]);
+    }
+  }
+  this->indices.assign(indexArray, indexArray + numIndices);
+
+  delete [] vertexArray;
+  delete [] indexArray;
+
+  // The mesh shapes read the triangles through this part, which refers to
+  // the arrays above instead of copying them
+  btIndexedMesh part;
+  part.m_numTriangles = static_cast<int>(this->indices.size() / 3);
+  part.m_triangleIndexBase =
+      reinterpret_cast<const unsigned char *>(this->indices.data());
+  part.m_triangleIndexStride = 3 * sizeof(int);
+  part.m_numVertices = static_cast<int>(numVertices);
+  part.m_vertexBase =
+      reinterpret_cast<const unsigned char *>(this->vertices.data());
+  part.m_vertexStride = 3 * sizeof(btScalar);
+#ifdef BT_USE_DOUBLE_PRECISION
+  part.m_vertexType = PHY_DOUBLE;
+#else
+  part.m_vertexType = PHY_FLOAT;
+#endif
+  this->addIndexedMesh(part, PHY_INTEGER);
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<ConvexMesh> ConvexMesh::Get(
+    const ignition::common::Mesh &_input,
+    const Eigen::Vector3d &_scale,
+    const mesh::ConvexDecompositionOptions &_options)
+{
+  return GetConvexMeshCache().Get(
+      mesh::ConvexMeshKey(_input, _scale, _options), [&]() -> ConvexMesh *
+  {
+    const std::vector<mesh::ConvexHull> hulls =
+        mesh::ComputeConvexDecomposition(_input, _options);
+    if (hulls.empty())
+      return nullptr;
+    return new ConvexMesh(hulls, _scale);
+  });
+}
+
+/////////////////////////////////////////////////
+std::size_t ConvexMesh::CacheSize()
+{
+  return GetConvexMeshCache().Size();
+}
+
+/////////////////////////////////////////////////
+ConvexMesh::ConvexMesh(
+    const std::vector<mesh::ConvexHull> &_hulls,
+    const Eigen::Vector3d &_scale)
+{
+  this->hulls.reserve(_hulls.size());
+  for (const mesh::ConvexHull &hull : _hulls)
+  {
+    auto hullShape = std::make_unique<btConvexHullShape>();
+    for (const Eigen::Vector3d &vertex : hull.vertices)
+    {
+      hullShape->addPoint(btVector3(
+          static_cast<btScalar>(vertex.x() * _scale.x()),
+          static_cast<btScalar>(vertex.y() * _scale.y()),
+          static_cast<btScalar>(vertex.z() * _scale.z())), false);
+    }
+    hullShape->recalcLocalAabb();
+    this->hulls.push_back(std::move(hullShape));
+  }
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::unique_ptr<btConvexHullShape>> &
+ConvexMesh::Hulls() const
+{
+  return this->hulls;
+}
+
+}
+}
+}
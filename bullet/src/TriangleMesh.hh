@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_BULLET_SRC_TRIANGLEMESH_HH_
+#define IGNITION_PHYSICS_BULLET_SRC_TRIANGLEMESH_HH_
+
+#include <btBulletCollisionCommon.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include <ignition/common/Mesh.hh>
+#include <ignition/physics/mesh/ConvexDecomposition.hh>
+
+namespace ignition {
+namespace physics {
+namespace bullet {
+
+/// \brief Triangles of a mesh as indices into a single scaled copy of its
+/// vertices, which bullet mesh shapes read in place.
+class TriangleMesh : public btTriangleIndexVertexArray
+{
+  /// \brief Constructor
+  /// \param[in] _input The mesh
+  /// \param[in] _scale The scale of the mesh
+  public: TriangleMesh(const ignition::common::Mesh &_input,
+                       const Eigen::Vector3d &_scale);
+
+  /// \brief Get the triangles of a mesh with a scale. While the triangles are
+  /// in use, every request for the same mesh and scale gets the same
+  /// triangles, so a mesh that is instanced many times is stored only once.
+  /// The cache only holds a weak pointer, so the triangles are freed and
+  /// evicted from the cache once the last shape that uses them is gone.
+  /// \param[in] _input The mesh
+  /// \param[in] _scale The scale of the mesh
+  /// \return The triangles of the mesh
+  public: static std::shared_ptr<TriangleMesh> Get(
+      const ignition::common::Mesh &_input,
+      const Eigen::Vector3d &_scale);
+
+  /// \brief Number of triangle meshes in the cache of Get
+  public: static std::size_t CacheSize();
+
+  /// \brief Scaled vertices, three coordinates each
+  private: std::vector<btScalar> vertices;
+
+  /// \brief Vertex indices, three per triangle
+  private: std::vector<int> indices;
+};
+
+/// \brief Scaled convex hulls of the parts of a mesh, which the compound
+/// shapes of every instance of the mesh share as children.
+class ConvexMesh
+{
+  /// \brief Constructor
+  /// \param[in] _hulls The convex hulls of the parts of the mesh
+  /// \param[in] _scale The scale of the mesh
+  public: ConvexMesh(const std::vector<mesh::ConvexHull> &_hulls,
+                     const Eigen::Vector3d &_scale);
+
+  /// \brief Get the convex hulls of a mesh with a scale. Like the triangles
+  /// of TriangleMesh::Get, the hulls are shared while they are in use, so a
+  /// mesh is only decomposed again once every shape that uses it is gone.
+  /// \param[in] _input The mesh
+  /// \param[in] _scale The scale of the mesh
+  /// \param[in] _options How to decompose the mesh
+  /// \return The hulls of the mesh, or nullptr if the mesh has no volume
+  public: static std::shared_ptr<ConvexMesh> Get(
+      const ignition::common::Mesh &_input,
+      const Eigen::Vector3d &_scale,
+      const mesh::ConvexDecompositionOptions &_options);
+
+  /// \brief Number of convex meshes in the cache of Get
+  public: static std::size_t CacheSize();
+
+  /// \brief The convex hulls
+  public: const std::vector<std::unique_ptr<btConvexHullShape>> &Hulls() const;
+
+  /// \brief The convex hulls
+  private: std::vector<std::unique_ptr<btConvexHullShape>> hulls;
+};
+
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_BULLET_SRC_TRIANGLEMESH_HH_
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "TriangleMesh.hh"
+
+using namespace ignition;
+
+/// \brief Two unit cubes that are 2 m apart along x
+common::Mesh TwoCubes()
+{
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (unsigned int cube = 0; cube < 2; ++cube)
+  {
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      subMesh.AddVertex(
+          3.0 * cube + ((corner & 1) ? 1.0 : 0.0),
+          (corner & 2) ? 1.0 : 0.0,
+          (corner & 4) ? 1.0 : 0.0);
+    }
+
+    // Corner i has x, y and z at the maximum for bits 0, 1 and 2 of i
+    const unsigned int triangles[12][3] = {
+        {0, 2, 1}, {1, 2, 3}, {4, 5, 6}, {5, 7, 6},
+        {0, 1, 4}, {1, 5, 4}, {2, 6, 3}, {3, 6, 7},
+        {0, 4, 2}, {2, 4, 6}, {1, 3, 5}, {3, 7, 5}};
+    for (const auto &triangle : triangles)
+    {
+      for (const unsigned int index : triangle)
+        subMesh.AddIndex(8u * cube + index);
+    }
+  }
+
+  common::Mesh mesh;
+  mesh.SetName("two_cubes");
+  mesh.AddSubMesh(subMesh);
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMesh_TEST, ShareTriangleMesh)
+{
+  const common::Mesh mesh = TwoCubes();
+  const std::size_t cacheSize = physics::bullet::TriangleMesh::CacheSize();
+
+  // Two shapes of the same mesh and scale share one mesh interface
+  std::shared_ptr<btStridingMeshInterface> triangles1 =
+      physics::bullet::TriangleMesh::Get(mesh, Eigen::Vector3d::Ones());
+  std::shared_ptr<btStridingMeshInterface> triangles2 =
+      physics::bullet::TriangleMesh::Get(mesh, Eigen::Vector3d::Ones());
+  ASSERT_NE(nullptr, triangles1);
+  EXPECT_EQ(triangles1, triangles2);
+  EXPECT_EQ(cacheSize + 1u, physics::bullet::TriangleMesh::CacheSize());
+
+  // The vertices and indices are read in place, without copies per triangle
+  const unsigned char *vertexBase = nullptr;
+  const unsigned char *indexBase = nullptr;
+  int vertexCount = 0;
+  int vertexStride = 0;
+  int triangleCount = 0;
+  int indexStride = 0;
+  PHY_ScalarType vertexType;
+  PHY_ScalarType indexType;
+  triangles1->getLockedReadOnlyVertexIndexBase(&vertexBase, vertexCount,
+      vertexType, vertexStride, &indexBase, indexStride, triangleCount,
+      indexType);
+  EXPECT_EQ(16, vertexCount);
+  EXPECT_EQ(24, triangleCount);
+  EXPECT_EQ(PHY_INTEGER, indexType);
+  triangles1->unLockReadOnlyVertexBase(0);
+
+  // Another scale gets its own triangles
+  auto scaled = physics::bullet::TriangleMesh::Get(
+      mesh, Eigen::Vector3d::Constant(2.0));
+  ASSERT_NE(nullptr, scaled);
+  EXPECT_NE(triangles1, scaled);
+  EXPECT_EQ(cacheSize + 2u, physics::bullet::TriangleMesh::CacheSize());
+
+  // The entry is evicted once both shapes release the triangles
+  scaled.reset();
+  EXPECT_EQ(cacheSize + 1u, physics::bullet::TriangleMesh::CacheSize());
+  triangles1.reset();
+  EXPECT_EQ(cacheSize + 1u, physics::bullet::TriangleMesh::CacheSize());
+  triangles2.reset();
+  EXPECT_EQ(cacheSize, physics::bullet::TriangleMesh::CacheSize());
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMesh_TEST, ShareConvexMesh)
+{
+  const common::Mesh mesh = TwoCubes();
+  const std::size_t cacheSize = physics::bullet::ConvexMesh::CacheSize();
+
+  physics::mesh::ConvexDecompositionOptions options;
+  options.maxConvexHulls = 2u;
+
+  // Shapes of the same mesh, scale and decomposition share the hulls
+  auto hulls1 = physics::bullet::ConvexMesh::Get(
+      mesh, Eigen::Vector3d::Ones(), options);
+  auto hulls2 = physics::bullet::ConvexMesh::Get(
+      mesh, Eigen::Vector3d::Ones(), options);
+  ASSERT_NE(nullptr, hulls1);
+  EXPECT_EQ(hulls1, hulls2);
+  ASSERT_EQ(2u, hulls1->Hulls().size());
+  EXPECT_EQ(cacheSize + 1u, physics::bullet::ConvexMesh::CacheSize());
+
+  // The hulls are scaled
+  auto scaled = physics::bullet::ConvexMesh::Get(
+      mesh, Eigen::Vector3d::Constant(2.0), options);
+  ASSERT_NE(nullptr, scaled);
+  EXPECT_NE(hulls1, scaled);
+  btVector3 min, max;
+  btTransform identity;
+  identity.setIdentity();
+  scaled->Hulls()[0]->getAabb(identity, min, max);
+  EXPECT_NEAR(2.0, max.z() - min.z(), 0.1);
+
+  // A different decomposition is cached on its own
+  options.maxConvexHulls = 1u;
+  auto single = physics::bullet::ConvexMesh::Get(
+      mesh, Eigen::Vector3d::Ones(), options);
+  ASSERT_NE(nullptr, single);
+  EXPECT_EQ(1u, single->Hulls().size());
+  EXPECT_EQ(cacheSize + 3u, physics::bullet::ConvexMesh::CacheSize());
+
+  // The hulls are evicted once the last shape that uses them is gone
+  hulls1.reset();
+  EXPECT_EQ(cacheSize + 3u, physics::bullet::ConvexMesh::CacheSize());
+  hulls2.reset();
+  scaled.reset();
+  single.reset();
+  EXPECT_EQ(cacheSize, physics::bullet::ConvexMesh::CacheSize());
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMesh_TEST, FlatConvexMesh)
+{
+  common::SubMesh subMesh;
+  subMesh.AddVertex(0, 0, 0);
+  subMesh.AddVertex(1, 0, 0);
+  subMesh.AddVertex(0, 1, 0);
+  subMesh.AddIndex(0);
+  subMesh.AddIndex(1);
+  subMesh.AddIndex(2);
+  common::Mesh mesh;
+  mesh.AddSubMesh(subMesh);
+
+  const std::size_t cacheSize = physics::bullet::ConvexMesh::CacheSize();
+  EXPECT_EQ(nullptr, physics::bullet::ConvexMesh::Get(
+      mesh, Eigen::Vector3d::Ones(),
+      physics::mesh::ConvexDecompositionOptions()));
+  EXPECT_EQ(cacheSize, physics::bullet::ConvexMesh::CacheSize());
+}
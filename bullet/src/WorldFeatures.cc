@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "WorldFeatures.hh"
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btThreads.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ignition {
+namespace physics {
+namespace bullet {
+
+namespace {
+/////////////////////////////////////////////////
+/// \brief The task scheduler of Bullet, which is global, so every
+/// multithreaded world shares it. It is created on first use and never
+/// destroyed, since worlds may outlive static objects.
+/// \return The task scheduler, or null if Bullet was built without
+/// multithreading support
+btITaskScheduler *TaskScheduler()
+{
+  static btITaskScheduler *scheduler = []()
+  {
+    btITaskScheduler *defaultScheduler = btCreateDefaultTaskScheduler();
+    if (defaultScheduler)
+      btSetTaskScheduler(defaultScheduler);
+    return defaultScheduler;
+  }();
+  return scheduler;
+}
+
+/////////////////////////////////////////////////
+/// \brief Number of threads that a world steps on
+std::size_t ResolveThreadCount(const WorldInfo &_worldInfo)
+{
+  btITaskScheduler *scheduler = TaskScheduler();
+  if (!scheduler)
+    return 1u;
+
+  const auto maxThreads =
+    static_cast<std::size_t>(scheduler->getMaxNumThreads());
+  if (_worldInfo.threadCount == 0u)
+    return maxThreads;
+  return std::min(_worldInfo.threadCount, maxThreads);
+}
+}
+
+/////////////////////////////////////////////////
+void BuildDynamicsWorld(WorldInfo &_worldInfo, const bool _multithreaded)
+{
+  if (_multithreaded)
+  {
+    // Pooled allocators are not thread safe once they run out, so they are
+    // made large enough to not run out
+    btDefaultCollisionConstructionInfo constructionInfo;
+    constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+    constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+    _worldInfo.collisionConfiguration =
+      std::make_shared<btDefaultCollisionConfiguration>(constructionInfo);
+    _worldInfo.dispatcher = std::make_shared<btCollisionDispatcherMt>(
+      _worldInfo.collisionConfiguration.get(), 40);
+    _worldInfo.broadphase = std::make_shared<btDbvtBroadphase>();
+
+    // Small islands are solved in parallel by a pool of sequential solvers,
+    // and large islands by a solver that is parallel itself
+    _worldInfo.solver =
+      std::make_shared<btConstraintSolverPoolMt>(BT_MAX_THREAD_COUNT);
+    _worldInfo.islandSolver =
+      std::make_shared<btSequentialImpulseConstraintSolverMt>();
+    _worldInfo.world = std::make_shared<btDiscreteDynamicsWorldMt>(
+      _worldInfo.dispatcher.get(), _worldInfo.broadphase.get(),
+      static_cast<btConstraintSolverPoolMt *>(_worldInfo.solver.get()),
+      _worldInfo.islandSolver.get(),
+      _worldInfo.collisionConfiguration.get());
+  }
+  else
+  {
+    _worldInfo.collisionConfiguration =
+      std::make_shared<btDefaultCollisionConfiguration>();
+    _worldInfo.dispatcher = std::make_shared<btCollisionDispatcher>(
+      _worldInfo.collisionConfiguration.get());
+    _worldInfo.broadphase = std::make_shared<btDbvtBroadphase>();
+    _worldInfo.solver =
+      std::make_shared<btSequentialImpulseConstraintSolver>();
+    _worldInfo.islandSolver = nullptr;
+    _worldInfo.world = std::make_shared<btDiscreteDynamicsWorld>(
+      _worldInfo.dispatcher.get(), _worldInfo.broadphase.get(),
+      _worldInfo.solver.get(), _worldInfo.collisionConfiguration.get());
+  }
+
+  /* TO-DO(Lobotuerk): figure out what this line does*/
+  _worldInfo.world->getSolverInfo().m_globalCfm = 0;
+
+  btGImpactCollisionAlgorithm::registerAlgorithm(_worldInfo.dispatcher.get());
+}
+
+/////////////////////////////////////////////////
+void UseWorldThreads(const WorldInfo &_worldInfo)
+{
+  if (!_worldInfo.islandSolver)
+    return;
+
+  btGetTaskScheduler()->setNumThreadsUsed(
+    static_cast<int>(ResolveThreadCount(_worldInfo)));
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolver(const Identity &_id,
+    const std::string &_solver)
+{
+  const WorldInfoPtr &worldInfo = this->worlds.at(_id);
+
+  bool multithreaded;
+  if (_solver == "sequential_impulse" ||
+      _solver == "btSequentialImpulseConstraintSolver")
+  {
+    multithreaded = false;
+  }
+  else if (_solver == "sequential_impulse_mt" ||
+           _solver == "btSequentialImpulseConstraintSolverMt")
+  {
+    multithreaded = true;
+  }
+  else
+  {
+    ignerr << "Solver [" << _solver << "] is not supported, keeping ["
+           << worldInfo->solverName << "]." << std::endl;
+    return;
+  }
+
+  if (multithreaded && !TaskScheduler())
+  {
+    ignerr << "Solver [" << _solver << "] needs a version of Bullet that "
+           << "was built with BT_THREADSAFE, keeping ["
+           << worldInfo->solverName << "]." << std::endl;
+    return;
+  }
+
+  if (multithreaded != static_cast<bool>(worldInfo->islandSolver))
+  {
+    // Bullet cannot swap the dispatcher or solver of a world for their
+    // multithreaded versions, so the bodies and joints move to a new world
+    WorldInfo rebuilt;
+    BuildDynamicsWorld(rebuilt, multithreaded);
+
+    btDiscreteDynamicsWorld &from = *worldInfo->world;
+    btDiscreteDynamicsWorld &to = *rebuilt.world;
+    to.setGravity(from.getGravity());
+    to.getSolverInfo() = from.getSolverInfo();
+
+    // Joints go first, since they refer to the bodies
+    std::vector<btTypedConstraint *> constraints;
+    for (int i = 0; i < from.getNumConstraints(); ++i)
+      constraints.push_back(from.getConstraint(i));
+    for (btTypedConstraint *constraint : constraints)
+      from.removeConstraint(constraint);
+
+    std::vector<btCollisionObject *> objects;
+    const btCollisionObjectArray &objectArray = from.getCollisionObjectArray();
+    for (int i = 0; i < objectArray.size(); ++i)
+      objects.push_back(objectArray[i]);
+    for (btCollisionObject *object : objects)
+    {
+      btRigidBody *body = btRigidBody::upcast(object);
+      if (!body)
+        continue;
+
+      const btBroadphaseProxy *proxy = body->getBroadphaseHandle();
+      const int group = proxy->m_collisionFilterGroup;
+      const int mask = proxy->m_collisionFilterMask;
+      from.removeRigidBody(body);
+      to.addRigidBody(body, group, mask);
+    }
+
+    // Linked bodies never collide, as when the joints were constructed
+    for (btTypedConstraint *constraint : constraints)
+      to.addConstraint(constraint, true);
+
+    // The old world goes before the objects that it uses
+    worldInfo->world = rebuilt.world;
+    worldInfo->islandSolver = rebuilt.islandSolver;
+    worldInfo->solver = rebuilt.solver;
+    worldInfo->broadphase = rebuilt.broadphase;
+    worldInfo->dispatcher = rebuilt.dispatcher;
+    worldInfo->collisionConfiguration = rebuilt.collisionConfiguration;
+  }
+
+  worldInfo->solverName =
+    multithreaded ? "sequential_impulse_mt" : "sequential_impulse";
+  ignmsg << "Using [" << worldInfo->solverName << "] solver" << std::endl;
+}
+
+/////////////////////////////////////////////////
+const std::string &WorldFeatures::GetWorldSolver(const Identity &_id) const
+{
+  return this->worlds.at(_id)->solverName;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldThreadCount(
+    const Identity &_id, const std::size_t _threads)
+{
+  this->worlds.at(_id)->threadCount = _threads;
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldThreadCount(const Identity &_id) const
+{
+  const WorldInfoPtr &worldInfo = this->worlds.at(_id);
+  if (!worldInfo->islandSolver)
+    return 1u;
+  return ResolveThreadCount(*worldInfo);
+}
+
+}
+}
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_BULLET_SRC_WORLDFEATURES_HH_
+#define IGNITION_PHYSICS_BULLET_SRC_WORLDFEATURES_HH_
+
+#include <cstddef>
+#include <string>
+
+#include <ignition/physics/World.hh>
+
+#include "Base.hh"
+
+namespace ignition {
+namespace physics {
+namespace bullet {
+
+/// \brief Create the collision configuration, dispatcher, broadphase,
+/// solvers and dynamics world of a world. Multithreaded worlds dispatch
+/// collisions and solve islands on the threads of Bullet's task scheduler.
+/// \param[in,out] _worldInfo The world
+/// \param[in] _multithreaded Whether to create a multithreaded world
+void BuildDynamicsWorld(WorldInfo &_worldInfo, bool _multithreaded);
+
+/// \brief Let Bullet's task scheduler use as many threads as a world should
+/// step on. The task scheduler is shared by every world, so this is called
+/// before a multithreaded world steps.
+/// \param[in] _worldInfo The world
+void UseWorldThreads(const WorldInfo &_worldInfo);
+
+struct WorldFeatureList : FeatureList<
+  Solver,
+  ThreadCount
+> { };
+
+class WorldFeatures :
+    public virtual Base,
+    public virtual Implements3d<WorldFeatureList>
+{
+  // Documentation inherited
+  public: void SetWorldSolver(const Identity &_id, const std::string &_solver)
+      override;
+
+  // Documentation inherited
+  public: const std::string &GetWorldSolver(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldThreadCount(
+      const Identity &_id, std::size_t _threads) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldThreadCount(const Identity &_id) const override;
+};
+
+}
+}
+}
+
+#endif
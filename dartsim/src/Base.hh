@@ -23,7 +23,11 @@
 #include <dart/dynamics/Skeleton.hpp>
 #include <dart/simulation/World.hpp>
 
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -39,6 +43,8 @@ namespace ignition {
 namespace physics {
 namespace dartsim {
 
+class TiledHeightmap;
+
 /// \brief The structs ModelInfo, LinkInfo, JointInfo, and ShapeInfo are used
 /// for two reasons:
 /// 1) Holding extra information such as the name or offset
@@ -92,11 +98,82 @@ struct ShapeInfo
   Eigen::Isometry3d tf_offset = Eigen::Isometry3d::Identity();
 };
 
+/// \brief Terrain attached with AttachTiledHeightmapShape. Its tiles are
+/// paged in and out as the world of its link steps.
+struct TiledHeightmapInfo
+{
+  /// \brief Entity ID of the link of the terrain
+  std::size_t linkID;
+
+  /// \brief Gazebo-specified name of the terrain
+  std::string name;
+
+  /// \brief Pose of the center of the terrain in the link frame
+  Eigen::Isometry3d pose;
+
+  /// \brief Tiles of the terrain
+  std::shared_ptr<TiledHeightmap> tiles;
+
+  /// \brief Shape nodes of the resident tiles, by tile index
+  std::unordered_map<std::size_t, dart::dynamics::ShapeNode *> tileNodes;
+};
+
+/// \brief Storage of one kind of entity. Entities live in a dense vector, so
+/// iterating over them touches contiguous memory, and a sparse vector indexed
+/// by entity ID maps each ID to its slot in the dense vector, so a lookup by ID
+/// is two indexed loads instead of a hash lookup. Removing an entity moves the
+/// last entity into its slot. Entity IDs come from a counter that is never
+/// reset, so an ID is never reused and the ID of a removed entity simply maps
+/// to no slot; no generation counter is needed to detect stale IDs.
 template <typename Value1, typename Key2 = Value1>
 struct EntityStorage
 {
-  /// \brief Map from an entity ID to its corresponding object
-  std::unordered_map<std::size_t, Value1> idToObject;
+  /// \brief Marks an entity ID that has no slot in this storage
+  static constexpr std::uint32_t kNoSlot =
+      std::numeric_limits<std::uint32_t>::max();
+
+  /// \brief Marks an entity whose index within its container is not tracked
+  static constexpr std::size_t kNoContainer =
+      std::numeric_limits<std::size_t>::max();
+
+  struct Entry
+  {
+    /// \brief Entity ID
+    std::size_t id;
+
+    /// \brief The stored object
+    Value1 object;
+
+    /// \brief ID of the container of the entity, or kNoContainer
+    std::size_t containerID = kNoContainer;
+
+    /// \brief Index of the entity within its container
+    std::size_t indexInContainer = 0u;
+  };
+
+  /// \brief Dense storage of the entities. The order changes when an entity
+  /// is removed.
+  std::vector<Entry> entries;
+
+  /// \brief Number of consecutive entity IDs that share a page of idToSlot
+  static constexpr std::size_t kSlotPageSize = 1024u;
+
+  /// \brief Slots of kSlotPageSize consecutive entity IDs
+  struct SlotPage
+  {
+    /// \brief Slot in entries of each ID, or kNoSlot
+    std::array<std::uint32_t, kSlotPageSize> slots;
+
+    /// \brief Number of IDs of this page that have a slot
+    std::size_t used = 0u;
+  };
+
+  /// \brief Map from an entity ID to its slot in entries. Entity IDs are
+  /// shared by every kind of entity and are never reused, so the IDs are
+  /// split into pages that only exist while one of their IDs is stored here.
+  /// Memory is bounded by the live entities rather than by every ID ever
+  /// created, and a lookup is still two indexed loads.
+  std::vector<std::unique_ptr<SlotPage>> idToSlot;
 
   /// \brief Map from an object pointer (or other unique key) to its entity ID
   std::unordered_map<Key2, std::size_t> objectToID;
@@ -116,40 +193,111 @@ struct EntityStorage
   /// their Models, so we do not need to use this field for Joints
   IndexMap indexInContainerToID;
 
-  /// \brief Map from an entity ID to its index within its container
-  std::unordered_map<std::size_t, std::size_t> idToIndexInContainer;
+  /// \brief Incremented whenever an entity is added or removed, so that
+  /// caches built from the stored entities know when to rebuild.
+  std::size_t version = 0u;
+
+  /// \brief Store a new entity
+  /// \param[in] _id ID of the entity
+  /// \param[in] _key Unique key of the entity
+  /// \param[in] _object Object of the entity
+  /// \return Reference to the stored object. It is invalidated when another
+  /// entity is added to or removed from this storage.
+  Value1 &Add(const std::size_t _id, const Key2 &_key, Value1 _object)
+  {
+    this->SetSlot(_id, static_cast<std::uint32_t>(this->entries.size()));
+    this->entries.push_back(Entry{_id, std::move(_object)});
+    this->objectToID[_key] = _id;
+    ++this->version;
+    return this->entries.back().object;
+  }
+
+  /// \brief Track the index of a stored entity within its container
+  /// \param[in] _id ID of the entity
+  /// \param[in] _containerID ID of the container
+  /// \param[in] _index Index of the entity within the container
+  void AddToContainer(const std::size_t _id, const std::size_t _containerID,
+                      const std::size_t _index)
+  {
+    Entry &entry = this->EntryOf(_id);
+    entry.containerID = _containerID;
+    entry.indexInContainer = _index;
+    this->indexInContainerToID[_containerID].push_back(_id);
+  }
+
+  /// \brief Get the entry of an entity
+  /// \param[in] _id ID of the entity
+  /// \return Pointer to the entry, or nullptr if the entity is not stored
+  Entry *Find(const std::size_t _id)
+  {
+    const std::uint32_t slot = this->SlotOf(_id);
+    if (slot == kNoSlot)
+      return nullptr;
+    return &this->entries[slot];
+  }
+
+  const Entry *Find(const std::size_t _id) const
+  {
+    return const_cast<EntityStorage *>(this)->Find(_id);
+  }
+
+  /// \brief Get the entry of an entity
+  /// \throws std::out_of_range if the entity is not stored
+  Entry &EntryOf(const std::size_t _id)
+  {
+    Entry *entry = this->Find(_id);
+    if (!entry)
+      throw std::out_of_range("EntityStorage: unknown entity ID");
+    return *entry;
+  }
 
-  /// \brief Map from an entity ID to the ID of its container
-  std::unordered_map<std::size_t, std::size_t> idToContainerID;
+  const Entry &EntryOf(const std::size_t _id) const
+  {
+    return const_cast<EntityStorage *>(this)->EntryOf(_id);
+  }
 
   Value1 &operator[](const std::size_t _id)
   {
-    return idToObject[_id];
+    return this->EntryOf(_id).object;
   }
 
   Value1 &at(const std::size_t _id)
   {
-    return idToObject.at(_id);
+    return this->EntryOf(_id).object;
   }
 
   const Value1 &at(const std::size_t _id) const
   {
-    return idToObject.at(_id);
+    return this->EntryOf(_id).object;
   }
 
   Value1 &at(const Key2 &_key)
   {
-    return idToObject.at(objectToID.at(_key));
+    return this->EntryOf(objectToID.at(_key)).object;
   }
 
   const Value1 &at(const Key2 &_key) const
   {
-    return idToObject.at(objectToID.at(_key));
+    return this->EntryOf(objectToID.at(_key)).object;
   }
 
   std::size_t size() const
   {
-    return idToObject.size();
+    return this->entries.size();
+  }
+
+  /// \brief Index of an entity within its container
+  /// \throws std::out_of_range if the entity is not stored
+  std::size_t IndexInContainer(const std::size_t _id) const
+  {
+    return this->EntryOf(_id).indexInContainer;
+  }
+
+  /// \brief ID of the container of an entity, or kNoContainer
+  /// \throws std::out_of_range if the entity is not stored
+  std::size_t ContainerOf(const std::size_t _id) const
+  {
+    return this->EntryOf(_id).containerID;
   }
 
   std::size_t IdentityOf(const Key2 &_key) const
@@ -164,49 +312,127 @@ struct EntityStorage
 
   bool HasEntity(const std::size_t _id) const
   {
-    return idToObject.find(_id) != idToObject.end();
+    return this->Find(_id) != nullptr;
   }
 
-  bool RemoveEntity(const Key2 &_key)
+  /// \brief Remove an entity. The entry and ID slot of the entity are freed
+  /// in constant time. The later siblings of the entity in its container are
+  /// renumbered, which is linear in their number, because their indices are
+  /// exposed by features such as GetModel(index) and GetIndex.
+  /// \param[in] _key Unique key of the entity
+  /// \param[in] _updateContainer If false, the entity is left in
+  /// indexInContainerToID and the indices of its siblings are not updated
+  /// until RebuildContainer is called. This makes removing many entities of
+  /// the same container linear in the size of the container.
+  /// \return True if the entity was found and removed
+  bool RemoveEntity(const Key2 &_key, const bool _updateContainer = true)
   {
     auto entIter = this->objectToID.find(_key);
-    if (entIter!= this->objectToID.end())
-    {
-      std::size_t entId = entIter->second;
+    if (entIter == this->objectToID.end())
+      return false;
+
+    const std::size_t entId = entIter->second;
+    const std::uint32_t slot = this->SlotOf(entId);
+    const Entry &entry = this->entries[slot];
 
-      // Check if we are keeping track of the index of this entity in its
-      // container
-      auto contIter = this->idToContainerID.find(entId);
-      if (contIter != this->idToContainerID.end())
+    // Check if we are keeping track of the index of this entity in its
+    // container
+    if (_updateContainer && entry.containerID != kNoContainer)
+    {
+      // The key in indexInContainerToID is the index of the vector so erasing
+      // the element automatically decrements the index of the rest of the
+      // elements of the vector. The indices stored in the entries, however,
+      // are numbers. We need to decrement all the indices greater than the
+      // index of the entity we are removing.
+      std::vector<std::size_t> &siblings =
+          this->indexInContainerToID[entry.containerID];
+      for (auto indIter = siblings.begin() + entry.indexInContainer + 1;
+           indIter != siblings.end(); ++indIter)
       {
-        std::size_t contId = contIter->second;
-        std::size_t entIndex = this->idToIndexInContainer.at(entId);
-
-        // house keeping
-        // The key in indexInContainerToID is the index of the vector so erasing
-        // the element automatically decrements the index of the rest of the
-        // elements of the vector. The indices in idToIndexInContainer, however,
-        // are stored as numbers (as values in the map). We need to decrement
-        // all the indices greater than the index of the model we are removing.
-        for (auto indIter =
-                 this->indexInContainerToID[contId].begin() + entIndex + 1;
-             indIter != this->indexInContainerToID[contId].end(); ++indIter)
-        {
-          // decrement the index (the value of the map)
-          --this->idToIndexInContainer[*indIter];
-        }
-
-        this->idToIndexInContainer.erase(entId);
-        this->indexInContainerToID[contId].erase(
-            this->indexInContainerToID[contId].begin() + entIndex);
-        this->idToContainerID.erase(entId);
+        --this->EntryOf(*indIter).indexInContainer;
       }
+      siblings.erase(siblings.begin() + entry.indexInContainer);
+    }
+
+    // Move the last entity into the slot of the removed one
+    if (slot + 1u != this->entries.size())
+    {
+      this->entries[slot] = std::move(this->entries.back());
+      this->SetSlot(this->entries[slot].id, slot);
+    }
+    this->entries.pop_back();
+    this->ClearSlot(entId);
+
+    this->objectToID.erase(entIter);
+    ++this->version;
+    return true;
+  }
+
+  /// \brief Drop the entities of a container that were removed without
+  /// updating the container, and recompute the indices of the others
+  /// \param[in] _containerID ID of the container
+  void RebuildContainer(const std::size_t _containerID)
+  {
+    auto contIter = this->indexInContainerToID.find(_containerID);
+    if (contIter == this->indexInContainerToID.end())
+      return;
+
+    std::vector<std::size_t> &children = contIter->second;
+    std::size_t index = 0u;
+    for (const std::size_t childID : children)
+    {
+      Entry *entry = this->Find(childID);
+      if (!entry)
+        continue;
+
+      entry->indexInContainer = index;
+      children[index++] = childID;
+    }
+    children.resize(index);
+  }
 
-      this->objectToID.erase(entIter);
-      this->idToObject.erase(entId);
-      return true;
+  /// \brief Slot of an entity ID in entries, or kNoSlot
+  std::uint32_t SlotOf(const std::size_t _id) const
+  {
+    const std::size_t page = _id / kSlotPageSize;
+    if (page >= this->idToSlot.size() || !this->idToSlot[page])
+      return kNoSlot;
+    return this->idToSlot[page]->slots[_id % kSlotPageSize];
+  }
+
+  /// \brief Set the slot of an entity ID, allocating its page if needed
+  void SetSlot(const std::size_t _id, const std::uint32_t _slot)
+  {
+    const std::size_t page = _id / kSlotPageSize;
+    if (page >= this->idToSlot.size())
+      this->idToSlot.resize(page + 1u);
+
+    std::unique_ptr<SlotPage> &slotPage = this->idToSlot[page];
+    if (!slotPage)
+    {
+      slotPage = std::make_unique<SlotPage>();
+      slotPage->slots.fill(kNoSlot);
+    }
+
+    std::uint32_t &slot = slotPage->slots[_id % kSlotPageSize];
+    if (slot == kNoSlot)
+      ++slotPage->used;
+    slot = _slot;
+  }
+
+  /// \brief Clear the slot of a stored entity ID, releasing its page once
+  /// none of the IDs of the page are stored
+  void ClearSlot(const std::size_t _id)
+  {
+    const std::size_t page = _id / kSlotPageSize;
+    std::unique_ptr<SlotPage> &slotPage = this->idToSlot[page];
+    slotPage->slots[_id % kSlotPageSize] = kNoSlot;
+    if (--slotPage->used == 0u)
+    {
+      slotPage.reset();
+      while (!this->idToSlot.empty() && !this->idToSlot.back())
+        this->idToSlot.pop_back();
     }
-    return false;
   }
 };
 
@@ -252,16 +478,9 @@ class Base : public Implements3d<FeatureList<Feature>>
   {
     const std::size_t id = this->GetNextEntity();
 
-    this->worlds.idToObject[id] = _world;
-    this->worlds.objectToID[_name] = id;
-
-    std::vector<std::size_t> &indexInContainerToID =
-        this->worlds.indexInContainerToID.at(0);
-
-    this->worlds.idToIndexInContainer[id] = indexInContainerToID.size();
-    indexInContainerToID.push_back(id);
-
-    this->worlds.idToContainerID[id] = 0;
+    this->worlds.Add(id, _name, _world);
+    this->worlds.AddToContainer(
+        id, 0, this->worlds.indexInContainerToID.at(0).size());
 
     _world->setName(_name);
     this->frames[id] = dart::dynamics::Frame::World();
@@ -273,20 +492,15 @@ class Base : public Implements3d<FeatureList<Feature>>
       const ModelInfo &_info, const std::size_t _worldID)
   {
     const std::size_t id = this->GetNextEntity();
-    this->models.idToObject[id] = std::make_shared<ModelInfo>(_info);
-    ModelInfo &entry = *this->models.idToObject[id];
-    this->models.objectToID[_info.model] = id;
+    ModelInfo &entry = *this->models.Add(
+        id, _info.model, std::make_shared<ModelInfo>(_info));
 
     const dart::simulation::WorldPtr &world = worlds[_worldID];
 
-    std::vector<std::size_t> &indexInContainerToID =
-        this->models.indexInContainerToID[_worldID];
-    const std::size_t indexInWorld = indexInContainerToID.size();
-    this->models.idToIndexInContainer[id] = indexInWorld;
-    indexInContainerToID.push_back(id);
-    world->addSkeleton(entry.model);
+    this->models.AddToContainer(
+        id, _worldID, this->models.indexInContainerToID[_worldID].size());
+    this->AddSkeleton(world, entry.model);
 
-    this->models.idToContainerID[id] = _worldID;
     this->frames[id] = _info.frame.get();
 
     return std::forward_as_tuple(id, entry);
@@ -297,22 +511,17 @@ class Base : public Implements3d<FeatureList<Feature>>
               const std::size_t _worldID)
   {
     const std::size_t id = this->GetNextEntity();
-    this->models.idToObject[id] = std::make_shared<ModelInfo>(_info);
-    ModelInfo &entry = *this->models.idToObject[id];
-    this->models.objectToID[_info.model] = id;
+    ModelInfo &entry = *this->models.Add(
+        id, _info.model, std::make_shared<ModelInfo>(_info));
 
     const dart::simulation::WorldPtr &world = worlds[_worldID];
 
     auto parentModelInfo = this->models.at(_parentID);
     const std::size_t indexInModel =
         parentModelInfo->nestedModels.size();
-    this->models.idToIndexInContainer[id] = indexInModel;
-    std::vector<std::size_t> &indexInContainerToID =
-        this->models.indexInContainerToID[_parentID];
-    indexInContainerToID.push_back(id);
-    world->addSkeleton(entry.model);
+    this->models.AddToContainer(id, _parentID, indexInModel);
+    this->AddSkeleton(world, entry.model);
 
-    this->models.idToContainerID[id] = _parentID;
     this->frames[id] = _info.frame.get();
     parentModelInfo->nestedModels.push_back(id);
     return {id, entry};
@@ -323,12 +532,11 @@ class Base : public Implements3d<FeatureList<Feature>>
   {
     const std::size_t id = this->GetNextEntity();
     auto linkInfo = std::make_shared<LinkInfo>();
-    this->links.idToObject[id] = linkInfo;
     linkInfo->link = _bn;
     // The name of the BodyNode during creation is assumed to be the
     // Gazebo-specified name.
     linkInfo->name = _bn->getName();
-    this->links.objectToID[_bn] = id;
+    this->links.Add(id, _bn, linkInfo);
     this->frames[id] = _bn;
 
     this->linksByName[_fullName] = _bn;
@@ -337,12 +545,7 @@ class Base : public Implements3d<FeatureList<Feature>>
     // Even though DART keeps track of the index of this BodyNode in the
     // skeleton, the BodyNode may be moved to another skeleton when a joint is
     // constructed. Thus, we store the original index here.
-    this->links.idToIndexInContainer[id] = _bn->getIndexInSkeleton();
-    std::vector<std::size_t> &indexInContainerToID =
-        this->links.indexInContainerToID[_modelID];
-    indexInContainerToID.push_back(id);
-
-    this->links.idToContainerID[id] = _modelID;
+    this->links.AddToContainer(id, _modelID, _bn->getIndexInSkeleton());
 
     return id;
   }
@@ -350,16 +553,18 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: inline std::size_t AddJoint(DartJoint *_joint)
   {
     const std::size_t id = this->GetNextEntity();
-    this->joints.idToObject[id] = std::make_shared<JointInfo>();
-    this->joints.idToObject[id]->joint = _joint;
-    this->joints.objectToID[_joint] = id;
-    dart::dynamics::SimpleFramePtr jointFrame =
-        dart::dynamics::SimpleFrame::createShared(
-            _joint->getChildBodyNode(), _joint->getName() + "_frame",
-            _joint->getTransformFromChildBodyNode());
+    auto jointInfo = std::make_shared<JointInfo>();
+    jointInfo->joint = _joint;
+    jointInfo->frame = dart::dynamics::SimpleFrame::createShared(
+        _joint->getChildBodyNode(), _joint->getName() + "_frame",
+        _joint->getTransformFromChildBodyNode());
+
+    this->frames[id] = jointInfo->frame.get();
+    this->joints.Add(id, _joint, std::move(jointInfo));
 
-    this->joints.idToObject[id]->frame = jointFrame;
-    this->frames[id] = this->joints.idToObject[id]->frame.get();
+    // The child link of a new joint may have been moved to another skeleton,
+    // so caches of the links of each skeleton are rebuilt
+    ++this->links.version;
 
     return id;
   }
@@ -368,15 +573,75 @@ class Base : public Implements3d<FeatureList<Feature>>
       const ShapeInfo &_info)
   {
     const std::size_t id = this->GetNextEntity();
-    this->shapes.idToObject[id] = std::make_shared<ShapeInfo>(_info);
-    this->shapes.objectToID[_info.node] = id;
+    this->shapes.Add(id, _info.node, std::make_shared<ShapeInfo>(_info));
     this->frames[id] = _info.node.get();
 
     return id;
   }
 
+  /// \brief Add a skeleton to a world, or hold on to it until
+  /// AddDeferredSkeletons is called while deferAddSkeleton is true
+  public: inline void AddSkeleton(
+      const DartWorldPtr &_world, const DartSkeletonPtr &_skeleton)
+  {
+    if (this->deferAddSkeleton)
+      this->deferredSkeletons.emplace_back(_world, _skeleton);
+    else
+      _world->addSkeleton(_skeleton);
+  }
+
+  /// \brief Add the skeletons that were held back by AddSkeleton to their
+  /// worlds, in the order they were constructed, and stop deferring
+  public: inline void AddDeferredSkeletons()
+  {
+    this->deferAddSkeleton = false;
+    for (const auto &[world, skeleton] : this->deferredSkeletons)
+      world->addSkeleton(skeleton);
+    this->deferredSkeletons.clear();
+  }
+
+  /// \brief Defers AddSkeleton while it exists. When the outermost guard is
+  /// destroyed, including while an exception propagates, the skeletons that
+  /// were held back are added to their worlds, so that the worlds always
+  /// match the stored models.
+  public: class DeferAddSkeletonGuard
+  {
+    /// \brief Constructor
+    /// \param[in] _base Base whose skeletons are deferred
+    public: explicit DeferAddSkeletonGuard(Base &_base)
+      : base(_base), outermost(!_base.deferAddSkeleton)
+    {
+      this->base.deferAddSkeleton = true;
+    }
+
+    public: DeferAddSkeletonGuard(const DeferAddSkeletonGuard &) = delete;
+    public: DeferAddSkeletonGuard &operator=(
+        const DeferAddSkeletonGuard &) = delete;
+
+    /// \brief Destructor
+    public: ~DeferAddSkeletonGuard()
+    {
+      if (this->outermost)
+        this->base.AddDeferredSkeletons();
+    }
+
+    /// \brief Base whose skeletons are deferred
+    private: Base &base;
+
+    /// \brief False if the skeletons were already deferred by someone else
+    private: const bool outermost;
+  };
+
+  /// \brief Remove a model and everything it contains
+  /// \param[in] _worldID ID of the world of the model
+  /// \param[in] _modelID ID of the model
+  /// \param[in] _updateWorldIndices If false and the model is a direct child
+  /// of the world, the indices of the other models of the world are not
+  /// updated until models.RebuildContainer(_worldID) is called
+  /// \return True if the model was removed
   public: bool RemoveModelImpl(const std::size_t _worldID,
-                               const std::size_t _modelID)
+                               const std::size_t _modelID,
+                               const bool _updateWorldIndices = true)
   {
     const auto &world = this->worlds.at(_worldID);
     auto modelInfo = this->models.at(_modelID);
@@ -405,18 +670,18 @@ class Base : public Implements3d<FeatureList<Feature>>
 
     // If this is a nested model, remove an entry from the parent models
     // "nestedModels" vector
-    auto parentID = this->models.idToContainerID.at(_modelID);
+    auto parentID = this->models.ContainerOf(_modelID);
     if (parentID != _worldID)
     {
       auto parentModelInfo = this->models.at(parentID);
-      const std::size_t modelIndex =
-          this->models.idToIndexInContainer.at(_modelID);
+      const std::size_t modelIndex = this->models.IndexInContainer(_modelID);
       if (modelIndex >= parentModelInfo->nestedModels.size())
         return false;
       parentModelInfo->nestedModels.erase(
           parentModelInfo->nestedModels.begin() + modelIndex);
     }
-    this->models.RemoveEntity(skel);
+    this->models.RemoveEntity(
+        skel, _updateWorldIndices || parentID != _worldID);
     world->removeSkeleton(skel);
     return true;
   }
@@ -424,17 +689,14 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: inline std::size_t GetWorldOfModelImpl(
               const std::size_t &_modelID) const
   {
-    if (this->models.HasEntity(_modelID))
+    const auto *entry = this->models.Find(_modelID);
+    if (entry && entry->containerID != decltype(this->models)::kNoContainer)
     {
-      auto parentIt = this->models.idToContainerID.find(_modelID);
-      if (parentIt != this->models.idToContainerID.end())
+      if (this->worlds.HasEntity(entry->containerID))
       {
-        if (this->worlds.HasEntity(parentIt->second))
-        {
-          return parentIt->second;
-        }
-        return this->GetWorldOfModelImpl(parentIt->second);
+        return entry->containerID;
       }
+      return this->GetWorldOfModelImpl(entry->containerID);
     }
     return this->GenerateInvalidId();
   }
@@ -446,6 +708,19 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: EntityStorage<ShapeInfoPtr, const DartShapeNode*> shapes;
   public: std::unordered_map<std::size_t, dart::dynamics::Frame*> frames;
 
+  /// \brief While true, AddModel and AddNestedModel do not add the skeletons
+  /// of new models to their worlds, so that a batch of models is added once
+  /// every model of the batch is complete. See AddDeferredSkeletons.
+  public: bool deferAddSkeleton = false;
+
+  /// \brief Skeletons held back while deferAddSkeleton is true, with their
+  /// worlds
+  public: std::vector<std::pair<DartWorldPtr, DartSkeletonPtr>>
+      deferredSkeletons;
+
+  /// \brief Terrain whose tiles are paged in and out as the worlds step
+  public: std::vector<TiledHeightmapInfo> tiledHeightmaps;
+
   /// \brief Map from the fully qualified link name (including the world name)
   /// to the BodyNode object. This is useful for keeping track of BodyNodes even
   /// as they move to other skeletons.
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <stdexcept>
+
 #include <ignition/physics/Implements.hh>
 
 #include <ignition/physics/sdf/ConstructCollision.hh>
@@ -39,6 +41,65 @@ using namespace ignition::physics;
 
 
 
+TEST(BaseClass, EntityStorage)
+{
+  dartsim::EntityStorage<std::shared_ptr<int>, std::string> storage;
+
+  // IDs are shared with other kinds of entities, so they have gaps
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    const std::size_t id = 3 * i + 1;
+    storage.Add(id, std::to_string(id), std::make_shared<int>(i));
+    storage.AddToContainer(id, 0, i);
+  }
+  ASSERT_EQ(4u, storage.size());
+  EXPECT_FALSE(storage.HasEntity(0u));
+  EXPECT_FALSE(storage.HasEntity(100u));
+  EXPECT_EQ(1, *storage.at(4u));
+  EXPECT_EQ(2, *storage.at(std::string("7")));
+
+  // Removing an entity moves the last one into its slot and shifts the
+  // indices of the later siblings
+  EXPECT_TRUE(storage.RemoveEntity("4"));
+  EXPECT_FALSE(storage.RemoveEntity("4"));
+  EXPECT_FALSE(storage.HasEntity(4u));
+  EXPECT_THROW(storage.at(4u), std::out_of_range);
+  ASSERT_EQ(3u, storage.size());
+  EXPECT_EQ(3, *storage.at(10u));
+  EXPECT_EQ(0u, storage.IndexInContainer(1u));
+  EXPECT_EQ(1u, storage.IndexInContainer(7u));
+  EXPECT_EQ(2u, storage.IndexInContainer(10u));
+  EXPECT_EQ(0u, storage.ContainerOf(10u));
+  EXPECT_EQ(std::vector<std::size_t>({1, 7, 10}),
+            storage.indexInContainerToID.at(0));
+}
+
+TEST(BaseClass, EntityStorageSlotPages)
+{
+  using Storage = dartsim::EntityStorage<std::shared_ptr<int>, std::string>;
+  Storage storage;
+
+  // Only the pages of the stored IDs are allocated, however large the IDs
+  const std::size_t farID = 1000 * Storage::kSlotPageSize + 5u;
+  storage.Add(3u, "3", std::make_shared<int>(3));
+  storage.Add(farID, "far", std::make_shared<int>(4));
+  ASSERT_EQ(1001u, storage.idToSlot.size());
+  std::size_t pages = 0u;
+  for (const auto &page : storage.idToSlot)
+    pages += page ? 1u : 0u;
+  EXPECT_EQ(2u, pages);
+  EXPECT_FALSE(storage.HasEntity(farID - 1u));
+  EXPECT_EQ(4, *storage.at(farID));
+
+  // Pages are released with their last ID
+  EXPECT_TRUE(storage.RemoveEntity("far"));
+  EXPECT_EQ(1u, storage.idToSlot.size());
+  EXPECT_FALSE(storage.HasEntity(farID));
+  EXPECT_EQ(3, *storage.at(3u));
+  EXPECT_TRUE(storage.RemoveEntity("3"));
+  EXPECT_TRUE(storage.idToSlot.empty());
+}
+
 TEST(BaseClass, RemoveModel)
 {
   dartsim::Base base;
@@ -97,7 +158,7 @@ TEST(BaseClass, RemoveModel)
   EXPECT_EQ(5u, base.shapes.size());
 
   std::size_t testModelID = modelIDs["skel2"];
-  EXPECT_EQ(2u, base.models.idToIndexInContainer[testModelID]);
+  EXPECT_EQ(2u, base.models.IndexInContainer(testModelID));
 
   // Remove skel2
   base.RemoveModelImpl(worldID, testModelID);
@@ -115,7 +176,7 @@ TEST(BaseClass, RemoveModel)
   {
     for (const auto &[name, modelID] : modelIDs)
     {
-      auto modelIndex = base.models.idToIndexInContainer[modelID];
+      auto modelIndex = base.models.IndexInContainer(modelID);
       EXPECT_EQ(name, world->getSkeleton(modelIndex)->getName());
     }
   };
@@ -185,6 +246,49 @@ TEST(BaseClass, AddNestedModel)
   EXPECT_EQ(nestedModel2ID, parentModelInfo.nestedModels[1]);
 }
 
+TEST(BaseClass, DeferAddSkeletonGuard)
+{
+  dartsim::Base base;
+  base.InitiateEngine(0);
+
+  dart::simulation::WorldPtr world = dart::simulation::World::create("default");
+  base.AddWorld(world, world->getName());
+
+  auto skel1 = dart::dynamics::Skeleton::create("skel1");
+  auto skel2 = dart::dynamics::Skeleton::create("skel2");
+  {
+    dartsim::Base::DeferAddSkeletonGuard guard(base);
+    base.AddSkeleton(world, skel1);
+
+    // Nested guards leave the skeletons to the outermost one
+    {
+      dartsim::Base::DeferAddSkeletonGuard nestedGuard(base);
+      base.AddSkeleton(world, skel2);
+    }
+    EXPECT_TRUE(base.deferAddSkeleton);
+    EXPECT_EQ(0u, world->getNumSkeletons());
+  }
+  EXPECT_FALSE(base.deferAddSkeleton);
+  ASSERT_EQ(2u, world->getNumSkeletons());
+  EXPECT_EQ(skel1, world->getSkeleton(0));
+  EXPECT_EQ(skel2, world->getSkeleton(1));
+
+  // The held back skeletons are added when construction throws
+  auto skel3 = dart::dynamics::Skeleton::create("skel3");
+  try
+  {
+    dartsim::Base::DeferAddSkeletonGuard guard(base);
+    base.AddSkeleton(world, skel3);
+    throw std::runtime_error("construction failed");
+  }
+  catch (const std::runtime_error &)
+  {
+  }
+  EXPECT_FALSE(base.deferAddSkeleton);
+  EXPECT_EQ(3u, world->getNumSkeletons());
+  EXPECT_TRUE(base.deferredSkeletons.empty());
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
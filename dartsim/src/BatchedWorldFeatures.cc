@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "BatchedWorldFeatures.hh"
+
+namespace ignition {
+namespace physics {
+namespace dartsim {
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::GetBatchedWorldState(
+    const Identity &/*_engineID*/,
+    std::size_t _firstWorld, std::size_t _worldCount,
+    BatchMatrixType &_positions, BatchMatrixType &_velocities) const
+{
+  std::size_t dofs = 0u;
+  if (!this->CheckBatch(_firstWorld, _worldCount, dofs))
+    return false;
+
+  _positions.resize(_worldCount, dofs);
+  _velocities.resize(_worldCount, dofs);
+  this->ForEachBatchDof(_firstWorld, _worldCount,
+      [&](const DartSkeleton &_skeleton, std::size_t _dof,
+          Eigen::Index _row, Eigen::Index _col)
+      {
+        _positions(_row, _col) = _skeleton.getPosition(_dof);
+        _velocities(_row, _col) = _skeleton.getVelocity(_dof);
+      });
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::SetBatchedWorldState(
+    const Identity &/*_engineID*/,
+    std::size_t _firstWorld, std::size_t _worldCount,
+    const BatchMatrixType &_positions, const BatchMatrixType &_velocities)
+{
+  if (!this->CheckBatchMatrix(_firstWorld, _worldCount, _positions) ||
+      !this->CheckBatchMatrix(_firstWorld, _worldCount, _velocities))
+  {
+    return false;
+  }
+
+  this->ForEachBatchDof(_firstWorld, _worldCount,
+      [&](DartSkeleton &_skeleton, std::size_t _dof,
+          Eigen::Index _row, Eigen::Index _col)
+      {
+        _skeleton.setPosition(_dof, _positions(_row, _col));
+        _skeleton.setVelocity(_dof, _velocities(_row, _col));
+      });
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::GetBatchedWorldForces(
+    const Identity &/*_engineID*/,
+    std::size_t _firstWorld, std::size_t _worldCount,
+    BatchMatrixType &_forces) const
+{
+  std::size_t dofs = 0u;
+  if (!this->CheckBatch(_firstWorld, _worldCount, dofs))
+    return false;
+
+  _forces.resize(_worldCount, dofs);
+  this->ForEachBatchDof(_firstWorld, _worldCount,
+      [&](const DartSkeleton &_skeleton, std::size_t _dof,
+          Eigen::Index _row, Eigen::Index _col)
+      {
+        _forces(_row, _col) = _skeleton.getForce(_dof);
+      });
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::SetBatchedWorldForces(
+    const Identity &/*_engineID*/,
+    std::size_t _firstWorld, std::size_t _worldCount,
+    const BatchMatrixType &_forces)
+{
+  if (!this->CheckBatchMatrix(_firstWorld, _worldCount, _forces))
+    return false;
+
+  this->ForEachBatchDof(_firstWorld, _worldCount,
+      [&](DartSkeleton &_skeleton, std::size_t _dof,
+          Eigen::Index _row, Eigen::Index _col)
+      {
+        _skeleton.setForce(_dof, _forces(_row, _col));
+      });
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::CheckBatch(std::size_t _firstWorld,
+    std::size_t _worldCount, std::size_t &_dofs) const
+{
+  const std::vector<std::size_t> &worldIDs =
+      this->worlds.indexInContainerToID.at(0);
+  if (_firstWorld + _worldCount > worldIDs.size())
+  {
+    ignerr << "A batch of [" << _worldCount << "] worlds starting at index ["
+           << _firstWorld << "] was requested, but the engine only has ["
+           << worldIDs.size() << "] worlds." << std::endl;
+    return false;
+  }
+
+  _dofs = 0u;
+  for (std::size_t k = 0; k < _worldCount; ++k)
+  {
+    const auto &world = this->worlds.at(worldIDs[_firstWorld + k]);
+    std::size_t dofs = 0u;
+    for (std::size_t s = 0; s < world->getNumSkeletons(); ++s)
+      dofs += world->getSkeleton(s)->getNumDofs();
+
+    if (k == 0u)
+    {
+      _dofs = dofs;
+    }
+    else if (dofs != _dofs)
+    {
+      ignerr << "World [" << world->getName() << "] has [" << dofs
+             << "] degrees of freedom, but the first world of the batch has ["
+             << _dofs << "]." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::CheckBatchMatrix(std::size_t _firstWorld,
+    std::size_t _worldCount, const BatchMatrixType &_matrix) const
+{
+  std::size_t dofs = 0u;
+  if (!this->CheckBatch(_firstWorld, _worldCount, dofs))
+    return false;
+
+  if (static_cast<std::size_t>(_matrix.rows()) != _worldCount ||
+      static_cast<std::size_t>(_matrix.cols()) != dofs)
+  {
+    ignerr << "Expected a [" << _worldCount << " x " << dofs
+           << "] batch matrix, but got a [" << _matrix.rows() << " x "
+           << _matrix.cols() << "] matrix." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+template <typename FuncT>
+void BatchedWorldFeatures::ForEachBatchDof(std::size_t _firstWorld,
+    std::size_t _worldCount, FuncT _func) const
+{
+  const std::vector<std::size_t> &worldIDs =
+      this->worlds.indexInContainerToID.at(0);
+  for (std::size_t k = 0; k < _worldCount; ++k)
+  {
+    const auto &world = this->worlds.at(worldIDs[_firstWorld + k]);
+    Eigen::Index col = 0;
+    for (std::size_t s = 0; s < world->getNumSkeletons(); ++s)
+    {
+      DartSkeleton &skeleton = *world->getSkeleton(s);
+      for (std::size_t i = 0; i < skeleton.getNumDofs(); ++i, ++col)
+        _func(skeleton, i, static_cast<Eigen::Index>(k), col);
+    }
+  }
+}
+
+}
+}
+}
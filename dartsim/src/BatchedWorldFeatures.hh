@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_PHYSICS_DARTSIM_SRC_BATCHEDWORLDFEATURES_HH_
+#define IGNITION_PHYSICS_DARTSIM_SRC_BATCHEDWORLDFEATURES_HH_
+
+#include <ignition/physics/BatchedWorlds.hh>
+
+#include "Base.hh"
+
+namespace ignition {
+namespace physics {
+namespace dartsim {
+
+struct BatchedWorldFeatureList : FeatureList<
+  BatchedWorldStateFeature,
+  BatchedWorldForcesFeature
+> { };
+
+/// \brief The generalized coordinates of a world are the degrees of freedom
+/// of its skeletons, in the order that the skeletons were added to the
+/// world, and in the order of the degrees of freedom of each skeleton.
+class BatchedWorldFeatures :
+    public virtual Base,
+    public virtual Implements3d<BatchedWorldFeatureList>
+{
+  public: using BatchMatrixType = BatchMatrix<FeaturePolicy3d>;
+
+  // Documentation inherited
+  public: bool GetBatchedWorldState(
+      const Identity &_engineID,
+      std::size_t _firstWorld, std::size_t _worldCount,
+      BatchMatrixType &_positions,
+      BatchMatrixType &_velocities) const override;
+
+  // Documentation inherited
+  public: bool SetBatchedWorldState(
+      const Identity &_engineID,
+      std::size_t _firstWorld, std::size_t _worldCount,
+      const BatchMatrixType &_positions,
+      const BatchMatrixType &_velocities) override;
+
+  // Documentation inherited
+  public: bool GetBatchedWorldForces(
+      const Identity &_engineID,
+      std::size_t _firstWorld, std::size_t _worldCount,
+      BatchMatrixType &_forces) const override;
+
+  // Documentation inherited
+  public: bool SetBatchedWorldForces(
+      const Identity &_engineID,
+      std::size_t _firstWorld, std::size_t _worldCount,
+      const BatchMatrixType &_forces) override;
+
+  /// \brief Check that the worlds of a batch exist and have the same number
+  /// of degrees of freedom
+  /// \param[in] _firstWorld Index of the first world of the batch
+  /// \param[in] _worldCount Number of worlds in the batch
+  /// \param[out] _dofs Number of degrees of freedom of each world
+  /// \return True if the batch is valid
+  private: bool CheckBatch(std::size_t _firstWorld, std::size_t _worldCount,
+      std::size_t &_dofs) const;
+
+  /// \brief Check that a matrix has one row per world of a batch and one
+  /// column per degree of freedom
+  /// \param[in] _firstWorld Index of the first world of the batch
+  /// \param[in] _worldCount Number of worlds in the batch
+  /// \param[in] _matrix Matrix to check
+  /// \return True if the batch is valid and the matrix matches its size
+  private: bool CheckBatchMatrix(std::size_t _firstWorld,
+      std::size_t _worldCount, const BatchMatrixType &_matrix) const;
+
+  /// \brief Call a function for every degree of freedom of a batch
+  /// \param[in] _firstWorld Index of the first world of the batch
+  /// \param[in] _worldCount Number of worlds in the batch
+  /// \param[in] _func Function called with the skeleton, the index of the
+  /// degree of freedom in the skeleton, and the row and column of the degree
+  /// of freedom in the batch matrices
+  private: template <typename FuncT>
+  void ForEachBatchDof(std::size_t _firstWorld, std::size_t _worldCount,
+      FuncT _func) const;
+};
+
+}
+}
+}
+
+#endif
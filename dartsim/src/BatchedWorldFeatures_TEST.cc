@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/plugin/Loader.hh>
+
+#include <ignition/physics/BatchedWorlds.hh>
+#include <ignition/physics/ForwardStep.hh>
+#include <ignition/physics/GetEntities.hh>
+#include <ignition/physics/RequestEngine.hh>
+#include <ignition/physics/sdf/ConstructWorldReplicas.hh>
+
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
+
+#include "test/Utils.hh"
+
+struct TestFeatureList : ignition::physics::FeatureList<
+    ignition::physics::BatchedWorldStateFeature,
+    ignition::physics::BatchedWorldForcesFeature,
+    ignition::physics::ForwardStepWorlds,
+    ignition::physics::GetEntities,
+    ignition::physics::sdf::ConstructSdfWorldReplicas
+> { };
+
+using namespace ignition;
+
+using TestEnginePtr = physics::Engine3dPtr<TestFeatureList>;
+using BatchMatrix = physics::BatchMatrix<physics::FeaturePolicy3d>;
+
+//////////////////////////////////////////////////
+class BatchedWorldFeaturesFixture : public ::testing::Test
+{
+  protected: void SetUp() override
+  {
+    ignition::plugin::Loader loader;
+    loader.LoadLib(dartsim_plugin_LIB);
+
+    ignition::plugin::PluginPtr dartsim =
+        loader.Instantiate("ignition::physics::dartsim::Plugin");
+
+    this->engine =
+        ignition::physics::RequestEngine3d<TestFeatureList>::From(dartsim);
+    ASSERT_NE(nullptr, this->engine);
+  }
+  protected: TestEnginePtr engine;
+};
+
+//////////////////////////////////////////////////
+TEST_F(BatchedWorldFeaturesFixture, WorldReplicas)
+{
+  sdf::Root root;
+  const sdf::Errors errors = root.Load(TEST_WORLD_DIR "/falling.world");
+  ASSERT_TRUE(errors.empty());
+  const sdf::World *sdfWorld = root.WorldByIndex(0);
+
+  const std::size_t replicaCount = 3u;
+  auto replicas = this->engine->ConstructWorldReplicas(*sdfWorld, replicaCount);
+  ASSERT_EQ(replicaCount, replicas.size());
+  ASSERT_EQ(replicaCount, this->engine->GetWorldCount());
+  for (std::size_t i = 0; i < replicaCount; ++i)
+  {
+    ASSERT_NE(nullptr, replicas[i]);
+    EXPECT_EQ(sdfWorld->Name() + "_" + std::to_string(i),
+              replicas[i]->GetName());
+    EXPECT_EQ(replicas[i]->EntityID(),
+              this->engine->GetWorld(i)->EntityID());
+  }
+
+  // all the replicas start in the same state
+  BatchMatrix positions;
+  BatchMatrix velocities;
+  ASSERT_TRUE(this->engine->GetBatchedWorldState(
+      0, replicaCount, positions, velocities));
+  ASSERT_EQ(static_cast<Eigen::Index>(replicaCount), positions.rows());
+  ASSERT_LT(0, positions.cols());
+  EXPECT_EQ(positions.rows(), velocities.rows());
+  EXPECT_EQ(positions.cols(), velocities.cols());
+  for (std::size_t i = 1; i < replicaCount; ++i)
+  {
+    EXPECT_TRUE(positions.row(0).isApprox(positions.row(i)));
+    EXPECT_TRUE(velocities.row(0).isApprox(velocities.row(i)));
+  }
+
+  // the replicas stay in lockstep
+  std::vector<physics::ForwardStep::Output> outputs;
+  std::vector<physics::ForwardStep::State> states;
+  std::vector<physics::ForwardStep::Input> inputs;
+  for (std::size_t step = 0; step < 100; ++step)
+    this->engine->StepWorlds(outputs, states, inputs);
+
+  BatchMatrix newPositions;
+  BatchMatrix newVelocities;
+  ASSERT_TRUE(this->engine->GetBatchedWorldState(
+      0, replicaCount, newPositions, newVelocities));
+  EXPECT_FALSE(newPositions.isApprox(positions));
+  for (std::size_t i = 1; i < replicaCount; ++i)
+  {
+    EXPECT_TRUE(newPositions.row(0).isApprox(newPositions.row(i)));
+    EXPECT_TRUE(newVelocities.row(0).isApprox(newVelocities.row(i)));
+  }
+
+  // reset the state of a single replica
+  ASSERT_TRUE(this->engine->SetBatchedWorldState(
+      1, 1, positions.topRows(1), velocities.topRows(1)));
+  ASSERT_TRUE(this->engine->GetBatchedWorldState(
+      0, replicaCount, newPositions, newVelocities));
+  EXPECT_TRUE(newPositions.row(1).isApprox(positions.row(1)));
+  EXPECT_TRUE(newVelocities.row(1).isApprox(velocities.row(1)));
+  EXPECT_FALSE(newPositions.row(0).isApprox(positions.row(0)));
+
+  // forces of the whole batch
+  BatchMatrix forces = BatchMatrix::Constant(
+      positions.rows(), positions.cols(), 0.5);
+  ASSERT_TRUE(this->engine->SetBatchedWorldForces(0, replicaCount, forces));
+  BatchMatrix newForces;
+  ASSERT_TRUE(this->engine->GetBatchedWorldForces(
+      0, replicaCount, newForces));
+  EXPECT_TRUE(newForces.isApprox(forces));
+
+  // matrices that don't match the batch and batches that don't exist
+  EXPECT_FALSE(this->engine->SetBatchedWorldForces(
+      0, replicaCount, forces.leftCols(1)));
+  EXPECT_FALSE(this->engine->SetBatchedWorldForces(1, replicaCount, forces));
+  EXPECT_FALSE(this->engine->GetBatchedWorldState(
+      replicaCount, 1, positions, velocities));
+}
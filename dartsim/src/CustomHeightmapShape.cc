@@ -17,15 +17,77 @@
 
 #include "CustomHeightmapShape.hh"
 
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
-#include <ignition/common/Console.hh>
+#include <ignition/common/Dem.hh>
 #include <ignition/common/ImageHeightmap.hh>
 #include <ignition/math/eigen3/Conversions.hh>
+#include <ignition/physics/mesh/WeakValueCache.hh>
 
 namespace ignition {
 namespace physics {
 namespace dartsim {
 
+namespace {
+/////////////////////////////////////////////////
+/// \brief Identifies a height field sampled from a heightmap. The pointer
+/// identifies the heightmap while it is alive, and the file name and
+/// dimensions guard against another heightmap being created at the address
+/// of a destroyed one.
+struct HeightmapKey
+{
+  const common::HeightmapData *data;
+  std::string filename;
+  std::array<double, 4> dimensions;
+  std::array<double, 3> size;
+  int subSampling;
+
+  bool operator==(const HeightmapKey &_other) const
+  {
+    return this->data == _other.data &&
+        this->subSampling == _other.subSampling &&
+        this->size == _other.size && this->dimensions == _other.dimensions &&
+        this->filename == _other.filename;
+  }
+};
+
+/////////////////////////////////////////////////
+struct HeightmapKeyHash
+{
+  std::size_t operator()(const HeightmapKey &_key) const
+  {
+    std::size_t hash = std::hash<const void *>()(_key.data);
+    for (const double s : _key.size)
+      hash = mesh::HashCombine(hash, s);
+    return mesh::HashCombine(hash, _key.subSampling);
+  }
+};
+
+/////////////////////////////////////////////////
+using HeightmapCache =
+    mesh::WeakValueCache<HeightmapKey, CustomHeightmapShape, HeightmapKeyHash>;
+
+/////////////////////////////////////////////////
+HeightmapCache &GetHeightmapCache()
+{
+  static HeightmapCache cache;
+  return cache;
+}
+
+/////////////////////////////////////////////////
+std::string HeightmapFilename(const common::HeightmapData &_input)
+{
+  if (const auto *image = dynamic_cast<const common::ImageHeightmap *>(&_input))
+    return image->Filename();
+  if (const auto *dem = dynamic_cast<const common::Dem *>(&_input))
+    return dem->Filename();
+  return "";
+}
+}
+
 /////////////////////////////////////////////////
 CustomHeightmapShape::CustomHeightmapShape(
     const common::HeightmapData &_input,
@@ -47,27 +109,35 @@ CustomHeightmapShape::CustomHeightmapShape(
 
   auto sizeIgn = ignition::math::eigen3::convert(_size);
 
-  // We need to make a copy here in order to use the non-const FillHeightMap
-  // function
-  common::ImageHeightmap copyData;
-  try
-  {
-    const auto &image = dynamic_cast<const common::ImageHeightmap &>(_input);
-    copyData.Load(image.Filename());
-  }
-  catch(const std::bad_cast &)
-  {
-    ignerr << "Only image heightmaps are supported at the moment." << std::endl;
-    return;
-  }
-
+  // FillHeightMap is not const in ignition-common, but image heightmaps and
+  // DEMs only read their decoded data in it, so the heights are sampled from
+  // the input directly instead of from a copy that decodes the file again.
   std::vector<float> heightsFloat;
-  copyData.FillHeightMap(_subSampling, vertSize, sizeIgn, scale, flipY,
-      heightsFloat);
+  const_cast<common::HeightmapData &>(_input).FillHeightMap(
+      _subSampling, vertSize, sizeIgn, scale, flipY, heightsFloat);
 
   this->setHeightField(vertSize, vertSize, heightsFloat);
   this->setScale(Vector3(scale.X(), scale.Y(), 1));
 }
+
+/////////////////////////////////////////////////
+std::shared_ptr<CustomHeightmapShape> CustomHeightmapShape::Get(
+    const common::HeightmapData &_input,
+    const Eigen::Vector3d &_size,
+    const int _subSampling)
+{
+  HeightmapKey key{&_input, HeightmapFilename(_input),
+      {static_cast<double>(_input.Width()),
+       static_cast<double>(_input.Height()),
+       static_cast<double>(_input.MinElevation()),
+       static_cast<double>(_input.MaxElevation())},
+      {_size.x(), _size.y(), _size.z()}, _subSampling};
+
+  return GetHeightmapCache().Get(key, [&]()
+  {
+    return new CustomHeightmapShape(_input, _size, _subSampling);
+  });
+}
 }
 }
 }
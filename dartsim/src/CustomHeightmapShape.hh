@@ -18,6 +18,8 @@
 #ifndef IGNITION_PHYSICS_DARTSIM_SRC_CUSTOMHEIGHTMAPSHAPE_HH_
 #define IGNITION_PHYSICS_DARTSIM_SRC_CUSTOMHEIGHTMAPSHAPE_HH_
 
+#include <memory>
+
 #include <dart/dynamics/HeightmapShape.hpp>
 #include <ignition/common/HeightmapData.hh>
 
@@ -40,6 +42,20 @@ class CustomHeightmapShape : public dart::dynamics::HeightmapShape<float>
       const common::HeightmapData &_input,
       const Eigen::Vector3d &_size,
       const int _subSampling);
+
+  /// \brief Get the shape of a heightmap. While a shape is in use, every
+  /// request for the same heightmap, size and sub-sampling gets that same
+  /// shape, so the height field is sampled and stored only once. The cache
+  /// only holds a weak pointer, so the shape is freed and evicted once its
+  /// last shape node is gone.
+  /// \param[in] _input Holds heightmap data.
+  /// \param[in] _size Heightmap size in meters.
+  /// \param[in] _subSampling How much to subsample.
+  /// \return The shape of the heightmap
+  public: static std::shared_ptr<CustomHeightmapShape> Get(
+      const common::HeightmapData &_input,
+      const Eigen::Vector3d &_size,
+      const int _subSampling);
 };
 }
 }
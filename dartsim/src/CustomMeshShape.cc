@@ -17,11 +17,16 @@
 
 #include "CustomMeshShape.hh"
 
+#include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/SubMesh.hh>
+#include <ignition/math/eigen3/Conversions.hh>
+#include <ignition/physics/mesh/MeshKey.hh>
+#include <ignition/physics/mesh/WeakValueCache.hh>
 
 namespace ignition {
 namespace physics {
@@ -93,6 +98,96 @@ unsigned int GetPrimitiveType(
 
   return 0;
 }
+
+/////////////////////////////////////////////////
+using MeshCache = mesh::WeakValueCache<
+    mesh::MeshKey, CustomMeshShape, mesh::MeshKeyHash>;
+
+/////////////////////////////////////////////////
+using ConvexMeshCache = mesh::WeakValueCache<
+    mesh::ConvexMeshKey, CustomMeshShape, mesh::ConvexMeshKeyHash>;
+
+/////////////////////////////////////////////////
+MeshCache &GetMeshCache()
+{
+  static MeshCache cache;
+  return cache;
+}
+
+/////////////////////////////////////////////////
+ConvexMeshCache &GetConvexMeshCache()
+{
+  static ConvexMeshCache cache;
+  return cache;
+}
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<CustomMeshShape> CustomMeshShape::Get(
+    const ignition::common::Mesh &_input,
+    const Eigen::Vector3d &_scale)
+{
+  return GetMeshCache().Get(mesh::MeshKey(_input, _scale), [&]()
+  {
+    return new CustomMeshShape(_input, _scale);
+  });
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<CustomMeshShape> CustomMeshShape::GetConvex(
+    const ignition::common::Mesh &_input,
+    const Eigen::Vector3d &_scale,
+    const mesh::ConvexDecompositionOptions &_options)
+{
+  return GetConvexMeshCache().Get(
+      mesh::ConvexMeshKey(_input, _scale, _options), [&]()
+  {
+    const std::vector<mesh::ConvexHull> hulls =
+        mesh::ComputeConvexDecomposition(_input, _options);
+    if (hulls.empty())
+    {
+      ignwarn << "[dartsim::CustomMeshShape] The mesh [" << _input.Path()
+              << "] has no volume, so it has no convex hull. It will collide "
+              << "as triangles.\n";
+      return new CustomMeshShape(_input, _scale);
+    }
+
+    // Each hull becomes a submesh of one mesh, so that the hulls are the
+    // parts of a single shape
+    ignition::common::Mesh hullMesh;
+    hullMesh.SetName(_input.Name());
+    hullMesh.SetPath(_input.Path());
+    for (const mesh::ConvexHull &hull : hulls)
+    {
+      Eigen::Vector3d center = Eigen::Vector3d::Zero();
+      for (const Eigen::Vector3d &vertex : hull.vertices)
+        center += vertex;
+      center /= static_cast<double>(hull.vertices.size());
+
+      ignition::common::SubMesh subMesh;
+      subMesh.SetPrimitiveType(ignition::common::SubMesh::TRIANGLES);
+      for (const Eigen::Vector3d &vertex : hull.vertices)
+      {
+        subMesh.AddVertex(math::eigen3::convert(vertex));
+        subMesh.AddNormal(math::eigen3::convert(
+            Eigen::Vector3d((vertex - center).normalized())));
+      }
+      for (const std::array<unsigned int, 3> &face : hull.faces)
+      {
+        for (const unsigned int index : face)
+          subMesh.AddIndex(index);
+      }
+      hullMesh.AddSubMesh(subMesh);
+    }
+
+    return new CustomMeshShape(hullMesh, _scale);
+  });
+}
+
+/////////////////////////////////////////////////
+std::size_t CustomMeshShape::CacheSize()
+{
+  return GetMeshCache().Size() + GetConvexMeshCache().Size();
 }
 
 /////////////////////////////////////////////////
@@ -18,8 +18,11 @@
 #ifndef IGNITION_PHYSICS_DARTSIM_SRC_CUSTOMMESHSHAPE_HH_
 #define IGNITION_PHYSICS_DARTSIM_SRC_CUSTOMMESHSHAPE_HH_
 
+#include <memory>
+
 #include <dart/dynamics/MeshShape.hpp>
 #include <ignition/common/Mesh.hh>
+#include <ignition/physics/mesh/ConvexDecomposition.hh>
 
 namespace ignition {
 namespace physics {
@@ -33,6 +36,35 @@ class CustomMeshShape : public dart::dynamics::MeshShape
   public: CustomMeshShape(
       const ignition::common::Mesh &_input,
       const Eigen::Vector3d &_scale);
+
+  /// \brief Get the shape of a mesh with a scale. While a shape is in use,
+  /// every request for the same mesh and scale gets that same shape, so a mesh
+  /// that is instanced many times is converted and stored only once. Shape
+  /// nodes share the shape through its shared pointer, and the cache only
+  /// holds a weak pointer, so the shape is freed and evicted from the cache
+  /// once its last shape node is gone.
+  /// \param[in] _input The mesh
+  /// \param[in] _scale The scale of the mesh
+  /// \return The shape of the mesh
+  public: static std::shared_ptr<CustomMeshShape> Get(
+      const ignition::common::Mesh &_input,
+      const Eigen::Vector3d &_scale);
+
+  /// \brief Get the shape of a mesh that collides as its convex hull or as
+  /// an approximate convex decomposition. The hulls are the submeshes of the
+  /// shape. Shapes are shared like the shapes of Get.
+  /// \param[in] _input The mesh
+  /// \param[in] _scale The scale of the mesh
+  /// \param[in] _options Options of the convex decomposition
+  /// \return The shape of the convex hulls of the mesh, or the shape of its
+  /// triangles if it has no volume
+  public: static std::shared_ptr<CustomMeshShape> GetConvex(
+      const ignition::common::Mesh &_input,
+      const Eigen::Vector3d &_scale,
+      const mesh::ConvexDecompositionOptions &_options);
+
+  /// \brief Number of shapes in the cache of Get and GetConvex
+  public: static std::size_t CacheSize();
 };
 
 }
@@ -20,6 +20,8 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <dart/config.hpp>
 #include <dart/collision/ode/OdeCollisionDetector.hpp>
@@ -94,6 +96,30 @@ class BitmaskContactFilter : public dart::collision::BodyNodeCollisionFilter
     }
   }
 
+  /// \brief Remove the collisions of many skeletons in one pass over the
+  /// bitmasks, e.g. after a batch of models is removed.
+  public: void RemoveSkeletonsCollisions(
+      const std::vector<dart::dynamics::SkeletonPtr> &_skelPtrs)
+  {
+    if (this->bitmaskMap.empty())
+      return;
+
+    std::unordered_set<DartShapeConstPtr> shapes;
+    for (const auto &skelPtr : _skelPtrs)
+    {
+      for (std::size_t i = 0; i < skelPtr->getNumShapeNodes(); ++i)
+        shapes.insert(skelPtr->getShapeNode(i));
+    }
+
+    for (auto it = this->bitmaskMap.begin(); it != this->bitmaskMap.end();)
+    {
+      if (shapes.count(it->first) > 0u)
+        it = this->bitmaskMap.erase(it);
+      else
+        ++it;
+    }
+  }
+
   public: virtual ~BitmaskContactFilter() = default;
 };
 
@@ -123,7 +149,7 @@ static std::size_t GetWorldOfShapeNode(const EntityManagementFeatures *_emf,
   // Get the body node's skeleton
   const auto skelPtr = bn->getSkeleton();
   // Now find the skeleton's model
-  const std::size_t modelID = _emf->models.objectToID.at(skelPtr);
+  const std::size_t modelID = _emf->models.IdentityOf(skelPtr);
   // And the world containing the model
   return _emf->GetWorldOfModelImpl(modelID);
 }
@@ -158,7 +184,7 @@ Identity EntityManagementFeatures::GetWorld(
 {
   const std::size_t id =
       this->worlds.indexInContainerToID.begin()->second[_worldIndex];
-  return this->GenerateIdentity(id, this->worlds.idToObject.at(id));
+  return this->GenerateIdentity(id, this->worlds.at(id));
 }
 
 /////////////////////////////////////////////////
@@ -166,7 +192,7 @@ Identity EntityManagementFeatures::GetWorld(
     const Identity &, const std::string &_worldName) const
 {
   const std::size_t id = this->worlds.IdentityOf(_worldName);
-  return this->GenerateIdentity(id, this->worlds.idToObject.at(id));
+  return this->GenerateIdentity(id, this->worlds.at(id));
 }
 
 /////////////////////////////////////////////////
@@ -181,7 +207,7 @@ std::size_t EntityManagementFeatures::GetWorldIndex(
     const Identity &_worldID) const
 {
   // TODO(anyone) this will throw if the world has been removed
-  return this->worlds.idToIndexInContainer.at(_worldID);
+  return this->worlds.IndexInContainer(_worldID);
 }
 
 /////////////////////////////////////////////////
@@ -261,7 +287,7 @@ std::size_t EntityManagementFeatures::GetModelIndex(
   // TODO(anyone) this will throw if the model has been removed. The alternative
   // is to first check if the model exists, but what should we return if it
   // doesn't exist
-  return this->models.idToIndexInContainer.at(_modelID);
+  return this->models.IndexInContainer(_modelID);
 }
 
 /////////////////////////////////////////////////
@@ -468,14 +494,14 @@ const std::string &EntityManagementFeatures::GetLinkName(
 std::size_t EntityManagementFeatures::GetLinkIndex(
     const Identity &_linkID) const
 {
-  return this->links.idToIndexInContainer.at(_linkID);
+  return this->links.IndexInContainer(_linkID);
 }
 
 /////////////////////////////////////////////////
 Identity EntityManagementFeatures::GetModelOfLink(
     const Identity &_linkID) const
 {
-  const std::size_t modelID = this->links.idToContainerID.at(_linkID);
+  const std::size_t modelID = this->links.ContainerOf(_linkID);
 
   // If the model containing the link doesn't exist in "models", it means this
   // link belongs to a removed model.
@@ -672,6 +698,34 @@ bool EntityManagementFeatures::ModelRemoved(const Identity &_modelID) const
   return !this->models.HasEntity(_modelID);
 }
 
+/////////////////////////////////////////////////
+std::size_t EntityManagementFeatures::RemoveModelsByName(
+    const Identity &_worldID, const std::vector<std::string> &_modelNames)
+{
+  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
+
+  // The indices of the remaining models of the world are recomputed, and the
+  // collision filter is updated, once for the whole batch instead of once per
+  // removed model. The removed skeletons are held until then, so that their
+  // shape nodes stay valid.
+  std::vector<DartSkeletonPtr> removed;
+  removed.reserve(_modelNames.size());
+  std::size_t count = 0u;
+  for (const std::string &modelName : _modelNames)
+  {
+    const DartSkeletonPtr model = world->getSkeleton(modelName);
+    if (model == nullptr || !this->models.HasEntity(model))
+      continue;
+
+    removed.push_back(model);
+    if (this->RemoveModelImpl(_worldID, this->models.IdentityOf(model), false))
+      ++count;
+  }
+  this->models.RebuildContainer(_worldID);
+  GetFilterPtr(this, _worldID)->RemoveSkeletonsCollisions(removed);
+  return count;
+}
+
 /////////////////////////////////////////////////
 bool EntityManagementFeatures::RemoveNestedModelByIndex(
     const Identity &_modelID, std::size_t _nestedModelIndex)
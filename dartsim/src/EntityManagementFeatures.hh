@@ -19,6 +19,7 @@
 #define IGNITION_PHYSICS_DARTSIM_SRC_GETENTITIESFEATURE_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/physics/ConstructEmpty.hh>
 #include <ignition/physics/Shape.hh>
@@ -35,6 +36,7 @@ namespace dartsim {
 struct EntityManagementFeatureList : FeatureList<
   GetEntities,
   RemoveEntities,
+  RemoveModelsFromWorld,
   ConstructEmptyWorldFeature,
   ConstructEmptyModelFeature,
   ConstructEmptyNestedModelFeature,
@@ -147,6 +149,10 @@ class EntityManagementFeatures :
 
   public: bool ModelRemoved(const Identity &_modelID) const override;
 
+  public: std::size_t RemoveModelsByName(
+      const Identity &_worldID,
+      const std::vector<std::string> &_modelNames) override;
+
   public: bool RemoveNestedModelByIndex(
      const Identity &_modelID, std::size_t _modelIndex) override;
 
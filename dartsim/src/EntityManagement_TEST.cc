@@ -17,6 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <string>
+
+#include <dart/dynamics/FreeJoint.hpp>
+
 #include <ignition/plugin/Loader.hh>
 
 #include <ignition/common/ImageHeightmap.hh>
@@ -29,12 +34,15 @@
 #include <ignition/physics/RequestEngine.hh>
 #include <ignition/physics/RevoluteJoint.hh>
 
+#include "CustomFeatures.hh"
 #include "EntityManagementFeatures.hh"
 #include "JointFeatures.hh"
 #include "KinematicsFeatures.hh"
 #include "ShapeFeatures.hh"
+#include "SimulationFeatures.hh"
 
 struct TestFeatureList : ignition::physics::FeatureList<
+    ignition::physics::dartsim::CustomFeatureList,
     ignition::physics::dartsim::EntityManagementFeatureList,
     ignition::physics::dartsim::JointFeatureList,
     ignition::physics::dartsim::KinematicsFeatureList,
@@ -205,6 +213,58 @@ TEST(EntityManagement_TEST, ConstructEmptyWorld)
   EXPECT_NEAR(meshShapeScaledSize[1], 0.3831, 1e-4);
   EXPECT_NEAR(meshShapeScaledSize[2], 0.0489, 1e-4);
 
+  // Instances of a mesh with the same scale share one converted shape
+  auto meshShapeCopy = meshLink->AttachMeshShape("chassis_copy", *mesh);
+  ASSERT_NE(nullptr, meshShapeCopy);
+  auto dartWorld = world->GetDartsimWorld();
+  ASSERT_NE(nullptr, dartWorld);
+  auto findShape = [&](const std::string &_name)
+  {
+    dart::dynamics::ShapePtr shape;
+    for (std::size_t i = 0; i < dartWorld->getNumSkeletons(); ++i)
+    {
+      const auto skeleton = dartWorld->getSkeleton(i);
+      for (std::size_t j = 0; j < skeleton->getNumShapeNodes(); ++j)
+      {
+        const auto *shapeNode = skeleton->getShapeNode(j);
+        if (shapeNode->getName() == _name)
+          shape = shapeNode->getShape();
+      }
+    }
+    return shape;
+  };
+  ASSERT_NE(nullptr, findShape("mesh_link:chassis"));
+  EXPECT_EQ(findShape("mesh_link:chassis"),
+            findShape("mesh_link:chassis_copy"));
+  EXPECT_NE(findShape("mesh_link:chassis"),
+            findShape("mesh_link:small_chassis"));
+
+  // The convex hull of a mesh has the same bounding box as the mesh
+  auto meshShapeHull = meshLink->AttachConvexMeshShape("chassis_hull", *mesh);
+  ASSERT_NE(nullptr, meshShapeHull);
+  for (std::size_t i = 0; i < 3; ++i)
+    EXPECT_NEAR(originalMeshSize[i], meshShapeHull->GetSize()[i], 1e-6);
+  EXPECT_NE(nullptr, meshLink->GetShape("chassis_hull")->CastToMeshShape());
+  EXPECT_NE(findShape("mesh_link:chassis"),
+            findShape("mesh_link:chassis_hull"));
+
+  // So does its decomposition, which is cached on disk
+  ignition::physics::mesh::ConvexDecompositionOptions decomposition;
+  decomposition.maxConvexHulls = 8u;
+  const std::string tempDir = ignition::common::createTempDirectory(
+      "hull_cache", ignition::common::tempDirectoryPath());
+  ASSERT_FALSE(tempDir.empty());
+  decomposition.cacheDirectory =
+      ignition::common::joinPaths(tempDir, "hull_cache");
+  auto meshShapeParts = meshLink->AttachConvexMeshShape("chassis_parts",
+      *mesh, Eigen::Isometry3d::Identity(), Eigen::Vector3d::Ones(),
+      decomposition);
+  ASSERT_NE(nullptr, meshShapeParts);
+  for (std::size_t i = 0; i < 3; ++i)
+    EXPECT_NEAR(originalMeshSize[i], meshShapeParts->GetSize()[i], 1e-6);
+  EXPECT_TRUE(ignition::common::isDirectory(decomposition.cacheDirectory));
+  ignition::common::removeAll(tempDir);
+
   auto heightmapLink = model->ConstructEmptyLink("heightmap_link");
   heightmapLink->AttachFixedJoint(child, "heightmap_joint");
 
@@ -230,6 +290,16 @@ TEST(EntityManagement_TEST, ConstructEmptyWorld)
   EXPECT_NEAR(size.X(), heightmapShapeRecast->GetSize()[0], 1e-6);
   EXPECT_NEAR(size.Y(), heightmapShapeRecast->GetSize()[1], 1e-6);
   EXPECT_NEAR(size.Z(), heightmapShapeRecast->GetSize()[2], 1e-6);
+
+  // Instances of a heightmap with the same size share one height field
+  auto heightmapShapeCopy = heightmapLink->AttachHeightmapShape(
+      "heightmap_copy", data, ignition::math::eigen3::convert(pose),
+      ignition::math::eigen3::convert(size));
+  ASSERT_NE(nullptr, heightmapShapeCopy);
+  EXPECT_NEAR(size.Z(), heightmapShapeCopy->GetSize()[2], 1e-6);
+  ASSERT_NE(nullptr, findShape("heightmap_link:heightmap"));
+  EXPECT_EQ(findShape("heightmap_link:heightmap"),
+            findShape("heightmap_link:heightmap_copy"));
 }
 
 TEST(EntityManagement_TEST, RemoveEntities)
@@ -341,6 +411,120 @@ TEST(EntityManagement_TEST, ModelByIndexWithNestedModels)
   EXPECT_EQ(2ul, model2Again->GetIndex());
 }
 
+struct TiledHeightmapFeatureList : ignition::physics::FeatureList<
+    TestFeatureList,
+    ignition::physics::dartsim::SimulationFeatureList
+> { };
+
+TEST(EntityManagement_TEST, TiledHeightmap)
+{
+  ignition::plugin::Loader loader;
+  loader.LoadLib(dartsim_plugin_LIB);
+
+  ignition::plugin::PluginPtr dartsim =
+      loader.Instantiate("ignition::physics::dartsim::Plugin");
+
+  auto engine = ignition::physics::RequestEngine3d<
+      TiledHeightmapFeatureList>::From(dartsim);
+  ASSERT_NE(nullptr, engine);
+
+  auto world = engine->ConstructEmptyWorld("empty world");
+  ASSERT_NE(nullptr, world);
+  auto dartWorld = world->GetDartsimWorld();
+  ASSERT_NE(nullptr, dartWorld);
+
+  // A flat terrain of 9x5 samples, 2 m apart, split into 4x2 tiles of 3x3
+  // samples that span 4x4 m
+  ignition::physics::heightmap::HeightmapTiling tiling;
+  tiling.samplesX = 9;
+  tiling.samplesY = 5;
+  tiling.sampleSpacing = 2.0;
+  tiling.tileSamples = 3;
+  tiling.maxResidentTiles = 3;
+  tiling.pagingRadius = 0.5;
+
+  const std::string tempDir = ignition::common::createTempDirectory(
+      "tiled_heightmap", ignition::common::tempDirectoryPath());
+  ASSERT_FALSE(tempDir.empty());
+  const std::string heightFile =
+      ignition::common::joinPaths(tempDir, "tiled_heightmap.bin");
+  {
+    std::ofstream file(heightFile, std::ios::binary);
+    const float height = 0.0f;
+    for (std::size_t i = 0; i < tiling.samplesX * tiling.samplesY; ++i)
+      file.write(reinterpret_cast<const char *>(&height), sizeof(height));
+  }
+
+  auto terrain = world->ConstructEmptyModel("terrain");
+  auto terrainLink = terrain->ConstructEmptyLink("terrain_link");
+  dartWorld->getSkeleton("terrain")->setMobile(false);
+
+  auto ball = world->ConstructEmptyModel("ball");
+  auto ballLink = ball->ConstructEmptyLink("ball_link");
+  ballLink->AttachSphereShape("sphere", 0.1);
+  auto ballJoint = dartWorld->getSkeleton("ball")->getJoint(0);
+  auto moveBall = [&](double _x, double _y)
+  {
+    ballJoint->setPositions(dart::dynamics::FreeJoint::convertToPositions(
+        Eigen::Isometry3d(Eigen::Translation3d(_x, _y, 1.0))));
+    ballJoint->setVelocities(Eigen::Vector6d::Zero());
+  };
+
+  tiling.samplesY = 6;
+  EXPECT_EQ(nullptr, terrainLink->AttachTiledHeightmapShape(
+      "ground", heightFile, tiling, Eigen::Isometry3d::Identity()));
+  tiling.samplesY = 5;
+  auto ground = terrainLink->AttachTiledHeightmapShape(
+      "ground", heightFile, tiling, Eigen::Isometry3d::Identity());
+  ASSERT_NE(nullptr, ground);
+  EXPECT_EQ("ground", ground->GetName());
+  EXPECT_NEAR(16.0, ground->GetSize()[0], 1e-6);
+  EXPECT_NEAR(8.0, ground->GetSize()[1], 1e-6);
+
+  // Only the shape of the whole terrain exists before the world steps
+  EXPECT_EQ(1u, terrainLink->GetShapeCount());
+
+  ignition::physics::ForwardStep::Output output;
+  ignition::physics::ForwardStep::State state;
+  ignition::physics::ForwardStep::Input input;
+
+  // The terrain spans [-8, 8] x [-4, 4] m, and tile 0_0 its lowest corner
+  moveBall(-7.0, -3.0);
+  world->Step(output, state, input);
+  EXPECT_EQ(2u, terrainLink->GetShapeCount());
+  auto tile = terrainLink->GetShape("ground_0_0");
+  ASSERT_NE(nullptr, tile);
+  auto heightmapTile = tile->CastToHeightmapShape();
+  ASSERT_NE(nullptr, heightmapTile);
+  EXPECT_NEAR(4.0, heightmapTile->GetSize()[0], 1e-6);
+  EXPECT_NEAR(4.0, heightmapTile->GetSize()[1], 1e-6);
+  EXPECT_NEAR(-6.0, tile->GetRelativeTransform().translation().x(), 1e-6);
+  EXPECT_NEAR(-2.0, tile->GetRelativeTransform().translation().y(), 1e-6);
+
+  moveBall(7.0, 3.0);
+  world->Step(output, state, input);
+  moveBall(-7.0, 3.0);
+  world->Step(output, state, input);
+  EXPECT_EQ(4u, terrainLink->GetShapeCount());
+  EXPECT_NE(nullptr, terrainLink->GetShape("ground_0_0"));
+  EXPECT_NE(nullptr, terrainLink->GetShape("ground_3_1"));
+  EXPECT_NE(nullptr, terrainLink->GetShape("ground_0_1"));
+
+  // A fourth tile evicts the least recently needed one
+  moveBall(1.0, -3.0);
+  world->Step(output, state, input);
+  EXPECT_EQ(4u, terrainLink->GetShapeCount());
+  EXPECT_EQ(nullptr, terrainLink->GetShape("ground_0_0"));
+  EXPECT_NE(nullptr, terrainLink->GetShape("ground_2_0"));
+
+  // Removing the terrain drops its tiles
+  EXPECT_TRUE(terrain->Remove());
+  world->Step(output, state, input);
+  EXPECT_EQ(1u, world->GetModelCount());
+
+  ignition::common::removeAll(tempDir);
+}
+
 
 int main(int argc, char *argv[])
 {
@@ -113,10 +113,10 @@ Identity FreeGroupFeatures::GetFreeGroupRootLink(const Identity &_groupID) const
 FreeGroupFeatures::FreeGroupInfo FreeGroupFeatures::GetCanonicalInfo(
     const Identity &_groupID) const
 {
-  const auto model_it = this->models.idToObject.find(_groupID);
-  if (model_it != this->models.idToObject.end())
+  const auto *modelEntry = this->models.Find(_groupID);
+  if (modelEntry)
   {
-    const auto &modelInfo = model_it->second;
+    const auto &modelInfo = modelEntry->object;
     if (modelInfo->model->getNumBodyNodes() > 0)
     {
       return FreeGroupInfo{
@@ -432,6 +432,7 @@ void JointFeatures::DetachJoint(const Identity &_jointId)
   // TODO(addisu) Remove incrementVersion once DART has been updated to
   // internally increment the BodyNode's version after moveTo.
   child->incrementVersion();
+  ++this->links.version;
 }
 
 /////////////////////////////////////////////////
@@ -672,6 +673,57 @@ Wrench3d JointFeatures::GetJointTransmittedWrenchInJointFrame(
   wrenchOut.force = transmittedWrenchInJoint.tail<3>();
   return wrenchOut;
 }
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointStates(
+    const Identity &_modelID,
+    Eigen::VectorXd &_positions,
+    Eigen::VectorXd &_velocities) const
+{
+  // The joints of a model are the joints of its skeleton, and the degrees of
+  // freedom of a skeleton are ordered by joint
+  const auto &skeleton = this->ReferenceInterface<ModelInfo>(_modelID)->model;
+  _positions = skeleton->getPositions();
+  _velocities = skeleton->getVelocities();
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointForces(
+    const Identity &_modelID, const Eigen::VectorXd &_forces)
+{
+  const auto &skeleton = this->ReferenceInterface<ModelInfo>(_modelID)->model;
+  if (static_cast<std::size_t>(_forces.size()) != skeleton->getNumDofs())
+  {
+    ignerr << "Invalid number of joint forces [" << _forces.size()
+           << "] set on model [" << skeleton->getName() << "], which has ["
+           << skeleton->getNumDofs() << "] degrees of freedom. The forces "
+           << "will be ignored\n";
+    return;
+  }
+
+  // Take extra care that the values are finite. A nan can cause the DART
+  // constraint solver to fail, which will in turn either cause a crash or
+  // collisions to fail
+  if (!_forces.allFinite())
+  {
+    ignerr << "Invalid joint force values set on model ["
+           << skeleton->getName() << "]. The values will be ignored\n";
+    return;
+  }
+
+  // Like SetJointForce, the forces are commands of force actuators, so that
+  // the effort limits of the joints still apply
+  for (std::size_t i = 0; i < skeleton->getNumJoints(); ++i)
+  {
+    DartJoint *joint = skeleton->getJoint(i);
+    if (joint->getNumDofs() > 0u &&
+        joint->getActuatorType() != dart::dynamics::Joint::FORCE)
+    {
+      joint->setActuatorType(dart::dynamics::Joint::FORCE);
+    }
+  }
+  skeleton->setCommands(_forces);
+}
 }
 }
 }
@@ -56,7 +56,10 @@ struct JointFeatureList : FeatureList<
   SetJointPositionLimitsFeature,
   SetJointVelocityLimitsFeature,
   SetJointEffortLimitsFeature,
-  GetJointTransmittedWrench
+  GetJointTransmittedWrench,
+
+  GetModelJointStates,
+  SetModelJointForces
 > { };
 
 class JointFeatures :
@@ -203,6 +206,15 @@ class JointFeatures :
   // ----- Transmitted wrench -----
   public: Wrench3d GetJointTransmittedWrenchInJointFrame(
       const Identity &_id) const override;
+
+  // ----- Model joint states -----
+  public: void GetModelJointStates(
+      const Identity &_modelID,
+      Eigen::VectorXd &_positions,
+      Eigen::VectorXd &_velocities) const override;
+
+  public: void SetModelJointForces(
+      const Identity &_modelID, const Eigen::VectorXd &_forces) override;
 };
 
 }
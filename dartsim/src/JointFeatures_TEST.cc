@@ -64,11 +64,13 @@ using TestFeatureList = ignition::physics::FeatureList<
   physics::GetBasicJointState,
   physics::GetEntities,
   physics::GetJointTransmittedWrench,
+  physics::GetModelJointStates,
   physics::JointFrameSemantics,
   physics::LinkFrameSemantics,
   physics::RevoluteJointCast,
   physics::SetBasicJointState,
   physics::SetJointVelocityCommandFeature,
+  physics::SetModelJointForces,
   physics::sdf::ConstructSdfModel,
   physics::sdf::ConstructSdfWorld,
   physics::SetJointPositionLimitsFeature,
@@ -174,6 +176,69 @@ TEST_F(JointFeaturesFixture, JointSetCommand)
   }
 }
 
+// Test reading and writing all the joints of a model at once
+TEST_F(JointFeaturesFixture, ModelJointStates)
+{
+  sdf::Root root;
+  const sdf::Errors errors = root.Load(TEST_WORLD_DIR "test.world");
+  ASSERT_TRUE(errors.empty()) << errors.front();
+
+  const std::string modelName{"double_pendulum_with_base"};
+  auto world = this->engine->ConstructWorld(*root.WorldByIndex(0));
+  auto model = world->GetModel(modelName);
+
+  dart::simulation::WorldPtr dartWorld = world->GetDartsimWorld();
+  ASSERT_NE(nullptr, dartWorld);
+  const dart::dynamics::SkeletonPtr skeleton =
+    dartWorld->getSkeleton(modelName);
+  ASSERT_NE(nullptr, skeleton);
+
+  physics::ForwardStep::Output output;
+  physics::ForwardStep::State state;
+  physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 10; ++i)
+    world->Step(output, state, input);
+
+  // the states are in the order of the joints of the model
+  Eigen::VectorXd positions;
+  Eigen::VectorXd velocities;
+  model->GetJointStates(positions, velocities);
+  ASSERT_EQ(static_cast<Eigen::Index>(skeleton->getNumDofs()),
+            positions.size());
+  ASSERT_EQ(positions.size(), velocities.size());
+  Eigen::Index index = 0;
+  for (std::size_t i = 0; i < model->GetJointCount(); ++i)
+  {
+    auto joint = model->GetJoint(i);
+    for (std::size_t dof = 0; dof < skeleton->getJoint(i)->getNumDofs();
+         ++dof, ++index)
+    {
+      EXPECT_DOUBLE_EQ(joint->GetPosition(dof), positions[index]);
+      EXPECT_DOUBLE_EQ(joint->GetVelocity(dof), velocities[index]);
+    }
+  }
+  EXPECT_EQ(positions.size(), index);
+
+  // forces are commands of force actuators, like Joint::SetForce
+  auto upperJoint = model->GetJoint("upper_joint");
+  auto *dartUpperJoint = skeleton->getJoint("upper_joint");
+  upperJoint->SetVelocityCommand(0, 1);
+  EXPECT_EQ(dart::dynamics::Joint::SERVO, dartUpperJoint->getActuatorType());
+
+  Eigen::VectorXd forces = Eigen::VectorXd::Zero(positions.size());
+  forces[dartUpperJoint->getIndexInSkeleton(0)] = 2.0;
+  model->SetJointForces(forces);
+  EXPECT_EQ(dart::dynamics::Joint::FORCE, dartUpperJoint->getActuatorType());
+  EXPECT_DOUBLE_EQ(2.0, dartUpperJoint->getCommand(0));
+
+  // forces that don't match the model are ignored
+  model->SetJointForces(Eigen::VectorXd::Ones(positions.size() + 1));
+  EXPECT_DOUBLE_EQ(2.0, dartUpperJoint->getCommand(0));
+  forces[0] = std::numeric_limits<double>::quiet_NaN();
+  model->SetJointForces(forces);
+  EXPECT_DOUBLE_EQ(2.0, dartUpperJoint->getCommand(0));
+}
+
 TEST_F(JointFeaturesFixture, JointSetPositionLimitsWithForceControl)
 {
   sdf::Root root;
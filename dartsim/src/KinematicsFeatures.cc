@@ -64,12 +64,12 @@ FrameData3d KinematicsFeatures::FrameDataRelativeToWorld(
 const dart::dynamics::Frame *KinematicsFeatures::SelectFrame(
     const FrameID &_id) const
 {
-  const auto model_it = this->models.idToObject.find(_id.ID());
-  if (model_it != this->models.idToObject.end())
+  const auto *modelEntry = this->models.Find(_id.ID());
+  if (modelEntry)
   {
     // This is a model FreeGroup frame, so we'll use the first root link as the
     // frame
-    return model_it->second->model->getRootBodyNode();
+    return modelEntry->object->model->getRootBodyNode();
   }
 
   auto framesIt = this->frames.find(_id.ID());
@@ -20,6 +20,9 @@
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 #include <dart/constraint/ConstraintSolver.hpp>
 #include <dart/dynamics/BallJoint.hpp>
@@ -349,7 +352,7 @@ static ShapeAndTransform ConstructGeometry(
     const ignition::common::Mesh * _mesh =
       meshMgr->MeshByName(ellipsoidMeshName);
 
-    auto mesh = std::make_shared<CustomMeshShape>(*_mesh, Vector3d(1, 1, 1));
+    auto mesh = CustomMeshShape::Get(*_mesh, Vector3d(1, 1, 1));
     auto mesh2 = std::dynamic_pointer_cast<dart::dynamics::MeshShape>(mesh);
     return {mesh2};
   }
@@ -422,6 +425,39 @@ Identity SDFFeatures::ConstructSdfModel(
   return this->ConstructSdfModelImpl(_parentID, _sdfModel);
 }
 
+/////////////////////////////////////////////////
+std::vector<Identity> SDFFeatures::ConstructSdfModels(
+    const Identity &_worldID,
+    const std::vector<::sdf::Model> &_sdfModels)
+{
+  const dart::simulation::WorldPtr &world = this->worlds.at(_worldID);
+
+  std::vector<Identity> modelIDs;
+  modelIDs.reserve(_sdfModels.size());
+  std::unordered_set<std::string> modelNames;
+
+  // The skeletons are added to the world, and so registered with its
+  // collision detector, only once every model of the batch is complete.
+  // Until then dartsim cannot make the names of the skeletons unique, so
+  // models whose names are taken are skipped.
+  DeferAddSkeletonGuard deferAddSkeleton(*this);
+  for (const ::sdf::Model &sdfModel : _sdfModels)
+  {
+    if (world->getSkeleton(sdfModel.Name()) != nullptr ||
+        !modelNames.insert(sdfModel.Name()).second)
+    {
+      ignerr << "A model named [" << sdfModel.Name() << "] already exists in "
+             << "world [" << world->getName() << "]. The model will not be "
+             << "constructed\n";
+      modelIDs.push_back(this->GenerateInvalidId());
+      continue;
+    }
+    modelIDs.push_back(this->ConstructSdfModelImpl(_worldID, sdfModel));
+  }
+
+  return modelIDs;
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfNestedModel(const Identity &_parentID,
                                               const ::sdf::Model &_sdfModel)
@@ -19,14 +19,17 @@
 #define IGNITION_PHYSICS_DARTSIM_SRC_SDFFEATURES_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/physics/sdf/ConstructCollision.hh>
 #include <ignition/physics/sdf/ConstructJoint.hh>
 #include <ignition/physics/sdf/ConstructLink.hh>
 #include <ignition/physics/sdf/ConstructModel.hh>
+#include <ignition/physics/sdf/ConstructModels.hh>
 #include <ignition/physics/sdf/ConstructNestedModel.hh>
 #include <ignition/physics/sdf/ConstructVisual.hh>
 #include <ignition/physics/sdf/ConstructWorld.hh>
+#include <ignition/physics/sdf/ConstructWorldReplicas.hh>
 
 #include <ignition/physics/Implements.hh>
 
@@ -39,7 +42,9 @@ namespace dartsim {
 
 struct SDFFeatureList : FeatureList<
   sdf::ConstructSdfWorld,
+  sdf::ConstructSdfWorldReplicas,
   sdf::ConstructSdfModel,
+  sdf::ConstructSdfModels,
   sdf::ConstructSdfNestedModel,
   sdf::ConstructSdfLink,
   sdf::ConstructSdfJoint,
@@ -59,6 +64,10 @@ class SDFFeatures :
       const Identity &_parentID,
       const ::sdf::Model &_sdfModel) override;
 
+  public: std::vector<Identity> ConstructSdfModels(
+      const Identity &_worldID,
+      const std::vector<::sdf::Model> &_sdfModels) override;
+
   public: Identity ConstructSdfNestedModel(
       const Identity &_parentID,
       const ::sdf::Model &_sdfModel) override;
@@ -26,13 +26,16 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include <ignition/plugin/Loader.hh>
 
 #include <ignition/physics/FrameSemantics.hh>
 #include <ignition/physics/GetEntities.hh>
 #include <ignition/physics/Joint.hh>
+#include <ignition/physics/RemoveEntities.hh>
 #include <ignition/physics/RequestEngine.hh>
 #include <ignition/physics/RevoluteJoint.hh>
 
@@ -40,6 +43,7 @@
 #include <ignition/physics/sdf/ConstructJoint.hh>
 #include <ignition/physics/sdf/ConstructLink.hh>
 #include <ignition/physics/sdf/ConstructModel.hh>
+#include <ignition/physics/sdf/ConstructModels.hh>
 #include <ignition/physics/sdf/ConstructNestedModel.hh>
 #include <ignition/physics/sdf/ConstructWorld.hh>
 
@@ -56,6 +60,7 @@
 
 struct TestFeatureList : ignition::physics::FeatureList<
     ignition::physics::GetEntities,
+    ignition::physics::RemoveModelsFromWorld,
     ignition::physics::GetBasicJointState,
     ignition::physics::SetBasicJointState,
     ignition::physics::LinkFrameSemantics,
@@ -64,6 +69,7 @@ struct TestFeatureList : ignition::physics::FeatureList<
     ignition::physics::sdf::ConstructSdfJoint,
     ignition::physics::sdf::ConstructSdfLink,
     ignition::physics::sdf::ConstructSdfModel,
+    ignition::physics::sdf::ConstructSdfModels,
     ignition::physics::sdf::ConstructSdfNestedModel,
     ignition::physics::sdf::ConstructSdfWorld
 > { };
@@ -932,6 +938,66 @@ TEST_P(SDFFeatures_TEST, Shapes)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_P(SDFFeatures_TEST, ConstructAndRemoveModels)
+{
+  auto world = this->LoadWorld(TEST_WORLD_DIR"/shapes.sdf");
+  ASSERT_NE(nullptr, world);
+
+  auto dartWorld = world->GetDartsimWorld();
+  ASSERT_NE(nullptr, dartWorld);
+  ASSERT_EQ(5u, dartWorld->getNumSkeletons());
+
+  sdf::Root root;
+  ASSERT_TRUE(root.Load(TEST_WORLD_DIR"/shapes.sdf").empty());
+  const sdf::Model *sdfBox = root.WorldByIndex(0)->ModelByName("box");
+  ASSERT_NE(nullptr, sdfBox);
+
+  const std::size_t count = 100u;
+  std::vector<sdf::Model> sdfModels(count, *sdfBox);
+  for (std::size_t i = 0; i < count; ++i)
+    sdfModels[i].SetName("box_" + std::to_string(i));
+  // names that are taken are skipped
+  sdfModels.push_back(*sdfBox);
+  sdfModels.push_back(sdfModels.front());
+
+  auto models = world->ConstructModels(sdfModels);
+  ASSERT_EQ(count + 2, models.size());
+  EXPECT_EQ(nullptr, models[count]);
+  EXPECT_EQ(nullptr, models[count + 1]);
+  ASSERT_EQ(count + 5, dartWorld->getNumSkeletons());
+  ASSERT_EQ(count + 5, world->GetModelCount());
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    ASSERT_NE(nullptr, models[i]);
+    EXPECT_EQ(sdfModels[i].Name(), models[i]->GetName());
+    EXPECT_EQ(i + 5, models[i]->GetIndex());
+    EXPECT_EQ(1u, models[i]->GetLinkCount());
+    EXPECT_EQ(sdfModels[i].Name(), dartWorld->getSkeleton(i + 5)->getName());
+  }
+
+  // remove every other new model, plus a name that does not exist
+  std::vector<std::string> names = {"no_such_model"};
+  for (std::size_t i = 0; i < count; i += 2)
+    names.push_back(sdfModels[i].Name());
+  EXPECT_EQ(count / 2, world->RemoveModels(names));
+  ASSERT_EQ(count / 2 + 5, dartWorld->getNumSkeletons());
+  ASSERT_EQ(count / 2 + 5, world->GetModelCount());
+
+  // the remaining models keep their order and their indices are updated
+  EXPECT_EQ("box", world->GetModel(0)->GetName());
+  for (std::size_t i = 1; i < count; i += 2)
+  {
+    const std::size_t index = 5 + i / 2;
+    EXPECT_EQ(sdfModels[i].Name(), world->GetModel(index)->GetName());
+    EXPECT_EQ(index, models[i]->GetIndex());
+    EXPECT_EQ(sdfModels[i].Name(), dartWorld->getSkeleton(index)->getName());
+  }
+
+  // the world can still be stepped with the new collision objects
+  dartWorld->step();
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -18,6 +18,7 @@
 #include "ShapeFeatures.hh"
 
 #include <memory>
+#include <vector>
 
 #include <dart/dynamics/BoxShape.hpp>
 #include <dart/dynamics/CapsuleShape.hpp>
@@ -34,6 +35,7 @@
 
 #include "CustomHeightmapShape.hh"
 #include "CustomMeshShape.hh"
+#include "TiledHeightmap.hh"
 
 namespace ignition {
 namespace physics {
@@ -265,7 +267,7 @@ Identity ShapeFeatures::AttachEllipsoidShape(
     16, 16);
   const ignition::common::Mesh * _mesh = meshMgr->MeshByName(ellipsoidMeshName);
 
-  auto mesh = std::make_shared<CustomMeshShape>(*_mesh, Vector3d(1, 1, 1));
+  auto mesh = CustomMeshShape::Get(*_mesh, Vector3d(1, 1, 1));
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
@@ -363,7 +365,7 @@ Identity ShapeFeatures::AttachHeightmapShape(
     const LinearVector3d &_size,
     int _subSampling)
 {
-  auto heightmap = std::make_shared<CustomHeightmapShape>(_heightmapData,
+  auto heightmap = CustomHeightmapShape::Get(_heightmapData,
       _size, _subSampling);
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
@@ -377,6 +379,38 @@ Identity ShapeFeatures::AttachHeightmapShape(
   return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
 }
 
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachTiledHeightmapShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const std::string &_heightFile,
+    const heightmap::HeightmapTiling &_tiling,
+    const Pose3d &_pose)
+{
+  auto tiles = std::make_shared<TiledHeightmap>();
+  if (!tiles->Load(_heightFile, _tiling))
+    return this->GenerateInvalidId();
+
+  // The shape of the terrain is a flat heightmap that spans all of it, and
+  // has no collision aspect, so it only gives the terrain an identity. The
+  // tiles are attached to the link by SimulationFeatures as the world steps.
+  using HeightmapShape = dart::dynamics::HeightmapShape<float>;
+  auto footprint = std::make_shared<HeightmapShape>();
+  footprint->setHeightField(2u, 2u, std::vector<float>(4u, 0.0f));
+  const Eigen::Vector2d size = tiles->Size();
+  footprint->setScale(HeightmapShape::Vector3(
+      static_cast<float>(size.x()), static_cast<float>(size.y()), 1.0f));
+
+  DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+  dart::dynamics::ShapeNode *sn =
+      bn->createShapeNode(footprint, bn->getName() + ":" + _name);
+  sn->setRelativeTransform(_pose);
+  const std::size_t shapeID = this->AddShape({sn, _name});
+
+  this->tiledHeightmaps.push_back({_linkID.id, _name, _pose, tiles, {}});
+  return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToMeshShape(
     const Identity &_shapeID) const
@@ -426,7 +460,29 @@ Identity ShapeFeatures::AttachMeshShape(
     const Pose3d &_pose,
     const LinearVector3d &_scale)
 {
-  auto mesh = std::make_shared<CustomMeshShape>(_mesh, _scale);
+  auto mesh = CustomMeshShape::Get(_mesh, _scale);
+
+  DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+  dart::dynamics::ShapeNode *sn =
+      bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
+                              dart::dynamics::DynamicsAspect>(
+          mesh, bn->getName() + ":" + _name);
+
+  sn->setRelativeTransform(_pose);
+  const std::size_t shapeID = this->AddShape({sn, _name});
+  return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexMeshShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const ignition::common::Mesh &_mesh,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale,
+    const mesh::ConvexDecompositionOptions &_options)
+{
+  auto mesh = CustomMeshShape::GetConvex(_mesh, _scale, _options);
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
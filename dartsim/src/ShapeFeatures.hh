@@ -26,6 +26,7 @@
 #include <ignition/physics/CylinderShape.hh>
 #include <ignition/physics/EllipsoidShape.hh>
 #include <ignition/physics/heightmap/HeightmapShape.hh>
+#include <ignition/physics/heightmap/TiledHeightmapShape.hh>
 #include <ignition/physics/mesh/MeshShape.hh>
 #include <ignition/physics/PlaneShape.hh>
 #include <ignition/physics/SphereShape.hh>
@@ -70,10 +71,12 @@ struct ShapeFeatureList : FeatureList<
   heightmap::GetHeightmapShapeProperties,
 //  heightmap::SetHeightmapShapeProperties,
   heightmap::AttachHeightmapShapeFeature,
+  heightmap::AttachTiledHeightmapShapeFeature,
 
   mesh::GetMeshShapeProperties,
 //  mesh::SetMeshShapeProperties,
   mesh::AttachMeshShapeFeature,
+  mesh::AttachConvexMeshShapeFeature,
   GetPlaneShapeProperties,
 //  SetPlaneShapeProperties,
   AttachPlaneShapeFeature
@@ -180,6 +183,13 @@ class ShapeFeatures :
       const LinearVector3d &_size,
       int _subSampling) override;
 
+  public: Identity AttachTiledHeightmapShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const std::string &_heightFile,
+      const heightmap::HeightmapTiling &_tiling,
+      const Pose3d &_pose) override;
+
   // ----- Mesh Features -----
   public: Identity CastToMeshShape(
       const Identity &_shapeID) const override;
@@ -197,6 +207,14 @@ class ShapeFeatures :
       const Pose3d &_pose,
       const LinearVector3d &_scale) override;
 
+  public: Identity AttachConvexMeshShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const ignition::common::Mesh &_mesh,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale,
+      const mesh::ConvexDecompositionOptions &_options) override;
+
   // ----- Boundingbox Features -----
   public: AlignedBox3d GetShapeAxisAlignedBoundingBox(
               const Identity &_shapeID) const override;
@@ -15,20 +15,30 @@
  *
 */
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 
 #include <dart/collision/CollisionObject.hpp>
 #include <dart/collision/CollisionResult.hpp>
 #include <dart/constraint/ConstraintSolver.hpp>
 #include <dart/constraint/ContactConstraint.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
 #ifdef DART_HAS_CONTACT_SURFACE
 #include <dart/constraint/ContactSurface.hpp>
 #endif
 
+#if __has_include(<ode/ode.h>)
+#include <ode/ode.h>
+#define DARTSIM_HAS_ODE_HEADER
+#endif
+
 #include <ignition/common/Profiler.hh>
 
 #include <ignition/math/Pose3.hh>
@@ -37,6 +47,7 @@
 #include "ignition/physics/GetContacts.hh"
 
 #include "SimulationFeatures.hh"
+#include "TiledHeightmap.hh"
 
 namespace ignition {
 namespace physics {
@@ -49,7 +60,178 @@ void SimulationFeatures::WorldForwardStep(
     const ForwardStep::Input & _u)
 {
   IGN_PROFILE("SimulationFeatures::WorldForwardStep");
-  auto *world = this->ReferenceInterface<DartWorld>(_worldID);
+  std::lock_guard<std::mutex> lock(this->stepMutex);
+  this->PageHeightmapTiles(_worldID);
+  this->UpdateLinkPoseCache();
+  this->StepWorld(_worldID, _h, _u);
+}
+
+void SimulationFeatures::EngineForwardStepWorlds(
+    const Identity &/*_engineID*/,
+    std::vector<ForwardStep::Output> &_h,
+    std::vector<ForwardStep::State> &_x,
+    const std::vector<ForwardStep::Input> &_u)
+{
+  IGN_PROFILE("SimulationFeatures::EngineForwardStepWorlds");
+  std::lock_guard<std::mutex> lock(this->stepMutex);
+
+  const std::vector<std::size_t> &worldIDs =
+      this->worlds.indexInContainerToID.at(0);
+  _h.resize(worldIDs.size());
+  _x.resize(worldIDs.size());
+
+  // Paging tiles adds and removes shapes, so it is done before the worlds step
+  for (const std::size_t worldID : worldIDs)
+    this->PageHeightmapTiles(worldID);
+
+  // The entity maps are only read while the worlds step, and each world only
+  // writes to its own output and to its own range of the link pose cache.
+  this->UpdateLinkPoseCache();
+
+  const ForwardStep::Input defaultInput;
+  auto stepWorld = [&](std::size_t _index)
+  {
+    this->StepWorld(worldIDs[_index], _h[_index],
+        _index < _u.size() ? _u[_index] : defaultInput);
+  };
+
+  if (worldIDs.size() < 2u)
+  {
+    for (std::size_t i = 0; i < worldIDs.size(); ++i)
+      stepWorld(i);
+    return;
+  }
+
+  if (!this->workerPool)
+    this->workerPool = std::make_unique<common::WorkerPool>();
+
+  for (std::size_t i = 0; i < worldIDs.size(); ++i)
+  {
+    this->workerPool->AddWork([&stepWorld, i]()
+    {
+#ifdef DARTSIM_HAS_ODE_HEADER
+      // ODE needs per-thread data for the ODE collision detector
+      dAllocateODEDataForThread(dAllocateMaskAll);
+#endif
+      stepWorld(i);
+    });
+  }
+  this->workerPool->WaitForResults();
+}
+
+void SimulationFeatures::PageHeightmapTiles(const std::size_t _worldID)
+{
+  if (this->tiledHeightmaps.empty())
+    return;
+
+  IGN_PROFILE("SimulationFeatures::PageHeightmapTiles");
+  const DartWorldPtr &world = this->worlds.at(_worldID);
+  std::vector<Eigen::AlignedBox3d> boxes;
+  std::vector<std::size_t> load;
+  std::vector<std::size_t> evict;
+
+  auto it = this->tiledHeightmaps.begin();
+  while (it != this->tiledHeightmaps.end())
+  {
+    // The shapes of the tiles were removed along with the link
+    const auto *linkEntry = this->links.Find(it->linkID);
+    if (!linkEntry)
+    {
+      it = this->tiledHeightmaps.erase(it);
+      continue;
+    }
+
+    DartBodyNode *bn = linkEntry->object->link.get();
+    const DartSkeletonPtr skeleton = bn->getSkeleton();
+    if (!world->hasSkeleton(skeleton))
+    {
+      ++it;
+      continue;
+    }
+
+    const Eigen::Isometry3d worldToTerrain =
+        (bn->getWorldTransform() * it->pose).inverse();
+    boxes.clear();
+    for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+    {
+      const DartSkeletonPtr &other = world->getSkeleton(i);
+      if (other == skeleton || !other->isMobile())
+        continue;
+
+      for (std::size_t j = 0; j < other->getNumBodyNodes(); ++j)
+      {
+        const DartBodyNode *otherBn = other->getBodyNode(j);
+
+        // Box of the corners of the bounding boxes of the collision shapes,
+        // or the origin of a body without any
+        Eigen::AlignedBox3d box;
+        const std::size_t numShapes =
+            otherBn->getNumShapeNodesWith<dart::dynamics::CollisionAspect>();
+        for (std::size_t k = 0; k < numShapes; ++k)
+        {
+          const DartShapeNode *sn =
+              otherBn->getShapeNodeWith<dart::dynamics::CollisionAspect>(k);
+          const dart::math::BoundingBox &local =
+              sn->getShape()->getBoundingBox();
+          const Eigen::Isometry3d shapeToTerrain =
+              worldToTerrain * sn->getWorldTransform();
+          for (int corner = 0; corner < 8; ++corner)
+          {
+            box.extend(shapeToTerrain * Eigen::Vector3d(
+                (corner & 1) ? local.getMax().x() : local.getMin().x(),
+                (corner & 2) ? local.getMax().y() : local.getMin().y(),
+                (corner & 4) ? local.getMax().z() : local.getMin().z()));
+          }
+        }
+        if (box.isEmpty())
+        {
+          box.extend(
+              worldToTerrain * otherBn->getWorldTransform().translation());
+        }
+        boxes.push_back(box);
+      }
+    }
+
+    it->tiles->Page(boxes, load, evict);
+    for (const std::size_t tile : evict)
+    {
+      auto nodeIt = it->tileNodes.find(tile);
+      if (nodeIt == it->tileNodes.end())
+        continue;
+
+      DartShapeNode *sn = nodeIt->second;
+      if (this->shapes.HasEntity(sn))
+      {
+        this->frames.erase(this->shapes.IdentityOf(sn));
+        this->shapes.RemoveEntity(sn);
+      }
+      sn->remove();
+      it->tileNodes.erase(nodeIt);
+    }
+
+    for (const std::size_t tile : load)
+    {
+      const std::string name = it->name + it->tiles->TileSuffix(tile);
+      DartShapeNode *sn =
+          bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
+                                  dart::dynamics::DynamicsAspect>(
+              it->tiles->TileShape(tile), bn->getName() + ":" + name);
+
+      Eigen::Isometry3d tilePose = it->pose;
+      tilePose.translate(it->tiles->TileCenter(tile));
+      sn->setRelativeTransform(tilePose);
+      this->AddShape({sn, name});
+      it->tileNodes[tile] = sn;
+    }
+    ++it;
+  }
+}
+
+void SimulationFeatures::StepWorld(std::size_t _worldID,
+    ForwardStep::Output &_h, const ForwardStep::Input &_u) const
+{
+  IGN_PROFILE("SimulationFeatures::StepWorld");
+  auto *world = this->worlds.at(_worldID).get();
   auto *dtDur =
       _u.Query<std::chrono::steady_clock::duration>();
   const double tol = 1e-6;
@@ -67,47 +249,170 @@ void SimulationFeatures::WorldForwardStep(
 
   // TODO(MXG): Parse input
   world->step();
-  this->Write(_h.Get<ChangedWorldPoses>());
+
+  // remove link poses from the previous iteration
+  auto &changedPoses = _h.Get<ChangedWorldPoses>();
+  changedPoses.entries.clear();
+  auto rangeIt = std::lower_bound(this->worldLinkPoses.begin(),
+      this->worldLinkPoses.end(), _worldID,
+      [](const WorldLinkPoses &_range, std::size_t _id)
+      {
+        return _range.worldID < _id;
+      });
+  if (rangeIt != this->worldLinkPoses.end() && rangeIt->worldID == _worldID)
+    this->WriteWorld(*rangeIt, changedPoses);
   // TODO(MXG): Fill in state
 }
 
-void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
+void SimulationFeatures::WriteWorld(const WorldLinkPoses &_range,
+    ChangedWorldPoses &_changedPoses) const
 {
-  // remove link poses from the previous iteration
-  _changedPoses.entries.clear();
-  _changedPoses.entries.reserve(this->links.size());
-
-  std::unordered_map<std::size_t, math::Pose3d> newPoses;
-
-  for (const auto &[id, info] : this->links.idToObject)
+  // skeletons whose generalized positions did not change, e.g. skeletons at
+  // rest or static skeletons, have the same link poses as before, so their
+  // links are skipped without visiting them
+  for (std::size_t s = _range.skeletonBegin; s < _range.skeletonEnd; ++s)
   {
-    // make sure the link exists
-    if (info && info->link)
+    SkeletonState &state = this->skeletonStates[s];
+    const std::size_t dofs = state.skeleton->getNumDofs();
+    bool changed = state.version != state.skeleton->getVersion() ||
+        static_cast<std::size_t>(state.positions.size()) != dofs;
+    if (changed)
+    {
+      state.version = state.skeleton->getVersion();
+      state.positions.resize(dofs);
+    }
+    for (std::size_t i = 0; i < dofs; ++i)
+    {
+      const double position = state.skeleton->getPosition(i);
+      if (changed || position != state.positions[i])
+      {
+        changed = true;
+        state.positions[i] = position;
+      }
+    }
+    if (!changed && state.written)
+      continue;
+
+    for (std::size_t l = state.linkBegin; l < state.linkEnd; ++l)
     {
+      LinkPose &entry = this->prevLinkPoses[l];
       WorldPose wp;
       wp.pose = ignition::math::eigen3::convert(
-          info->link->getWorldTransform());
-      wp.body = id;
+          entry.link->getWorldTransform());
+      wp.body = entry.id;
 
       // If the link's pose is new or has changed, save this new pose and
       // add it to the output poses. Otherwise, keep the existing link pose
-      auto iter = this->prevLinkPoses.find(id);
-      if ((iter == this->prevLinkPoses.end()) ||
-          !iter->second.Pos().Equal(wp.pose.Pos(), 1e-6) ||
-          !iter->second.Rot().Equal(wp.pose.Rot(), 1e-6))
+      if (!entry.written ||
+          !entry.pose.Pos().Equal(wp.pose.Pos(), 1e-6) ||
+          !entry.pose.Rot().Equal(wp.pose.Rot(), 1e-6))
       {
         _changedPoses.entries.push_back(wp);
-        newPoses[id] = wp.pose;
+        entry.pose = wp.pose;
+        entry.written = true;
       }
-      else
-        newPoses[id] = iter->second;
     }
+    state.written = true;
   }
+}
 
-  // Save the new poses so that they can be used to check for updates in the
-  // next iteration. Re-setting this->prevLinkPoses with the contents of
-  // newPoses ensures that we aren't caching data for links that were removed
-  this->prevLinkPoses = std::move(newPoses);
+void SimulationFeatures::UpdateLinkPoseCache() const
+{
+  // rebuild the cache if links were added or removed. Adding or detaching a
+  // joint moves its child link to another skeleton, which increments the
+  // version of the links too.
+  if (this->prevLinkPosesVersion == this->links.version)
+    return;
+
+  std::vector<LinkPose> linkPoses;
+  linkPoses.reserve(this->links.size());
+  for (const auto &link : this->links.entries)
+  {
+    // make sure the link exists
+    if (link.object && link.object->link)
+    {
+      LinkPose entry;
+      entry.id = link.id;
+      entry.link = link.object->link.get();
+      entry.worldID = this->GetWorldOfModelImpl(link.containerID);
+      entry.skeleton = 0u;
+      entry.written = false;
+      linkPoses.push_back(entry);
+    }
+  }
+  std::sort(linkPoses.begin(), linkPoses.end(),
+      [](const LinkPose &_a, const LinkPose &_b)
+      {
+        return std::tie(_a.worldID, _a.id) < std::tie(_b.worldID, _b.id);
+      });
+
+  // keep the poses of links that were already written
+  std::unordered_map<std::size_t, std::size_t> prevIndices;
+  for (std::size_t i = 0; i < this->prevLinkPoses.size(); ++i)
+    prevIndices[this->prevLinkPoses[i].id] = i;
+  for (LinkPose &entry : linkPoses)
+  {
+    auto prevIt = prevIndices.find(entry.id);
+    if (prevIt != prevIndices.end())
+    {
+      entry.pose = this->prevLinkPoses[prevIt->second].pose;
+      entry.written = this->prevLinkPoses[prevIt->second].written;
+    }
+  }
+
+  // number the skeletons in the order of their first link. A skeleton
+  // belongs to a single world, so the skeletons of a world get consecutive
+  // numbers.
+  std::vector<SkeletonState> states;
+  std::unordered_map<const DartSkeleton *, std::size_t> skeletonIndices;
+  for (LinkPose &entry : linkPoses)
+  {
+    const DartSkeleton *skeleton = entry.link->getSkeleton().get();
+    auto [it, inserted] = skeletonIndices.insert({skeleton, states.size()});
+    if (inserted)
+    {
+      SkeletonState state;
+      state.skeleton = skeleton;
+      state.version = skeleton->getVersion();
+      state.written = true;
+      states.push_back(state);
+    }
+    entry.skeleton = it->second;
+  }
+
+  // group the links by skeleton, which also groups them by world, so that
+  // each world can write its poses on its own and skeletons that did not move
+  // are skipped as a whole
+  std::stable_sort(linkPoses.begin(), linkPoses.end(),
+      [](const LinkPose &_a, const LinkPose &_b)
+      {
+        return _a.skeleton < _b.skeleton;
+      });
+
+  this->worldLinkPoses.clear();
+  for (std::size_t l = 0; l < linkPoses.size(); ++l)
+  {
+    const LinkPose &entry = linkPoses[l];
+    SkeletonState &state = states[entry.skeleton];
+    if (l == 0u || linkPoses[l - 1u].skeleton != entry.skeleton)
+      state.linkBegin = l;
+    state.linkEnd = l + 1u;
+    state.written = state.written && entry.written;
+
+    if (this->worldLinkPoses.empty() ||
+        this->worldLinkPoses.back().worldID != entry.worldID)
+    {
+      WorldLinkPoses range;
+      range.worldID = entry.worldID;
+      range.skeletonBegin = entry.skeleton;
+      this->worldLinkPoses.push_back(range);
+    }
+    this->worldLinkPoses.back().skeletonEnd = entry.skeleton + 1u;
+  }
+
+  this->prevLinkPoses = std::move(linkPoses);
+  this->skeletonStates = std::move(states);
+  this->prevLinkPosesVersion = this->links.version;
 }
 
 std::vector<SimulationFeatures::ContactInternal>
@@ -115,7 +420,7 @@ SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
 {
   std::vector<SimulationFeatures::ContactInternal> outContacts;
   auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
-  const auto colResult = world->getLastCollisionResult();
+  const auto &colResult = world->getLastCollisionResult();
 
   for (const auto &dtContact : colResult.getContacts())
   {
@@ -127,6 +432,38 @@ SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
   return outContacts;
 }
 
+void SimulationFeatures::GetContactBufferFromLastStep(
+    const Identity &_worldID, std::vector<ContactData> &_contacts) const
+{
+  IGN_PROFILE("SimulationFeatures::GetContactBufferFromLastStep");
+  _contacts.clear();
+  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
+  const auto &colResult = world->getLastCollisionResult();
+  _contacts.reserve(colResult.getNumContacts());
+
+  for (const auto &dtContact : colResult.getContacts())
+  {
+    auto *dtShapeNode1 =
+      dtContact.collisionObject1->getShapeFrame()->asShapeNode();
+    auto *dtShapeNode2 =
+      dtContact.collisionObject2->getShapeFrame()->asShapeNode();
+
+    if (!this->shapes.HasEntity(dtShapeNode1) ||
+        !this->shapes.HasEntity(dtShapeNode2))
+    {
+      continue;
+    }
+
+    auto &contact = _contacts.emplace_back();
+    contact.shape1 = this->shapes.IdentityOf(dtShapeNode1);
+    contact.shape2 = this->shapes.IdentityOf(dtShapeNode2);
+    contact.point = dtContact.point;
+    contact.normal = dtContact.normal;
+    contact.force = dtContact.force;
+    contact.depth = dtContact.penetrationDepth;
+  }
+}
+
 std::optional<SimulationFeatures::ContactInternal>
 SimulationFeatures::convertContact(
   const dart::collision::Contact& _contact) const
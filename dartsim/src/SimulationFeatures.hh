@@ -19,6 +19,7 @@
 #define IGNITION_PHYSICS_DARTSIM_SRC_SIMULATIONFEATURES_HH_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,9 +29,9 @@
 #include <dart/constraint/ContactSurface.hpp>
 #endif
 
-#include <ignition/math/Pose3.hh>
+#include <ignition/common/WorkerPool.hh>
 
-#include <ignition/physics/CanWriteData.hh>
+#include <ignition/math/Pose3.hh>
 
 #include <ignition/physics/ForwardStep.hh>
 #include <ignition/physics/GetContacts.hh>
@@ -53,10 +54,12 @@ namespace dartsim {
 
 struct SimulationFeatureList : FeatureList<
   ForwardStep,
+  ForwardStepWorlds,
 #ifdef DART_HAS_CONTACT_SURFACE
   SetContactPropertiesCallbackFeature,
 #endif
-  GetContactsFromLastStepFeature
+  GetContactsFromLastStepFeature,
+  GetContactBufferFromLastStepFeature
 > { };
 
 #ifdef DART_HAS_CONTACT_SURFACE
@@ -88,14 +91,15 @@ using IgnContactSurfaceHandlerPtr = std::shared_ptr<IgnContactSurfaceHandler>;
 #endif
 
 class SimulationFeatures :
-    public CanWriteExpectedData<SimulationFeatures,
-      ExpectData<ChangedWorldPoses>>,
     public virtual Base,
     public virtual Implements3d<SimulationFeatureList>
 {
   public: using GetContactsFromLastStepFeature::Implementation<FeaturePolicy3d>
     ::ContactInternal;
 
+  public: using GetContactBufferFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactData;
+
   public: SimulationFeatures() = default;
   public: ~SimulationFeatures() override = default;
 
@@ -105,14 +109,124 @@ class SimulationFeatures :
       ForwardStep::State &_x,
       const ForwardStep::Input &_u) override;
 
-  public: void Write(ChangedWorldPoses &_changedPoses) const;
+  public: void EngineForwardStepWorlds(
+      const Identity &_engineID,
+      std::vector<ForwardStep::Output> &_h,
+      std::vector<ForwardStep::State> &_x,
+      const std::vector<ForwardStep::Input> &_u) override;
 
   public: std::vector<ContactInternal> GetContactsFromLastStep(
       const Identity &_worldID) const override;
 
-  /// \brief link poses from the most recent pose change/update.
-  /// The key is the link's ID, and the value is the link's pose
-  private: mutable std::unordered_map<std::size_t, math::Pose3d> prevLinkPoses;
+  public: void GetContactBufferFromLastStep(
+      const Identity &_worldID,
+      std::vector<ContactData> &_contacts) const override;
+
+  /// \brief Step a single world and write the poses of its links that
+  /// changed. Distinct worlds can be stepped in parallel once the link pose
+  /// cache is up to date.
+  /// \param[in] _worldID ID of the world to step
+  /// \param[out] _h Output of the world
+  /// \param[in] _u Input of the world
+  private: void StepWorld(std::size_t _worldID,
+      ForwardStep::Output &_h, const ForwardStep::Input &_u) const;
+
+  /// \brief Page the tiles of the tiled heightmaps of a world in and out
+  /// around the links of the world that are not static
+  /// \param[in] _worldID ID of the world
+  private: void PageHeightmapTiles(std::size_t _worldID);
+
+  /// \brief Rebuild prevLinkPoses, skeletonStates and worldLinkPoses from the
+  /// stored links if links were added, removed or moved to another skeleton,
+  /// keeping the previous poses of links that still exist
+  private: void UpdateLinkPoseCache() const;
+
+  /// \brief Range of the link pose cache that belongs to a world
+  private: struct WorldLinkPoses
+  {
+    /// \brief Entity ID of the world
+    std::size_t worldID;
+
+    /// \brief First index of the skeletons of the world in skeletonStates
+    std::size_t skeletonBegin;
+
+    /// \brief One past the last index of the skeletons of the world
+    std::size_t skeletonEnd;
+  };
+
+  /// \brief Append the poses of the links of a world that changed since they
+  /// were last written
+  /// \param[in] _range Skeletons of the world
+  /// \param[out] _changedPoses Poses that changed
+  private: void WriteWorld(const WorldLinkPoses &_range,
+      ChangedWorldPoses &_changedPoses) const;
+
+  /// \brief Pose of a link from the most recent pose change/update
+  private: struct LinkPose
+  {
+    /// \brief Entity ID of the link
+    std::size_t id;
+
+    /// \brief Entity ID of the world of the link
+    std::size_t worldID;
+
+    /// \brief BodyNode of the link
+    DartBodyNode *link;
+
+    /// \brief Index of the skeleton of the link in skeletonStates
+    std::size_t skeleton;
+
+    /// \brief Most recent pose that was written
+    math::Pose3d pose;
+
+    /// \brief False if the link's pose was never written
+    bool written;
+  };
+
+  /// \brief Generalized positions of a skeleton from the previous step, used
+  /// to skip the links of skeletons that did not move
+  private: struct SkeletonState
+  {
+    /// \brief The skeleton
+    const DartSkeleton *skeleton;
+
+    /// \brief Version of the skeleton when the positions were saved
+    std::size_t version;
+
+    /// \brief Generalized positions from the previous step
+    Eigen::VectorXd positions;
+
+    /// \brief First index of the links of the skeleton in prevLinkPoses
+    std::size_t linkBegin;
+
+    /// \brief One past the last index of the links of the skeleton
+    std::size_t linkEnd;
+
+    /// \brief True if the pose of every link of the skeleton was written
+    bool written;
+  };
+
+  /// \brief Link poses from the most recent pose change/update, sorted by
+  /// world, skeleton and link ID, so that the links of a skeleton that did
+  /// not move are skipped as a whole. This array is reused across steps and
+  /// only rebuilt when links are added, removed or moved to another skeleton.
+  private: mutable std::vector<LinkPose> prevLinkPoses;
+
+  /// \brief State of the skeletons of the links in prevLinkPoses
+  private: mutable std::vector<SkeletonState> skeletonStates;
+
+  /// \brief Version of the link storage that prevLinkPoses was built from
+  private: mutable std::size_t prevLinkPosesVersion = 0u;
+
+  /// \brief Ranges of skeletonStates of each world, sorted by world ID
+  private: mutable std::vector<WorldLinkPoses> worldLinkPoses;
+
+  /// \brief Serializes stepping, since stepping updates the link pose cache
+  private: std::mutex stepMutex;
+
+  /// \brief Worker pool used to step worlds in parallel, created the first
+  /// time more than one world is stepped
+  private: std::unique_ptr<common::WorkerPool> workerPool;
 
   private: std::optional<ContactInternal> convertContact(
     const dart::collision::Contact& _contact) const;
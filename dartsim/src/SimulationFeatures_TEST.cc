@@ -19,6 +19,8 @@
 
 #include <iostream>
 #include <set>
+#include <string>
+#include <vector>
 
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/eigen3/Conversions.hh>
@@ -46,6 +48,7 @@ struct TestFeatureList : ignition::physics::FeatureList<
     ignition::physics::LinkFrameSemantics,
     ignition::physics::ForwardStep,
     ignition::physics::GetContactsFromLastStepFeature,
+    ignition::physics::GetContactBufferFromLastStepFeature,
     ignition::physics::GetEntities,
     ignition::physics::GetShapeBoundingBox,
     ignition::physics::CollisionFilterMaskFeature,
@@ -161,6 +164,151 @@ TEST_P(SimulationFeatures_TEST, Falling)
   }
 }
 
+TEST_P(SimulationFeatures_TEST, ChangedWorldPoses)
+{
+  const std::string library = GetParam();
+  if (library.empty())
+    return;
+
+  auto worlds = LoadWorlds(library, TEST_WORLD_DIR "/falling.world");
+
+  for (const auto &world : worlds)
+  {
+    const std::size_t sphereLinkID =
+        world->GetModel("sphere")->GetLink(0)->EntityID();
+    const std::size_t boxLinkID =
+        world->GetModel("box")->GetLink(0)->EntityID();
+
+    ignition::physics::ForwardStep::Input input;
+    ignition::physics::ForwardStep::State state;
+    ignition::physics::ForwardStep::Output output;
+
+    auto changedBodies = [&]()
+    {
+      std::set<std::size_t> bodies;
+      for (const auto &entry :
+           output.Get<ignition::physics::ChangedWorldPoses>().entries)
+      {
+        bodies.insert(entry.body);
+      }
+      return bodies;
+    };
+
+    // all link poses are new in the first step
+    world->Step(output, state, input);
+    std::set<std::size_t> bodies = changedBodies();
+    EXPECT_EQ(1u, bodies.count(sphereLinkID));
+    EXPECT_EQ(1u, bodies.count(boxLinkID));
+
+    // only the falling sphere moves afterwards, the static box is skipped
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      world->Step(output, state, input);
+      bodies = changedBodies();
+      EXPECT_EQ(1u, bodies.count(sphereLinkID));
+      EXPECT_EQ(0u, bodies.count(boxLinkID));
+    }
+  }
+}
+
+struct StepWorldsFeatureList : ignition::physics::FeatureList<
+    ignition::physics::ForwardStep,
+    ignition::physics::ForwardStepWorlds,
+    ignition::physics::GetEntities,
+    ignition::physics::LinkFrameSemantics,
+    ignition::physics::sdf::ConstructSdfWorld
+> { };
+
+TEST_P(SimulationFeatures_TEST, StepWorlds)
+{
+  const std::string library = GetParam();
+  if (library.empty())
+    return;
+
+  ignition::plugin::Loader loader;
+  loader.LoadLib(library);
+
+  const std::set<std::string> pluginNames =
+      ignition::physics::FindFeatures3d<StepWorldsFeatureList>::From(loader);
+  EXPECT_LT(0u, pluginNames.size());
+
+  for (const std::string &name : pluginNames)
+  {
+    ignition::plugin::PluginPtr plugin = loader.Instantiate(name);
+    auto engine =
+        ignition::physics::RequestEngine3d<StepWorldsFeatureList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors &errors = root.Load(TEST_WORLD_DIR "/falling.world");
+    ASSERT_EQ(0u, errors.size());
+    sdf::World sdfWorld = *root.WorldByIndex(0);
+
+    // construct several copies of the same world
+    const std::size_t worldCount = 4u;
+    for (std::size_t i = 0; i < worldCount; ++i)
+    {
+      sdfWorld.SetName("falling_" + std::to_string(i));
+      ASSERT_NE(nullptr, engine->ConstructWorld(sdfWorld));
+    }
+    ASSERT_EQ(worldCount, engine->GetWorldCount());
+
+    // a reference copy in a separate engine that is stepped on its own
+    ignition::plugin::PluginPtr refPlugin = loader.Instantiate(name);
+    auto refEngine =
+        ignition::physics::RequestEngine3d<StepWorldsFeatureList>::From(
+            refPlugin);
+    ASSERT_NE(nullptr, refEngine);
+    sdfWorld.SetName("falling_reference");
+    auto refWorld = refEngine->ConstructWorld(sdfWorld);
+    ASSERT_NE(nullptr, refWorld);
+    ignition::physics::ForwardStep::Output refOutput;
+    ignition::physics::ForwardStep::State refState;
+    ignition::physics::ForwardStep::Input refInput;
+
+    std::vector<ignition::physics::ForwardStep::Output> outputs;
+    std::vector<ignition::physics::ForwardStep::State> states;
+    std::vector<ignition::physics::ForwardStep::Input> inputs;
+    for (std::size_t step = 0; step < 100; ++step)
+    {
+      engine->StepWorlds(outputs, states, inputs);
+      refWorld->Step(refOutput, refState, refInput);
+      ASSERT_EQ(worldCount, outputs.size());
+      ASSERT_EQ(worldCount, states.size());
+
+      // each world only reports the poses of its own links
+      for (std::size_t i = 0; i < worldCount; ++i)
+      {
+        auto world = engine->GetWorld(i);
+        std::set<std::size_t> worldLinks;
+        for (std::size_t m = 0; m < world->GetModelCount(); ++m)
+        {
+          auto model = world->GetModel(m);
+          for (std::size_t l = 0; l < model->GetLinkCount(); ++l)
+            worldLinks.insert(model->GetLink(l)->EntityID());
+        }
+
+        const auto &entries =
+            outputs[i].Get<ignition::physics::ChangedWorldPoses>().entries;
+        EXPECT_FALSE(entries.empty());
+        for (const auto &entry : entries)
+          EXPECT_EQ(1u, worldLinks.count(entry.body));
+      }
+    }
+
+    // all the copies step the same way as the reference stepped on its own
+    const auto expectedPos = refWorld->GetModel("sphere")->
+        GetLink(0)->FrameDataRelativeToWorld().pose.translation();
+    EXPECT_GT(2.0, expectedPos.z());
+    for (std::size_t i = 0; i < worldCount; ++i)
+    {
+      const auto pos = engine->GetWorld(i)->GetModel("sphere")->
+          GetLink(0)->FrameDataRelativeToWorld().pose.translation();
+      EXPECT_NEAR(expectedPos.z(), pos.z(), 1e-9);
+    }
+  }
+}
+
 TEST_P(SimulationFeatures_TEST, ShapeBoundingBox)
 {
   const std::string library = GetParam();
@@ -421,6 +569,32 @@ TEST_P(SimulationFeatures_TEST, RetrieveContacts)
       checkContact(contact, false);
     }
 
+    // The contact buffer holds the same contacts, in the same order
+    std::vector<TestWorld::ContactData> contactBuffer;
+    world->GetContactBufferFromLastStep(contactBuffer);
+    ASSERT_EQ(contacts.size(), contactBuffer.size());
+    for (std::size_t i = 0; i < contacts.size(); ++i)
+    {
+      const auto &contactPoint = contacts[i].Get<TestContactPoint>();
+      const auto &extraContactData = contacts[i].Get<TestExtraContactData>();
+      const auto &contactData = contactBuffer[i];
+      EXPECT_EQ(contactPoint.collision1->EntityID(), contactData.shape1);
+      EXPECT_EQ(contactPoint.collision2->EntityID(), contactData.shape2);
+      EXPECT_TRUE(ignition::physics::test::Equal(contactPoint.point,
+                                                 contactData.point, 1e-6));
+      EXPECT_TRUE(ignition::physics::test::Equal(extraContactData.normal,
+                                                 contactData.normal, 1e-6));
+      EXPECT_TRUE(ignition::physics::test::Equal(extraContactData.force,
+                                                 contactData.force, 1e-6));
+      EXPECT_DOUBLE_EQ(extraContactData.depth, contactData.depth);
+    }
+
+    // Reusing the buffer keeps its storage
+    const auto *bufferData = contactBuffer.data();
+    world->GetContactBufferFromLastStep(contactBuffer);
+    EXPECT_EQ(4u, contactBuffer.size());
+    EXPECT_EQ(bufferData, contactBuffer.data());
+
 #ifdef DART_HAS_CONTACT_SURFACE
     // removing a non-existing callback yields no error but returns false
     EXPECT_FALSE(world->RemoveContactPropertiesCallback("foo"));
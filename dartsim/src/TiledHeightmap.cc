@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TiledHeightmap.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+
+namespace ignition {
+namespace physics {
+namespace dartsim {
+
+/////////////////////////////////////////////////
+TiledHeightmap::~TiledHeightmap()
+{
+  this->Unmap();
+}
+
+/////////////////////////////////////////////////
+bool TiledHeightmap::Load(const std::string &_path,
+                          const heightmap::HeightmapTiling &_tiling)
+{
+  this->Unmap();
+  this->lru.clear();
+  this->resident.clear();
+
+  if (_tiling.samplesX < 2u || _tiling.samplesY < 2u ||
+      _tiling.tileSamples < 2u || _tiling.maxResidentTiles == 0u ||
+      !(_tiling.sampleSpacing > 0.0) || !(_tiling.pagingRadius >= 0.0))
+  {
+    ignerr << "Invalid tiling of height file [" << _path << "]: a terrain "
+           << "and its tiles need at least 2 samples along each axis, at "
+           << "least one tile must be resident, the sample spacing must be "
+           << "positive and the paging radius must not be negative."
+           << std::endl;
+    return false;
+  }
+
+  const std::size_t bytes =
+      _tiling.samplesX * _tiling.samplesY * sizeof(float);
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    ignerr << "Unable to open height file [" << _path << "]" << std::endl;
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) ||
+      static_cast<std::size_t>(fileSize.QuadPart) < bytes)
+  {
+    ignerr << "Height file [" << _path << "] holds fewer than the "
+           << _tiling.samplesX * _tiling.samplesY << " samples of its tiling"
+           << std::endl;
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE fileMapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  void *data = fileMapping ?
+      MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, bytes) : nullptr;
+  if (!data)
+  {
+    ignerr << "Unable to map height file [" << _path << "]" << std::endl;
+    if (fileMapping)
+      CloseHandle(fileMapping);
+    return false;
+  }
+  this->mapping = fileMapping;
+#else
+  const int fd = ::open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    ignerr << "Unable to open height file [" << _path << "]" << std::endl;
+    return false;
+  }
+
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0 ||
+      static_cast<std::size_t>(fileStat.st_size) < bytes)
+  {
+    ignerr << "Height file [" << _path << "] holds fewer than the "
+           << _tiling.samplesX * _tiling.samplesY << " samples of its tiling"
+           << std::endl;
+    ::close(fd);
+    return false;
+  }
+
+  // The mapping keeps the file open, so the descriptor can be closed
+  void *data = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    ignerr << "Unable to map height file [" << _path << "]" << std::endl;
+    return false;
+  }
+#endif
+
+  this->samples = static_cast<const float *>(data);
+  this->mappedBytes = bytes;
+  this->tiling = _tiling;
+  this->tilesX = (_tiling.samplesX - 2u) / (_tiling.tileSamples - 1u) + 1u;
+  this->tilesY = (_tiling.samplesY - 2u) / (_tiling.tileSamples - 1u) + 1u;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::TileCountX() const
+{
+  return this->tilesX;
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::TileCountY() const
+{
+  return this->tilesY;
+}
+
+/////////////////////////////////////////////////
+void TiledHeightmap::Page(const std::vector<Eigen::AlignedBox3d> &_boxes,
+                          std::vector<std::size_t> &_load,
+                          std::vector<std::size_t> &_evict)
+{
+  _load.clear();
+  _evict.clear();
+  if (!this->samples)
+    return;
+
+  const double spacing = this->tiling.sampleSpacing;
+  const double radius = this->tiling.pagingRadius;
+  const double tileLength =
+      static_cast<double>(this->tiling.tileSamples - 1u) * spacing;
+  const double lengthX =
+      static_cast<double>(this->tiling.samplesX - 1u) * spacing;
+  const double lengthY =
+      static_cast<double>(this->tiling.samplesY - 1u) * spacing;
+
+  // Range of tiles along one axis that overlap [_min, _max], measured from the
+  // edge of the terrain. Returns false if the range misses the terrain.
+  auto tileRange = [tileLength](double _min, double _max, double _length,
+                                std::size_t _tiles,
+                                std::size_t &_first, std::size_t &_last)
+  {
+    if (_max < 0.0 || _min > _length)
+      return false;
+    _first = static_cast<std::size_t>(std::floor(
+        std::max(_min, 0.0) / tileLength));
+    _last = std::min(static_cast<std::size_t>(std::floor(
+        std::min(_max, _length) / tileLength)), _tiles - 1u);
+    return true;
+  };
+
+  std::vector<std::size_t> needed;
+  for (const Eigen::AlignedBox3d &box : _boxes)
+  {
+    if (box.isEmpty())
+      continue;
+
+    // Extent of the box measured from the corner of the terrain
+    const double minX = box.min().x() + 0.5 * lengthX;
+    const double maxX = box.max().x() + 0.5 * lengthX;
+    const double minY = box.min().y() + 0.5 * lengthY;
+    const double maxY = box.max().y() + 0.5 * lengthY;
+
+    std::size_t firstX, lastX, firstY, lastY;
+    if (!tileRange(minX - radius, maxX + radius, lengthX, this->tilesX,
+                   firstX, lastX) ||
+        !tileRange(minY - radius, maxY + radius, lengthY, this->tilesY,
+                   firstY, lastY))
+    {
+      continue;
+    }
+
+    for (std::size_t j = firstY; j <= lastY; ++j)
+    {
+      for (std::size_t i = firstX; i <= lastX; ++i)
+        needed.push_back(j * this->tilesX + i);
+    }
+  }
+  std::sort(needed.begin(), needed.end());
+  needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+
+  // Move the needed tiles to the front, so the tiles at the back are the
+  // least recently needed ones
+  for (const std::size_t tile : needed)
+  {
+    auto it = this->resident.find(tile);
+    if (it != this->resident.end())
+    {
+      this->lru.splice(this->lru.begin(), this->lru, it->second);
+    }
+    else
+    {
+      this->lru.push_front(tile);
+      this->resident[tile] = this->lru.begin();
+      _load.push_back(tile);
+    }
+  }
+
+  while (this->resident.size() > this->tiling.maxResidentTiles &&
+         this->resident.size() > needed.size())
+  {
+    const std::size_t tile = this->lru.back();
+    this->lru.pop_back();
+    this->resident.erase(tile);
+    _evict.push_back(tile);
+  }
+}
+
+/////////////////////////////////////////////////
+Eigen::Vector2d TiledHeightmap::Size() const
+{
+  return Eigen::Vector2d(
+      static_cast<double>(this->tiling.samplesX - 1u),
+      static_cast<double>(this->tiling.samplesY - 1u)) *
+      this->tiling.sampleSpacing;
+}
+
+/////////////////////////////////////////////////
+void TiledHeightmap::EvictAll(std::vector<std::size_t> &_evict)
+{
+  _evict.assign(this->lru.begin(), this->lru.end());
+  this->lru.clear();
+  this->resident.clear();
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::ResidentTileCount() const
+{
+  return this->resident.size();
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<dart::dynamics::HeightmapShape<float>>
+TiledHeightmap::TileShape(const std::size_t _tile) const
+{
+  std::size_t firstX, countX, firstY, countY;
+  this->TileSamples(_tile % this->tilesX, this->tiling.samplesX,
+                    firstX, countX);
+  this->TileSamples(_tile / this->tilesX, this->tiling.samplesY,
+                    firstY, countY);
+
+  // Rows of the height file go along +y, but dartsim expects the rows of a
+  // height field to go along -y, so the rows of the tile are reversed
+  std::vector<float> heights(countX * countY);
+  for (std::size_t row = 0; row < countY; ++row)
+  {
+    const float *source =
+        this->samples + (firstY + row) * this->tiling.samplesX + firstX;
+    std::copy(source, source + countX,
+              heights.begin() + (countY - 1u - row) * countX);
+  }
+
+  using HeightmapShape = dart::dynamics::HeightmapShape<float>;
+  auto shape = std::make_shared<HeightmapShape>();
+  shape->setHeightField(countX, countY, heights);
+  shape->setScale(HeightmapShape::Vector3(
+      static_cast<float>(this->tiling.sampleSpacing),
+      static_cast<float>(this->tiling.sampleSpacing), 1.0f));
+  return shape;
+}
+
+/////////////////////////////////////////////////
+Eigen::Vector3d TiledHeightmap::TileCenter(const std::size_t _tile) const
+{
+  std::size_t firstX, countX, firstY, countY;
+  this->TileSamples(_tile % this->tilesX, this->tiling.samplesX,
+                    firstX, countX);
+  this->TileSamples(_tile / this->tilesX, this->tiling.samplesY,
+                    firstY, countY);
+
+  const double spacing = this->tiling.sampleSpacing;
+  return Eigen::Vector3d(
+      (static_cast<double>(firstX) + 0.5 * static_cast<double>(countX - 1u) -
+       0.5 * static_cast<double>(this->tiling.samplesX - 1u)) * spacing,
+      (static_cast<double>(firstY) + 0.5 * static_cast<double>(countY - 1u) -
+       0.5 * static_cast<double>(this->tiling.samplesY - 1u)) * spacing,
+      0.0);
+}
+
+/////////////////////////////////////////////////
+std::string TiledHeightmap::TileSuffix(const std::size_t _tile) const
+{
+  return "_" + std::to_string(_tile % this->tilesX) + "_" +
+      std::to_string(_tile / this->tilesX);
+}
+
+/////////////////////////////////////////////////
+void TiledHeightmap::TileSamples(const std::size_t _index,
+                                 const std::size_t _samples,
+                                 std::size_t &_first,
+                                 std::size_t &_count) const
+{
+  _first = _index * (this->tiling.tileSamples - 1u);
+  _count = std::min(this->tiling.tileSamples, _samples - _first);
+}
+
+/////////////////////////////////////////////////
+void TiledHeightmap::Unmap()
+{
+  if (!this->samples)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(this->samples);
+  CloseHandle(this->mapping);
+  this->mapping = nullptr;
+#else
+  ::munmap(const_cast<float *>(this->samples), this->mappedBytes);
+#endif
+  this->samples = nullptr;
+  this->mappedBytes = 0u;
+}
+}
+}
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_DARTSIM_SRC_TILEDHEIGHTMAP_HH_
+#define IGNITION_PHYSICS_DARTSIM_SRC_TILEDHEIGHTMAP_HH_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <dart/dynamics/HeightmapShape.hpp>
+
+#include <ignition/physics/heightmap/TiledHeightmapShape.hh>
+
+namespace ignition {
+namespace physics {
+namespace dartsim {
+
+/// \brief Terrain read from a memory-mapped height file and split into tiles
+/// that are made resident on demand. This class decides which tiles are
+/// resident and builds their shapes. Attaching the shapes to a link is up to
+/// the caller.
+class TiledHeightmap
+{
+  /// \brief Constructor
+  public: TiledHeightmap() = default;
+
+  /// \brief Destructor. Unmaps the height file.
+  public: ~TiledHeightmap();
+
+  public: TiledHeightmap(const TiledHeightmap &) = delete;
+  public: TiledHeightmap &operator=(const TiledHeightmap &) = delete;
+
+  /// \brief Map a height file
+  /// \param[in] _path Path of the height file
+  /// \param[in] _tiling Layout of the height file and its tiles
+  /// \return True if the layout is valid and the file holds every sample
+  public: bool Load(const std::string &_path,
+                    const heightmap::HeightmapTiling &_tiling);
+
+  /// \brief Number of tiles along the x axis
+  public: std::size_t TileCountX() const;
+
+  /// \brief Number of tiles along the y axis
+  public: std::size_t TileCountY() const;
+
+  /// \brief Update which tiles are resident
+  /// \param[in] _boxes Bounding boxes in the frame of the terrain that need
+  /// the tiles under and around them
+  /// \param[out] _load Tiles that became resident
+  /// \param[out] _evict Tiles that were evicted
+  public: void Page(const std::vector<Eigen::AlignedBox3d> &_boxes,
+                    std::vector<std::size_t> &_load,
+                    std::vector<std::size_t> &_evict);
+
+  /// \brief Length of the terrain along the x and y axes
+  public: Eigen::Vector2d Size() const;
+
+  /// \brief Evict every tile
+  /// \param[out] _evict Tiles that were evicted
+  public: void EvictAll(std::vector<std::size_t> &_evict);
+
+  /// \brief Number of resident tiles
+  public: std::size_t ResidentTileCount() const;
+
+  /// \brief Build the shape of a tile from the height file
+  /// \param[in] _tile Index of the tile
+  /// \return Shape of the tile, centered on the tile like the heightmap
+  /// shapes of dartsim
+  public: std::shared_ptr<dart::dynamics::HeightmapShape<float>> TileShape(
+      std::size_t _tile) const;
+
+  /// \brief Position of the center of a tile in the frame of the terrain
+  /// \param[in] _tile Index of the tile
+  public: Eigen::Vector3d TileCenter(std::size_t _tile) const;
+
+  /// \brief Suffix of the name of a tile, "_<column>_<row>"
+  /// \param[in] _tile Index of the tile
+  public: std::string TileSuffix(std::size_t _tile) const;
+
+  /// \brief First sample and number of samples of a tile along one axis
+  /// \param[in] _index Index of the tile along the axis
+  /// \param[in] _samples Number of samples along the axis
+  /// \param[out] _first First sample of the tile
+  /// \param[out] _count Number of samples of the tile
+  private: void TileSamples(std::size_t _index, std::size_t _samples,
+                            std::size_t &_first, std::size_t &_count) const;
+
+  /// \brief Unmap the height file
+  private: void Unmap();
+
+  /// \brief Layout of the height file
+  private: heightmap::HeightmapTiling tiling;
+
+  /// \brief Mapped samples of the height file
+  private: const float *samples = nullptr;
+
+  /// \brief Number of mapped bytes
+  private: std::size_t mappedBytes = 0u;
+
+#ifdef _WIN32
+  /// \brief Handle of the file mapping
+  private: void *mapping = nullptr;
+#endif
+
+  /// \brief Number of tiles along the x axis
+  private: std::size_t tilesX = 0u;
+
+  /// \brief Number of tiles along the y axis
+  private: std::size_t tilesY = 0u;
+
+  /// \brief Resident tiles, the most recently needed first
+  private: std::list<std::size_t> lru;
+
+  /// \brief Map from a resident tile to its position in lru
+  private: std::unordered_map<std::size_t, std::list<std::size_t>::iterator>
+      resident;
+};
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_DARTSIM_SRC_TILEDHEIGHTMAP_HH_
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_HEIGHTMAP_TILEDHEIGHTMAPSHAPE_HH_
+#define IGNITION_PHYSICS_HEIGHTMAP_TILEDHEIGHTMAPSHAPE_HH_
+
+#include <cstddef>
+#include <string>
+
+#include <ignition/physics/heightmap/HeightmapShape.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace heightmap
+{
+  /////////////////////////////////////////////////
+  /// \brief Layout of a height file and how its terrain is split into tiles.
+  ///
+  /// A height file holds samplesX * samplesY native-endian 32-bit floats in
+  /// row-major order, with rows along the y axis. Each value is the height in
+  /// meters of one sample, and neighboring samples are sampleSpacing meters
+  /// apart. The terrain is centered on the origin of its pose.
+  struct HeightmapTiling
+  {
+    /// \brief Number of samples along the x axis.
+    std::size_t samplesX = 0u;
+
+    /// \brief Number of samples along the y axis.
+    std::size_t samplesY = 0u;
+
+    /// \brief Distance in meters between neighboring samples.
+    double sampleSpacing = 1.0;
+
+    /// \brief Number of samples along each side of a tile. Neighboring tiles
+    /// share the samples of their common edge, so that the terrain has no
+    /// gaps.
+    std::size_t tileSamples = 257u;
+
+    /// \brief Most tiles that are kept resident. When more tiles are needed,
+    /// the least recently needed tiles are evicted first. Tiles needed by the
+    /// current step are never evicted, so this limit may be exceeded when the
+    /// bodies are spread farther apart than the limit allows.
+    std::size_t maxResidentTiles = 64u;
+
+    /// \brief Tiles that are within this horizontal distance in meters of
+    /// the bounding box of a link that is not static are made resident.
+    double pagingRadius = 50.0;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Attach terrain that is too large to be held as one heightmap
+  /// shape to a link. The terrain is read from a memory-mapped height file
+  /// and split into tiles. Only the tiles near links that are not static are
+  /// resident. Each resident tile is a heightmap shape of the link, named
+  /// "<name>_<column>_<row>", so tiles appear and disappear as the
+  /// simulation steps. The terrain itself is a heightmap shape named
+  /// "<name>" that spans the whole terrain at height zero and does not
+  /// collide.
+  class AttachTiledHeightmapShapeFeature
+      : public virtual FeatureWithRequirements<AttachHeightmapShapeFeature>
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Link : public virtual Feature::Link<PolicyT, FeaturesT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using ShapePtrType = HeightmapShapePtr<PolicyT, FeaturesT>;
+
+      /// \brief Attach tiled terrain to a link. No tile is resident until
+      /// the world is stepped.
+      /// \param[in] _name Name of the terrain, used as the prefix of the
+      /// names of its tiles.
+      /// \param[in] _heightFile Path of the height file.
+      /// \param[in] _tiling Layout of the height file and its tiles.
+      /// \param[in] _pose Pose of the center of the terrain in the link frame.
+      /// \return The shape of the whole terrain, or nullptr if the height
+      /// file could not be mapped.
+      public: ShapePtrType AttachTiledHeightmapShape(
+          const std::string &_name,
+          const std::string &_heightFile,
+          const HeightmapTiling &_tiling,
+          const PoseType &_pose);
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: virtual Identity AttachTiledHeightmapShape(
+          const Identity &_linkID,
+          const std::string &_name,
+          const std::string &_heightFile,
+          const HeightmapTiling &_tiling,
+          const PoseType &_pose) = 0;
+    };
+  };
+}
+}
+}
+
+#include <ignition/physics/heightmap/detail/TiledHeightmapShape.hh>
+
+#endif  // IGNITION_PHYSICS_HEIGHTMAP_TILEDHEIGHTMAPSHAPE_HH_
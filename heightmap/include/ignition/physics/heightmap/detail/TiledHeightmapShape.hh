@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_HEIGHTMAP_DETAIL_TILEDHEIGHTMAPSHAPE_HH_
+#define IGNITION_PHYSICS_HEIGHTMAP_DETAIL_TILEDHEIGHTMAPSHAPE_HH_
+
+#include <string>
+
+#include <ignition/physics/heightmap/TiledHeightmapShape.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace heightmap
+{
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  auto AttachTiledHeightmapShapeFeature::Link<PolicyT, FeaturesT>::
+      AttachTiledHeightmapShape(
+      const std::string &_name,
+      const std::string &_heightFile,
+      const HeightmapTiling &_tiling,
+      const PoseType &_pose) -> ShapePtrType
+  {
+    return ShapePtrType(this->pimpl,
+          this->template Interface<AttachTiledHeightmapShapeFeature>()
+              ->AttachTiledHeightmapShape(this->identity, _name, _heightFile,
+              _tiling, _pose));
+  }
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_HEIGHTMAP_DETAIL_TILEDHEIGHTMAPSHAPE_HH_
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_PHYSICS_BATCHEDWORLDS_HH_
+#define IGNITION_PHYSICS_BATCHEDWORLDS_HH_
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+#include <ignition/physics/FeatureList.hh>
+
+namespace ignition
+{
+namespace physics
+{
+/// \brief Matrix that holds one row of generalized coordinates per world of
+/// a batch. Rows are contiguous in memory, so the matrix of a batch of K
+/// worlds with N degrees of freedom each is a single K x N buffer.
+template <typename PolicyT>
+using BatchMatrix = Eigen::Matrix<typename PolicyT::Scalar,
+    Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/////////////////////////////////////////////////
+/// \brief BatchedWorldStateFeature reads and writes the generalized positions
+/// and velocities of a batch of worlds in a single call, instead of one call
+/// per degree of freedom of each world. A batch is a contiguous range of
+/// worlds of the engine that have the same number of degrees of freedom,
+/// such as the replicas created by sdf::ConstructSdfWorldReplicas.
+///
+/// The generalized coordinates of a world are the degrees of freedom of its
+/// models, in the order that the models were added to the world. The layout
+/// of the coordinates of a model is defined by the physics engine, and is
+/// the same for every replica of a world.
+class IGNITION_PHYSICS_VISIBLE BatchedWorldStateFeature
+    : public virtual Feature
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+  {
+    public: using BatchMatrixType = BatchMatrix<PolicyT>;
+
+    /// \brief Get the generalized positions and velocities of a batch of
+    /// worlds
+    /// \param[in] _firstWorld Index of the first world of the batch
+    /// \param[in] _worldCount Number of worlds in the batch
+    /// \param[out] _positions Resized to _worldCount rows, one per world, and
+    /// one column per degree of freedom
+    /// \param[out] _velocities Resized like _positions
+    /// \return True if the batch exists and all of its worlds have the same
+    /// number of degrees of freedom
+    public: bool GetBatchedWorldState(
+        std::size_t _firstWorld, std::size_t _worldCount,
+        BatchMatrixType &_positions, BatchMatrixType &_velocities) const;
+
+    /// \brief Set the generalized positions and velocities of a batch of
+    /// worlds, e.g. to reset some of them
+    /// \param[in] _firstWorld Index of the first world of the batch
+    /// \param[in] _worldCount Number of worlds in the batch
+    /// \param[in] _positions One row per world and one column per degree of
+    /// freedom
+    /// \param[in] _velocities Same size as _positions
+    /// \return True if the batch exists and the matrices match its size
+    public: bool SetBatchedWorldState(
+        std::size_t _firstWorld, std::size_t _worldCount,
+        const BatchMatrixType &_positions,
+        const BatchMatrixType &_velocities);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using BatchMatrixType = BatchMatrix<PolicyT>;
+
+    public: virtual bool GetBatchedWorldState(
+        const Identity &_engineID,
+        std::size_t _firstWorld, std::size_t _worldCount,
+        BatchMatrixType &_positions, BatchMatrixType &_velocities) const = 0;
+
+    public: virtual bool SetBatchedWorldState(
+        const Identity &_engineID,
+        std::size_t _firstWorld, std::size_t _worldCount,
+        const BatchMatrixType &_positions,
+        const BatchMatrixType &_velocities) = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+/// \brief BatchedWorldForcesFeature reads and writes the generalized forces
+/// of a batch of worlds in a single call. See BatchedWorldStateFeature for
+/// the definition of a batch and of its degrees of freedom. Forces that are
+/// set are applied during the next step.
+class IGNITION_PHYSICS_VISIBLE BatchedWorldForcesFeature
+    : public virtual FeatureWithRequirements<BatchedWorldStateFeature>
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+  {
+    public: using BatchMatrixType = BatchMatrix<PolicyT>;
+
+    /// \brief Get the generalized forces of a batch of worlds
+    /// \param[in] _firstWorld Index of the first world of the batch
+    /// \param[in] _worldCount Number of worlds in the batch
+    /// \param[out] _forces Resized to _worldCount rows, one per world, and
+    /// one column per degree of freedom
+    /// \return True if the batch exists and all of its worlds have the same
+    /// number of degrees of freedom
+    public: bool GetBatchedWorldForces(
+        std::size_t _firstWorld, std::size_t _worldCount,
+        BatchMatrixType &_forces) const;
+
+    /// \brief Set the generalized forces of a batch of worlds
+    /// \param[in] _firstWorld Index of the first world of the batch
+    /// \param[in] _worldCount Number of worlds in the batch
+    /// \param[in] _forces One row per world and one column per degree of
+    /// freedom
+    /// \return True if the batch exists and the matrix matches its size
+    public: bool SetBatchedWorldForces(
+        std::size_t _firstWorld, std::size_t _worldCount,
+        const BatchMatrixType &_forces);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using BatchMatrixType = BatchMatrix<PolicyT>;
+
+    public: virtual bool GetBatchedWorldForces(
+        const Identity &_engineID,
+        std::size_t _firstWorld, std::size_t _worldCount,
+        BatchMatrixType &_forces) const = 0;
+
+    public: virtual bool SetBatchedWorldForces(
+        const Identity &_engineID,
+        std::size_t _firstWorld, std::size_t _worldCount,
+        const BatchMatrixType &_forces) = 0;
+  };
+};
+}
+}
+
+#include "ignition/physics/detail/BatchedWorlds.hh"
+
+#endif
@@ -184,6 +184,49 @@ namespace ignition
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief ForwardStepWorlds is a feature that steps all the worlds of an
+    /// engine forward in time at once. Worlds are independent, so physics
+    /// engines may step them in parallel. This is useful to pack many small
+    /// environments into one process, e.g. for reinforcement learning.
+    class ForwardStepWorlds : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: using Input = ForwardStep::Input;
+      public: using Output = ForwardStep::Output;
+      public: using State = ForwardStep::State;
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Step every world of the engine forward in time. Each world
+        /// writes to its own output and state, so the result is the same as
+        /// stepping the worlds one after the other. Entities must not be
+        /// created or removed while the worlds are stepping.
+        /// \param[out] _h Output of each world, resized to the number of
+        /// worlds and in the same order as GetWorld(index).
+        /// \param[in,out] _x State of each world, resized like _h.
+        /// \param[in] _u Input of each world, in the same order as
+        /// GetWorld(index). Worlds without an input use a default input.
+        public: void StepWorlds(std::vector<Output> &_h,
+                                std::vector<State> &_x,
+                                const std::vector<Input> &_u)
+        {
+          this->template Interface<ForwardStepWorlds>()->
+              EngineForwardStepWorlds(this->identity, _h, _x, _u);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void EngineForwardStepWorlds(
+            const Identity &_engineID,
+            std::vector<Output> &_h,
+            std::vector<State> &_x,
+            const std::vector<Input> &_u) = 0;
+      };
+    };
+
     // ---------------- SetState Interface -----------------
     // class SetState
     // {
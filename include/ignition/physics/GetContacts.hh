@@ -100,6 +100,66 @@ class IGNITION_PHYSICS_VISIBLE GetContactsFromLastStepFeature
         const Identity &_worldID) const = 0;
   };
 };
+
+/// \brief GetContactBufferFromLastStepFeature is a feature for filling a
+/// caller-owned buffer with the contacts generated in the previous simulation
+/// step. Unlike GetContactsFromLastStepFeature, each contact is a plain struct
+/// that refers to its shapes by entity ID, so a buffer that is reused across
+/// steps does not allocate memory once it holds enough contacts.
+class IGNITION_PHYSICS_VISIBLE GetContactBufferFromLastStepFeature
+    : public virtual FeatureWithRequirements<ForwardStep>
+{
+  public: template <typename PolicyT>
+  struct ContactDataT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+
+    /// \brief Entity ID of the collision shape of the first body. This can
+    /// be compared against the EntityID() of a shape.
+    std::size_t shape1 = 0u;
+    /// \brief Entity ID of the collision shape of the second body
+    std::size_t shape2 = 0u;
+    /// \brief The point of contact expressed in the world frame
+    VectorType point = VectorType::Zero();
+    /// \brief The normal of the force acting on the first body expressed
+    /// in the world frame. Zero if the engine does not compute normals.
+    VectorType normal = VectorType::Zero();
+    /// \brief The contact force acting on the first body expressed in the
+    /// world frame. Zero if the engine does not compute contact forces.
+    VectorType force = VectorType::Zero();
+    /// \brief The penetration depth
+    Scalar depth = 0;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ContactData = ContactDataT<PolicyT>;
+
+    /// \brief Fill a buffer with the contacts generated in the previous
+    /// simulation step. The buffer is cleared first but keeps its capacity,
+    /// so reuse the same buffer every step to avoid allocations.
+    /// \param[out] _contacts Buffer to fill with contacts
+    public: void GetContactBufferFromLastStep(
+        std::vector<ContactData> &_contacts) const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using ContactData = ContactDataT<PolicyT>;
+
+    /// \brief Implementation API for filling a buffer with the contacts
+    /// generated in the previous simulation step
+    /// \param[in] _worldID Identity of the world
+    /// \param[out] _contacts Buffer to fill with contacts. Implementations
+    /// must clear the buffer before filling it.
+    public: virtual void GetContactBufferFromLastStep(
+        const Identity &_worldID,
+        std::vector<ContactData> &_contacts) const = 0;
+  };
+};
 }
 }
 
@@ -584,6 +584,81 @@ namespace ignition
       };
     };
 
+
+    /////////////////////////////////////////////////
+    /// \brief This feature retrieves the generalized positions and
+    /// velocities of every degree of freedom of the joints of a model in a
+    /// single call, instead of one call per degree of freedom. The degrees of
+    /// freedom are in the order of the joints of the model, GetJoint(index),
+    /// and then in the order of the degrees of freedom within each joint.
+    class IGNITION_PHYSICS_VISIBLE GetModelJointStates
+        : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using JointVector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Get the generalized positions and velocities of every
+        /// degree of freedom of the joints of this model.
+        /// \param[out] _positions
+        ///   Resized to the number of degrees of freedom of the joints of this
+        ///   model, and filled with their generalized positions.
+        /// \param[out] _velocities
+        ///   Resized like _positions, and filled with the generalized
+        ///   velocities.
+        public: void GetJointStates(
+            JointVector &_positions, JointVector &_velocities) const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using JointVector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        // see Model::GetJointStates above
+        public: virtual void GetModelJointStates(
+            const Identity &_modelID,
+            JointVector &_positions, JointVector &_velocities) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature sets the generalized force of every degree of
+    /// freedom of the joints of a model in a single call. The degrees of
+    /// freedom are in the same order as GetModelJointStates.
+    class IGNITION_PHYSICS_VISIBLE SetModelJointForces
+        : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using JointVector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Set the generalized force of every degree of freedom of the
+        /// joints of this model. This is equivalent to calling
+        /// Joint::SetForce on each degree of freedom.
+        /// \param[in] _forces
+        ///   One generalized force per degree of freedom. The forces are
+        ///   ignored if the size does not match the number of degrees of
+        ///   freedom, or if any of them is not finite.
+        public: void SetJointForces(const JointVector &_forces);
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using JointVector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        // see Model::SetJointForces above
+        public: virtual void SetModelJointForces(
+            const Identity &_modelID, const JointVector &_forces) = 0;
+      };
+    };
   }
 }
 
@@ -19,6 +19,7 @@
 #define IGNITION_PHYSICS_REMOVEENTITIES_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/physics/FeatureList.hh>
 
@@ -109,6 +110,35 @@ namespace ignition
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief This feature removes many Model entities from a World at once.
+    /// Plugins can share the bookkeeping of the removal across the whole
+    /// batch, which is much faster than calling RemoveModel for each model
+    /// when removing thousands of models.
+    class IGNITION_PHYSICS_VISIBLE RemoveModelsFromWorld
+        : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Remove Models that exist within this World. Names that do
+        /// not match a model of this world are skipped.
+        /// \param[in] _names
+        ///   Names of the models within this world.
+        /// \return Number of models that were found and removed.
+        public: std::size_t RemoveModels(
+            const std::vector<std::string> &_names);
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual std::size_t RemoveModelsByName(
+            const Identity &_worldID,
+            const std::vector<std::string> &_modelNames) = 0;
+      };
+    };
+
     using RemoveEntities = FeatureList<
       RemoveModelFromWorld,
       RemoveNestedModelFromModel
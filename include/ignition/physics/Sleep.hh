@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_PHYSICS_SLEEP_HH_
+#define IGNITION_PHYSICS_SLEEP_HH_
+
+#include <cstddef>
+
+#include <ignition/physics/FeatureList.hh>
+
+namespace ignition
+{
+namespace physics
+{
+/// \brief SetSleepThresholdsFeature sets how slowly bodies must move before
+/// they may go to sleep. A body whose linear and angular speeds stay below
+/// both thresholds for a while is put to sleep, and stepping a world skips
+/// the bodies that sleep until something touches them or a command moves
+/// them. Thresholds of zero keep bodies awake.
+class IGNITION_PHYSICS_VISIBLE SetSleepThresholdsFeature
+    : public virtual Feature
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+
+    /// \brief Set the sleep thresholds of every body in this world, and of
+    /// the bodies that are added to it later.
+    /// \param[in] _linearSpeed Linear speed threshold in m/s
+    /// \param[in] _angularSpeed Angular speed threshold in rad/s
+    public: void SetSleepThresholds(Scalar _linearSpeed, Scalar _angularSpeed);
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+
+    /// \brief Set the sleep thresholds of the bodies of this model, in place
+    /// of those of its world.
+    /// \param[in] _linearSpeed Linear speed threshold in m/s
+    /// \param[in] _angularSpeed Angular speed threshold in rad/s
+    public: void SetSleepThresholds(Scalar _linearSpeed, Scalar _angularSpeed);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+
+    public: virtual void SetWorldSleepThresholds(
+        const Identity &_worldID,
+        Scalar _linearSpeed,
+        Scalar _angularSpeed) = 0;
+
+    public: virtual void SetModelSleepThresholds(
+        const Identity &_modelID,
+        Scalar _linearSpeed,
+        Scalar _angularSpeed) = 0;
+  };
+};
+
+/// \brief GetSleepStatisticsFeature counts the bodies of a world that are
+/// awake and those that sleep.
+class IGNITION_PHYSICS_VISIBLE GetSleepStatisticsFeature
+    : public virtual Feature
+{
+  /// \brief Number of bodies of a world by sleep state
+  public: struct SleepStatistics
+  {
+    /// \brief Bodies that are simulated when the world is stepped
+    std::size_t activeBodies = 0u;
+
+    /// \brief Bodies that sleep, so stepping the world skips them
+    std::size_t sleepingBodies = 0u;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    /// \brief Count the bodies of this world that are awake and those that
+    /// sleep. Static bodies are not counted.
+    public: SleepStatistics GetSleepStatistics() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual SleepStatistics GetSleepStatistics(
+        const Identity &_worldID) const = 0;
+  };
+};
+}
+}
+
+#include "ignition/physics/detail/Sleep.hh"
+
+#endif /* end of include guard: IGNITION_PHYSICS_SLEEP_HH_ */
@@ -18,6 +18,7 @@
 #ifndef IGNITION_PHYSICS_WORLD_HH_
 #define IGNITION_PHYSICS_WORLD_HH_
 
+#include <cstddef>
 #include <string>
 
 #include <ignition/physics/FeatureList.hh>
@@ -163,6 +164,44 @@ namespace ignition
             const Identity &_id) const = 0;
       };
     };
+
+    /////////////////////////////////////////////////
+    class IGNITION_PHYSICS_VISIBLE ThreadCount : public virtual Feature
+    {
+      /// \brief The World API for setting the number of threads that step
+      /// the world.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the number of threads that step the world. Only
+        /// multithreaded solvers use more than one thread.
+        /// \param[in] _threads Number of threads, or 0 for as many as the
+        /// engine supports.
+        public: void SetThreadCount(std::size_t _threads);
+
+        /// \brief Get the number of threads that step the world.
+        /// \return Number of threads.
+        public: std::size_t GetThreadCount() const;
+      };
+
+      /// \private The implementation API for the number of threads.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the number of threads.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _threads Number of threads, or 0 for as many as the
+        /// engine supports.
+        public: virtual void SetWorldThreadCount(
+            const Identity &_id, std::size_t _threads) = 0;
+
+        /// \brief Implementation API for getting the number of threads.
+        /// \param[in] _id Identity of the world.
+        /// \return Number of threads.
+        public: virtual std::size_t GetWorldThreadCount(
+            const Identity &_id) const = 0;
+      };
+    };
   }
 }
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_PHYSICS_DETAIL_BATCHEDWORLDS_HH_
+#define IGNITION_PHYSICS_DETAIL_BATCHEDWORLDS_HH_
+
+#include <ignition/physics/BatchedWorlds.hh>
+
+namespace ignition
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool BatchedWorldStateFeature::Engine<PolicyT, FeaturesT>::
+GetBatchedWorldState(
+    std::size_t _firstWorld, std::size_t _worldCount,
+    BatchMatrixType &_positions, BatchMatrixType &_velocities) const
+{
+  return this->template Interface<BatchedWorldStateFeature>()
+      ->GetBatchedWorldState(this->identity, _firstWorld, _worldCount,
+                             _positions, _velocities);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool BatchedWorldStateFeature::Engine<PolicyT, FeaturesT>::
+SetBatchedWorldState(
+    std::size_t _firstWorld, std::size_t _worldCount,
+    const BatchMatrixType &_positions, const BatchMatrixType &_velocities)
+{
+  return this->template Interface<BatchedWorldStateFeature>()
+      ->SetBatchedWorldState(this->identity, _firstWorld, _worldCount,
+                             _positions, _velocities);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool BatchedWorldForcesFeature::Engine<PolicyT, FeaturesT>::
+GetBatchedWorldForces(
+    std::size_t _firstWorld, std::size_t _worldCount,
+    BatchMatrixType &_forces) const
+{
+  return this->template Interface<BatchedWorldForcesFeature>()
+      ->GetBatchedWorldForces(this->identity, _firstWorld, _worldCount,
+                              _forces);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool BatchedWorldForcesFeature::Engine<PolicyT, FeaturesT>::
+SetBatchedWorldForces(
+    std::size_t _firstWorld, std::size_t _worldCount,
+    const BatchMatrixType &_forces)
+{
+  return this->template Interface<BatchedWorldForcesFeature>()
+      ->SetBatchedWorldForces(this->identity, _firstWorld, _worldCount,
+                              _forces);
+}
+
+}
+}
+
+#endif
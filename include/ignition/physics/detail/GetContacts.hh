@@ -67,6 +67,16 @@ auto GetContactsFromLastStepFeature::World<
   return output;
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void GetContactBufferFromLastStepFeature::World<
+    PolicyT, FeaturesT>::GetContactBufferFromLastStep(
+    std::vector<ContactData> &_contacts) const
+{
+  this->template Interface<GetContactBufferFromLastStepFeature>()
+      ->GetContactBufferFromLastStep(this->identity, _contacts);
+}
+
 }  // namespace physics
 }  // namespace ignition
 
@@ -245,6 +245,24 @@ namespace ignition
           RelativeWrench(this->GetFrameID(), this->GetTransmittedWrench()),
           _relativeTo, _inCoordinatesOf);
     }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void GetModelJointStates::Model<PolicyT, FeaturesT>::GetJointStates(
+        JointVector &_positions, JointVector &_velocities) const
+    {
+      this->template Interface<GetModelJointStates>()
+          ->GetModelJointStates(this->identity, _positions, _velocities);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetModelJointForces::Model<PolicyT, FeaturesT>::SetJointForces(
+        const JointVector &_forces)
+    {
+      this->template Interface<SetModelJointForces>()
+          ->SetModelJointForces(this->identity, _forces);
+    }
   }
 }
 
@@ -19,6 +19,7 @@
 #define IGNITION_PHYSICS_DETAIL_REMOVEENTITIES_HH_
 
 #include <string>
+#include <vector>
 #include <ignition/physics/RemoveEntities.hh>
 
 namespace ignition
@@ -79,6 +80,15 @@ namespace ignition
       return this->template Interface<RemoveNestedModelFromModel>()
                           ->RemoveNestedModelByName(this->identity, _name);
     }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    std::size_t RemoveModelsFromWorld::World<PolicyT, FeaturesT>::RemoveModels(
+        const std::vector<std::string> &_names)
+    {
+      return this->template Interface<RemoveModelsFromWorld>()
+          ->RemoveModelsByName(this->identity, _names);
+    }
   }
 }
 
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_PHYSICS_DETAIL_SLEEP_HH_
+#define IGNITION_PHYSICS_DETAIL_SLEEP_HH_
+
+#include <ignition/physics/Sleep.hh>
+
+namespace ignition
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SetSleepThresholdsFeature::World<PolicyT, FeaturesT>::SetSleepThresholds(
+    Scalar _linearSpeed, Scalar _angularSpeed)
+{
+  this->template Interface<SetSleepThresholdsFeature>()
+      ->SetWorldSleepThresholds(this->identity, _linearSpeed, _angularSpeed);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SetSleepThresholdsFeature::Model<PolicyT, FeaturesT>::SetSleepThresholds(
+    Scalar _linearSpeed, Scalar _angularSpeed)
+{
+  this->template Interface<SetSleepThresholdsFeature>()
+      ->SetModelSleepThresholds(this->identity, _linearSpeed, _angularSpeed);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetSleepStatisticsFeature::World<PolicyT, FeaturesT>::GetSleepStatistics()
+    const -> SleepStatistics
+{
+  return this->template Interface<GetSleepStatisticsFeature>()
+      ->GetSleepStatistics(this->identity);
+}
+
+}  // namespace physics
+}  // namespace ignition
+
+#endif
@@ -18,6 +18,7 @@
 #ifndef IGNITION_PHYSICS_DETAIL_WORLD_HH_
 #define IGNITION_PHYSICS_DETAIL_WORLD_HH_
 
+#include <cstddef>
 #include <string>
 
 #include <ignition/physics/World.hh>
@@ -117,6 +118,24 @@ const std::string &Solver::World<PolicyT, FeaturesT>::
       ->GetWorldSolver(this->identity);
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void ThreadCount::World<PolicyT, FeaturesT>::SetThreadCount(
+    const std::size_t _threads)
+{
+  this->template Interface<ThreadCount>()
+      ->SetWorldThreadCount(this->identity, _threads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::size_t ThreadCount::World<PolicyT, FeaturesT>::
+    GetThreadCount() const
+{
+  return this->template Interface<ThreadCount>()
+      ->GetWorldThreadCount(this->identity);
+}
+
 }  // namespace physics
 }  // namespace ignition
 
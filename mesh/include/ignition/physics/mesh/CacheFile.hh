@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_CACHEFILE_HH_
+#define IGNITION_PHYSICS_MESH_CACHEFILE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  /// \brief Initial value of a hash computed with HashBytes.
+  constexpr std::uint64_t kHashBytesSeed = 14695981039346656037ull;
+
+  /////////////////////////////////////////////////
+  /// \brief Add bytes to a 64 bit FNV-1a hash, to name the files in which
+  /// data converted from a mesh is cached, or to check their contents.
+  /// \param[in] _hash The hash so far, starting from kHashBytesSeed.
+  /// \param[in] _data The bytes to add.
+  /// \param[in] _size Number of bytes to add.
+  /// \return The updated hash.
+  inline std::uint64_t HashBytes(std::uint64_t _hash, const void *_data,
+                                 std::size_t _size);
+
+  /////////////////////////////////////////////////
+  /// \brief Name of a cache file.
+  /// \param[in] _hash Hash of the data that the file is converted from.
+  /// \param[in] _extension Extension of the file, without the dot.
+  /// \return The hash in hexadecimal, followed by the extension.
+  inline std::string CacheFileName(std::uint64_t _hash,
+                                   const std::string &_extension);
+
+  /////////////////////////////////////////////////
+  /// \brief Write a cache file, creating its directory if needed. The
+  /// contents are written to a temporary file that is then renamed, so that
+  /// processes that share the cache never read a partially written file.
+  /// \param[in] _path Path of the file.
+  /// \param[in] _contents Contents of the file.
+  /// \return True if the file was written.
+  inline bool WriteCacheFile(const std::string &_path,
+                             const std::string &_contents);
+}
+}
+}
+
+#include <ignition/physics/mesh/detail/CacheFile.hh>
+
+#endif  // IGNITION_PHYSICS_MESH_CACHEFILE_HH_
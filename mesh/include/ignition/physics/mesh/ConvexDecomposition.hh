@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_CONVEXDECOMPOSITION_HH_
+#define IGNITION_PHYSICS_MESH_CONVEXDECOMPOSITION_HH_
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include <ignition/common/Mesh.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  /// \brief A convex polyhedron given by its vertices and triangles.
+  struct ConvexHull
+  {
+    /// \brief Vertices of the hull.
+    std::vector<Eigen::Vector3d> vertices;
+
+    /// \brief Triangles of the hull as indices into vertices, wound
+    /// counter-clockwise when seen from outside of the hull.
+    std::vector<std::array<unsigned int, 3>> faces;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Options of ComputeConvexDecomposition.
+  struct ConvexDecompositionOptions
+  {
+    /// \brief Most convex hulls that the mesh is split into. With 1, the mesh
+    /// collides as its convex hull.
+    std::size_t maxConvexHulls = 1u;
+
+    /// \brief A part of the mesh is only split in two if the hulls of the two
+    /// halves together have at least this fraction less volume than the hull
+    /// of the part, i.e. if the split removes enough empty space.
+    double minVolumeReduction = 0.05;
+
+    /// \brief Directory in which decompositions are cached, keyed by a hash of
+    /// the mesh data and these options. If empty, the directory in the
+    /// IGN_PHYSICS_MESH_CACHE_PATH environment variable is used, and if that
+    /// is not set either, decompositions are not cached.
+    std::string cacheDirectory;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Compute the convex hull of a set of points.
+  /// \param[in] _points The points.
+  /// \return The convex hull, which has no faces if the points are fewer than
+  /// four or all lie in one plane.
+  inline ConvexHull ComputeConvexHull(
+      const std::vector<Eigen::Vector3d> &_points);
+
+  /////////////////////////////////////////////////
+  /// \brief Volume of a convex hull.
+  /// \param[in] _hull The hull.
+  /// \return Volume of the hull.
+  inline double ConvexHullVolume(const ConvexHull &_hull);
+
+  /////////////////////////////////////////////////
+  /// \brief Approximate a mesh with convex hulls, so that physics engines can
+  /// collide it with convex collision algorithms instead of testing its
+  /// triangles. Starting from the whole mesh, the part whose split removes the
+  /// most empty space is repeatedly split in two by an axis-aligned plane,
+  /// with each triangle going to the side of its centroid, until
+  /// _options.maxConvexHulls parts exist or no split removes enough space.
+  /// The hulls are in the frame of the mesh and are not scaled.
+  /// \param[in] _mesh The mesh.
+  /// \param[in] _options How far to decompose the mesh and where to cache
+  /// the result.
+  /// \return The convex hulls of the parts of the mesh, or an empty vector if
+  /// the mesh has no volume.
+  inline std::vector<ConvexHull> ComputeConvexDecomposition(
+      const common::Mesh &_mesh,
+      const ConvexDecompositionOptions &_options =
+          ConvexDecompositionOptions());
+}
+}
+}
+
+#include <ignition/physics/mesh/detail/ConvexDecomposition.hh>
+
+#endif  // IGNITION_PHYSICS_MESH_CONVEXDECOMPOSITION_HH_
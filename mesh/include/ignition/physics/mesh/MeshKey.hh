@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_MESHKEY_HH_
+#define IGNITION_PHYSICS_MESH_MESHKEY_HH_
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include <Eigen/Geometry>
+
+#include <ignition/common/Mesh.hh>
+
+#include <ignition/physics/mesh/ConvexDecomposition.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  /// \brief Key of the data that an engine plugin converts from a mesh with a
+  /// scale, to share it through a WeakValueCache. Meshes are owned by the
+  /// MeshManager, so the pointer identifies the mesh while it is loaded. The
+  /// name and path guard against another mesh being loaded at the address of
+  /// an unloaded one.
+  struct MeshKey
+  {
+    /// \brief Constructor
+    /// \param[in] _mesh The mesh.
+    /// \param[in] _scale The scale of the mesh.
+    inline MeshKey(const common::Mesh &_mesh, const Eigen::Vector3d &_scale);
+
+    /// \brief Equality operator
+    /// \param[in] _other Key to compare to.
+    /// \return True if both keys are of the same mesh and scale.
+    inline bool operator==(const MeshKey &_other) const;
+
+    /// \brief The mesh
+    const common::Mesh *mesh;
+
+    /// \brief Name of the mesh
+    std::string name;
+
+    /// \brief Path of the mesh
+    std::string path;
+
+    /// \brief Scale of the mesh
+    std::array<double, 3> scale;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Hash function of MeshKey.
+  struct MeshKeyHash
+  {
+    /// \brief Hash a key.
+    /// \param[in] _key The key.
+    /// \return Hash of the key.
+    inline std::size_t operator()(const MeshKey &_key) const;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Key of the convex hulls of a mesh with a scale. The cache
+  /// directory of the options is left out, since it does not change the
+  /// hulls.
+  struct ConvexMeshKey
+  {
+    /// \brief Constructor
+    /// \param[in] _mesh The mesh.
+    /// \param[in] _scale The scale of the mesh.
+    /// \param[in] _options How the mesh is decomposed.
+    inline ConvexMeshKey(const common::Mesh &_mesh,
+                         const Eigen::Vector3d &_scale,
+                         const ConvexDecompositionOptions &_options);
+
+    /// \brief Equality operator
+    /// \param[in] _other Key to compare to.
+    /// \return True if both keys are of the same decomposition of the same
+    /// mesh and scale.
+    inline bool operator==(const ConvexMeshKey &_other) const;
+
+    /// \brief The mesh and scale
+    MeshKey mesh;
+
+    /// \brief Most convex hulls of the decomposition, at least 1
+    std::size_t maxConvexHulls;
+
+    /// \brief Least volume reduction of a split
+    double minVolumeReduction;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Hash function of ConvexMeshKey.
+  struct ConvexMeshKeyHash
+  {
+    /// \brief Hash a key.
+    /// \param[in] _key The key.
+    /// \return Hash of the key.
+    inline std::size_t operator()(const ConvexMeshKey &_key) const;
+  };
+}
+}
+}
+
+#include <ignition/physics/mesh/detail/MeshKey.hh>
+
+#endif  // IGNITION_PHYSICS_MESH_MESHKEY_HH_
@@ -24,6 +24,7 @@
 
 #include <ignition/physics/DeclareShapeType.hh>
 #include <ignition/physics/Geometry.hh>
+#include <ignition/physics/mesh/ConvexDecomposition.hh>
 
 namespace ignition
 {
@@ -130,6 +131,62 @@ namespace mesh
           const Dimensions &_scale) = 0;
     };
   };
+
+  /////////////////////////////////////////////////
+  /// \brief Attach a mesh shape that collides as its convex hull or as an
+  /// approximate convex decomposition instead of as a set of triangles. This
+  /// makes contacts with the mesh much cheaper, at the cost of filling in its
+  /// concave regions. See ComputeConvexDecomposition.
+  class AttachConvexMeshShapeFeature
+      : public virtual FeatureWithRequirements<AttachMeshShapeFeature>
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Link : public virtual Feature::Link<PolicyT, FeaturesT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: using ShapePtrType = MeshShapePtr<PolicyT, FeaturesT>;
+
+      /// \brief Attach a mesh shape that collides as convex hulls.
+      /// \param[in] _name Shape's name.
+      /// \param[in] _mesh The mesh.
+      /// \param[in] _pose Pose of the mesh in the link frame.
+      /// \param[in] _scale Scale of the mesh.
+      /// \param[in] _options How many convex hulls to split the mesh into and
+      /// where to cache them. By default the mesh collides as its convex hull.
+      /// \return The shape, which collides as triangles if the mesh has no
+      /// volume.
+      public: ShapePtrType AttachConvexMeshShape(
+          const std::string &_name,
+          const ignition::common::Mesh &_mesh,
+          const PoseType &_pose = PoseType::Identity(),
+          const Dimensions &_scale = Dimensions::Ones(),
+          const ConvexDecompositionOptions &_options =
+              ConvexDecompositionOptions());
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: virtual Identity AttachConvexMeshShape(
+          const Identity &_linkID,
+          const std::string &_name,
+          const ignition::common::Mesh &_mesh,
+          const PoseType &_pose,
+          const Dimensions &_scale,
+          const ConvexDecompositionOptions &_options) = 0;
+    };
+  };
 }
 }
 }
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_WEAKVALUECACHE_HH_
+#define IGNITION_PHYSICS_MESH_WEAKVALUECACHE_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  /// \brief Combine the hash of a value into a hash, to write the hash
+  /// functions of cache keys.
+  /// \param[in] _seed The hash so far.
+  /// \param[in] _value The value to add to the hash.
+  /// \return The combined hash.
+  template <typename T>
+  std::size_t HashCombine(std::size_t _seed, const T &_value);
+
+  /////////////////////////////////////////////////
+  /// \brief A thread safe cache of shared values that only holds weak
+  /// pointers to them, so that engine plugins can share data converted from a
+  /// mesh or heightmap between every shape that uses it. A value stays cached
+  /// while a shared pointer to it exists, and its entry is evicted when the
+  /// last one is released.
+  /// \tparam Key Key of a value. It must be equality comparable.
+  /// \tparam T Type of the values.
+  /// \tparam Hash Hash function of the keys.
+  template <typename Key, typename T, typename Hash = std::hash<Key>>
+  class WeakValueCache
+  {
+    /// \brief Constructor
+    public: WeakValueCache();
+
+    /// \brief Get the value of a key, or create and cache it. The value is
+    /// created without holding the lock of the cache, so slow conversions do
+    /// not block lookups of other keys. If two threads create the value of
+    /// the same key at once, both get the one that was cached first.
+    /// \param[in] _key Key of the value.
+    /// \param[in] _create Callable that returns a new value, allocated with
+    /// new, or nullptr if the value cannot be created.
+    /// \return The value, or nullptr if _create returned nullptr.
+    public: template <typename CreateT>
+    std::shared_ptr<T> Get(const Key &_key, CreateT &&_create);
+
+    /// \brief Number of keys in the cache.
+    /// \return Number of keys in the cache.
+    public: std::size_t Size() const;
+
+    /// \brief Entries of the cache. The deleters of the values share it, so
+    /// values may outlive the cache, e.g. when a plugin is unloaded at exit.
+    private: struct State
+    {
+      std::mutex mutex;
+      std::unordered_map<Key, std::weak_ptr<T>, Hash> values;
+    };
+
+    /// \brief Entries of the cache
+    private: std::shared_ptr<State> state;
+  };
+}
+}
+}
+
+#include <ignition/physics/mesh/detail/WeakValueCache.hh>
+
+#endif  // IGNITION_PHYSICS_MESH_WEAKVALUECACHE_HH_
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_DETAIL_CACHEFILE_HH_
+#define IGNITION_PHYSICS_MESH_DETAIL_CACHEFILE_HH_
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+
+#include <ignition/physics/mesh/CacheFile.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  inline std::uint64_t HashBytes(std::uint64_t _hash, const void *_data,
+                                 const std::size_t _size)
+  {
+    const auto *bytes = static_cast<const unsigned char *>(_data);
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+      _hash ^= bytes[i];
+      _hash *= 1099511628211ull;
+    }
+    return _hash;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::string CacheFileName(const std::uint64_t _hash,
+                                   const std::string &_extension)
+  {
+    std::ostringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << _hash
+             << "." << _extension;
+    return fileName.str();
+  }
+
+  /////////////////////////////////////////////////
+  inline bool WriteCacheFile(const std::string &_path,
+                             const std::string &_contents)
+  {
+    const std::string directory = common::parentPath(_path);
+    if (!common::createDirectories(directory))
+    {
+      ignwarn << "Unable to create the mesh cache directory [" << directory
+              << "]" << std::endl;
+      return false;
+    }
+
+    // Threads and processes that write the same file at once each write
+    // their own temporary file
+    const std::string tmpPath = _path + "." + std::to_string(
+        std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+        static_cast<std::size_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count())) +
+        ".tmp";
+    {
+      std::ofstream file(tmpPath, std::ios::binary);
+      file.write(_contents.data(),
+                 static_cast<std::streamsize>(_contents.size()));
+      if (!file)
+      {
+        ignwarn << "Unable to write the mesh cache file [" << tmpPath << "]"
+                << std::endl;
+        file.close();
+        std::remove(tmpPath.c_str());
+        return false;
+      }
+    }
+
+    if (std::rename(tmpPath.c_str(), _path.c_str()) != 0)
+    {
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+    return true;
+  }
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_MESH_DETAIL_CACHEFILE_HH_
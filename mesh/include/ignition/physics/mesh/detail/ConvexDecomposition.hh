@@ -0,0 +1,583 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_DETAIL_CONVEXDECOMPOSITION_HH_
+#define IGNITION_PHYSICS_MESH_DETAIL_CONVEXDECOMPOSITION_HH_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+
+#include <ignition/physics/mesh/CacheFile.hh>
+#include <ignition/physics/mesh/ConvexDecomposition.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  namespace detail
+  {
+    /// \brief Version of the decomposition and of its cache files. Increment
+    /// it when either changes, so that stale cache files are not used.
+    constexpr std::uint64_t kConvexCacheVersion = 1u;
+
+    /// \brief Marks the start of a cache file
+    constexpr char kConvexCacheMagic[8] =
+        {'I', 'G', 'N', 'H', 'U', 'L', 'L', 'S'};
+
+    /// \brief Largest vertex or face count that a cache file may hold, to
+    /// reject corrupt files before allocating memory for them
+    constexpr std::uint64_t kConvexCacheMaxCount = 1u << 24;
+
+    /////////////////////////////////////////////////
+    /// \brief Read convex hulls from a cache file
+    /// \return True if the file exists and holds valid hulls
+    inline bool ReadConvexCache(const std::string &_path,
+                                std::vector<ConvexHull> &_hulls)
+    {
+      std::ifstream file(_path, std::ios::binary);
+      if (!file)
+        return false;
+
+      char magic[sizeof(kConvexCacheMagic)];
+      std::uint64_t version = 0u;
+      std::uint64_t hullCount = 0u;
+      file.read(magic, sizeof(magic));
+      file.read(reinterpret_cast<char *>(&version), sizeof(version));
+      file.read(reinterpret_cast<char *>(&hullCount), sizeof(hullCount));
+      if (!file || !std::equal(magic, magic + sizeof(magic), kConvexCacheMagic)
+          || version != kConvexCacheVersion || hullCount > kConvexCacheMaxCount)
+      {
+        return false;
+      }
+
+      std::vector<ConvexHull> hulls(hullCount);
+      for (ConvexHull &hull : hulls)
+      {
+        std::uint64_t vertexCount = 0u;
+        file.read(reinterpret_cast<char *>(&vertexCount), sizeof(vertexCount));
+        if (!file || vertexCount > kConvexCacheMaxCount)
+          return false;
+        hull.vertices.resize(vertexCount);
+        for (Eigen::Vector3d &vertex : hull.vertices)
+        {
+          file.read(reinterpret_cast<char *>(vertex.data()),
+                    3 * sizeof(double));
+        }
+
+        std::uint64_t faceCount = 0u;
+        file.read(reinterpret_cast<char *>(&faceCount), sizeof(faceCount));
+        if (!file || faceCount > kConvexCacheMaxCount)
+          return false;
+        hull.faces.resize(faceCount);
+        for (std::array<unsigned int, 3> &face : hull.faces)
+        {
+          for (unsigned int &index : face)
+          {
+            std::uint32_t value = 0u;
+            file.read(reinterpret_cast<char *>(&value), sizeof(value));
+            if (value >= vertexCount)
+              return false;
+            index = value;
+          }
+        }
+      }
+
+      if (!file)
+        return false;
+
+      _hulls = std::move(hulls);
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Write convex hulls to a cache file
+    inline void WriteConvexCache(const std::string &_path,
+                                 const std::vector<ConvexHull> &_hulls)
+    {
+      std::ostringstream contents;
+      const std::uint64_t hullCount = _hulls.size();
+      contents.write(kConvexCacheMagic, sizeof(kConvexCacheMagic));
+      contents.write(reinterpret_cast<const char *>(&kConvexCacheVersion),
+                     sizeof(kConvexCacheVersion));
+      contents.write(reinterpret_cast<const char *>(&hullCount),
+                     sizeof(hullCount));
+      for (const ConvexHull &hull : _hulls)
+      {
+        const std::uint64_t vertexCount = hull.vertices.size();
+        contents.write(reinterpret_cast<const char *>(&vertexCount),
+                       sizeof(vertexCount));
+        for (const Eigen::Vector3d &vertex : hull.vertices)
+        {
+          contents.write(reinterpret_cast<const char *>(vertex.data()),
+                         3 * sizeof(double));
+        }
+
+        const std::uint64_t faceCount = hull.faces.size();
+        contents.write(reinterpret_cast<const char *>(&faceCount),
+                       sizeof(faceCount));
+        for (const std::array<unsigned int, 3> &face : hull.faces)
+        {
+          for (const unsigned int index : face)
+          {
+            const std::uint32_t value = index;
+            contents.write(reinterpret_cast<const char *>(&value),
+                           sizeof(value));
+          }
+        }
+      }
+
+      WriteCacheFile(_path, contents.str());
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief A part of a mesh during a convex decomposition, with the best
+    /// way found to split it in two
+    struct ConvexPart
+    {
+      /// \brief Triangles of the part
+      std::vector<std::size_t> triangles;
+
+      /// \brief Convex hull of the part
+      ConvexHull hull;
+
+      /// \brief Volume of hull
+      double volume = 0.0;
+
+      /// \brief Fraction of volume that the best split removes
+      double reduction = 0.0;
+
+      /// \brief Triangles of the two halves of the best split
+      std::array<std::vector<std::size_t>, 2> halves;
+
+      /// \brief Convex hulls of the two halves of the best split
+      std::array<ConvexHull, 2> halfHulls;
+    };
+  }
+
+  /////////////////////////////////////////////////
+  inline ConvexHull ComputeConvexHull(
+      const std::vector<Eigen::Vector3d> &_points)
+  {
+    ConvexHull hull;
+    if (_points.size() < 4u)
+      return hull;
+
+    Eigen::AlignedBox3d box;
+    for (const Eigen::Vector3d &point : _points)
+      box.extend(point);
+
+    // Points closer than this to the plane of a face are treated as lying in
+    // it, which keeps nearly coplanar points from creating slivers
+    const double eps = 1e-9 * box.diagonal().norm();
+    if (!(eps > 0.0))
+      return hull;
+
+    // Start from a tetrahedron of points that are far apart
+    Eigen::Index axis;
+    box.diagonal().maxCoeff(&axis);
+    std::size_t i0 = 0u;
+    std::size_t i1 = 0u;
+    for (std::size_t i = 0; i < _points.size(); ++i)
+    {
+      if (_points[i][axis] < _points[i0][axis])
+        i0 = i;
+      if (_points[i][axis] > _points[i1][axis])
+        i1 = i;
+    }
+
+    const Eigen::Vector3d direction =
+        (_points[i1] - _points[i0]).normalized();
+    std::size_t i2 = i0;
+    double maxDistance = 0.0;
+    for (std::size_t i = 0; i < _points.size(); ++i)
+    {
+      const double distance =
+          (_points[i] - _points[i0]).cross(direction).norm();
+      if (distance > maxDistance)
+      {
+        maxDistance = distance;
+        i2 = i;
+      }
+    }
+    if (maxDistance <= eps)
+      return hull;
+
+    const Eigen::Vector3d normal = (_points[i1] - _points[i0]).cross(
+        _points[i2] - _points[i0]).normalized();
+    std::size_t i3 = i0;
+    maxDistance = 0.0;
+    for (std::size_t i = 0; i < _points.size(); ++i)
+    {
+      const double distance = std::abs(normal.dot(_points[i] - _points[i0]));
+      if (distance > maxDistance)
+      {
+        maxDistance = distance;
+        i3 = i;
+      }
+    }
+    if (maxDistance <= eps)
+      return hull;
+
+    struct Face
+    {
+      std::array<std::size_t, 3> vertices;
+      Eigen::Vector3d normal;
+      double offset;
+      bool alive;
+      std::size_t visitedBy;
+    };
+    std::vector<Face> faces;
+
+    // Map from a directed edge to the face that has it, so that the faces
+    // around a face can be found
+    std::map<std::pair<std::size_t, std::size_t>, std::size_t> edges;
+
+    const auto addFace = [&](std::size_t _a, std::size_t _b, std::size_t _c)
+    {
+      const Eigen::Vector3d faceNormal = (_points[_b] - _points[_a]).cross(
+          _points[_c] - _points[_a]).normalized();
+      const std::size_t index = faces.size();
+      faces.push_back({{_a, _b, _c}, faceNormal, faceNormal.dot(_points[_a]),
+                       true, std::numeric_limits<std::size_t>::max()});
+      edges[{_a, _b}] = index;
+      edges[{_b, _c}] = index;
+      edges[{_c, _a}] = index;
+    };
+
+    // Wind the base of the tetrahedron so that its normal points away from
+    // the apex, and the other faces so that every edge is shared by two faces
+    // in opposite directions
+    if (normal.dot(_points[i3] - _points[i0]) > 0.0)
+      std::swap(i1, i2);
+    addFace(i0, i1, i2);
+    addFace(i1, i0, i3);
+    addFace(i2, i1, i3);
+    addFace(i0, i2, i3);
+
+    std::size_t deadFaces = 0u;
+    std::vector<std::size_t> visible;
+    std::vector<std::pair<std::size_t, std::size_t>> horizon;
+    for (std::size_t p = 0; p < _points.size(); ++p)
+    {
+      if (p == i0 || p == i1 || p == i2 || p == i3)
+        continue;
+
+      visible.clear();
+      for (std::size_t f = 0; f < faces.size(); ++f)
+      {
+        Face &face = faces[f];
+        if (face.alive && face.normal.dot(_points[p]) - face.offset > eps)
+        {
+          face.visitedBy = p;
+          visible.push_back(f);
+        }
+      }
+      if (visible.empty())
+        continue;
+
+      // The edges between visible and hidden faces form the horizon, which
+      // is connected to the new point
+      horizon.clear();
+      for (const std::size_t f : visible)
+      {
+        const std::array<std::size_t, 3> &v = faces[f].vertices;
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+          const std::size_t a = v[k];
+          const std::size_t b = v[(k + 1) % 3];
+          auto twin = edges.find({b, a});
+          if (twin == edges.end() || faces[twin->second].visitedBy != p)
+            horizon.emplace_back(a, b);
+        }
+      }
+
+      for (const std::size_t f : visible)
+      {
+        const std::array<std::size_t, 3> &v = faces[f].vertices;
+        faces[f].alive = false;
+        for (std::size_t k = 0; k < 3; ++k)
+          edges.erase({v[k], v[(k + 1) % 3]});
+      }
+      deadFaces += visible.size();
+
+      for (const auto &edge : horizon)
+        addFace(edge.first, edge.second, p);
+
+      // Drop dead faces once they outnumber the live ones, so that the loop
+      // over the faces stays proportional to the size of the hull
+      if (deadFaces > faces.size() / 2u)
+      {
+        std::vector<Face> liveFaces;
+        liveFaces.reserve(faces.size() - deadFaces);
+        edges.clear();
+        for (const Face &face : faces)
+        {
+          if (!face.alive)
+            continue;
+          const std::size_t index = liveFaces.size();
+          const std::array<std::size_t, 3> &v = face.vertices;
+          for (std::size_t k = 0; k < 3; ++k)
+            edges[{v[k], v[(k + 1) % 3]}] = index;
+          liveFaces.push_back(face);
+        }
+        faces = std::move(liveFaces);
+        deadFaces = 0u;
+      }
+    }
+
+    std::vector<unsigned int> hullIndex(
+        _points.size(), std::numeric_limits<unsigned int>::max());
+    for (const Face &face : faces)
+    {
+      if (!face.alive)
+        continue;
+
+      std::array<unsigned int, 3> hullFace;
+      for (std::size_t k = 0; k < 3; ++k)
+      {
+        unsigned int &index = hullIndex[face.vertices[k]];
+        if (index == std::numeric_limits<unsigned int>::max())
+        {
+          index = static_cast<unsigned int>(hull.vertices.size());
+          hull.vertices.push_back(_points[face.vertices[k]]);
+        }
+        hullFace[k] = index;
+      }
+      hull.faces.push_back(hullFace);
+    }
+
+    return hull;
+  }
+
+  /////////////////////////////////////////////////
+  inline double ConvexHullVolume(const ConvexHull &_hull)
+  {
+    double volume = 0.0;
+    for (const std::array<unsigned int, 3> &face : _hull.faces)
+    {
+      volume += _hull.vertices[face[0]].dot(
+          _hull.vertices[face[1]].cross(_hull.vertices[face[2]]));
+    }
+    return volume / 6.0;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::vector<ConvexHull> ComputeConvexDecomposition(
+      const common::Mesh &_mesh,
+      const ConvexDecompositionOptions &_options)
+  {
+    double *vertexArray = nullptr;
+    int *indexArray = nullptr;
+    _mesh.FillArrays(&vertexArray, &indexArray);
+
+    const std::size_t vertexCount = _mesh.VertexCount();
+    const std::size_t indexCount = _mesh.IndexCount();
+    std::vector<Eigen::Vector3d> vertices(vertexCount);
+    for (std::size_t i = 0; i < vertexCount; ++i)
+    {
+      vertices[i] = Eigen::Vector3d(
+          vertexArray[3 * i], vertexArray[3 * i + 1], vertexArray[3 * i + 2]);
+    }
+
+    std::vector<std::array<std::size_t, 3>> triangles;
+    triangles.reserve(indexCount / 3u);
+    for (std::size_t i = 0; i + 2u < indexCount; i += 3u)
+    {
+      const std::array<std::size_t, 3> triangle = {
+          static_cast<std::size_t>(indexArray[i]),
+          static_cast<std::size_t>(indexArray[i + 1]),
+          static_cast<std::size_t>(indexArray[i + 2])};
+      if (std::all_of(triangle.begin(), triangle.end(),
+          [vertexCount](std::size_t _index) { return _index < vertexCount; }))
+      {
+        triangles.push_back(triangle);
+      }
+    }
+
+    delete [] vertexArray;
+    delete [] indexArray;
+
+    std::vector<ConvexHull> hulls;
+
+    std::string cacheDirectory = _options.cacheDirectory;
+    if (cacheDirectory.empty())
+      common::env("IGN_PHYSICS_MESH_CACHE_PATH", cacheDirectory);
+
+    std::string cachePath;
+    if (!cacheDirectory.empty())
+    {
+      std::uint64_t hash = kHashBytesSeed;
+      const std::uint64_t maxConvexHulls = _options.maxConvexHulls;
+      hash = HashBytes(hash, &detail::kConvexCacheVersion,
+                       sizeof(detail::kConvexCacheVersion));
+      hash = HashBytes(hash, &maxConvexHulls, sizeof(maxConvexHulls));
+      hash = HashBytes(hash, &_options.minVolumeReduction,
+                       sizeof(_options.minVolumeReduction));
+      for (const Eigen::Vector3d &vertex : vertices)
+        hash = HashBytes(hash, vertex.data(), 3 * sizeof(double));
+      for (const std::array<std::size_t, 3> &triangle : triangles)
+      {
+        for (const std::size_t index : triangle)
+        {
+          const std::uint64_t value = index;
+          hash = HashBytes(hash, &value, sizeof(value));
+        }
+      }
+
+      cachePath = common::joinPaths(
+          cacheDirectory, CacheFileName(hash, "hulls"));
+      if (detail::ReadConvexCache(cachePath, hulls))
+        return hulls;
+    }
+
+    std::vector<char> used(vertexCount, 0);
+    std::vector<Eigen::Vector3d> points;
+    const auto hullOf = [&](const std::vector<std::size_t> &_triangles)
+    {
+      points.clear();
+      for (const std::size_t t : _triangles)
+      {
+        for (const std::size_t index : triangles[t])
+        {
+          if (!used[index])
+          {
+            used[index] = 1;
+            points.push_back(vertices[index]);
+          }
+        }
+      }
+      for (const std::size_t t : _triangles)
+      {
+        for (const std::size_t index : triangles[t])
+          used[index] = 0;
+      }
+      return ComputeConvexHull(points);
+    };
+
+    // Find the axis-aligned plane through the center of the triangles of a
+    // part that removes the most volume from its hull
+    const auto evaluate = [&](detail::ConvexPart &_part)
+    {
+      _part.reduction = 0.0;
+      Eigen::AlignedBox3d box;
+      for (const std::size_t t : _part.triangles)
+      {
+        const std::array<std::size_t, 3> &triangle = triangles[t];
+        box.extend((vertices[triangle[0]] + vertices[triangle[1]] +
+                    vertices[triangle[2]]) / 3.0);
+      }
+
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        const double plane = box.center()[axis];
+        std::array<std::vector<std::size_t>, 2> halves;
+        for (const std::size_t t : _part.triangles)
+        {
+          const std::array<std::size_t, 3> &triangle = triangles[t];
+          const double centroid = (vertices[triangle[0]][axis] +
+              vertices[triangle[1]][axis] + vertices[triangle[2]][axis]) / 3.0;
+          halves[centroid < plane ? 0 : 1].push_back(t);
+        }
+        if (halves[0].empty() || halves[1].empty())
+          continue;
+
+        std::array<ConvexHull, 2> halfHulls = {
+            hullOf(halves[0]), hullOf(halves[1])};
+        if (halfHulls[0].faces.empty() || halfHulls[1].faces.empty())
+          continue;
+
+        const double reduction = 1.0 - (ConvexHullVolume(halfHulls[0]) +
+            ConvexHullVolume(halfHulls[1])) / _part.volume;
+        if (reduction > _part.reduction)
+        {
+          _part.reduction = reduction;
+          _part.halves = std::move(halves);
+          _part.halfHulls = std::move(halfHulls);
+        }
+      }
+    };
+
+    std::vector<detail::ConvexPart> parts(1);
+    parts[0].triangles.resize(triangles.size());
+    for (std::size_t t = 0; t < triangles.size(); ++t)
+      parts[0].triangles[t] = t;
+    parts[0].hull = hullOf(parts[0].triangles);
+    parts[0].volume = ConvexHullVolume(parts[0].hull);
+    if (parts[0].hull.faces.empty() || !(parts[0].volume > 0.0))
+      return hulls;
+
+    if (_options.maxConvexHulls > 1u)
+      evaluate(parts[0]);
+
+    while (parts.size() < _options.maxConvexHulls)
+    {
+      const std::size_t best = static_cast<std::size_t>(
+          std::max_element(parts.begin(), parts.end(),
+              [](const detail::ConvexPart &_a, const detail::ConvexPart &_b)
+              {
+                return _a.reduction < _b.reduction;
+              }) - parts.begin());
+      if (parts[best].reduction < _options.minVolumeReduction ||
+          !(parts[best].reduction > 0.0))
+      {
+        break;
+      }
+
+      std::array<detail::ConvexPart, 2> halves;
+      for (std::size_t h = 0; h < 2; ++h)
+      {
+        halves[h].triangles = std::move(parts[best].halves[h]);
+        halves[h].hull = std::move(parts[best].halfHulls[h]);
+        halves[h].volume = ConvexHullVolume(halves[h].hull);
+      }
+      parts[best] = std::move(halves[0]);
+      parts.push_back(std::move(halves[1]));
+
+      if (parts.size() < _options.maxConvexHulls)
+      {
+        evaluate(parts[best]);
+        evaluate(parts.back());
+      }
+    }
+
+    hulls.reserve(parts.size());
+    for (detail::ConvexPart &part : parts)
+      hulls.push_back(std::move(part.hull));
+
+    if (!cachePath.empty())
+      detail::WriteConvexCache(cachePath, hulls);
+
+    return hulls;
+  }
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_MESH_DETAIL_CONVEXDECOMPOSITION_HH_
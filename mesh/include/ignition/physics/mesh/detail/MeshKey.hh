@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_DETAIL_MESHKEY_HH_
+#define IGNITION_PHYSICS_MESH_DETAIL_MESHKEY_HH_
+
+#include <algorithm>
+#include <functional>
+
+#include <ignition/physics/mesh/MeshKey.hh>
+#include <ignition/physics/mesh/WeakValueCache.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  MeshKey::MeshKey(const common::Mesh &_mesh, const Eigen::Vector3d &_scale)
+    : mesh(&_mesh),
+      name(_mesh.Name()),
+      path(_mesh.Path()),
+      scale{{_scale.x(), _scale.y(), _scale.z()}}
+  {
+  }
+
+  /////////////////////////////////////////////////
+  bool MeshKey::operator==(const MeshKey &_other) const
+  {
+    return this->mesh == _other.mesh && this->scale == _other.scale &&
+        this->name == _other.name && this->path == _other.path;
+  }
+
+  /////////////////////////////////////////////////
+  std::size_t MeshKeyHash::operator()(const MeshKey &_key) const
+  {
+    std::size_t hash = std::hash<const void *>()(_key.mesh);
+    for (const double s : _key.scale)
+      hash = HashCombine(hash, s);
+    return hash;
+  }
+
+  /////////////////////////////////////////////////
+  ConvexMeshKey::ConvexMeshKey(const common::Mesh &_mesh,
+                               const Eigen::Vector3d &_scale,
+                               const ConvexDecompositionOptions &_options)
+    : mesh(_mesh, _scale),
+      maxConvexHulls(std::max<std::size_t>(_options.maxConvexHulls, 1u)),
+      minVolumeReduction(_options.minVolumeReduction)
+  {
+  }
+
+  /////////////////////////////////////////////////
+  bool ConvexMeshKey::operator==(const ConvexMeshKey &_other) const
+  {
+    return this->mesh == _other.mesh &&
+        this->maxConvexHulls == _other.maxConvexHulls &&
+        this->minVolumeReduction == _other.minVolumeReduction;
+  }
+
+  /////////////////////////////////////////////////
+  std::size_t ConvexMeshKeyHash::operator()(const ConvexMeshKey &_key) const
+  {
+    std::size_t hash = MeshKeyHash()(_key.mesh);
+    hash = HashCombine(hash, _key.maxConvexHulls);
+    return HashCombine(hash, _key.minVolumeReduction);
+  }
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_MESH_DETAIL_MESHKEY_HH_
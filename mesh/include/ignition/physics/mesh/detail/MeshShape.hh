@@ -67,6 +67,22 @@ namespace mesh
           this->template Interface<AttachMeshShapeFeature>()
               ->AttachMeshShape(this->identity, _name, _mesh, _pose, _scale));
   }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  auto AttachConvexMeshShapeFeature::Link<PolicyT, FeaturesT>::
+      AttachConvexMeshShape(
+      const std::string &_name,
+      const ignition::common::Mesh &_mesh,
+      const PoseType &_pose,
+      const Dimensions &_scale,
+      const ConvexDecompositionOptions &_options) -> ShapePtrType
+  {
+    return ShapePtrType(this->pimpl,
+          this->template Interface<AttachConvexMeshShapeFeature>()
+              ->AttachConvexMeshShape(this->identity, _name, _mesh, _pose,
+                                      _scale, _options));
+  }
 }
 }
 }
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_MESH_DETAIL_WEAKVALUECACHE_HH_
+#define IGNITION_PHYSICS_MESH_DETAIL_WEAKVALUECACHE_HH_
+
+#include <utility>
+
+#include <ignition/physics/mesh/WeakValueCache.hh>
+
+namespace ignition
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  template <typename T>
+  std::size_t HashCombine(std::size_t _seed, const T &_value)
+  {
+    return _seed * 31u + std::hash<T>()(_value);
+  }
+
+  /////////////////////////////////////////////////
+  template <typename Key, typename T, typename Hash>
+  WeakValueCache<Key, T, Hash>::WeakValueCache()
+    : state(std::make_shared<State>())
+  {
+  }
+
+  /////////////////////////////////////////////////
+  template <typename Key, typename T, typename Hash>
+  template <typename CreateT>
+  std::shared_ptr<T> WeakValueCache<Key, T, Hash>::Get(
+      const Key &_key, CreateT &&_create)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->state->mutex);
+      auto it = this->state->values.find(_key);
+      if (it != this->state->values.end())
+      {
+        std::shared_ptr<T> value = it->second.lock();
+        if (value)
+          return value;
+      }
+    }
+
+    T *created = std::forward<CreateT>(_create)();
+    if (!created)
+      return nullptr;
+
+    // The deleter evicts the value, unless the entry was already replaced by
+    // a new value for the same key
+    std::shared_ptr<T> value(created,
+        [state = this->state, _key](T *_value)
+        {
+          {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            auto it = state->values.find(_key);
+            if (it != state->values.end() && it->second.expired())
+              state->values.erase(it);
+          }
+          delete _value;
+        });
+
+    // The value that lost a race is released after the lock, since its
+    // deleter locks the cache too
+    std::shared_ptr<T> cached;
+    {
+      std::lock_guard<std::mutex> lock(this->state->mutex);
+      std::weak_ptr<T> &entry = this->state->values[_key];
+      cached = entry.lock();
+      if (!cached)
+      {
+        entry = value;
+        cached = value;
+      }
+    }
+    return cached;
+  }
+
+  /////////////////////////////////////////////////
+  template <typename Key, typename T, typename Hash>
+  std::size_t WeakValueCache<Key, T, Hash>::Size() const
+  {
+    std::lock_guard<std::mutex> lock(this->state->mutex);
+    return this->state->values.size();
+  }
+}
+}
+}
+
+#endif  // IGNITION_PHYSICS_MESH_DETAIL_WEAKVALUECACHE_HH_
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/physics/mesh/CacheFile.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+TEST(CacheFile_TEST, HashBytes)
+{
+  // Reference values of 64 bit FNV-1a
+  EXPECT_EQ(physics::mesh::kHashBytesSeed,
+            physics::mesh::HashBytes(physics::mesh::kHashBytesSeed, "", 0u));
+  EXPECT_EQ(0xaf63dc4c8601ec8cull,
+            physics::mesh::HashBytes(physics::mesh::kHashBytesSeed, "a", 1u));
+
+  // Hashing in pieces gives the same hash
+  const std::uint64_t ab =
+      physics::mesh::HashBytes(physics::mesh::kHashBytesSeed, "ab", 2u);
+  EXPECT_EQ(ab, physics::mesh::HashBytes(
+      physics::mesh::HashBytes(physics::mesh::kHashBytesSeed, "a", 1u),
+      "b", 1u));
+
+  EXPECT_EQ("00000000000000ff.bvh", physics::mesh::CacheFileName(255u, "bvh"));
+}
+
+/////////////////////////////////////////////////
+TEST(CacheFile_TEST, WriteCacheFile)
+{
+  const std::string tempDir = common::createTempDirectory(
+      "cache_file", common::tempDirectoryPath());
+  ASSERT_FALSE(tempDir.empty());
+
+  // The directory of the file is created, and no temporary file is left
+  const std::string directory = common::joinPaths(tempDir, "a", "b");
+  const std::string path = common::joinPaths(directory, "file.bin");
+  const std::string contents("cached\0data", 11u);
+  ASSERT_TRUE(physics::mesh::WriteCacheFile(path, contents));
+
+  std::size_t fileCount = 0u;
+  for (common::DirIter it(directory); it != common::DirIter(); ++it)
+    ++fileCount;
+  EXPECT_EQ(1u, fileCount);
+
+  {
+    std::ifstream file(path, std::ios::binary);
+    EXPECT_EQ(contents, std::string(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>()));
+  }
+
+  // An existing file is replaced
+  ASSERT_TRUE(physics::mesh::WriteCacheFile(path, "new"));
+  {
+    std::ifstream file(path, std::ios::binary);
+    EXPECT_EQ("new", std::string(std::istreambuf_iterator<char>(file),
+                                 std::istreambuf_iterator<char>()));
+  }
+
+  common::removeAll(tempDir);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "ignition/physics/mesh/ConvexDecomposition.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Corners of the box from _min to _max
+std::vector<Eigen::Vector3d> BoxCorners(const Eigen::Vector3d &_min,
+                                        const Eigen::Vector3d &_max)
+{
+  std::vector<Eigen::Vector3d> corners;
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    corners.emplace_back(
+        (corner & 1) ? _max.x() : _min.x(),
+        (corner & 2) ? _max.y() : _min.y(),
+        (corner & 4) ? _max.z() : _min.z());
+  }
+  return corners;
+}
+
+/////////////////////////////////////////////////
+/// \brief Add the 12 triangles of a unit cube to a submesh
+void AddCube(common::SubMesh &_subMesh, const Eigen::Vector3d &_min)
+{
+  const unsigned int first =
+      static_cast<unsigned int>(_subMesh.VertexCount());
+  for (const Eigen::Vector3d &corner :
+       BoxCorners(_min, _min + Eigen::Vector3d::Ones()))
+  {
+    _subMesh.AddVertex(corner.x(), corner.y(), corner.z());
+  }
+
+  // Corner i has x, y and z at the maximum for bits 0, 1 and 2 of i
+  const std::array<std::array<unsigned int, 3>, 12> triangles = {{
+      {{0, 2, 1}}, {{1, 2, 3}}, {{4, 5, 6}}, {{5, 7, 6}},
+      {{0, 1, 4}}, {{1, 5, 4}}, {{2, 6, 3}}, {{3, 6, 7}},
+      {{0, 4, 2}}, {{2, 4, 6}}, {{1, 3, 5}}, {{3, 7, 5}}}};
+  for (const std::array<unsigned int, 3> &triangle : triangles)
+  {
+    for (const unsigned int index : triangle)
+      _subMesh.AddIndex(first + index);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief An L made of unit cubes in the xz plane, with arms that are four
+/// cubes long
+common::Mesh LMesh()
+{
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (int x = 0; x < 4; ++x)
+    AddCube(subMesh, Eigen::Vector3d(x, 0, 0));
+  for (int z = 1; z < 4; ++z)
+    AddCube(subMesh, Eigen::Vector3d(0, 0, z));
+
+  common::Mesh mesh;
+  mesh.AddSubMesh(subMesh);
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+/// \brief Total volume of convex hulls
+double TotalVolume(const std::vector<physics::mesh::ConvexHull> &_hulls)
+{
+  double volume = 0.0;
+  for (const physics::mesh::ConvexHull &hull : _hulls)
+    volume += physics::mesh::ConvexHullVolume(hull);
+  return volume;
+}
+
+/////////////////////////////////////////////////
+TEST(ConvexDecomposition_TEST, CubeHull)
+{
+  // The center of the cube lies inside the hull and is dropped
+  std::vector<Eigen::Vector3d> points =
+      BoxCorners(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones());
+  points.push_back(Eigen::Vector3d::Constant(0.5));
+
+  const physics::mesh::ConvexHull hull =
+      physics::mesh::ComputeConvexHull(points);
+  EXPECT_EQ(8u, hull.vertices.size());
+  EXPECT_NEAR(1.0, physics::mesh::ConvexHullVolume(hull), 1e-9);
+
+  // Each of the 6 faces of the cube is split into 2 triangles, and each
+  // triangle faces away from the center
+  ASSERT_EQ(12u, hull.faces.size());
+  std::vector<Eigen::Vector3d> normals;
+  for (const std::array<unsigned int, 3> &face : hull.faces)
+  {
+    const Eigen::Vector3d &a = hull.vertices[face[0]];
+    const Eigen::Vector3d normal =
+        (hull.vertices[face[1]] - a).cross(hull.vertices[face[2]] - a);
+    EXPECT_LT(0.0, normal.dot(a - Eigen::Vector3d::Constant(0.5)));
+
+    const Eigen::Vector3d unit = normal.normalized();
+    bool found = false;
+    for (const Eigen::Vector3d &other : normals)
+      found = found || other.isApprox(unit, 1e-9);
+    if (!found)
+      normals.push_back(unit);
+  }
+  EXPECT_EQ(6u, normals.size());
+}
+
+/////////////////////////////////////////////////
+TEST(ConvexDecomposition_TEST, FlatHull)
+{
+  std::vector<Eigen::Vector3d> points = BoxCorners(
+      Eigen::Vector3d::Zero(), Eigen::Vector3d(1.0, 1.0, 0.0));
+  EXPECT_TRUE(physics::mesh::ComputeConvexHull(points).faces.empty());
+
+  points.resize(3u);
+  EXPECT_TRUE(physics::mesh::ComputeConvexHull(points).faces.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(ConvexDecomposition_TEST, SplitL)
+{
+  const common::Mesh mesh = LMesh();
+
+  // With one hull, the L collides as its convex hull, which fills in the
+  // corner between the arms
+  const std::vector<physics::mesh::ConvexHull> whole =
+      physics::mesh::ComputeConvexDecomposition(mesh);
+  ASSERT_EQ(1u, whole.size());
+  EXPECT_NEAR(11.5, TotalVolume(whole), 1e-9);
+
+  // More hulls remove empty space from the corner
+  physics::mesh::ConvexDecompositionOptions options;
+  options.maxConvexHulls = 8u;
+  const std::vector<physics::mesh::ConvexHull> parts =
+      physics::mesh::ComputeConvexDecomposition(mesh, options);
+  EXPECT_LT(1u, parts.size());
+  EXPECT_GE(options.maxConvexHulls, parts.size());
+  for (const physics::mesh::ConvexHull &part : parts)
+    EXPECT_LT(0.0, physics::mesh::ConvexHullVolume(part));
+  EXPECT_GT(TotalVolume(whole), TotalVolume(parts));
+}
+
+/////////////////////////////////////////////////
+TEST(ConvexDecomposition_TEST, Cache)
+{
+  const std::string tempDir = common::createTempDirectory(
+      "convex_cache", common::tempDirectoryPath());
+  ASSERT_FALSE(tempDir.empty());
+
+  const common::Mesh mesh = LMesh();
+  physics::mesh::ConvexDecompositionOptions options;
+  options.maxConvexHulls = 8u;
+  options.cacheDirectory = common::joinPaths(tempDir, "hulls");
+
+  const std::vector<physics::mesh::ConvexHull> computed =
+      physics::mesh::ComputeConvexDecomposition(mesh, options);
+  ASSERT_LT(1u, computed.size());
+
+  // The decomposition is written to one cache file
+  std::vector<std::string> files;
+  for (common::DirIter it(options.cacheDirectory); it != common::DirIter();
+       ++it)
+  {
+    files.push_back(*it);
+  }
+  ASSERT_EQ(1u, files.size());
+  const std::string cacheFile = files[0];
+
+  const auto expectSameHulls =
+      [&](const std::vector<physics::mesh::ConvexHull> &_hulls)
+      {
+        ASSERT_EQ(computed.size(), _hulls.size());
+        for (std::size_t i = 0; i < computed.size(); ++i)
+        {
+          EXPECT_EQ(computed[i].vertices, _hulls[i].vertices);
+          EXPECT_EQ(computed[i].faces, _hulls[i].faces);
+        }
+      };
+
+  // A valid cache file is read back
+  expectSameHulls(physics::mesh::ComputeConvexDecomposition(mesh, options));
+
+  // A corrupt cache file is ignored, and replaced by the recomputed hulls
+  {
+    std::ofstream file(cacheFile, std::ios::binary | std::ios::trunc);
+    file << "not a convex decomposition";
+  }
+  expectSameHulls(physics::mesh::ComputeConvexDecomposition(mesh, options));
+
+  // So is a truncated one
+  std::string contents;
+  {
+    std::ifstream file(cacheFile, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+  ASSERT_LT(64u, contents.size());
+  {
+    std::ofstream file(cacheFile, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(),
+               static_cast<std::streamsize>(contents.size() / 2u));
+  }
+  expectSameHulls(physics::mesh::ComputeConvexDecomposition(mesh, options));
+
+  std::ifstream file(cacheFile, std::ios::binary | std::ios::ate);
+  EXPECT_EQ(static_cast<std::streamoff>(contents.size()),
+            static_cast<std::streamoff>(file.tellg()));
+  file.close();
+
+  common::removeAll(tempDir);
+}
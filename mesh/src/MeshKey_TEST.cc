@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Mesh.hh>
+
+#include "ignition/physics/mesh/MeshKey.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+TEST(MeshKey_TEST, MeshKey)
+{
+  common::Mesh mesh;
+  mesh.SetName("mesh");
+  mesh.SetPath("/meshes/mesh.dae");
+  common::Mesh other;
+  other.SetName("mesh");
+  other.SetPath("/meshes/mesh.dae");
+
+  const physics::mesh::MeshKey key(mesh, Eigen::Vector3d(1, 2, 3));
+  EXPECT_EQ(&mesh, key.mesh);
+  EXPECT_EQ("mesh", key.name);
+  EXPECT_EQ("/meshes/mesh.dae", key.path);
+
+  const physics::mesh::MeshKey same(mesh, Eigen::Vector3d(1, 2, 3));
+  EXPECT_TRUE(key == same);
+  EXPECT_EQ(physics::mesh::MeshKeyHash()(key),
+            physics::mesh::MeshKeyHash()(same));
+
+  EXPECT_FALSE(key == physics::mesh::MeshKey(mesh, Eigen::Vector3d::Ones()));
+  EXPECT_FALSE(key == physics::mesh::MeshKey(other, Eigen::Vector3d(1, 2, 3)));
+
+  // A mesh loaded at the address of another one has a different key
+  physics::mesh::MeshKey reloaded = key;
+  reloaded.path = "/meshes/other.dae";
+  EXPECT_FALSE(key == reloaded);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshKey_TEST, ConvexMeshKey)
+{
+  common::Mesh mesh;
+  physics::mesh::ConvexDecompositionOptions options;
+  options.maxConvexHulls = 0u;
+
+  // 0 and 1 hulls both collide as the convex hull of the mesh
+  const physics::mesh::ConvexMeshKey key(mesh, Eigen::Vector3d::Ones(),
+                                         options);
+  EXPECT_EQ(1u, key.maxConvexHulls);
+  options.maxConvexHulls = 1u;
+  const physics::mesh::ConvexMeshKey same(mesh, Eigen::Vector3d::Ones(),
+                                          options);
+  EXPECT_TRUE(key == same);
+  EXPECT_EQ(physics::mesh::ConvexMeshKeyHash()(key),
+            physics::mesh::ConvexMeshKeyHash()(same));
+
+  // The cache directory does not change the hulls
+  options.cacheDirectory = "/tmp/hulls";
+  EXPECT_TRUE(key == physics::mesh::ConvexMeshKey(
+      mesh, Eigen::Vector3d::Ones(), options));
+
+  options.maxConvexHulls = 4u;
+  EXPECT_FALSE(key == physics::mesh::ConvexMeshKey(
+      mesh, Eigen::Vector3d::Ones(), options));
+  options.maxConvexHulls = 1u;
+  options.minVolumeReduction = 0.5;
+  EXPECT_FALSE(key == physics::mesh::ConvexMeshKey(
+      mesh, Eigen::Vector3d::Ones(), options));
+}
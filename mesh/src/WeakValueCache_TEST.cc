@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "ignition/physics/mesh/WeakValueCache.hh"
+
+using ignition::physics::mesh::WeakValueCache;
+
+/////////////////////////////////////////////////
+TEST(WeakValueCache_TEST, ShareAndEvict)
+{
+  WeakValueCache<std::string, int> cache;
+  int created = 0;
+  auto create = [&]() { return new int(++created); };
+
+  // Every request of a key gets the same value while it is in use
+  std::shared_ptr<int> a1 = cache.Get("a", create);
+  std::shared_ptr<int> a2 = cache.Get("a", create);
+  std::shared_ptr<int> b = cache.Get("b", create);
+  ASSERT_NE(nullptr, a1);
+  EXPECT_EQ(a1, a2);
+  EXPECT_NE(a1, b);
+  EXPECT_EQ(2, created);
+  EXPECT_EQ(2u, cache.Size());
+
+  // The entry is evicted with the last user of the value
+  a1.reset();
+  EXPECT_EQ(2u, cache.Size());
+  a2.reset();
+  EXPECT_EQ(1u, cache.Size());
+
+  // A released key gets a new value
+  std::shared_ptr<int> a3 = cache.Get("a", create);
+  EXPECT_EQ(3, *a3);
+  EXPECT_EQ(2u, cache.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(WeakValueCache_TEST, CreateFails)
+{
+  WeakValueCache<std::string, int> cache;
+  EXPECT_EQ(nullptr, cache.Get("a", []() -> int * { return nullptr; }));
+  EXPECT_EQ(0u, cache.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(WeakValueCache_TEST, OutliveCache)
+{
+  std::shared_ptr<int> value;
+  {
+    WeakValueCache<std::string, int> cache;
+    value = cache.Get("a", []() { return new int(1); });
+  }
+
+  // Releasing a value after its cache is gone is safe
+  EXPECT_EQ(1, *value);
+  value.reset();
+}
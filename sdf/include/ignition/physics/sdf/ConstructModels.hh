@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_SDF_CONSTRUCTMODELS_HH_
+#define IGNITION_PHYSICS_SDF_CONSTRUCTMODELS_HH_
+
+#include <vector>
+
+#include <sdf/Model.hh>
+
+#include <ignition/physics/FeatureList.hh>
+
+namespace ignition {
+namespace physics {
+namespace sdf {
+
+/// \brief Construct many model entities from sdf::Model DOM objects at once.
+/// Plugins can defer the work that depends on the set of models in the world,
+/// such as registering the models with the collision detector, until the
+/// whole batch is constructed. This is much faster than calling
+/// ConstructModel for each model when spawning thousands of models.
+class ConstructSdfModels : public virtual Feature
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ModelPtrType = ModelPtr<PolicyT, FeaturesT>;
+
+    /// \brief Construct models in this world
+    /// \param[in] _models The sdf models to construct
+    /// \return The constructed models, in the order of _models. A model that
+    /// could not be constructed is a null pointer.
+    public: std::vector<ModelPtrType> ConstructModels(
+        const std::vector<::sdf::Model> &_models);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual std::vector<Identity> ConstructSdfModels(
+        const Identity &_world, const std::vector<::sdf::Model> &_models) = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ConstructSdfModels::World<PolicyT, FeaturesT>::ConstructModels(
+    const std::vector<::sdf::Model> &_models) -> std::vector<ModelPtrType>
+{
+  const std::vector<Identity> identities =
+      this->template Interface<ConstructSdfModels>()
+          ->ConstructSdfModels(this->identity, _models);
+
+  std::vector<ModelPtrType> models;
+  models.reserve(identities.size());
+  for (const Identity &identity : identities)
+    models.emplace_back(this->pimpl, identity);
+  return models;
+}
+
+}
+}
+}
+
+#endif
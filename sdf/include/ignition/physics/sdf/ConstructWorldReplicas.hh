@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_SDF_CONSTRUCTWORLDREPLICAS_HH_
+#define IGNITION_PHYSICS_SDF_CONSTRUCTWORLDREPLICAS_HH_
+
+#include <string>
+#include <vector>
+
+#include <sdf/World.hh>
+
+#include <ignition/physics/FeatureList.hh>
+#include <ignition/physics/sdf/ConstructWorld.hh>
+
+namespace ignition {
+namespace physics {
+namespace sdf {
+
+/// \brief ConstructSdfWorldReplicas constructs several identical copies of
+/// an sdf world, e.g. to run many environments in lockstep. The replicas are
+/// added after the existing worlds of the engine, so they form a batch that
+/// starts at the index of the first replica. See BatchedWorldStateFeature
+/// and ForwardStepWorlds.
+class ConstructSdfWorldReplicas
+    : public virtual FeatureWithRequirements<ConstructSdfWorld>
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+  {
+    public: using WorldPtrType = WorldPtr<PolicyT, FeaturesT>;
+
+    /// \brief Construct replicas of a world. Replica i is named
+    /// "<world name>_<i>", since world names must be unique in an engine.
+    /// \param[in] _world The sdf world to replicate
+    /// \param[in] _count Number of replicas
+    /// \return The replicas, in the order of their world indices
+    public: std::vector<WorldPtrType> ConstructWorldReplicas(
+        const ::sdf::World &_world, std::size_t _count);
+  };
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ConstructSdfWorldReplicas::Engine<PolicyT, FeaturesT>::
+ConstructWorldReplicas(const ::sdf::World &_world, std::size_t _count)
+    -> std::vector<WorldPtrType>
+{
+  std::vector<WorldPtrType> replicas;
+  replicas.reserve(_count);
+
+  ::sdf::World replica = _world;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    replica.SetName(_world.Name() + "_" + std::to_string(i));
+    replicas.emplace_back(this->pimpl,
+        this->template Interface<ConstructSdfWorld>()
+            ->ConstructSdfWorld(this->identity, replica));
+  }
+  return replicas;
+}
+
+}
+}
+}
+
+#endif
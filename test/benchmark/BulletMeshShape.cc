@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <ignition/common/MeshManager.hh>
+
+#include "TriangleMesh.hh"
+
+using namespace ignition;
+using namespace physics::bullet;
+
+/////////////////////////////////////////////////
+/// \brief Resident set size of this process in bytes, or 0 if unknown. It is
+/// only known on Linux.
+static double ResidentSetSize()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0u;
+  std::size_t resident = 0u;
+  if (!(statm >> size >> resident))
+    return 0.0;
+  return static_cast<double>(resident * sysconf(_SC_PAGESIZE));
+#else
+  return 0.0;
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief A sphere that is dense enough to cost as much as a detailed mesh
+static const common::Mesh &SphereMesh()
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const std::string name = "benchmark_sphere";
+  if (!meshManager->HasMesh(name))
+    meshManager->CreateSphere(name, 1.0, 128, 128);
+  return *meshManager->MeshByName(name);
+}
+
+/// \brief Create the triangles of each instance of a mesh, and report the
+/// memory that they use.
+/// Arguments are: number of instances
+template <typename CreateFunc>
+void CreateInstances(benchmark::State &_st, CreateFunc _create)
+{
+  const common::Mesh &mesh = SphereMesh();
+  const Eigen::Vector3d scale(1.0, 1.0, 1.0);
+  double rss = 0.0;
+  for (auto _ : _st)
+  {
+    const double rssBefore = ResidentSetSize();
+    std::vector<std::shared_ptr<btStridingMeshInterface>> meshes;
+    meshes.reserve(_st.range(0));
+    for (int64_t i = 0; i < _st.range(0); ++i)
+      meshes.push_back(_create(mesh, scale));
+    rss = ResidentSetSize() - rssBefore;
+
+    // The meshes are freed outside of the measured time
+    _st.PauseTiming();
+    meshes.clear();
+    _st.ResumeTiming();
+  }
+  _st.counters["rss_bytes"] = rss;
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+void BM_TriangleMesh_CopyTriangles(benchmark::State &_st)
+{
+  // Each triangle holds its own copy of its three vertices
+  CreateInstances(_st, [](const common::Mesh &_mesh,
+                          const Eigen::Vector3d &_scale)
+  {
+    double *vertices = nullptr;
+    int *indices = nullptr;
+    _mesh.FillArrays(&vertices, &indices);
+    auto triangles = std::make_shared<btTriangleMesh>();
+    for (unsigned int j = 0; j + 2 < _mesh.IndexCount(); j += 3)
+    {
+      btVector3 corners[3];
+      for (unsigned int k = 0; k < 3; ++k)
+      {
+        const double *vertex = vertices + 3 * indices[j + k];
+        corners[k] = btVector3(vertex[0] * _scale[0], vertex[1] * _scale[1],
+                               vertex[2] * _scale[2]);
+      }
+      triangles->addTriangle(corners[0], corners[1], corners[2]);
+    }
+    delete [] vertices;
+    delete [] indices;
+    return triangles;
+  });
+}
+
+// NOLINTNEXTLINE
+void BM_TriangleMesh_Indexed(benchmark::State &_st)
+{
+  CreateInstances(_st, [](const common::Mesh &_mesh,
+                          const Eigen::Vector3d &_scale)
+  {
+    return std::make_shared<TriangleMesh>(_mesh, _scale);
+  });
+}
+
+// NOLINTNEXTLINE
+void BM_TriangleMesh_Cached(benchmark::State &_st)
+{
+  CreateInstances(_st, &TriangleMesh::Get);
+  if (TriangleMesh::CacheSize() != 0u)
+    _st.SkipWithError("Unused meshes were not evicted from the cache");
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_TriangleMesh_CopyTriangles)
+    ->Arg(1)->Arg(500)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_TriangleMesh_Indexed)
+    ->Arg(1)->Arg(500)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_TriangleMesh_Cached)
+    ->Arg(1)->Arg(500)->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
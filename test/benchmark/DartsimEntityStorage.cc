@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "Base.hh"
+
+using namespace ignition::physics::dartsim;
+
+using Storage = EntityStorage<std::shared_ptr<LinkInfo>, const char *>;
+
+/// \brief The entity storage of the dartsim plugin before it became a slot
+/// map, which kept every entity in five hash maps. It is the baseline of the
+/// benchmarks below.
+template <typename Value1, typename Key2>
+struct HashMapStorage
+{
+  std::unordered_map<std::size_t, Value1> idToObject;
+  std::unordered_map<Key2, std::size_t> objectToID;
+  std::unordered_map<std::size_t, std::vector<std::size_t>>
+      indexInContainerToID;
+  std::unordered_map<std::size_t, std::size_t> idToIndexInContainer;
+  std::unordered_map<std::size_t, std::size_t> idToContainerID;
+
+  void Add(const std::size_t _id, const Key2 &_key, Value1 _object)
+  {
+    this->idToObject[_id] = std::move(_object);
+    this->objectToID[_key] = _id;
+  }
+
+  void AddToContainer(const std::size_t _id, const std::size_t _containerID,
+                      const std::size_t _index)
+  {
+    this->idToContainerID[_id] = _containerID;
+    this->idToIndexInContainer[_id] = _index;
+    this->indexInContainerToID[_containerID].push_back(_id);
+  }
+
+  Value1 &at(const std::size_t _id)
+  {
+    return this->idToObject.at(_id);
+  }
+
+  std::size_t IndexInContainer(const std::size_t _id) const
+  {
+    return this->idToIndexInContainer.at(_id);
+  }
+
+  std::size_t size() const
+  {
+    return this->idToObject.size();
+  }
+
+  bool RemoveEntity(const Key2 &_key)
+  {
+    auto entIter = this->objectToID.find(_key);
+    if (entIter == this->objectToID.end())
+      return false;
+
+    const std::size_t entId = entIter->second;
+    auto contIter = this->idToContainerID.find(entId);
+    if (contIter != this->idToContainerID.end())
+    {
+      std::vector<std::size_t> &siblings =
+          this->indexInContainerToID[contIter->second];
+      const std::size_t entIndex = this->idToIndexInContainer.at(entId);
+      for (auto indIter = siblings.begin() + entIndex + 1;
+           indIter != siblings.end(); ++indIter)
+      {
+        --this->idToIndexInContainer[*indIter];
+      }
+      this->idToIndexInContainer.erase(entId);
+      siblings.erase(siblings.begin() + entIndex);
+      this->idToContainerID.erase(contIter);
+    }
+
+    this->objectToID.erase(entIter);
+    this->idToObject.erase(entId);
+    return true;
+  }
+};
+
+using BaselineStorage = HashMapStorage<std::shared_ptr<LinkInfo>, const char *>;
+
+/// \brief Entity IDs are shared by every kind of entity, so the links of a
+/// world are interleaved with models, joints and shapes.
+static constexpr std::size_t kIdStride = 4u;
+
+/// \brief Number of links in each model
+static constexpr std::size_t kLinksPerModel = 8u;
+
+/// \brief Links of a world, with unique keys and IDs
+struct Links
+{
+  explicit Links(std::size_t _count)
+    : keys(_count)
+  {
+    this->order.resize(_count);
+    std::iota(this->order.begin(), this->order.end(), 0u);
+    std::shuffle(this->order.begin(), this->order.end(), std::mt19937(1234));
+  }
+
+  /// \brief Add every link to a storage
+  template <typename StorageT>
+  void Fill(StorageT &_storage) const
+  {
+    for (std::size_t i = 0; i < this->keys.size(); ++i)
+    {
+      const std::size_t id = i * kIdStride + 1u;
+      _storage.Add(id, &this->keys[i], std::make_shared<LinkInfo>());
+      _storage.AddToContainer(id, (i / kLinksPerModel) * kIdStride,
+                              i % kLinksPerModel);
+    }
+  }
+
+  /// \brief Addresses of these are the keys of the links
+  std::vector<char> keys;
+
+  /// \brief Random order in which to access the links
+  std::vector<std::size_t> order;
+};
+
+template <typename StorageT>
+// NOLINTNEXTLINE
+void BM_EntityStorage_Add(benchmark::State &_st)
+{
+  const Links links(_st.range(0));
+  for (auto _ : _st)
+  {
+    StorageT storage;
+    links.Fill(storage);
+    benchmark::DoNotOptimize(storage.size());
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+template <typename StorageT>
+// NOLINTNEXTLINE
+void BM_EntityStorage_Lookup(benchmark::State &_st)
+{
+  const Links links(_st.range(0));
+  StorageT storage;
+  links.Fill(storage);
+  for (auto _ : _st)
+  {
+    for (const std::size_t i : links.order)
+    {
+      benchmark::DoNotOptimize(storage.at(i * kIdStride + 1u).get());
+      benchmark::DoNotOptimize(storage.IndexInContainer(i * kIdStride + 1u));
+    }
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+template <typename StorageT>
+// NOLINTNEXTLINE
+void BM_EntityStorage_Remove(benchmark::State &_st)
+{
+  const Links links(_st.range(0));
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    StorageT storage;
+    links.Fill(storage);
+    _st.ResumeTiming();
+
+    for (const std::size_t i : links.order)
+      storage.RemoveEntity(&links.keys[i]);
+    benchmark::DoNotOptimize(storage.size());
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_EntityStorage_Add, BaselineStorage)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_EntityStorage_Add, Storage)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_EntityStorage_Lookup, BaselineStorage)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_EntityStorage_Lookup, Storage)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_EntityStorage_Remove, BaselineStorage)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_EntityStorage_Remove, Storage)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <dart/collision/ode/OdeCollisionDetector.hpp>
+#include <dart/constraint/ConstraintSolver.hpp>
+#include <dart/dynamics/FreeJoint.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+#include <dart/dynamics/WeldJoint.hpp>
+#include <dart/simulation/World.hpp>
+
+#include <ignition/common/MeshManager.hh>
+
+#include "CustomMeshShape.hh"
+
+using namespace ignition;
+using namespace physics::dartsim;
+
+/////////////////////////////////////////////////
+/// \brief Resident set size of this process in bytes, or 0 if unknown. It is
+/// only known on Linux.
+static double ResidentSetSize()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0u;
+  std::size_t resident = 0u;
+  if (!(statm >> size >> resident))
+    return 0.0;
+  return static_cast<double>(resident * sysconf(_SC_PAGESIZE));
+#else
+  return 0.0;
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief A sphere that is dense enough to cost as much as a detailed mesh
+static const common::Mesh &SphereMesh()
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const std::string name = "benchmark_sphere";
+  if (!meshManager->HasMesh(name))
+    meshManager->CreateSphere(name, 1.0, 128, 128);
+  return *meshManager->MeshByName(name);
+}
+
+/////////////////////////////////////////////////
+/// \brief A thick tube, which is concave, so that its convex hull fills its
+/// hole while its convex decomposition does not
+static const common::Mesh &TubeMesh()
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const std::string name = "benchmark_tube";
+  if (!meshManager->HasMesh(name))
+    meshManager->CreateTube(name, 0.6f, 1.0f, 2.0f, 4, 256);
+  return *meshManager->MeshByName(name);
+}
+
+/// \brief Create one shape for each instance of a mesh, and report the memory
+/// that the shapes use.
+/// Arguments are: number of instances
+template <typename CreateFunc>
+void CreateInstances(benchmark::State &_st, CreateFunc _create)
+{
+  const common::Mesh &mesh = SphereMesh();
+  const Eigen::Vector3d scale(1.0, 1.0, 1.0);
+  double rss = 0.0;
+  for (auto _ : _st)
+  {
+    const double rssBefore = ResidentSetSize();
+    std::vector<std::shared_ptr<CustomMeshShape>> shapes;
+    shapes.reserve(_st.range(0));
+    for (int64_t i = 0; i < _st.range(0); ++i)
+      shapes.push_back(_create(mesh, scale));
+    rss = ResidentSetSize() - rssBefore;
+
+    // The shapes are freed outside of the measured time
+    _st.PauseTiming();
+    shapes.clear();
+    _st.ResumeTiming();
+  }
+  _st.counters["rss_bytes"] = rss;
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+void BM_MeshShape_Convert(benchmark::State &_st)
+{
+  CreateInstances(_st, [](const common::Mesh &_mesh,
+                          const Eigen::Vector3d &_scale)
+  {
+    return std::make_shared<CustomMeshShape>(_mesh, _scale);
+  });
+}
+
+// NOLINTNEXTLINE
+void BM_MeshShape_Cached(benchmark::State &_st)
+{
+  CreateInstances(_st, &CustomMeshShape::Get);
+  if (CustomMeshShape::CacheSize() != 0u)
+    _st.SkipWithError("Unused shapes were not evicted from the cache");
+}
+
+/// \brief Step a world in which pairs of tubes rest on each other, so that
+/// every step finds mesh-mesh contacts.
+/// Arguments are: number of pairs
+template <typename CreateFunc>
+void StepContacts(benchmark::State &_st, CreateFunc _create)
+{
+  const common::Mesh &mesh = TubeMesh();
+  const Eigen::Vector3d scale(1.0, 1.0, 1.0);
+
+  auto world = dart::simulation::World::create();
+  world->getConstraintSolver()->setCollisionDetector(
+      dart::collision::OdeCollisionDetector::create());
+  for (int64_t i = 0; i < _st.range(0); ++i)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() = Eigen::Vector3d(3.0 * static_cast<double>(i), 0, 0);
+
+    // The tubes are 2 m long and wide, so they slightly overlap
+    auto base = dart::dynamics::Skeleton::create("base" + std::to_string(i));
+    auto baseBody =
+        base->createJointAndBodyNodePair<dart::dynamics::WeldJoint>().second;
+    baseBody->getParentJoint()->setTransformFromParentBodyNode(pose);
+    baseBody->createShapeNodeWith<dart::dynamics::CollisionAspect,
+        dart::dynamics::DynamicsAspect>(_create(mesh, scale));
+    world->addSkeleton(base);
+
+    pose.translation().z() = 1.99;
+    auto object =
+        dart::dynamics::Skeleton::create("object" + std::to_string(i));
+    auto objectBody =
+        object->createJointAndBodyNodePair<dart::dynamics::FreeJoint>().second;
+    dart::dynamics::FreeJoint::setTransform(objectBody, pose);
+    objectBody->createShapeNodeWith<dart::dynamics::CollisionAspect,
+        dart::dynamics::DynamicsAspect>(_create(mesh, scale));
+    world->addSkeleton(object);
+  }
+
+  for (auto _ : _st)
+    world->step();
+  _st.counters["contacts"] =
+      static_cast<double>(world->getLastCollisionResult().getNumContacts());
+  _st.SetItemsProcessed(_st.iterations());
+}
+
+// NOLINTNEXTLINE
+void BM_MeshShape_StepTriangles(benchmark::State &_st)
+{
+  StepContacts(_st, &CustomMeshShape::Get);
+}
+
+// NOLINTNEXTLINE
+void BM_MeshShape_StepConvexHull(benchmark::State &_st)
+{
+  StepContacts(_st, [](const common::Mesh &_mesh,
+                       const Eigen::Vector3d &_scale)
+  {
+    return CustomMeshShape::GetConvex(_mesh, _scale,
+        physics::mesh::ConvexDecompositionOptions());
+  });
+}
+
+// NOLINTNEXTLINE
+void BM_MeshShape_StepConvexDecomposition(benchmark::State &_st)
+{
+  StepContacts(_st, [](const common::Mesh &_mesh,
+                       const Eigen::Vector3d &_scale)
+  {
+    physics::mesh::ConvexDecompositionOptions options;
+    options.maxConvexHulls = 16u;
+    return CustomMeshShape::GetConvex(_mesh, _scale, options);
+  });
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_MeshShape_Convert)
+    ->Arg(1)->Arg(500)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_MeshShape_Cached)
+    ->Arg(1)->Arg(500)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_MeshShape_StepTriangles)
+    ->Arg(1)->Arg(20)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_MeshShape_StepConvexHull)
+    ->Arg(1)->Arg(20)->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_MeshShape_StepConvexDecomposition)
+    ->Arg(1)->Arg(20)->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "aabb_tree/AABB.h"
+#include "aabb_tree/AABB3d.h"
+
+/// \brief Random boxes scattered so that each box overlaps a handful of
+/// neighbors, which is representative of a crowd scene.
+struct Boxes
+{
+  explicit Boxes(std::size_t _count)
+  {
+    // Keep the density constant regardless of the number of boxes
+    const double extent = 4.0 * std::cbrt(static_cast<double>(_count));
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> pos(0.0, extent);
+    std::uniform_real_distribution<double> size(0.5, 2.0);
+    std::uniform_real_distribution<double> step(-0.1, 0.1);
+
+    this->lower.resize(_count, std::vector<double>(3));
+    this->upper.resize(_count, std::vector<double>(3));
+    this->delta.resize(_count, std::vector<double>(3));
+    for (std::size_t i = 0; i < _count; ++i)
+    {
+      for (std::size_t k = 0; k < 3; ++k)
+      {
+        this->lower[i][k] = pos(gen);
+        this->upper[i][k] = this->lower[i][k] + size(gen);
+        this->delta[i][k] = step(gen);
+      }
+    }
+  }
+
+  /// \brief Move every box by its velocity
+  void Move()
+  {
+    for (std::size_t i = 0; i < this->lower.size(); ++i)
+    {
+      for (std::size_t k = 0; k < 3; ++k)
+      {
+        this->lower[i][k] += this->delta[i][k];
+        this->upper[i][k] += this->delta[i][k];
+      }
+    }
+  }
+
+  std::vector<std::vector<double>> lower;
+  std::vector<std::vector<double>> upper;
+  std::vector<std::vector<double>> delta;
+};
+
+// NOLINTNEXTLINE
+void BM_Tree_Build(benchmark::State &_st)
+{
+  Boxes boxes(_st.range(0));
+  for (auto _ : _st)
+  {
+    aabb::Tree tree(3, 0.0, 16);
+    for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+      tree.insertParticle(i, boxes.lower[i], boxes.upper[i]);
+    benchmark::DoNotOptimize(tree.getHeight());
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+void BM_Tree3d_Build(benchmark::State &_st)
+{
+  Boxes boxes(_st.range(0));
+  for (auto _ : _st)
+  {
+    aabb::Tree3d tree(0.0, 16);
+    for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+      tree.insertParticle(i, boxes.lower[i].data(), boxes.upper[i].data());
+    benchmark::DoNotOptimize(tree.getHeight());
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+void BM_Tree_UpdateAndQuery(benchmark::State &_st)
+{
+  Boxes boxes(_st.range(0));
+  aabb::Tree tree(3, 0.0, 16);
+  for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+    tree.insertParticle(i, boxes.lower[i], boxes.upper[i]);
+
+  for (auto _ : _st)
+  {
+    boxes.Move();
+    std::size_t pairs = 0;
+    for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+      tree.updateParticle(i, boxes.lower[i], boxes.upper[i]);
+    for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+      pairs += tree.query(i).size();
+    benchmark::DoNotOptimize(pairs);
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+void BM_Tree3d_UpdateAndQuery(benchmark::State &_st)
+{
+  Boxes boxes(_st.range(0));
+  aabb::Tree3d tree(0.0, 16);
+  for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+    tree.insertParticle(i, boxes.lower[i].data(), boxes.upper[i].data());
+
+  std::vector<std::size_t> result;
+  for (auto _ : _st)
+  {
+    boxes.Move();
+    std::size_t pairs = 0;
+    for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+      tree.updateParticle(i, boxes.lower[i].data(), boxes.upper[i].data());
+    for (std::size_t i = 0; i < boxes.lower.size(); ++i)
+    {
+      result.clear();
+      tree.query(i, result);
+      pairs += result.size();
+    }
+    benchmark::DoNotOptimize(pairs);
+  }
+  _st.SetItemsProcessed(_st.iterations() * _st.range(0));
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_Tree_Build)->Arg(1000)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_Tree3d_Build)->Arg(1000)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_Tree_UpdateAndQuery)->Arg(1000)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+// NOLINTNEXTLINE
+BENCHMARK(BM_Tree3d_UpdateAndQuery)->Arg(1000)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "lib/src/Collision.hh"
+#include "lib/src/CollisionDetector.hh"
+#include "lib/src/Link.hh"
+#include "lib/src/Model.hh"
+#include "lib/src/Shape.hh"
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+/// \brief Time step used by the benchmarks
+static const double kTimeStep = 0.001;
+
+/// \brief Create box models that move slowly in random directions
+/// \param[in] _count Number of models
+/// \param[out] _entities Models keyed by id
+void CreateModels(std::size_t _count, EntityMap &_entities)
+{
+  // Keep the density constant regardless of the number of models
+  const double extent = 2.0 * std::cbrt(static_cast<double>(_count));
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> pos(0.0, extent);
+  std::uniform_real_distribution<double> vel(-1.0, 1.0);
+
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+
+    model->SetPose(math::Pose3d(pos(gen), pos(gen), pos(gen), 0, 0, 0));
+    model->SetLinearVelocity(math::Vector3d(vel(gen), vel(gen), vel(gen)));
+    _entities.insert({model->GetId(), model});
+  }
+}
+
+/// \brief Step models and check collisions, reporting the number of AABB
+/// tree reinsertions per step.
+/// Arguments are: number of models, margin in mm, number of prediction steps
+// NOLINTNEXTLINE
+void BM_CheckCollisions(benchmark::State &_st)
+{
+  EntityMap entities;
+  CreateModels(_st.range(0), entities);
+
+  CollisionDetector cd;
+  cd.SetMargin(_st.range(1) * 1e-3);
+  cd.SetPredictionTime(_st.range(2) * kTimeStep);
+
+  // the first call inserts all models into the tree
+  cd.CheckCollisions(entities, true);
+
+  std::size_t steps = 0u;
+  std::size_t reinserted = 0u;
+  for (auto _ : _st)
+  {
+    for (auto &it : entities)
+    {
+      static_cast<Model *>(it.second.get())->UpdatePose(kTimeStep);
+    }
+    auto contacts = cd.CheckCollisions(entities, true);
+    benchmark::DoNotOptimize(contacts);
+    entities.ClearPoseDirty();
+
+    reinserted += cd.ReinsertedCount();
+    ++steps;
+  }
+  _st.counters["reinserted_per_step"] =
+      static_cast<double>(reinserted) / static_cast<double>(steps);
+  _st.counters["pairs"] = static_cast<double>(cd.PairCount());
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_CheckCollisions)
+    ->ArgNames({"models", "margin_mm", "predict_steps"})
+    ->Args({1000, 0, 0})
+    ->Args({1000, 50, 0})
+    ->Args({1000, 50, 4})
+    ->Args({10000, 0, 0})
+    ->Args({10000, 50, 0})
+    ->Args({10000, 50, 4})
+    ->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
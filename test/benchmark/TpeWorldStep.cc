@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+
+#include "lib/src/Collision.hh"
+#include "lib/src/Link.hh"
+#include "lib/src/Model.hh"
+#include "lib/src/Shape.hh"
+#include "lib/src/World.hh"
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+/// \brief Step a world of moving box models.
+/// Arguments are: number of models, number of threads
+// NOLINTNEXTLINE
+void BM_WorldStep(benchmark::State &_st)
+{
+  const std::size_t count = _st.range(0);
+
+  World world;
+  world.SetTimeStep(0.001);
+  world.SetThreadCount(_st.range(1));
+
+  // Keep the density constant regardless of the number of models
+  const double extent = 2.0 * std::cbrt(static_cast<double>(count));
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> pos(0.0, extent);
+  std::uniform_real_distribution<double> vel(-1.0, 1.0);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Entity &modelEnt = world.AddModel();
+    Model *model = static_cast<Model *>(&modelEnt);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+
+    model->SetPose(math::Pose3d(pos(gen), pos(gen), pos(gen), 0, 0, 0));
+    model->SetLinearVelocity(math::Vector3d(vel(gen), vel(gen), vel(gen)));
+  }
+
+  // the first step inserts all models into the broadphase
+  world.Step();
+
+  for (auto _ : _st)
+  {
+    world.Step();
+    benchmark::DoNotOptimize(world.GetContacts());
+  }
+  _st.SetItemsProcessed(_st.iterations() * count);
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_WorldStep)
+    ->ArgNames({"models", "threads"})
+    ->ArgsProduct({{1000, 20000}, {1, 2, 4, 8, 16, 32}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
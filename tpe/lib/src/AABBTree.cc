@@ -15,11 +15,14 @@
  *
 */
 
+#include <algorithm>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 
-#include "aabb_tree/AABB.h"
+#include "aabb_tree/AABB3d.h"
 
 #include "AABBTree.hh"
 
@@ -30,12 +33,15 @@ namespace tpelib {
 /// \brief Private data class for AABBTree
 class AABBTreePrivate
 {
-  /// \brief Pointer to the AABB tree
-  public: std::unique_ptr<aabb::Tree> aabbTree;
+  /// \brief The AABB tree. Node ids are the tree's particle indices.
+  public: aabb::Tree3d aabbTree{0.0, 16u};
 
-  /// \brief A map of node id and its AABB object in the tree
-  // public: std::unordered_map<std::size_t, unsigned int> nodeIds;
-  public: std::set<std::size_t> nodeIds;
+  /// \brief Margin added to each side of the node boxes
+  public: double margin = 0.0;
+
+  /// \brief Boxes of the nodes without the margin. The tree only stores the
+  /// fattened boxes.
+  public: std::unordered_map<std::size_t, math::AxisAlignedBox> boxes;
 };
 }
 }
@@ -49,42 +55,48 @@ using namespace tpelib;
 AABBTree::AABBTree()
   : dataPtr(new ::tpelib::AABBTreePrivate)
 {
-  this->dataPtr->aabbTree = std::make_unique<aabb::Tree>(3, 0.0, 100000);
 }
 
 //////////////////////////////////////////////////
 AABBTree::~AABBTree() = default;
 
 //////////////////////////////////////////////////
-void AABBTree::AddNode(std::size_t _id, const math::AxisAlignedBox &_aabb)
+void AABBTree::SetMargin(double _margin)
 {
-  std::vector<double> lowerBound(3);
-  lowerBound[0] = _aabb.Min().X();
-  lowerBound[1] = _aabb.Min().Y();
-  lowerBound[2] = _aabb.Min().Z();
+  this->dataPtr->margin = std::max(0.0, _margin);
+}
 
-  std::vector<double> upperBound(3);
-  upperBound[0] = _aabb.Max().X();
-  upperBound[1] = _aabb.Max().Y();
-  upperBound[2] = _aabb.Max().Z();
+//////////////////////////////////////////////////
+double AABBTree::Margin() const
+{
+  return this->dataPtr->margin;
+}
 
-  this->dataPtr->aabbTree->insertParticle(_id, lowerBound, upperBound);
-  this->dataPtr->nodeIds.insert(_id);
+//////////////////////////////////////////////////
+void AABBTree::AddNode(std::size_t _id, const math::AxisAlignedBox &_aabb)
+{
+  const double m = this->dataPtr->margin;
+  const double lowerBound[3] =
+      {_aabb.Min().X() - m, _aabb.Min().Y() - m, _aabb.Min().Z() - m};
+  const double upperBound[3] =
+      {_aabb.Max().X() + m, _aabb.Max().Y() + m, _aabb.Max().Z() + m};
+
+  this->dataPtr->aabbTree.insertParticle(_id, lowerBound, upperBound);
+  this->dataPtr->boxes[_id] = _aabb;
 }
 
 //////////////////////////////////////////////////
 bool AABBTree::RemoveNode(std::size_t _id)
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  if (!this->dataPtr->aabbTree.hasParticle(_id))
   {
     ignerr << "Unable to remove node '" << _id << "'. "
            << "Node not found." << std::endl;
     return false;
   }
 
-  this->dataPtr->aabbTree->removeParticle(_id);
-  this->dataPtr->nodeIds.erase(it);
+  this->dataPtr->aabbTree.removeParticle(_id);
+  this->dataPtr->boxes.erase(_id);
   return true;
 }
 
@@ -92,64 +104,106 @@ bool AABBTree::RemoveNode(std::size_t _id)
 bool AABBTree::UpdateNode(std::size_t _id,
     const math::AxisAlignedBox &_aabb)
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  bool reinserted = false;
+  return this->UpdateNode(_id, _aabb, reinserted);
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::UpdateNode(std::size_t _id,
+    const math::AxisAlignedBox &_aabb, bool &_reinserted)
+{
+  return this->UpdateNode(_id, _aabb, math::Vector3d::Zero, _reinserted);
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::UpdateNode(std::size_t _id,
+    const math::AxisAlignedBox &_aabb, const math::Vector3d &_displacement,
+    bool &_reinserted)
+{
+  _reinserted = false;
+  if (!this->dataPtr->aabbTree.hasParticle(_id))
   {
     ignerr << "Unable to update node '" << _id << "'. "
            << "Node not found." << std::endl;
     return false;
   }
 
-  std::vector<double> lowerBound(3);
-  lowerBound[0] = _aabb.Min().X();
-  lowerBound[1] = _aabb.Min().Y();
-  lowerBound[2] = _aabb.Min().Z();
-
-  std::vector<double> upperBound(3);
-  upperBound[0] = _aabb.Max().X();
-  upperBound[1] = _aabb.Max().Y();
-  upperBound[2] = _aabb.Max().Z();
+  const double lowerBound[3] =
+      {_aabb.Min().X(), _aabb.Min().Y(), _aabb.Min().Z()};
+  const double upperBound[3] =
+      {_aabb.Max().X(), _aabb.Max().Y(), _aabb.Max().Z()};
 
+  // fatten the box by the margin and extend it in the direction of motion
+  const double m = this->dataPtr->margin;
+  double fatLowerBound[3];
+  double fatUpperBound[3];
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    fatLowerBound[i] = lowerBound[i] - m + std::min(0.0, _displacement[i]);
+    fatUpperBound[i] = upperBound[i] + m + std::max(0.0, _displacement[i]);
+  }
 
-  this->dataPtr->aabbTree->updateParticle(_id, lowerBound, upperBound);
+  _reinserted = this->dataPtr->aabbTree.updateParticle(_id,
+      lowerBound, upperBound, fatLowerBound, fatUpperBound);
+  this->dataPtr->boxes[_id] = _aabb;
   return true;
 }
 
 //////////////////////////////////////////////////
 unsigned int AABBTree::NodeCount() const
 {
-  return this->dataPtr->nodeIds.size();
+  return static_cast<unsigned int>(this->dataPtr->aabbTree.nParticles());
 }
 
 //////////////////////////////////////////////////
 std::set<std::size_t> AABBTree::Collisions(std::size_t _id) const
 {
-  std::set<std::size_t> result;
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  std::vector<std::size_t> collisions;
+  this->Collisions(_id, collisions);
+  return std::set<std::size_t>(collisions.begin(), collisions.end());
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::Collisions(std::size_t _id,
+    std::vector<std::size_t> &_result) const
+{
+  _result.clear();
+  if (!this->dataPtr->aabbTree.hasParticle(_id))
   {
     ignerr << "Unable to compute collisions for node '" << _id << "'. "
            << "Node not found." << std::endl;
-    return result;
+    return false;
   }
 
-  auto collisions  = this->dataPtr->aabbTree->query(_id);
-  result = std::set<std::size_t>(collisions.begin(), collisions.end());
-  return result;
+  this->dataPtr->aabbTree.query(_id, _result);
+  return true;
 }
 
 //////////////////////////////////////////////////
 math::AxisAlignedBox AABBTree::AABB(std::size_t _id) const
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  auto it = this->dataPtr->boxes.find(_id);
+  if (it == this->dataPtr->boxes.end())
   {
     ignerr << "Unable to get AABB for node '" << _id << "'. "
            << "Node not found." << std::endl;
     return math::AxisAlignedBox();
   }
 
-  auto aabb = this->dataPtr->aabbTree->getAABB(_id);
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox AABBTree::FatAABB(std::size_t _id) const
+{
+  if (!this->dataPtr->aabbTree.hasParticle(_id))
+  {
+    ignerr << "Unable to get fattened AABB for node '" << _id << "'. "
+           << "Node not found." << std::endl;
+    return math::AxisAlignedBox();
+  }
+
+  const auto &aabb = this->dataPtr->aabbTree.getAABB(_id);
 
   return math::AxisAlignedBox(
       math::Vector3d(
@@ -161,6 +215,5 @@ math::AxisAlignedBox AABBTree::AABB(std::size_t _id) const
 //////////////////////////////////////////////////
 bool AABBTree::HasNode(std::size_t _id) const
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  return it != this->dataPtr->nodeIds.end();
+  return this->dataPtr->aabbTree.hasParticle(_id);
 }
@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <set>
+#include <vector>
 
 #include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/utils/SuppressWarning.hh>
@@ -41,6 +42,18 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE AABBTree
   /// \brief Destructor
   public: ~AABBTree();
 
+  /// \brief Set the margin that node boxes are fattened by when they are
+  /// inserted into the tree. A node is only reinserted when its box moves
+  /// out of its fattened box, so a larger margin means fewer tree updates
+  /// for slow moving nodes, at the cost of more overlapping pairs.
+  /// \param[in] _margin Margin in meters on each side of the box. Default is
+  /// 0.
+  public: void SetMargin(double _margin);
+
+  /// \brief Get the margin that node boxes are fattened by
+  /// \return Margin in meters on each side of the box
+  public: double Margin() const;
+
   /// \brief Add a node to the tree
   /// \param[in] _aabb Axis aligned bounding box of the node
   /// \param[in] _id Unique id of this node
@@ -57,6 +70,29 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE AABBTree
   /// \return True if the update was successful, false otherwise
   public: bool UpdateNode(std::size_t _id, const math::AxisAlignedBox &_aabb);
 
+  /// \brief Update a node's axis aligned bounding box
+  /// \param[in] _id Node id
+  /// \param[in] _aabb New axis aligned bounding box
+  /// \param[out] _reinserted True if the new box left the node's fattened
+  /// box and the node was reinserted into the tree. When this is false, the
+  /// result of Collisions() for this node is unchanged by the update.
+  /// \return True if the update was successful, false otherwise
+  public: bool UpdateNode(std::size_t _id, const math::AxisAlignedBox &_aabb,
+      bool &_reinserted);
+
+  /// \brief Update a node's axis aligned bounding box. If the node is
+  /// reinserted, its fattened box is also extended by the expected
+  /// displacement of the node so that it is not reinserted again on the
+  /// next update if it keeps moving at the same velocity.
+  /// \param[in] _id Node id
+  /// \param[in] _aabb New axis aligned bounding box
+  /// \param[in] _displacement Expected displacement of the node until the
+  /// next update
+  /// \param[out] _reinserted True if the node was reinserted into the tree
+  /// \return True if the update was successful, false otherwise
+  public: bool UpdateNode(std::size_t _id, const math::AxisAlignedBox &_aabb,
+      const math::Vector3d &_displacement, bool &_reinserted);
+
   /// \brief Get the number of nodes in the tree
   /// \return Number of nodes
   public: unsigned int NodeCount() const;
@@ -66,11 +102,28 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE AABBTree
   /// \return A set of node ids that collide with the input node
   public: std::set<std::size_t> Collisions(std::size_t _id) const;
 
+  /// \brief Get all the nodes that collide / intersect with input node.
+  /// This overload writes into a caller owned vector so that the buffer can
+  /// be reused across queries without reallocating.
+  /// \param[in] _id Input node id
+  /// \param[out] _result Ids of nodes that collide with the input node. The
+  /// vector is cleared first. The order of the ids is unspecified.
+  /// \return True if the node exists, false otherwise
+  public: bool Collisions(std::size_t _id,
+      std::vector<std::size_t> &_result) const;
+
   /// \brief Get the AABB for a node
   /// \param[in] _id Node id
-  /// \return Node's AABB
+  /// \return Node's AABB as last added or updated, without the margin
   public: math::AxisAlignedBox AABB(std::size_t _id) const;
 
+  /// \brief Get the fattened AABB that the tree stores for a node. This is
+  /// the node's AABB, fattened by the margin and extended by the expected
+  /// displacement, when the node was last inserted into the tree.
+  /// \param[in] _id Node id
+  /// \return Node's fattened AABB
+  public: math::AxisAlignedBox FatAABB(std::size_t _id) const;
+
   /// \brief Get whether the tree has a node with specified id
   /// \param[in] _id Node id
   /// \return True if tree has node, false otherwise
@@ -163,3 +163,82 @@ TEST(AABBTree, AABBTree)
   result = tree.Collisions(eId);
   EXPECT_EQ(0u, result.size());
 }
+
+/////////////////////////////////////////////////
+TEST(AABBTree, CollisionsIntoVector)
+{
+  AABBTree tree;
+
+  // ids that do not fit in 32 bits must not alias each other
+  std::size_t aId = 1u;
+  std::size_t bId = (static_cast<std::size_t>(1u) << 32u) + 1u;
+  std::size_t cId = 3u;
+  tree.AddNode(aId, math::AxisAlignedBox(
+      -math::Vector3d::One, math::Vector3d::One));
+  tree.AddNode(bId, math::AxisAlignedBox(
+      math::Vector3d::Zero, math::Vector3d(2, 2, 2)));
+  tree.AddNode(cId, math::AxisAlignedBox(
+      math::Vector3d(5, 5, 5), math::Vector3d(6, 6, 6)));
+  EXPECT_EQ(3u, tree.NodeCount());
+  EXPECT_TRUE(tree.HasNode(bId));
+
+  std::vector<std::size_t> result{42u};
+  EXPECT_TRUE(tree.Collisions(aId, result));
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(bId, result[0]);
+
+  EXPECT_TRUE(tree.Collisions(cId, result));
+  EXPECT_TRUE(result.empty());
+
+  EXPECT_FALSE(tree.Collisions(555u, result));
+  EXPECT_TRUE(result.empty());
+
+  // touching boxes count as colliding
+  EXPECT_TRUE(tree.UpdateNode(cId, math::AxisAlignedBox(
+      math::Vector3d(2, 2, 2), math::Vector3d(3, 3, 3))));
+  EXPECT_TRUE(tree.Collisions(cId, result));
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(bId, result[0]);
+
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(2, 2, 2),
+      math::Vector3d(3, 3, 3)), tree.AABB(cId));
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, FatAABB)
+{
+  AABBTree tree;
+  tree.SetMargin(0.5);
+
+  const std::size_t id = 1u;
+  const math::AxisAlignedBox box(math::Vector3d::Zero, math::Vector3d::One);
+  tree.AddNode(id, box);
+  EXPECT_EQ(box, tree.AABB(id));
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(-0.5, -0.5, -0.5),
+      math::Vector3d(1.5, 1.5, 1.5)), tree.FatAABB(id));
+
+  // moving within the fattened box only updates the box of the node
+  bool reinserted = true;
+  const math::AxisAlignedBox moved(math::Vector3d(0.2, 0, 0),
+      math::Vector3d(1.2, 1, 1));
+  EXPECT_TRUE(tree.UpdateNode(id, moved, math::Vector3d(1, 0, 0),
+      reinserted));
+  EXPECT_FALSE(reinserted);
+  EXPECT_EQ(moved, tree.AABB(id));
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(-0.5, -0.5, -0.5),
+      math::Vector3d(1.5, 1.5, 1.5)), tree.FatAABB(id));
+
+  // leaving it extends the new fattened box along the displacement
+  const math::AxisAlignedBox left(math::Vector3d(2, 0, 0),
+      math::Vector3d(3, 1, 1));
+  EXPECT_TRUE(tree.UpdateNode(id, left, math::Vector3d(1, 0, 0),
+      reinserted));
+  EXPECT_TRUE(reinserted);
+  EXPECT_EQ(left, tree.AABB(id));
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(1.5, -0.5, -0.5),
+      math::Vector3d(4.5, 1.5, 1.5)), tree.FatAABB(id));
+
+  EXPECT_TRUE(tree.RemoveNode(id));
+  EXPECT_EQ(math::AxisAlignedBox(), tree.AABB(id));
+  EXPECT_EQ(math::AxisAlignedBox(), tree.FatAABB(id));
+}
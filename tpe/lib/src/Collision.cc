@@ -24,9 +24,6 @@ class ignition::physics::tpelib::CollisionPrivate
 {
   /// \brief Collision's geometry shape
   public: std::shared_ptr<Shape> shape = nullptr;
-
-  /// \brief Collide bitmask
-  public: uint16_t collideBitmask = 0xFF;
 };
 
 using namespace ignition;
@@ -35,19 +32,19 @@ using namespace tpelib;
 
 //////////////////////////////////////////////////
 Collision::Collision()
-  : Entity(), dataPtr(new CollisionPrivate)
+  : Entity(EntityType::COLLISION), dataPtr(new CollisionPrivate)
 {
 }
 
 //////////////////////////////////////////////////
 Collision::Collision(std::size_t _id)
-  : Entity(_id), dataPtr(new CollisionPrivate)
+  : Entity(_id, EntityType::COLLISION), dataPtr(new CollisionPrivate)
 {
 }
 
 //////////////////////////////////////////////////
 Collision::Collision(const Collision &_other)
-  : Entity(), dataPtr(new CollisionPrivate)
+  : Entity(EntityType::COLLISION), dataPtr(new CollisionPrivate)
 {
   this->dataPtr->shape = _other.dataPtr->shape;
 }
@@ -126,7 +123,7 @@ math::AxisAlignedBox Collision::GetBoundingBox(bool /*_force*/) // NOLINT
 //////////////////////////////////////////////////
 void Collision::SetCollideBitmask(uint16_t _mask)
 {
-  this->dataPtr->collideBitmask = _mask;
+  EntityStore::Instance().SetCollideBitmask(this->GetHandle(), _mask);
   if (this->GetParent())
     this->GetParent()->ChildrenChanged();
 }
@@ -134,5 +131,5 @@ void Collision::SetCollideBitmask(uint16_t _mask)
 //////////////////////////////////////////////////
 uint16_t Collision::GetCollideBitmask() const
 {
-  return this->dataPtr->collideBitmask;
+  return EntityStore::Instance().CollideBitmask(this->GetHandle());
 }
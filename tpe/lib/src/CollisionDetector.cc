@@ -15,25 +15,202 @@
  *
 */
 
+#include <algorithm>
+#include <array>
 #include <set>
 #include <unordered_map>
+#include <utility>
 
 #include <ignition/common/Profiler.hh>
 
+#include "Collision.hh"
 #include "CollisionDetector.hh"
+#include "Narrowphase.hh"
 #include "Utils.hh"
 
 #include "AABBTree.hh"
 
+namespace ignition {
+namespace physics {
+namespace tpelib {
+
+/// \brief Minimum number of entities or pairs processed by each thread
+static const std::size_t kGrainSize = 256u;
+
+/// \brief Update of an entity in the AABB tree
+struct NodeUpdate
+{
+  /// \brief Entity id
+  std::size_t id = kNullEntityId;
+
+  /// \brief Entity
+  Entity *entity = nullptr;
+
+  /// \brief True if the entity is not in the tree yet
+  bool isNew = false;
+
+  /// \brief True if the entity has a valid bounding box
+  bool valid = false;
+
+  /// \brief Expected displacement of the entity until the next update
+  math::Vector3d displacement;
+};
+
+/// \brief Pair of entities to check for intersection
+struct NarrowphasePair
+{
+  /// \brief Id of first entity
+  std::size_t id1 = kNullEntityId;
+
+  /// \brief Id of second entity
+  std::size_t id2 = kNullEntityId;
+
+  /// \brief Contacts from the previous check of the pair if neither entity
+  /// moved since then, nullptr otherwise
+  const std::vector<Contact> *cached = nullptr;
+
+  /// \brief True if neither entity moved, so the contacts of this pair
+  /// should be cached for the next check
+  bool quiet = false;
+};
+
+/// \brief Get the intersection points between two axis aligned boxes, see
+/// CollisionDetector::GetIntersectionPoints
+/// \param[in] _b1 Axis aligned box 1
+/// \param[in] _b2 Axis aligned box 2
+/// \param[out] _points Intersection points to be filled
+/// \param[in] _singleContact Get only 1 intersection point at center of
+/// all points
+/// \return True if the boxes intersect
+static bool intersectionPoints(const math::AxisAlignedBox &_b1,
+    const math::AxisAlignedBox &_b2,
+    std::vector<math::Vector3d> &_points, bool _singleContact)
+{
+  // fast intersection check
+  if (_b1.Intersects(_b2))
+  {
+    // when two boxes intersect, the overlapping region is a small box
+    // get all corners of this intersection box
+    math::Vector3d min;
+    math::Vector3d max;
+    min.X() = std::max(_b1.Min().X(), _b2.Min().X());
+    min.Y() = std::max(_b1.Min().Y(), _b2.Min().Y());
+    min.Z() = std::max(_b1.Min().Z(), _b2.Min().Z());
+
+    max.X() = std::min(_b1.Max().X(), _b2.Max().X());
+    max.Y() = std::min(_b1.Max().Y(), _b2.Max().Y());
+    max.Z() = std::min(_b1.Max().Z(), _b2.Max().Z());
+
+    if (_singleContact)
+    {
+      // return center of intersecting region
+      _points.push_back(min + 0.5*(max-min));
+      return true;
+    }
+
+    // min min min
+    math::Vector3d corner = min;
+    _points.push_back(corner);
+
+    // min min max
+    corner.Z() = max.Z();
+    _points.push_back(corner);
+
+    // min max max
+    corner.Y() = max.Y();
+    _points.push_back(corner);
+
+    // min max min
+    corner.Z() = min.Z();
+    _points.push_back(corner);
+
+    // max max min
+    corner.X() = max.X();
+    _points.push_back(corner);
+
+    // max max max
+    corner.Z() = max.Z();
+    _points.push_back(corner);
+
+    // max min max
+    corner.Y() = min.Y();
+    _points.push_back(corner);
+
+    // max min min
+    corner.Z() = min.Z();
+    _points.push_back(corner);
+
+    return true;
+  }
+  return false;
+}
+
+/// \brief Hash function for a pair of entity ids
+struct PairHash
+{
+  std::size_t operator()(const std::pair<std::size_t, std::size_t> &_p) const
+  {
+    return std::hash<std::size_t>()(_p.first) ^
+        (std::hash<std::size_t>()(_p.second) * 0x9e3779b97f4a7c15ULL);
+  }
+};
+}
+}
+}
+
 /// \brief Private data class for CollisionDetector
 class ignition::physics::tpelib::CollisionDetectorPrivate
 {
-  /// \brief Helper function to check if collisions for a pair of nodes have
-  /// already been recorded or not
-  /// \param[in] _a Node A Id
-  /// \param[in] _b Node B Id
-  /// \return True if this is a duplicate collision
-  public: bool CheckDuplicateCollisionPair(std::size_t _a, std::size_t _b);
+  /// \brief Update the pair cache of an entity with the difference between
+  /// its cached and current overlapping entities.
+  /// \param[in] _id Entity id
+  /// \param[in] _neighbors Sorted ids of entities that currently overlap
+  /// the entity in the AABB tree
+  public: void UpdatePairs(std::size_t _id,
+      const std::vector<std::size_t> &_neighbors);
+
+  /// \brief Run a function over chunks of [0, _count) on the worker pool,
+  /// or on the calling thread if there is no worker pool.
+  /// \param[in] _count Number of indices
+  /// \param[in] _func Function to run on each chunk
+  public: void RunParallel(std::size_t _count,
+      const WorkerPool::ChunkFunction &_func);
+
+  /// \brief Remove an entity and all of its pairs from the pair cache
+  /// \param[in] _id Entity id
+  public: void RemovePairs(std::size_t _id);
+
+  /// \brief Collect the collisions of an entity and its descendants
+  /// \param[in] _entity Entity
+  /// \param[in] _pose World pose of the entity
+  /// \param[in] _exact True to collect the convex shapes of the collisions,
+  /// false to only collect their ids and world bounding boxes
+  /// \param[out] _shapes Shapes to append to
+  public: static void CollectShapes(const Entity &_entity,
+      const math::Pose3d &_pose, bool _exact,
+      std::vector<ConvexShape> &_shapes);
+
+  /// \brief Get the collisions of an entity collected for the narrowphase
+  /// \param[in] _id Entity id
+  /// \return Shapes of the entity
+  public: const std::vector<ConvexShape> &Shapes(std::size_t _id) const;
+
+  /// \brief Check the collisions of two entities against each other
+  /// \param[in] _id1 Id of first entity
+  /// \param[in] _id2 Id of second entity
+  /// \param[in] _singleContact Only add one contact for the two entities
+  /// \param[in,out] _points Buffer for intersection points
+  /// \param[out] _contacts Contacts to append to
+  public: void CheckShapes(std::size_t _id1, std::size_t _id2,
+      bool _singleContact, std::vector<math::Vector3d> &_points,
+      std::vector<Contact> &_contacts) const;
+
+  /// \brief Add a pair to the list of added or removed pairs
+  /// \param[in] _a Id of first entity
+  /// \param[in] _b Id of second entity
+  /// \param[out] _pairs List to add the ordered pair to
+  public: static void RecordPair(std::size_t _a, std::size_t _b,
+      std::vector<std::pair<std::size_t, std::size_t>> &_pairs);
 
   /// \brief AABB tree
   public: AABBTree aabbTree;
@@ -41,11 +218,88 @@ class ignition::physics::tpelib::CollisionDetectorPrivate
   /// \brief Set of entity id
   public: std::set<std::size_t> nodeIds;
 
-  /// \brief Keep track of pairs of node ids that collided. The map is cleared
-  /// after each collision detection iteration. The key and value are:
-  ///   std::unorderd_map<node_a_id, std::unordered_map<node_b_id, collided>
-  public: std::unordered_map<std::size_t, std::unordered_map<std::size_t, bool>>
-    collisionStateMap;
+  /// \brief Persistent cache of overlapping pairs. Each pair is stored in
+  /// both directions. The key and value are:
+  ///   std::map<node_a_id, std::set<node_b_id>>
+  /// Ordered containers are used so that contacts are generated in a
+  /// deterministic order.
+  public: std::map<std::size_t, std::set<std::size_t>> pairs;
+
+  /// \brief Ids of entities that need to be queried against the tree
+  public: std::vector<std::size_t> dirtyIds;
+
+  /// \brief Sorted ids of the entities to add or update in the tree
+  public: std::vector<std::size_t> updateIds;
+
+  /// \brief Ids of entities that are not in the tree because their bounding
+  /// box was empty, e.g. models without collisions. These are checked again
+  /// on every call since their box may change without them moving.
+  public: std::vector<std::size_t> pendingIds;
+
+  /// \brief Entities of the last check. Along with lastVersion, this tells
+  /// whether entities were added or removed since then.
+  public: const EntityMap *lastEntities = nullptr;
+
+  /// \brief Version of the entities of the last check
+  public: std::size_t lastVersion = 0u;
+
+  /// \brief Entities to add or update in the tree
+  public: std::vector<NodeUpdate> nodeUpdates;
+
+  /// \brief Bounding boxes of the entities in nodeUpdates. These are first
+  /// filled with the local boxes and then transformed to world boxes.
+  public: std::vector<math::AxisAlignedBox> updateBoxes;
+
+  /// \brief Poses of the entities in nodeUpdates
+  public: std::vector<math::Pose3d> updatePoses;
+
+  /// \brief Reusable buffers for tree query results of each dirty entity
+  public: std::vector<std::vector<std::size_t>> queryResults;
+
+  /// \brief Pairs to check for intersection
+  public: std::vector<NarrowphasePair> narrowphasePairs;
+
+  /// \brief Contacts of pairs in which neither entity moved during the last
+  /// check. Resting entities, e.g. sleeping models, keep the same contacts
+  /// so these are reused until one of the entities moves.
+  public: std::unordered_map<std::pair<std::size_t, std::size_t>,
+      std::vector<Contact>, PairHash> quietContacts;
+
+  /// \brief Value of the single contact argument that quietContacts were
+  /// computed with
+  public: bool quietSingleContact = false;
+
+  /// \brief Number of pairs whose contacts were reused during the last
+  /// collision check
+  public: std::size_t reusedPairCount = 0u;
+
+  /// \brief True to compute contacts from the collision shapes
+  public: bool exactNarrowphase = false;
+
+  /// \brief Sorted ids of the entities whose collisions were collected for
+  /// the narrowphase
+  public: std::vector<std::size_t> shapeEntityIds;
+
+  /// \brief World shapes of the collisions of each entity in
+  /// shapeEntityIds. Without the exact narrowphase, only the ids and world
+  /// bounding boxes are set.
+  public: std::vector<std::vector<ConvexShape>> entityShapes;
+
+  /// \brief Worker pool used to process entities and pairs in parallel
+  public: std::shared_ptr<WorkerPool> workerPool;
+
+  /// \brief Pairs added during the last collision check
+  public: std::vector<std::pair<std::size_t, std::size_t>> addedPairs;
+
+  /// \brief Pairs removed during the last collision check
+  public: std::vector<std::pair<std::size_t, std::size_t>> removedPairs;
+
+  /// \brief Number of pairs in the cache
+  public: std::size_t pairCount = 0u;
+
+  /// \brief Duration that fattened boxes are extended along the model's
+  /// linear velocity
+  public: double predictionTime = 0.0;
 };
 
 using namespace ignition;
@@ -65,209 +319,636 @@ CollisionDetector::~CollisionDetector() = default;
 std::vector<Contact> CollisionDetector::CheckCollisions(
     const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
     bool _singleContact)
+{
+  return this->CheckCollisions(EntityMap(_entities), _singleContact);
+}
+
+//////////////////////////////////////////////////
+std::vector<Contact> CollisionDetector::CheckCollisions(
+    const EntityMap &_entities,
+    bool _singleContact)
 {
   IGN_PROFILE("tpelib::CollisionDetector::CheckCollisions");
 
   // contacts to be filled and returned
   std::vector<Contact> contacts;
 
-  // update AABB tree
-  // remove nodes that no longer exist
-  auto nodesToCheckForRemoval = this->dataPtr->nodeIds;
-  for (auto id : nodesToCheckForRemoval)
+  this->dataPtr->addedPairs.clear();
+  this->dataPtr->removedPairs.clear();
+  this->dataPtr->dirtyIds.clear();
+
+  // entities report their pose changes to the map that holds them, so only
+  // the entities that moved are visited. Other maps are scanned.
+  std::vector<std::size_t> &updateIds = this->dataPtr->updateIds;
+  updateIds.clear();
+  if (_entities.TracksPoseChanges())
   {
-    if (_entities.find(id) == _entities.end())
+    for (const std::size_t id : _entities.PoseDirtyIds())
     {
-      this->dataPtr->aabbTree.RemoveNode(id);
-      this->dataPtr->nodeIds.erase(id);
+      auto it = _entities.find(id);
+      if (it != _entities.end() && it->second->PoseDirty())
+        updateIds.push_back(id);
+    }
+  }
+  else
+  {
+    for (const auto &[id, entity] : _entities)
+    {
+      if (entity->PoseDirty())
+        updateIds.push_back(id);
     }
   }
 
-  // add and update nodes in the tree
-  for (auto it = _entities.begin(); it != _entities.end(); ++it)
+  // update AABB tree. Nodes are only added and removed when the entities
+  // changed since the last check.
+  const bool entitiesChanged = !_entities.TracksPoseChanges() ||
+      this->dataPtr->lastEntities != &_entities ||
+      this->dataPtr->lastVersion != _entities.Version();
+  if (entitiesChanged)
   {
-    std::shared_ptr<Entity> e = it->second;
+    // remove nodes that no longer exist
+    for (auto idIt = this->dataPtr->nodeIds.begin();
+         idIt != this->dataPtr->nodeIds.end();)
+    {
+      if (_entities.find(*idIt) == _entities.end())
+      {
+        this->dataPtr->aabbTree.RemoveNode(*idIt);
+        this->dataPtr->RemovePairs(*idIt);
+        idIt = this->dataPtr->nodeIds.erase(idIt);
+      }
+      else
+      {
+        ++idIt;
+      }
+    }
+
     // add new nodes
-    if (!this->dataPtr->aabbTree.HasNode(it->first))
+    for (const auto &entry : _entities)
+    {
+      if (!this->dataPtr->aabbTree.HasNode(entry.first))
+        updateIds.push_back(entry.first);
+    }
+    this->dataPtr->lastEntities = &_entities;
+    this->dataPtr->lastVersion = _entities.Version();
+  }
+  else
+  {
+    updateIds.insert(updateIds.end(), this->dataPtr->pendingIds.begin(),
+        this->dataPtr->pendingIds.end());
+  }
+  std::sort(updateIds.begin(), updateIds.end());
+  updateIds.erase(std::unique(updateIds.begin(), updateIds.end()),
+      updateIds.end());
+
+  // find nodes to add and update in the tree
+  this->dataPtr->nodeUpdates.clear();
+  this->dataPtr->pendingIds.clear();
+  for (const std::size_t id : updateIds)
+  {
+    auto it = _entities.find(id);
+    if (it == _entities.end())
+      continue;
+
+    NodeUpdate update;
+    update.id = id;
+    update.entity = it->second.get();
+    update.isNew = !this->dataPtr->aabbTree.HasNode(id);
+    this->dataPtr->nodeUpdates.push_back(update);
+  }
+
+  // compute world aabbs. Each entity is only touched by one thread.
+  const EntityStore &store = EntityStore::Instance();
+  this->dataPtr->updateBoxes.resize(this->dataPtr->nodeUpdates.size());
+  this->dataPtr->updatePoses.resize(this->dataPtr->nodeUpdates.size());
+  this->dataPtr->RunParallel(this->dataPtr->nodeUpdates.size(),
+      [&](std::size_t, std::size_t _begin, std::size_t _end)
+  {
+    for (std::size_t i = _begin; i < _end; ++i)
     {
-      math::AxisAlignedBox b = e->GetBoundingBox();
+      NodeUpdate &update = this->dataPtr->nodeUpdates[i];
+      this->dataPtr->updateBoxes[i] = update.entity->GetBoundingBox();
+      this->dataPtr->updatePoses[i] = update.entity->GetPose();
+      update.valid = this->dataPtr->updateBoxes[i] != math::AxisAlignedBox();
+
+      // extend the fattened box along the expected motion of the model
+      const EntityHandle handle = update.entity->GetHandle();
+      if (update.valid && !update.isNew &&
+          this->dataPtr->predictionTime > 0.0 &&
+          store.Type(handle) == EntityType::MODEL)
+      {
+        update.displacement =
+            store.LinearVelocity(handle) * this->dataPtr->predictionTime;
+      }
+    }
 
-      if (b == math::AxisAlignedBox())
-        continue;
+    // convert to world aabbs in one batch
+    transformAxisAlignedBoxes(&this->dataPtr->updateBoxes[_begin],
+        &this->dataPtr->updatePoses[_begin],
+        &this->dataPtr->updateBoxes[_begin], _end - _begin);
+  });
 
-      // convert to world aabb
-      math::AxisAlignedBox aabb;
-      math::Pose3d p = e->GetPose();
-      aabb = transformAxisAlignedBox(b, p);
-      this->dataPtr->aabbTree.AddNode(e->GetId(), aabb);
+  // add and update nodes in the tree
+  for (std::size_t i = 0; i < this->dataPtr->nodeUpdates.size(); ++i)
+  {
+    const NodeUpdate &update = this->dataPtr->nodeUpdates[i];
+    if (!update.valid)
+    {
+      if (update.isNew)
+        this->dataPtr->pendingIds.push_back(update.id);
+      continue;
+    }
 
-      this->dataPtr->nodeIds.insert(it->first);
+    const math::AxisAlignedBox &aabb = this->dataPtr->updateBoxes[i];
+
+    // add new nodes
+    if (update.isNew)
+    {
+      this->dataPtr->aabbTree.AddNode(update.id, aabb);
+      this->dataPtr->nodeIds.insert(update.id);
+      this->dataPtr->dirtyIds.push_back(update.id);
     }
     // update existing nodes
-    else if (e->PoseDirty())
+    else
     {
-      math::AxisAlignedBox b = e->GetBoundingBox();
-
-      if (b == math::AxisAlignedBox())
-        continue;
+      // only entities that left their fattened box in the tree can have a
+      // different set of overlapping entities
+      bool reinserted = false;
+      this->dataPtr->aabbTree.UpdateNode(
+          update.id, aabb, update.displacement, reinserted);
+      if (reinserted)
+        this->dataPtr->dirtyIds.push_back(update.id);
+    }
+  }
 
-      // convert to world aabb
-      math::AxisAlignedBox aabb;
-      math::Pose3d p = e->GetPose();
-      aabb = transformAxisAlignedBox(b, p);
-      this->dataPtr->aabbTree.UpdateNode(e->GetId(), aabb);
+  // query AABB tree for entities that moved. This is done after all nodes
+  // are updated so that the result does not depend on the order in which
+  // the entities are visited.
+  const std::size_t dirtyCount = this->dataPtr->dirtyIds.size();
+  if (this->dataPtr->queryResults.size() < dirtyCount)
+    this->dataPtr->queryResults.resize(dirtyCount);
+  this->dataPtr->RunParallel(dirtyCount,
+      [&](std::size_t, std::size_t _begin, std::size_t _end)
+  {
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      std::vector<std::size_t> &result = this->dataPtr->queryResults[i];
+      this->dataPtr->aabbTree.Collisions(this->dataPtr->dirtyIds[i], result);
+      std::sort(result.begin(), result.end());
     }
+  });
+
+  // update the pair cache
+  for (std::size_t i = 0; i < dirtyCount; ++i)
+  {
+    this->dataPtr->UpdatePairs(
+        this->dataPtr->dirtyIds[i], this->dataPtr->queryResults[i]);
   }
 
-  // query AABB tree for collisions
-  for (auto it = _entities.begin(); it != _entities.end(); ++it)
+  // contacts of pairs that are no longer overlapping are not needed anymore
+  if (this->dataPtr->quietSingleContact != _singleContact)
+  {
+    this->dataPtr->quietContacts.clear();
+    this->dataPtr->quietSingleContact = _singleContact;
+  }
+  for (const auto &removed : this->dataPtr->removedPairs)
+    this->dataPtr->quietContacts.erase(removed);
+
+  // node updates are sorted by id since updateIds are sorted
+  auto moved = [&](std::size_t _id)
+  {
+    auto it = std::lower_bound(this->dataPtr->nodeUpdates.begin(),
+        this->dataPtr->nodeUpdates.end(), _id,
+        [](const NodeUpdate &_update, std::size_t _value)
+        {
+          return _update.id < _value;
+        });
+    return it != this->dataPtr->nodeUpdates.end() && it->id == _id;
+  };
+
+  // collect cached pairs to check for intersection. The pairs are visited in
+  // the same order regardless of the number of threads.
+  this->dataPtr->narrowphasePairs.clear();
+  this->dataPtr->reusedPairCount = 0u;
+  for (const auto &[id, neighbors] : this->dataPtr->pairs)
   {
-    std::shared_ptr<Entity> e = it->second;
+    const Entity *e = _entities.at(id).get();
     // Skip if the entity is static
     if (e->GetStatic())
       continue;
 
-    math::AxisAlignedBox b = e->GetBoundingBox();
-    if (b == math::AxisAlignedBox())
-        continue;
-
-    // check collisions
-    auto result = this->dataPtr->aabbTree.Collisions(e->GetId());
-    if (result.empty())
-      continue;
-
-    math::AxisAlignedBox wb1 = this->dataPtr->aabbTree.AABB(e->GetId());
-
     // Get collide bitmask for entity 1
     uint16_t cb1 = e->GetCollideBitmask();
+    const bool moved1 = moved(id);
 
-    // Check intersection
-    for (const auto &nId : result)
+    for (const auto &nId : neighbors)
     {
-      // skip if we have already checked collision for this pair of nodes
-      if (this->dataPtr->CheckDuplicateCollisionPair(e->GetId(), nId))
+      const Entity *e2 = _entities.at(nId).get();
+
+      // skip if the pair has already been visited from the other entity
+      if (nId < id && !e2->GetStatic())
         continue;
 
       // Get collide bitmask for entity 2
-      uint16_t cb2 = _entities.at(nId)->GetCollideBitmask();
+      uint16_t cb2 = e2->GetCollideBitmask();
 
       // collision filtering using collide bitmask
       if ((cb1 & cb2) == 0)
         continue;
 
-      std::vector<math::Vector3d> points;
-      math::AxisAlignedBox wb2 = this->dataPtr->aabbTree.AABB(nId);
-      if (this->GetIntersectionPoints(wb1, wb2, points, _singleContact))
+      NarrowphasePair pair;
+      pair.id1 = id;
+      pair.id2 = nId;
+      pair.quiet = !moved1 && !moved(nId);
+
+      // reuse the contacts of the pair if neither entity moved
+      auto cacheIt = this->dataPtr->quietContacts.find(
+          std::make_pair(std::min(id, nId), std::max(id, nId)));
+      if (cacheIt != this->dataPtr->quietContacts.end())
       {
-        Contact c;
-        // TPE checks collisions in the model level so contacts are associated
-        // with models and not collisions!
-        c.entity1 = e->GetId();
-        c.entity2 = nId;
-        for (const auto &p : points)
+        if (pair.quiet)
         {
-          c.point = p;
-          contacts.push_back(c);
+          pair.cached = &cacheIt->second;
+          ++this->dataPtr->reusedPairCount;
+        }
+        else
+        {
+          this->dataPtr->quietContacts.erase(cacheIt);
         }
       }
+      this->dataPtr->narrowphasePairs.push_back(pair);
     }
   }
 
-  this->dataPtr->collisionStateMap.clear();
+  // collect the world collisions of the entities whose pairs need to be
+  // checked
+  std::vector<std::size_t> &ids = this->dataPtr->shapeEntityIds;
+  ids.clear();
+  for (const auto &pair : this->dataPtr->narrowphasePairs)
+  {
+    if (pair.cached)
+      continue;
+    ids.push_back(pair.id1);
+    ids.push_back(pair.id2);
+  }
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+  if (this->dataPtr->entityShapes.size() < ids.size())
+    this->dataPtr->entityShapes.resize(ids.size());
+  this->dataPtr->RunParallel(ids.size(),
+      [&](std::size_t, std::size_t _begin, std::size_t _end)
+  {
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      const Entity *entity = _entities.at(ids[i]).get();
+      std::vector<ConvexShape> &shapes = this->dataPtr->entityShapes[i];
+      shapes.clear();
+      CollisionDetectorPrivate::CollectShapes(*entity, entity->GetPose(),
+          this->dataPtr->exactNarrowphase, shapes);
+    }
+  });
+
+  // check intersection in parallel chunks, then merge the contacts of each
+  // chunk in order so that the result does not depend on the thread count
+  const std::size_t pairCount = this->dataPtr->narrowphasePairs.size();
+  const std::size_t chunkCount = this->dataPtr->workerPool ?
+      this->dataPtr->workerPool->ChunkCount(pairCount, kGrainSize) : 1u;
+  std::vector<std::vector<Contact>> chunkContacts(chunkCount);
+  // quiet pairs that were checked and need to be cached, as
+  // (pair index, first contact, end contact) in the chunk's contacts
+  std::vector<std::vector<std::array<std::size_t, 3>>> chunkQuiet(chunkCount);
+  this->dataPtr->RunParallel(pairCount,
+      [&](std::size_t _chunk, std::size_t _begin, std::size_t _end)
+  {
+    std::vector<Contact> &chunk = chunkContacts[_chunk];
+    std::vector<math::Vector3d> points;
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      const NarrowphasePair &pair = this->dataPtr->narrowphasePairs[i];
+      if (pair.cached)
+      {
+        chunk.insert(chunk.end(), pair.cached->begin(), pair.cached->end());
+        continue;
+      }
+
+      const std::size_t first = chunk.size();
+      this->dataPtr->CheckShapes(
+          pair.id1, pair.id2, _singleContact, points, chunk);
+      if (pair.quiet)
+        chunkQuiet[_chunk].push_back({i, first, chunk.size()});
+    }
+  });
+
+  // cache the contacts of quiet pairs, including pairs without contacts
+  for (std::size_t c = 0; c < chunkCount; ++c)
+  {
+    for (const auto &[index, first, last] : chunkQuiet[c])
+    {
+      const NarrowphasePair &pair = this->dataPtr->narrowphasePairs[index];
+      this->dataPtr->quietContacts[std::make_pair(
+          std::min(pair.id1, pair.id2), std::max(pair.id1, pair.id2))] =
+          std::vector<Contact>(chunkContacts[c].begin() + first,
+          chunkContacts[c].begin() + last);
+    }
+  }
+
+  if (chunkCount == 1u)
+    return std::move(chunkContacts[0]);
+
+  std::size_t contactCount = 0u;
+  for (const auto &chunk : chunkContacts)
+    contactCount += chunk.size();
+  contacts.reserve(contactCount);
+  for (const auto &chunk : chunkContacts)
+    contacts.insert(contacts.end(), chunk.begin(), chunk.end());
+
   return contacts;
 }
 
 //////////////////////////////////////////////////
-bool CollisionDetector::GetIntersectionPoints(const math::AxisAlignedBox &_b1,
-    const math::AxisAlignedBox &_b2,
-    std::vector<math::Vector3d> &_points, bool _singleContact)
+void CollisionDetector::SetMargin(double _margin)
 {
-  IGN_PROFILE("CollisionDetector::GetIntersectionPoints");
-  // fast intersection check
-  if (_b1.Intersects(_b2))
-  {
-    // when two boxes intersect, the overlapping region is a small box
-    // get all corners of this intersection box
-    math::Vector3d min;
-    math::Vector3d max;
-    min.X() = std::max(_b1.Min().X(), _b2.Min().X());
-    min.Y() = std::max(_b1.Min().Y(), _b2.Min().Y());
-    min.Z() = std::max(_b1.Min().Z(), _b2.Min().Z());
+  this->dataPtr->aabbTree.SetMargin(_margin);
+}
 
-    max.X() = std::min(_b1.Max().X(), _b2.Max().X());
-    max.Y() = std::min(_b1.Max().Y(), _b2.Max().Y());
-    max.Z() = std::min(_b1.Max().Z(), _b2.Max().Z());
+//////////////////////////////////////////////////
+double CollisionDetector::Margin() const
+{
+  return this->dataPtr->aabbTree.Margin();
+}
 
-    if (_singleContact)
-    {
-      // return center of intersecting region
-      _points.push_back(min + 0.5*(max-min));
-      return true;
-    }
+//////////////////////////////////////////////////
+void CollisionDetector::SetPredictionTime(double _time)
+{
+  this->dataPtr->predictionTime = std::max(0.0, _time);
+}
 
-    // min min min
-    math::Vector3d corner = min;
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+double CollisionDetector::PredictionTime() const
+{
+  return this->dataPtr->predictionTime;
+}
 
-    // min min max
-    corner.Z() = max.Z();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+void CollisionDetector::SetWorkerPool(std::shared_ptr<WorkerPool> _pool)
+{
+  this->dataPtr->workerPool = std::move(_pool);
+}
 
-    // min max max
-    corner.Y() = max.Y();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+std::size_t CollisionDetector::ReinsertedCount() const
+{
+  return this->dataPtr->dirtyIds.size();
+}
 
-    // min max min
-    corner.Z() = min.Z();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+void CollisionDetector::SetExactNarrowphase(bool _exact)
+{
+  if (this->dataPtr->exactNarrowphase == _exact)
+    return;
+  this->dataPtr->exactNarrowphase = _exact;
+  this->dataPtr->quietContacts.clear();
+}
 
-    // max max min
-    corner.X() = max.X();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+bool CollisionDetector::ExactNarrowphase() const
+{
+  return this->dataPtr->exactNarrowphase;
+}
 
-    // max max max
-    corner.Z() = max.Z();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+std::size_t CollisionDetector::ReusedPairCount() const
+{
+  return this->dataPtr->reusedPairCount;
+}
 
-    // max min max
-    corner.Y() = min.Y();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+const std::vector<std::pair<std::size_t, std::size_t>>
+    &CollisionDetector::AddedPairs() const
+{
+  return this->dataPtr->addedPairs;
+}
 
-    // max min min
-    corner.Z() = min.Z();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+const std::vector<std::pair<std::size_t, std::size_t>>
+    &CollisionDetector::RemovedPairs() const
+{
+  return this->dataPtr->removedPairs;
+}
 
-    return true;
+//////////////////////////////////////////////////
+std::size_t CollisionDetector::PairCount() const
+{
+  return this->dataPtr->pairCount;
+}
+
+//////////////////////////////////////////////////
+bool CollisionDetector::GetIntersectionPoints(const math::AxisAlignedBox &_b1,
+    const math::AxisAlignedBox &_b2,
+    std::vector<math::Vector3d> &_points, bool _singleContact)
+{
+  IGN_PROFILE("CollisionDetector::GetIntersectionPoints");
+  return intersectionPoints(_b1, _b2, _points, _singleContact);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::UpdatePairs(std::size_t _id,
+    const std::vector<std::size_t> &_neighbors)
+{
+  std::set<std::size_t> &cached = this->pairs[_id];
+
+  // both the cached and the new neighbors are sorted, walk them together to
+  // find the pairs that were added and removed
+  auto oldIt = cached.begin();
+  auto newIt = _neighbors.begin();
+  while (oldIt != cached.end() || newIt != _neighbors.end())
+  {
+    if (newIt == _neighbors.end() ||
+        (oldIt != cached.end() && *oldIt < *newIt))
+    {
+      const std::size_t nId = *oldIt;
+      auto nIt = this->pairs.find(nId);
+      nIt->second.erase(_id);
+      if (nIt->second.empty())
+        this->pairs.erase(nIt);
+      oldIt = cached.erase(oldIt);
+      RecordPair(_id, nId, this->removedPairs);
+      --this->pairCount;
+    }
+    else if (oldIt == cached.end() || *newIt < *oldIt)
+    {
+      const std::size_t nId = *newIt;
+      cached.insert(oldIt, nId);
+      this->pairs[nId].insert(_id);
+      RecordPair(_id, nId, this->addedPairs);
+      ++this->pairCount;
+      ++newIt;
+    }
+    else
+    {
+      ++oldIt;
+      ++newIt;
+    }
   }
-  return false;
+
+  if (cached.empty())
+    this->pairs.erase(_id);
 }
 
 //////////////////////////////////////////////////
-bool CollisionDetectorPrivate::CheckDuplicateCollisionPair(
-    std::size_t _a, std::size_t _b)
+void CollisionDetectorPrivate::RunParallel(std::size_t _count,
+    const WorkerPool::ChunkFunction &_func)
 {
-  // use a 2d map to keep track of pairs of collisions
-  // mark the corresponding elements in the 2d map to true to indicate
-  // the check is done
-  bool duplicate = true;
-  auto aIt = this->collisionStateMap.find(_a);
-  if (aIt == this->collisionStateMap.end())
+  if (this->workerPool)
+    this->workerPool->Run(_count, kGrainSize, _func);
+  else if (_count > 0u)
+    _func(0u, 0u, _count);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::RemovePairs(std::size_t _id)
+{
+  auto it = this->pairs.find(_id);
+  if (it == this->pairs.end())
+    return;
+
+  for (const auto nId : it->second)
   {
-    duplicate = false;
+    auto nIt = this->pairs.find(nId);
+    nIt->second.erase(_id);
+    if (nIt->second.empty())
+      this->pairs.erase(nIt);
+    RecordPair(_id, nId, this->removedPairs);
+    --this->pairCount;
   }
-  else
+  this->pairs.erase(it);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::CollectShapes(const Entity &_entity,
+    const math::Pose3d &_pose, bool _exact, std::vector<ConvexShape> &_shapes)
+{
+  for (const auto &[childId, child] : _entity.GetChildMap())
   {
-    auto bIt = aIt->second.find(_b);
-    if (bIt == aIt->second.end())
+    const math::Pose3d pose = _pose * child->GetPose();
+    if (child->GetType() != EntityType::COLLISION)
+    {
+      CollectShapes(*child, pose, _exact, _shapes);
+      continue;
+    }
+
+    ConvexShape convex;
+    if (_exact)
+    {
+      Shape *shape = static_cast<const Collision *>(child.get())->GetShape();
+      if (!shape || !makeConvexShape(*shape, pose, convex))
+        continue;
+    }
+    else
     {
-      duplicate = false;
+      const math::AxisAlignedBox box = child->GetBoundingBox();
+      if (box == math::AxisAlignedBox())
+        continue;
+      convex.box = transformAxisAlignedBox(box, pose);
     }
+    convex.id = childId;
+    convex.handle = child->GetHandle();
+    _shapes.push_back(convex);
   }
+}
 
-  if (!duplicate)
+//////////////////////////////////////////////////
+const std::vector<ConvexShape> &CollisionDetectorPrivate::Shapes(
+    std::size_t _id) const
+{
+  auto it = std::lower_bound(
+      this->shapeEntityIds.begin(), this->shapeEntityIds.end(), _id);
+  return this->entityShapes[it - this->shapeEntityIds.begin()];
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::CheckShapes(std::size_t _id1,
+    std::size_t _id2, bool _singleContact,
+    std::vector<math::Vector3d> &_points,
+    std::vector<Contact> &_contacts) const
+{
+  const std::vector<ConvexShape> &shapes1 = this->Shapes(_id1);
+  const std::vector<ConvexShape> &shapes2 = this->Shapes(_id2);
+
+  // with a single contact, the deepest contact is kept. Without the exact
+  // narrowphase, the collisions whose boxes overlap the most are kept.
+  Contact deepest;
+  double deepestScore = 0.0;
+  bool found = false;
+  ShapeContact shapeContact;
+  for (const auto &s1 : shapes1)
   {
-    this->collisionStateMap[_a][_b] = true;
-    this->collisionStateMap[_b][_a] = true;
+    for (const auto &s2 : shapes2)
+    {
+      // midphase, skip collisions whose bounding boxes do not overlap
+      if (!s1.box.Intersects(s2.box))
+        continue;
+
+      Contact c;
+      c.entity1 = _id1;
+      c.entity2 = _id2;
+      c.collision1 = s1.id;
+      c.collision2 = s2.id;
+      c.collisionHandle1 = s1.handle;
+      c.collisionHandle2 = s2.handle;
+
+      double score = 0.0;
+      if (this->exactNarrowphase)
+      {
+        if (!collideShapes(s1, s2, shapeContact))
+          continue;
+        c.point = shapeContact.point;
+        c.normal = shapeContact.normal;
+        c.depth = shapeContact.depth;
+        score = c.depth;
+      }
+      else
+      {
+        _points.clear();
+        intersectionPoints(s1.box, s2.box, _points, _singleContact);
+        if (!_singleContact)
+        {
+          for (const auto &p : _points)
+          {
+            c.point = p;
+            _contacts.push_back(c);
+          }
+          continue;
+        }
+        c.point = _points.front();
+        score = 1.0;
+        for (std::size_t i = 0; i < 3u; ++i)
+        {
+          score *= std::min(s1.box.Max()[i], s2.box.Max()[i]) -
+              std::max(s1.box.Min()[i], s2.box.Min()[i]);
+        }
+      }
+
+      if (!_singleContact)
+      {
+        _contacts.push_back(c);
+      }
+      else if (!found || score > deepestScore)
+      {
+        deepest = c;
+        deepestScore = score;
+      }
+      found = true;
+    }
   }
-  return duplicate;
+
+  if (_singleContact && found)
+    _contacts.push_back(deepest);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::RecordPair(std::size_t _a, std::size_t _b,
+    std::vector<std::pair<std::size_t, std::size_t>> &_pairs)
+{
+  _pairs.emplace_back(std::min(_a, _b), std::max(_a, _b));
 }
@@ -21,6 +21,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <ignition/math/Pose3.hh>
@@ -31,6 +32,7 @@
 #include "Entity.hh"
 
 #include "AABBTree.hh"
+#include "WorkerPool.hh"
 
 namespace ignition {
 namespace physics {
@@ -48,10 +50,30 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Contact
   /// \brief Id of second collision entity
   public: std::size_t entity2 = kNullEntityId;
 
+  /// \brief Id of the collision of entity1 that is in contact
+  public: std::size_t collision1 = kNullEntityId;
+
+  /// \brief Id of the collision of entity2 that is in contact
+  public: std::size_t collision2 = kNullEntityId;
+
+  /// \brief Handle of the collision of entity1 that is in contact, so that
+  /// callers can index per collision data without looking up the id
+  public: EntityHandle collisionHandle1 = kNullEntityHandle;
+
+  /// \brief Handle of the collision of entity2 that is in contact
+  public: EntityHandle collisionHandle2 = kNullEntityHandle;
+
   IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
   /// \brief Point of contact in world frame;
   public: math::Vector3d point;
+
+  /// \brief Contact normal in world frame, pointing from entity1 to
+  /// entity2. Only set by the exact narrowphase.
+  public: math::Vector3d normal;
   IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief Penetration depth. Only set by the exact narrowphase.
+  public: double depth = 0.0;
 };
 
 /// \brief Collision Detector that checks collisions between a list of entities
@@ -63,16 +85,110 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE CollisionDetector
   /// \brief Destructor
   public: ~CollisionDetector();
 
-  /// \brief Check collisions between a list entities and get all contact points
+  /// \brief Check collisions between a list entities and get all contact points.
+  /// Overlapping pairs are cached between calls and only entities that moved
+  /// out of their fattened bounding box in the AABB tree are queried again.
+  /// Use AddedPairs and RemovedPairs to get the changes to the pair cache.
+  /// Entities that moved are those whose pose is dirty. When the entities
+  /// track their pose changes (see EntityMap::TracksPoseChanges), only the
+  /// entities listed in EntityMap::PoseDirtyIds are visited, and the tree is
+  /// only checked for added and removed entities when the map changed.
   /// \param[in] _entities List of entities
+  /// Collisions of overlapping entities are then filtered by their world
+  /// bounding boxes, and each pair of overlapping collisions is reported
+  /// with the ids of the two collisions.
   /// \param[in] _singleContact Get only 1 contact point for each pair of
-  /// collisions.
-  /// The contact point will be at the center of all points
+  /// entities. Without the exact narrowphase, the contact point is at the
+  /// center of the largest overlap between the bounding boxes of their
+  /// collisions. With the exact narrowphase, the deepest contact between the
+  /// collisions of the two entities is returned.
+  /// \return A list of contact points
+  public: std::vector<Contact> CheckCollisions(
+      const EntityMap &_entities,
+      bool _singleContact = false);
+
+  /// \brief Check collisions between a map of entities and get all contact
+  /// points. This copies the entities into an EntityMap and visits all of
+  /// them to find the ones that moved, prefer the EntityMap overload.
+  /// \param[in] _entities Map of entities
+  /// \param[in] _singleContact Get only 1 contact point for each pair of
+  /// entities.
   /// \return A list of contact points
   public: std::vector<Contact> CheckCollisions(
       const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
       bool _singleContact = false);
 
+  /// \brief Set whether contacts are computed from the shapes of the
+  /// collisions instead of their bounding boxes. Collisions whose world
+  /// bounding boxes overlap are then tested against each other exactly, and
+  /// contacts also carry a normal and a penetration depth. Meshes are
+  /// approximated by their bounding box.
+  /// \param[in] _exact True to enable the exact narrowphase. Default is
+  /// false, which reports a contact whenever collision bounding boxes
+  /// overlap.
+  public: void SetExactNarrowphase(bool _exact);
+
+  /// \brief Get whether contacts are computed from the collision shapes
+  /// \return True if the exact narrowphase is enabled
+  public: bool ExactNarrowphase() const;
+
+  /// \brief Set the margin that entity boxes are fattened by in the AABB
+  /// tree. Entities whose box stays within its fattened box are not
+  /// reinserted into the tree nor queried for new pairs. The margin only
+  /// affects broadphase, contacts are computed from the tight boxes.
+  /// \param[in] _margin Margin in meters. Default is 0.
+  public: void SetMargin(double _margin);
+
+  /// \brief Get the margin that entity boxes are fattened by
+  /// \return Margin in meters
+  public: double Margin() const;
+
+  /// \brief Set how far ahead fattened boxes of models are extended along
+  /// their linear velocity, so that models moving at a constant velocity
+  /// are reinserted less often.
+  /// \param[in] _time Prediction time in seconds, typically the time step.
+  /// Default is 0, which disables velocity prediction.
+  public: void SetPredictionTime(double _time);
+
+  /// \brief Get the velocity prediction time
+  /// \return Prediction time in seconds
+  public: double PredictionTime() const;
+
+  /// \brief Set the worker pool used to compute bounding boxes, query the
+  /// AABB tree and generate contacts in parallel. The contacts are the same,
+  /// and in the same order, regardless of the number of threads.
+  /// \param[in] _pool Worker pool, or nullptr to run on the calling thread
+  public: void SetWorkerPool(std::shared_ptr<WorkerPool> _pool);
+
+  /// \brief Get the number of entities that were added or reinserted into
+  /// the AABB tree during the last call to CheckCollisions.
+  /// \return Number of tree updates that restructured the tree
+  public: std::size_t ReinsertedCount() const;
+
+  /// \brief Get the number of entity pairs whose contacts were reused
+  /// during the last call to CheckCollisions. The contacts of a pair are
+  /// reused when neither entity moved since the pair was last checked, e.g.
+  /// when both models are sleeping or one of them is static.
+  /// \return Number of pairs that skipped the intersection check
+  public: std::size_t ReusedPairCount() const;
+
+  /// \brief Get the broadphase pairs that started overlapping during the last
+  /// call to CheckCollisions. Pairs are ordered so that first < second.
+  /// \return Pairs of entity ids added to the pair cache
+  public: const std::vector<std::pair<std::size_t, std::size_t>>
+      &AddedPairs() const;
+
+  /// \brief Get the broadphase pairs that stopped overlapping during the
+  /// last call to CheckCollisions, including pairs of removed entities.
+  /// Pairs are ordered so that first < second.
+  /// \return Pairs of entity ids removed from the pair cache
+  public: const std::vector<std::pair<std::size_t, std::size_t>>
+      &RemovedPairs() const;
+
+  /// \brief Get the number of pairs in the broadphase pair cache.
+  /// \return Number of potentially colliding pairs
+  public: std::size_t PairCount() const;
+
   /// \brief Get a vector of intersection points between two axis aligned boxes
   /// \param[in] _b1 Axis aligned box 1
   /// \param[in] _b2 Axis aligned box 2
@@ -16,7 +16,13 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 #include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Helpers.hh>
 
 #include "Collision.hh"
 #include "CollisionDetector.hh"
@@ -403,3 +409,419 @@ TEST(CollisionDetector, CheckStaticCollisionFiltering)
   std::vector<Contact> contacts = cd.CheckCollisions(entities);
   EXPECT_TRUE(contacts.empty());
 }
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, PairCache)
+{
+  // three boxes of size 2
+  std::vector<std::shared_ptr<Model>> models;
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(ignition::math::Vector3d(2, 2, 2));
+    collision->SetShape(boxShape);
+    models.push_back(model);
+  }
+  std::shared_ptr<Model> modelA = models[0];
+  std::shared_ptr<Model> modelB = models[1];
+  std::shared_ptr<Model> modelC = models[2];
+
+  CollisionDetector cd;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  for (auto &model : models)
+    entities[model->GetId()] = model;
+
+  auto orderedPair = [](std::size_t _a, std::size_t _b)
+  {
+    return std::make_pair(std::min(_a, _b), std::max(_a, _b));
+  };
+  auto resetPoseDirty = [&]()
+  {
+    for (auto &model : models)
+      model->ResetPoseDirty();
+  };
+
+  // A and B overlap, C is far away
+  modelA->SetPose(math::Pose3d(0, 0, 0, 0, 0, 0));
+  modelB->SetPose(math::Pose3d(1, 0, 0, 0, 0, 0));
+  modelC->SetPose(math::Pose3d(100, 0, 0, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(1u, contacts.size());
+  EXPECT_EQ(1u, cd.PairCount());
+  ASSERT_EQ(1u, cd.AddedPairs().size());
+  EXPECT_EQ(orderedPair(modelA->GetId(), modelB->GetId()),
+      cd.AddedPairs()[0]);
+  EXPECT_TRUE(cd.RemovedPairs().empty());
+  resetPoseDirty();
+
+  // nothing moved, pair is still reported but the cache is unchanged
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(1u, contacts.size());
+  EXPECT_EQ(1u, cd.PairCount());
+  EXPECT_TRUE(cd.AddedPairs().empty());
+  EXPECT_TRUE(cd.RemovedPairs().empty());
+
+  // move C onto B
+  modelC->SetPose(math::Pose3d(2.5, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(2u, contacts.size());
+  EXPECT_EQ(2u, cd.PairCount());
+  ASSERT_EQ(1u, cd.AddedPairs().size());
+  EXPECT_EQ(orderedPair(modelB->GetId(), modelC->GetId()),
+      cd.AddedPairs()[0]);
+  EXPECT_TRUE(cd.RemovedPairs().empty());
+  resetPoseDirty();
+
+  // move A away from B
+  modelA->SetPose(math::Pose3d(-10, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_TRUE(contacts[0].entity1 == modelB->GetId() ||
+      contacts[0].entity2 == modelB->GetId());
+  EXPECT_TRUE(contacts[0].entity1 == modelC->GetId() ||
+      contacts[0].entity2 == modelC->GetId());
+  EXPECT_EQ(1u, cd.PairCount());
+  EXPECT_TRUE(cd.AddedPairs().empty());
+  ASSERT_EQ(1u, cd.RemovedPairs().size());
+  EXPECT_EQ(orderedPair(modelA->GetId(), modelB->GetId()),
+      cd.RemovedPairs()[0]);
+  resetPoseDirty();
+
+  // remove C
+  entities.erase(modelC->GetId());
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_TRUE(contacts.empty());
+  EXPECT_EQ(0u, cd.PairCount());
+  EXPECT_TRUE(cd.AddedPairs().empty());
+  ASSERT_EQ(1u, cd.RemovedPairs().size());
+  EXPECT_EQ(orderedPair(modelB->GetId(), modelC->GetId()),
+      cd.RemovedPairs()[0]);
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, Margin)
+{
+  std::vector<std::shared_ptr<Model>> models;
+  for (unsigned int i = 0; i < 2u; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(ignition::math::Vector3d(2, 2, 2));
+    collision->SetShape(boxShape);
+    models.push_back(model);
+  }
+  std::shared_ptr<Model> modelA = models[0];
+  std::shared_ptr<Model> modelB = models[1];
+
+  CollisionDetector cd;
+  EXPECT_DOUBLE_EQ(0.0, cd.Margin());
+  cd.SetMargin(1.0);
+  EXPECT_DOUBLE_EQ(1.0, cd.Margin());
+  EXPECT_DOUBLE_EQ(0.0, cd.PredictionTime());
+
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  entities[modelA->GetId()] = modelA;
+  entities[modelB->GetId()] = modelB;
+
+  // boxes are 0.5 apart, the fattened boxes overlap but there is no contact
+  modelA->SetPose(math::Pose3d(0, 0, 0, 0, 0, 0));
+  modelB->SetPose(math::Pose3d(2.5, 0, 0, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  EXPECT_TRUE(contacts.empty());
+  EXPECT_EQ(2u, cd.ReinsertedCount());
+  EXPECT_EQ(1u, cd.PairCount());
+  modelA->ResetPoseDirty();
+  modelB->ResetPoseDirty();
+
+  // move A by less than the margin, the tree is not updated but the contact
+  // is found from the tight boxes
+  modelA->SetPose(math::Pose3d(0.8, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(0u, cd.ReinsertedCount());
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(math::Vector3d(1.65, 0, 0), contacts[0].point);
+  modelA->ResetPoseDirty();
+
+  // move A by more than the margin
+  modelA->SetPose(math::Pose3d(-1.5, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(1u, cd.ReinsertedCount());
+  EXPECT_TRUE(contacts.empty());
+  modelA->ResetPoseDirty();
+
+  // with velocity prediction, the fattened box of a model is extended along
+  // its velocity when it is reinserted. Without prediction, the last step
+  // would reinsert the model again.
+  cd.SetPredictionTime(1.0);
+  EXPECT_DOUBLE_EQ(1.0, cd.PredictionTime());
+  modelA->SetLinearVelocity(math::Vector3d(-1.0, 0, 0));
+  const std::vector<std::size_t> expectedReinserted = {0u, 1u, 0u, 0u};
+  for (std::size_t expected : expectedReinserted)
+  {
+    modelA->UpdatePose(1.0);
+    contacts = cd.CheckCollisions(entities, true);
+    EXPECT_EQ(expected, cd.ReinsertedCount());
+    EXPECT_TRUE(contacts.empty());
+    modelA->ResetPoseDirty();
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, ReusedPairs)
+{
+  // three boxes of size 2, A overlaps B and C
+  std::vector<std::shared_ptr<Model>> models;
+  EntityMap entities;
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(ignition::math::Vector3d(2, 2, 2));
+    collision->SetShape(boxShape);
+    model->SetPose(math::Pose3d(1.5 * i, 0, 0, 0, 0, 0));
+    models.push_back(model);
+    entities.insert({model->GetId(), model});
+  }
+  auto resetPoseDirty = [&]()
+  {
+    for (auto &model : models)
+      model->ResetPoseDirty();
+  };
+
+  CollisionDetector cd;
+  std::vector<Contact> contacts = cd.CheckCollisions(entities);
+  EXPECT_EQ(0u, cd.ReusedPairCount());
+  ASSERT_EQ(2u, cd.PairCount());
+  resetPoseDirty();
+
+  // nothing moved, the contacts of the first check are computed again since
+  // the pairs were not at rest when they were checked
+  std::vector<Contact> restContacts = cd.CheckCollisions(entities);
+  EXPECT_EQ(0u, cd.ReusedPairCount());
+
+  // the contacts of both pairs are reused from now on
+  std::vector<Contact> reusedContacts = cd.CheckCollisions(entities);
+  EXPECT_EQ(2u, cd.ReusedPairCount());
+  ASSERT_EQ(contacts.size(), reusedContacts.size());
+  for (std::size_t i = 0; i < contacts.size(); ++i)
+  {
+    EXPECT_EQ(contacts[i].entity1, reusedContacts[i].entity1);
+    EXPECT_EQ(contacts[i].entity2, reusedContacts[i].entity2);
+    EXPECT_EQ(contacts[i].point, reusedContacts[i].point);
+  }
+
+  // moving C only recomputes the contacts of the B-C pair
+  models[2]->SetPose(math::Pose3d(3.5, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities);
+  EXPECT_EQ(1u, cd.ReusedPairCount());
+  resetPoseDirty();
+
+  // asking for single contacts invalidates the reused contacts
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(0u, cd.ReusedPairCount());
+  EXPECT_EQ(2u, contacts.size());
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(2u, cd.ReusedPairCount());
+  EXPECT_EQ(2u, contacts.size());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, ExactNarrowphase)
+{
+  // a box and a box rotated by 45 degrees. The bounding boxes of the models
+  // overlap but the boxes don't.
+  std::vector<std::shared_ptr<Model>> models;
+  std::vector<std::size_t> collisionIds;
+  EntityMap entities;
+  for (unsigned int i = 0; i < 2u; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(ignition::math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    models.push_back(model);
+    collisionIds.push_back(collision->GetId());
+    entities.insert({model->GetId(), model});
+  }
+  models[1]->SetPose(math::Pose3d(1.1, 0.9, 0, 0, 0, IGN_PI * 0.25));
+
+  CollisionDetector cd;
+  EXPECT_FALSE(cd.ExactNarrowphase());
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(1u, contacts.size());
+
+  cd.SetExactNarrowphase(true);
+  EXPECT_TRUE(cd.ExactNarrowphase());
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_TRUE(contacts.empty());
+
+  // move the rotated box so that its corner penetrates the first box
+  models[1]->SetPose(
+      math::Pose3d(0.5 + std::sqrt(0.5) - 0.05, 0, 0, 0, 0, IGN_PI * 0.25));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  const Contact &c = contacts[0];
+  EXPECT_EQ(models[0]->GetId(), c.entity1);
+  EXPECT_EQ(models[1]->GetId(), c.entity2);
+  EXPECT_EQ(collisionIds[0], c.collision1);
+  EXPECT_EQ(collisionIds[1], c.collision2);
+  EXPECT_EQ(math::Vector3d(1, 0, 0), c.normal);
+  EXPECT_NEAR(0.05, c.depth, 1e-6);
+  EXPECT_NEAR(0.475, c.point.X(), 1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, ContactCollisions)
+{
+  // two overlapping models. The first one has its collision on a link that
+  // is not canonical.
+  std::shared_ptr<Model> model1(new Model);
+  Link *canonical = static_cast<Link *>(&model1->AddLink());
+  model1->SetCanonicalLink(canonical->GetId());
+  Link *link1 = static_cast<Link *>(&model1->AddLink());
+  Collision *collision1 = static_cast<Collision *>(&link1->AddCollision());
+  BoxShape boxShape;
+  boxShape.SetSize(ignition::math::Vector3d(2, 2, 2));
+  collision1->SetShape(boxShape);
+
+  std::shared_ptr<Model> model2(new Model);
+  Link *link2 = static_cast<Link *>(&model2->AddLink());
+  Collision *collision2a = static_cast<Collision *>(&link2->AddCollision());
+  collision2a->SetShape(boxShape);
+  Collision *collision2b = static_cast<Collision *>(&link2->AddCollision());
+  collision2b->SetShape(boxShape);
+  collision2b->SetPose(math::Pose3d(0, 0, 5, 0, 0, 0));
+  model2->SetPose(math::Pose3d(1, 0, 0, 0, 0, 0));
+
+  EntityMap entities;
+  entities.insert({model1->GetId(), model1});
+  entities.insert({model2->GetId(), model2});
+
+  CollisionDetector cd;
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(model1->GetId(), contacts[0].entity1);
+  EXPECT_EQ(model2->GetId(), contacts[0].entity2);
+  EXPECT_EQ(collision1->GetId(), contacts[0].collision1);
+  EXPECT_EQ(collision2a->GetId(), contacts[0].collision2);
+
+  EXPECT_EQ(collision1->GetHandle(), contacts[0].collisionHandle1);
+  EXPECT_EQ(collision2a->GetHandle(), contacts[0].collisionHandle2);
+  EXPECT_EQ(math::Vector3d(0.5, 0, 0), contacts[0].point);
+
+  // only the collisions that overlap are in contact
+  contacts = cd.CheckCollisions(entities, false);
+  ASSERT_EQ(8u, contacts.size());
+  for (const auto &c : contacts)
+  {
+    EXPECT_EQ(collision1->GetId(), c.collision1);
+    EXPECT_EQ(collision2a->GetId(), c.collision2);
+  }
+
+  // a model whose first link is away from model1 and whose second link
+  // touches it
+  std::shared_ptr<Model> model3(new Model);
+  Link *link3a = static_cast<Link *>(&model3->AddLink());
+  Collision *collision3a = static_cast<Collision *>(&link3a->AddCollision());
+  collision3a->SetShape(boxShape);
+  link3a->SetPose(math::Pose3d(0, 0, 5, 0, 0, 0));
+  Link *link3b = static_cast<Link *>(&model3->AddLink());
+  Collision *collision3b = static_cast<Collision *>(&link3b->AddCollision());
+  collision3b->SetShape(boxShape);
+  model3->SetPose(math::Pose3d(0, 1, 0, 0, 0, 0));
+
+  EntityMap entities2;
+  entities2.insert({model1->GetId(), model1});
+  entities2.insert({model3->GetId(), model3});
+
+  CollisionDetector cd2;
+  contacts = cd2.CheckCollisions(entities2, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(collision1->GetId(), contacts[0].collision1);
+  EXPECT_EQ(collision3b->GetId(), contacts[0].collision2);
+  EXPECT_EQ(math::Vector3d(0, 0.5, 0), contacts[0].point);
+
+  cd2.SetExactNarrowphase(true);
+  contacts = cd2.CheckCollisions(entities2, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(collision1->GetId(), contacts[0].collision1);
+  EXPECT_EQ(collision3b->GetId(), contacts[0].collision2);
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, TrackedPoseChanges)
+{
+  // a row of boxes of size 1 that don't touch
+  std::vector<std::shared_ptr<Model>> models;
+  EntityMap entities;
+  for (unsigned int i = 0; i < 4u; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Link *link = static_cast<Link *>(&model->AddLink());
+    Collision *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape boxShape;
+    boxShape.SetSize(ignition::math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    models.push_back(model);
+    entities.insert({model->GetId(), model});
+    model->SetPose(math::Pose3d(2.0 * i, 0, 0, 0, 0, 0));
+  }
+  EXPECT_TRUE(entities.TracksPoseChanges());
+  EXPECT_EQ(4u, entities.PoseDirtyIds().size());
+
+  CollisionDetector cd;
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  EXPECT_TRUE(contacts.empty());
+  EXPECT_EQ(4u, cd.ReinsertedCount());
+  entities.ClearPoseDirty();
+  EXPECT_TRUE(entities.PoseDirtyIds().empty());
+  for (const auto &model : models)
+    EXPECT_FALSE(model->PoseDirty());
+
+  // setting the pose more than once lists the model once
+  models[3]->SetPose(math::Pose3d(3.5, 0, 0, 0, 0, 0));
+  models[3]->SetPose(math::Pose3d(3.2, 0, 0, 0, 0, 0));
+  ASSERT_EQ(1u, entities.PoseDirtyIds().size());
+  EXPECT_EQ(models[3]->GetId(), entities.PoseDirtyIds()[0]);
+
+  // only the moved model is updated, and it now touches the third box
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(1u, cd.ReinsertedCount());
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(models[2]->GetId(), contacts[0].entity1);
+  EXPECT_EQ(models[3]->GetId(), contacts[0].entity2);
+  entities.ClearPoseDirty();
+
+  // removed entities are taken out of the tree
+  entities.erase(models[2]->GetId());
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_TRUE(contacts.empty());
+  EXPECT_EQ(0u, cd.PairCount());
+
+  // a removed entity no longer reports to the map, and a copy of the map
+  // does not track pose changes
+  models[2]->SetPose(math::Pose3d(0, 0, 0, 0, 0, 0));
+  EXPECT_TRUE(entities.PoseDirtyIds().empty());
+  EntityMap copy(entities);
+  EXPECT_FALSE(copy.TracksPoseChanges());
+  models[0]->SetPose(math::Pose3d(0, 1, 0, 0, 0, 0));
+  EXPECT_EQ(1u, entities.PoseDirtyIds().size());
+  EXPECT_TRUE(copy.PoseDirtyIds().empty());
+}
@@ -15,41 +15,33 @@
  *
 */
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "Entity.hh"
 #include "Utils.hh"
 
-/// \brief Private data class for entity
+/// \brief Private data class for entity. The data that is visited while
+/// stepping and checking collisions is kept in the EntityStore.
 class ignition::physics::tpelib::EntityPrivate
 {
   /// \brief Name of entity
   public: std::string name;
 
-  /// \brief Entity pose
-  public: math::Pose3d pose;
-
-  /// \brief Indicate if the object is static
-  public: bool isStatic = false;
-
-  /// \brief Entity Id
-  public: std::size_t id = 0u;
+  /// \brief Handle of the entity in the store
+  public: EntityHandle handle = kNullEntityHandle;
 
   /// \brief Child entities
-  public: std::map<std::size_t, std::shared_ptr<Entity>> children;
-
-  /// \brief Bounding Box
-  public: math::AxisAlignedBox bbox;
+  public: EntityMap children;
 
-  /// \brief Collide bitmask
-  public: uint16_t collideBitmask = 0xFF;
+  /// \brief Copy of the children returned by GetChildren
+  public: std::map<std::size_t, std::shared_ptr<Entity>> childrenCopy;
 
-  /// \brief Flag to indicate if bounding box changed
-  public: bool bboxDirty = true;
+  /// \brief Version of the children that childrenCopy was made from
+  public: std::size_t childrenCopyVersion = 0u;
 
-  /// \brief Flag to indicate if pose changed
-  public: bool poseDirty = false;
-
-  /// \brief Flag to indicate if collide bitmask changed
-  public: bool collideBitmaskDirty = true;
+  /// \brief True if childrenCopy was made
+  public: bool childrenCopied = false;
 
   /// \brief Parent of this entity
   public: Entity *parent = nullptr;
@@ -59,26 +51,343 @@ using namespace ignition;
 using namespace physics;
 using namespace tpelib;
 
+namespace
+{
+/// \brief Compare an entry of an EntityMap with an id
+bool entryIdLess(const EntityMap::value_type &_entry, std::size_t _id)
+{
+  return _entry.first < _id;
+}
+}
+
+//////////////////////////////////////////////////
+EntityMap::EntityMap(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities)
+  : entries(_entities.begin(), _entities.end()),
+    tracksPoseChanges(false)
+{
+  this->handles.reserve(this->entries.size());
+  for (const auto &entry : this->entries)
+  {
+    this->handles.push_back(
+        entry.second ? entry.second->GetHandle() : kNullEntityHandle);
+  }
+}
+
+//////////////////////////////////////////////////
+EntityMap::EntityMap(const EntityMap &_other)
+  : entries(_other.entries),
+    handles(_other.handles),
+    version(_other.version),
+    tracksPoseChanges(false)
+{
+}
+
+//////////////////////////////////////////////////
+EntityMap::~EntityMap()
+{
+  this->ReleaseEntries();
+}
+
+//////////////////////////////////////////////////
+EntityMap &EntityMap::operator=(const EntityMap &_other)
+{
+  if (this == &_other)
+    return *this;
+
+  this->ReleaseEntries();
+  this->entries = _other.entries;
+  this->handles = _other.handles;
+  this->poseDirtyIds.clear();
+  this->nameIndex.clear();
+  this->tracksPoseChanges = false;
+  ++this->version;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+EntityMap::iterator EntityMap::begin()
+{
+  return this->entries.begin();
+}
+
+//////////////////////////////////////////////////
+EntityMap::iterator EntityMap::end()
+{
+  return this->entries.end();
+}
+
+//////////////////////////////////////////////////
+EntityMap::const_iterator EntityMap::begin() const
+{
+  return this->entries.begin();
+}
+
+//////////////////////////////////////////////////
+EntityMap::const_iterator EntityMap::end() const
+{
+  return this->entries.end();
+}
+
+//////////////////////////////////////////////////
+std::size_t EntityMap::size() const
+{
+  return this->entries.size();
+}
+
+//////////////////////////////////////////////////
+bool EntityMap::empty() const
+{
+  return this->entries.empty();
+}
+
+//////////////////////////////////////////////////
+EntityMap::iterator EntityMap::find(std::size_t _id)
+{
+  auto it = std::lower_bound(
+      this->entries.begin(), this->entries.end(), _id, entryIdLess);
+  if (it != this->entries.end() && it->first == _id)
+    return it;
+  return this->entries.end();
+}
+
+//////////////////////////////////////////////////
+EntityMap::const_iterator EntityMap::find(std::size_t _id) const
+{
+  auto it = std::lower_bound(
+      this->entries.begin(), this->entries.end(), _id, entryIdLess);
+  if (it != this->entries.end() && it->first == _id)
+    return it;
+  return this->entries.end();
+}
+
+//////////////////////////////////////////////////
+EntityMap::const_iterator EntityMap::FindByName(
+    const std::string &_name) const
+{
+  if (this->tracksPoseChanges)
+  {
+    auto it = this->nameIndex.find(_name);
+    if (it == this->nameIndex.end())
+      return this->entries.end();
+    return this->find(it->second);
+  }
+
+  return std::find_if(this->entries.begin(), this->entries.end(),
+      [&_name](const value_type &_entry)
+      {
+        return _entry.second->GetNameRef() == _name;
+      });
+}
+
+//////////////////////////////////////////////////
+std::size_t EntityMap::count(std::size_t _id) const
+{
+  return this->find(_id) != this->entries.end() ? 1u : 0u;
+}
+
+//////////////////////////////////////////////////
+const std::shared_ptr<Entity> &EntityMap::at(std::size_t _id) const
+{
+  auto it = this->find(_id);
+  if (it == this->entries.end())
+    throw std::out_of_range("EntityMap::at");
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+const EntityMap::value_type &EntityMap::operator[](std::size_t _index) const
+{
+  return this->entries[_index];
+}
+
+//////////////////////////////////////////////////
+std::pair<EntityMap::iterator, bool> EntityMap::insert(value_type _value)
+{
+  // new ids are usually larger than all existing ones
+  auto it = this->entries.end();
+  if (!this->entries.empty() && _value.first <= this->entries.back().first)
+  {
+    it = std::lower_bound(
+        this->entries.begin(), this->entries.end(), _value.first, entryIdLess);
+    if (it->first == _value.first)
+      return {it, false};
+  }
+
+  const EntityHandle handle =
+      _value.second ? _value.second->GetHandle() : kNullEntityHandle;
+  this->handles.insert(
+      this->handles.begin() + (it - this->entries.begin()), handle);
+  it = this->entries.insert(it, std::move(_value));
+  ++this->version;
+
+  // the entity reports its pose changes and renames to this map from now on
+  if (handle != kNullEntityHandle)
+  {
+    EntityStore::Instance().SetContainer(handle, this);
+    this->IndexName(it->first, it->second->GetNameRef());
+  }
+  return {it, true};
+}
+
+//////////////////////////////////////////////////
+EntityMap::iterator EntityMap::erase(const_iterator _it)
+{
+  const std::size_t index = _it - this->entries.cbegin();
+  const EntityHandle handle = this->handles[index];
+  EntityStore &store = EntityStore::Instance();
+  if (handle != kNullEntityHandle && store.Container(handle) == this)
+  {
+    store.SetContainer(handle, nullptr);
+    this->UnindexName(_it->first, _it->second->GetNameRef());
+  }
+  this->handles.erase(this->handles.begin() + index);
+  ++this->version;
+  return this->entries.erase(_it);
+}
+
+//////////////////////////////////////////////////
+std::size_t EntityMap::erase(std::size_t _id)
+{
+  auto it = this->find(_id);
+  if (it == this->entries.end())
+    return 0u;
+  this->erase(it);
+  return 1u;
+}
+
+//////////////////////////////////////////////////
+void EntityMap::clear()
+{
+  this->ReleaseEntries();
+  this->entries.clear();
+  this->handles.clear();
+  this->poseDirtyIds.clear();
+  this->nameIndex.clear();
+  ++this->version;
+}
+
+//////////////////////////////////////////////////
+const std::vector<EntityHandle> &EntityMap::Handles() const
+{
+  return this->handles;
+}
+
+//////////////////////////////////////////////////
+std::size_t EntityMap::Version() const
+{
+  return this->version;
+}
+
+//////////////////////////////////////////////////
+bool EntityMap::TracksPoseChanges() const
+{
+  return this->tracksPoseChanges;
+}
+
+//////////////////////////////////////////////////
+const std::vector<std::size_t> &EntityMap::PoseDirtyIds() const
+{
+  return this->poseDirtyIds;
+}
+
+//////////////////////////////////////////////////
+void EntityMap::ClearPoseDirty()
+{
+  EntityStore &store = EntityStore::Instance();
+  for (const std::size_t id : this->poseDirtyIds)
+  {
+    auto it = this->find(id);
+    if (it == this->entries.end())
+      continue;
+    const EntityHandle handle = this->handles[it - this->entries.begin()];
+    store.SetFlag(handle,
+        EntityStore::kPoseDirty | EntityStore::kPoseDirtyListed, false);
+  }
+  this->poseDirtyIds.clear();
+}
+
+//////////////////////////////////////////////////
+void EntityMap::MarkPoseDirty(std::size_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->poseDirtyMutex);
+  this->poseDirtyIds.push_back(_id);
+}
+
+//////////////////////////////////////////////////
+void EntityMap::Rename(std::size_t _id, const std::string &_oldName,
+    const std::string &_newName)
+{
+  this->UnindexName(_id, _oldName);
+  this->IndexName(_id, _newName);
+}
+
+//////////////////////////////////////////////////
+void EntityMap::IndexName(std::size_t _id, const std::string &_name)
+{
+  if (!this->tracksPoseChanges)
+    return;
+
+  // keep the first entry with a given name, same as a linear search
+  auto [it, inserted] = this->nameIndex.emplace(_name, _id);
+  if (!inserted && _id < it->second)
+    it->second = _id;
+}
+
+//////////////////////////////////////////////////
+void EntityMap::UnindexName(std::size_t _id, const std::string &_name)
+{
+  auto it = this->nameIndex.find(_name);
+  if (it == this->nameIndex.end() || it->second != _id)
+    return;
+
+  // names are rarely shared, so the next entry with the name is searched for
+  // only when the indexed one goes away
+  for (const auto &entry : this->entries)
+  {
+    if (entry.first != _id && entry.second->GetNameRef() == _name)
+    {
+      it->second = entry.first;
+      return;
+    }
+  }
+  this->nameIndex.erase(it);
+}
+
+//////////////////////////////////////////////////
+void EntityMap::ReleaseEntries()
+{
+  EntityStore &store = EntityStore::Instance();
+  for (const EntityHandle handle : this->handles)
+  {
+    if (handle != kNullEntityHandle && store.Container(handle) == this)
+      store.SetContainer(handle, nullptr);
+  }
+}
+
 std::size_t Entity::nextId = 0;
 Entity Entity::kNullEntity = Entity(kNullEntityId);
 
 //////////////////////////////////////////////////
 Entity::Entity()
-  : dataPtr(new EntityPrivate)
+  : Entity(EntityType::ENTITY)
 {
-  this->dataPtr->id = Entity::GetNextId();
 }
 
 //////////////////////////////////////////////////
 Entity::Entity(const Entity &_other)
   : dataPtr(new EntityPrivate)
 {
-  this->dataPtr->id = _other.dataPtr->id;
+  EntityStore &store = EntityStore::Instance();
+  const EntityHandle other = _other.dataPtr->handle;
+  this->dataPtr->handle = store.Add(store.Id(other), EntityType::ENTITY);
   this->dataPtr->name = _other.dataPtr->name;
-  this->dataPtr->pose = _other.dataPtr->pose;
   this->dataPtr->children = _other.dataPtr->children;
-  this->dataPtr->bbox = _other.dataPtr->bbox;
-  this->dataPtr->collideBitmask = _other.dataPtr->collideBitmask;
+  store.SetPose(this->dataPtr->handle, store.Pose(other));
+  store.SetFlag(this->dataPtr->handle, EntityStore::kPoseDirty, false);
+  store.SetBoundingBox(this->dataPtr->handle, store.BoundingBox(other));
+  store.SetCollideBitmask(
+      this->dataPtr->handle, store.CollideBitmask(other));
 }
 
 //////////////////////////////////////////////////
@@ -88,18 +397,36 @@ Entity::Entity(Entity &&_other) noexcept
 }
 
 /////////////////////////////////////////////////
-Entity &Entity::operator=(Entity &&_entity) noexcept = default;
+Entity &Entity::operator=(Entity &&_entity) noexcept
+{
+  std::swap(this->dataPtr, _entity.dataPtr);
+  return *this;
+}
 
 //////////////////////////////////////////////////
 Entity::Entity(std::size_t _id)
+  : Entity(_id, EntityType::ENTITY)
+{
+}
+
+//////////////////////////////////////////////////
+Entity::Entity(EntityType _type)
+  : Entity(Entity::GetNextId(), _type)
+{
+}
+
+//////////////////////////////////////////////////
+Entity::Entity(std::size_t _id, EntityType _type)
   : dataPtr(new EntityPrivate)
 {
-  this->dataPtr->id = _id;
+  this->dataPtr->handle = EntityStore::Instance().Add(_id, _type);
 }
 
 //////////////////////////////////////////////////
 Entity::~Entity()
 {
+  if (this->dataPtr)
+    EntityStore::Instance().Remove(this->dataPtr->handle);
   delete this->dataPtr;
   this->dataPtr = nullptr;
 }
@@ -114,7 +441,15 @@ Entity &Entity::operator=(const Entity &_other)
 //////////////////////////////////////////////////
 void Entity::SetName(const std::string &_name)
 {
+  if (this->dataPtr->name == _name)
+    return;
+
+  const std::string oldName = std::move(this->dataPtr->name);
   this->dataPtr->name = _name;
+  EntityMap *container =
+      EntityStore::Instance().Container(this->dataPtr->handle);
+  if (container)
+    container->Rename(this->GetId(), oldName, _name);
 }
 
 //////////////////////////////////////////////////
@@ -132,47 +467,57 @@ const std::string &Entity::GetNameRef() const
 //////////////////////////////////////////////////
 void Entity::SetPose(const math::Pose3d &_pose)
 {
-  this->dataPtr->pose = _pose;
-  this->dataPtr->poseDirty = true;
+  EntityStore::Instance().SetPose(this->dataPtr->handle, _pose);
 }
 
 //////////////////////////////////////////////////
 math::Pose3d Entity::GetPose() const
 {
-  return this->dataPtr->pose;
+  return EntityStore::Instance().Pose(this->dataPtr->handle);
 }
 
 //////////////////////////////////////////////////
 math::Pose3d Entity::GetWorldPose() const
 {
-  if (this->dataPtr->parent)
-    return this->dataPtr->parent->GetWorldPose() * this->dataPtr->pose;
-
-  return this->dataPtr->pose;
+  return EntityStore::Instance().WorldPose(this->dataPtr->handle);
 }
 
 //////////////////////////////////////////////////
 void Entity::SetStatic(bool _static)
 {
-  this->dataPtr->isStatic = _static;
+  EntityStore::Instance().SetFlag(
+      this->dataPtr->handle, EntityStore::kStatic, _static);
 }
 
 //////////////////////////////////////////////////
 bool Entity::GetStatic() const
 {
-  return this->dataPtr->isStatic;
+  return EntityStore::Instance().Flag(
+      this->dataPtr->handle, EntityStore::kStatic);
 }
 
 //////////////////////////////////////////////////
 void Entity::SetId(std::size_t _id)
 {
-  this->dataPtr->id = _id;
+  EntityStore::Instance().SetId(this->dataPtr->handle, _id);
 }
 
 //////////////////////////////////////////////////
 std::size_t Entity::GetId() const
 {
-  return this->dataPtr->id;
+  return EntityStore::Instance().Id(this->dataPtr->handle);
+}
+
+//////////////////////////////////////////////////
+EntityHandle Entity::GetHandle() const
+{
+  return this->dataPtr->handle;
+}
+
+//////////////////////////////////////////////////
+EntityType Entity::GetType() const
+{
+  return EntityStore::Instance().Type(this->dataPtr->handle);
 }
 
 //////////////////////////////////////////////////
@@ -190,14 +535,9 @@ Entity &Entity::GetChildById(std::size_t _id) const
 //////////////////////////////////////////////////
 Entity &Entity::GetChildByName(const std::string &_name) const
 {
-  for (auto it = this->dataPtr->children.begin();
-      it != this->dataPtr->children.end(); ++it)
-  {
-    if (it->second->GetName() == _name)
-    {
-      return *it->second.get();
-    }
-  }
+  auto it = this->dataPtr->children.FindByName(_name);
+  if (it != this->dataPtr->children.end())
+    return *it->second.get();
 
   return kNullEntity;
 }
@@ -208,14 +548,7 @@ Entity &Entity::GetChildByIndex(unsigned int _index) const
   if (_index >= this->dataPtr->children.size())
     return kNullEntity;
 
-  auto it = this->dataPtr->children.begin();
-  std::advance(it, _index);
-  if (it != this->dataPtr->children.end())
-  {
-    return *it->second.get();
-  }
-
-  return kNullEntity;
+  return *this->dataPtr->children[_index].second.get();
 }
 
 //////////////////////////////////////////////////
@@ -224,6 +557,9 @@ bool Entity::RemoveChildById(std::size_t _id)
   auto it = this->dataPtr->children.find(_id);
   if (it != this->dataPtr->children.end())
   {
+    // a removed child is no longer stepped with its parent
+    if (it->second && it->second->GetParent() == this)
+      it->second->SetParent(nullptr);
     this->dataPtr->children.erase(it);
     this->ChildrenChanged();
     return true;
@@ -235,15 +571,14 @@ bool Entity::RemoveChildById(std::size_t _id)
 //////////////////////////////////////////////////
 bool Entity::RemoveChildByName(const std::string &_name)
 {
-  for (auto it = this->dataPtr->children.begin();
-      it != this->dataPtr->children.end(); ++it)
+  auto it = this->dataPtr->children.FindByName(_name);
+  if (it != this->dataPtr->children.end())
   {
-    if (it->second->GetName() == _name)
-    {
-      this->dataPtr->children.erase(it);
-      this->ChildrenChanged();
-      return true;
-    }
+    if (it->second && it->second->GetParent() == this)
+      it->second->SetParent(nullptr);
+    this->dataPtr->children.erase(it);
+    this->ChildrenChanged();
+    return true;
   }
   return false;
 }
@@ -257,12 +592,15 @@ size_t Entity::GetChildCount() const
 //////////////////////////////////////////////////
 math::AxisAlignedBox Entity::GetBoundingBox(bool _force)
 {
-  if (_force || this->dataPtr->bboxDirty)
+  EntityStore &store = EntityStore::Instance();
+  if (_force || store.Flag(this->dataPtr->handle,
+      EntityStore::kBoundingBoxDirty))
   {
     this->UpdateBoundingBox(_force);
-    this->dataPtr->bboxDirty = false;
+    store.SetFlag(this->dataPtr->handle, EntityStore::kBoundingBoxDirty,
+        false);
   }
-  return this->dataPtr->bbox;
+  return store.BoundingBox(this->dataPtr->handle);
 }
 
 //////////////////////////////////////////////////
@@ -277,28 +615,46 @@ void Entity::UpdateBoundingBox(bool _force)
     box.Merge(transformedBox);
   }
 
-  this->dataPtr->bbox = box;
+  EntityStore::Instance().SetBoundingBox(this->dataPtr->handle, box);
 }
 
 //////////////////////////////////////////////////
 uint16_t Entity::GetCollideBitmask() const
 {
-  if (this->dataPtr->collideBitmaskDirty)
+  EntityStore &store = EntityStore::Instance();
+  if (store.Flag(this->dataPtr->handle, EntityStore::kCollideBitmaskDirty))
   {
     uint16_t mask = 0u;
     for (auto &it : this->dataPtr->children)
     {
       mask |= it.second->GetCollideBitmask();
     }
-    this->dataPtr->collideBitmask = mask;
-    this->dataPtr->collideBitmaskDirty = false;
+    store.SetCollideBitmask(this->dataPtr->handle, mask);
+    store.SetFlag(this->dataPtr->handle, EntityStore::kCollideBitmaskDirty,
+        false);
   }
 
-  return this->dataPtr->collideBitmask;
+  return store.CollideBitmask(this->dataPtr->handle);
 }
 
 //////////////////////////////////////////////////
 std::map<std::size_t, std::shared_ptr<Entity>> &Entity::GetChildren() const
+{
+  // the copy is only rebuilt when children were added or removed
+  if (!this->dataPtr->childrenCopied ||
+      this->dataPtr->childrenCopyVersion != this->dataPtr->children.Version())
+  {
+    this->dataPtr->childrenCopy = std::map<std::size_t,
+        std::shared_ptr<Entity>>(this->dataPtr->children.begin(),
+        this->dataPtr->children.end());
+    this->dataPtr->childrenCopyVersion = this->dataPtr->children.Version();
+    this->dataPtr->childrenCopied = true;
+  }
+  return this->dataPtr->childrenCopy;
+}
+
+//////////////////////////////////////////////////
+EntityMap &Entity::GetChildMap() const
 {
   return this->dataPtr->children;
 }
@@ -312,17 +668,15 @@ std::size_t Entity::GetNextId()
 //////////////////////////////////////////////////
 void Entity::ChildrenChanged()
 {
-  this->dataPtr->bboxDirty = true;
-  this->dataPtr->collideBitmaskDirty = true;
-
-  if (this->dataPtr->parent)
-    this->dataPtr->parent->ChildrenChanged();
+  EntityStore::Instance().ChildrenChanged(this->dataPtr->handle);
 }
 
 //////////////////////////////////////////////////
 void Entity::SetParent(Entity *_parent)
 {
   this->dataPtr->parent = _parent;
+  EntityStore::Instance().SetParent(this->dataPtr->handle,
+      _parent ? _parent->dataPtr->handle : kNullEntityHandle);
 }
 
 //////////////////////////////////////////////////
@@ -334,11 +688,13 @@ Entity *Entity::GetParent() const
 //////////////////////////////////////////////////
 bool Entity::PoseDirty() const
 {
-  return this->dataPtr->poseDirty;
+  return EntityStore::Instance().Flag(
+      this->dataPtr->handle, EntityStore::kPoseDirty);
 }
 
 //////////////////////////////////////////////////
 void Entity::ResetPoseDirty()
 {
-  this->dataPtr->poseDirty = false;
+  EntityStore::Instance().SetFlag(
+      this->dataPtr->handle, EntityStore::kPoseDirty, false);
 }
@@ -21,23 +21,239 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Pose3.hh>
+#include <ignition/utils/SuppressWarning.hh>
 #include "ignition/physics/tpelib/Export.hh"
 
+#include "EntityStore.hh"
+
 namespace ignition {
 namespace physics {
 namespace tpelib {
 
 // forward declaration
+class Entity;
 class EntityPrivate;
 
 /// \brief Represents an invalid Id.
 static const std::size_t kNullEntityId = math::MAX_UI64;
 
-/// \brief Entity class
+/// \brief Flat map of child entities keyed by id. The entries are stored
+/// contiguously and sorted by id, so iteration is cache friendly and
+/// children can be accessed by index in constant time. Ids are handed out in
+/// increasing order, so adding a new child is an append. The interface
+/// mirrors the subset of std::map that is used by the entity classes. Note
+/// that, unlike std::map, inserting or erasing invalidates iterators.
+///
+/// Entities that are inserted into a map report their pose changes and
+/// renames to it, so that the entities that moved can be found without
+/// visiting every entry, and entries can be found by name through an index.
+/// Maps that are copied or built from a std::map are not told about the
+/// changes of their entries, see TracksPoseChanges.
+///
+/// The map also keeps the EntityStore handle of each entry, see Handles, so
+/// that passes over all entries can read the entity data from the store.
+class IGNITION_PHYSICS_TPELIB_VISIBLE EntityMap
+{
+  /// \brief Entry type, a pair of child id and child entity
+  public: using value_type = std::pair<std::size_t, std::shared_ptr<Entity>>;
+
+  /// \brief Iterator type
+  public: using iterator = std::vector<value_type>::iterator;
+
+  /// \brief Const iterator type
+  public: using const_iterator = std::vector<value_type>::const_iterator;
+
+  /// \brief Constructor
+  public: EntityMap() = default;
+
+  /// \brief Constructor from a std::map of entities
+  /// \param[in] _entities Map of entity ids to entities
+  public: explicit EntityMap(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities);
+
+  /// \brief Copy constructor. The copy does not track pose changes.
+  /// \param[in] _other Map to copy from
+  public: EntityMap(const EntityMap &_other);
+
+  /// \brief Destructor
+  public: ~EntityMap();
+
+  /// \brief Assignment operator. The map no longer tracks pose changes.
+  /// \param[in] _other Map to copy from
+  /// \return Reference to this map
+  public: EntityMap &operator=(const EntityMap &_other);
+
+  /// \brief Get an iterator to the first entry
+  /// \return Iterator to the first entry
+  public: iterator begin();
+
+  /// \brief Get an iterator past the last entry
+  /// \return Iterator past the last entry
+  public: iterator end();
+
+  /// \brief Get a const iterator to the first entry
+  /// \return Const iterator to the first entry
+  public: const_iterator begin() const;
+
+  /// \brief Get a const iterator past the last entry
+  /// \return Const iterator past the last entry
+  public: const_iterator end() const;
+
+  /// \brief Get the number of entries
+  /// \return Number of entries
+  public: std::size_t size() const;
+
+  /// \brief Get whether the map is empty
+  /// \return True if there are no entries
+  public: bool empty() const;
+
+  /// \brief Find an entry by id
+  /// \param[in] _id Id of the entity
+  /// \return Iterator to the entry or end() if not found
+  public: iterator find(std::size_t _id);
+
+  /// \brief Find an entry by id
+  /// \param[in] _id Id of the entity
+  /// \return Const iterator to the entry or end() if not found
+  public: const_iterator find(std::size_t _id) const;
+
+  /// \brief Find the first entry, by id, whose entity has the given name.
+  /// Maps that track the changes of their entries look the name up in an
+  /// index, other maps search the entries linearly.
+  /// \param[in] _name Name of the entity
+  /// \return Const iterator to the entry or end() if not found
+  public: const_iterator FindByName(const std::string &_name) const;
+
+  /// \brief Get the number of entries with the given id
+  /// \param[in] _id Id of the entity
+  /// \return 1 if the entry exists, 0 otherwise
+  public: std::size_t count(std::size_t _id) const;
+
+  /// \brief Get an entity by id. Throws std::out_of_range if the id is not
+  /// found.
+  /// \param[in] _id Id of the entity
+  /// \return Entity with the given id
+  public: const std::shared_ptr<Entity> &at(std::size_t _id) const;
+
+  /// \brief Get an entry by its position in the map
+  /// \param[in] _index Index of the entry, must be less than size()
+  /// \return Entry at the given index
+  public: const value_type &operator[](std::size_t _index) const;
+
+  /// \brief Insert an entry if its id does not exist yet
+  /// \param[in] _value Entry to insert
+  /// \return Iterator to the entry with the same id and true if the entry
+  /// was inserted
+  public: std::pair<iterator, bool> insert(value_type _value);
+
+  /// \brief Erase an entry
+  /// \param[in] _it Iterator to the entry to erase
+  /// \return Iterator following the erased entry
+  public: iterator erase(const_iterator _it);
+
+  /// \brief Erase an entry by id
+  /// \param[in] _id Id of the entity to erase
+  /// \return Number of entries erased
+  public: std::size_t erase(std::size_t _id);
+
+  /// \brief Remove all entries
+  public: void clear();
+
+  /// \brief Get the EntityStore handles of the entries, in the same order as
+  /// the entries. Null entities have kNullEntityHandle.
+  /// \return Handle of each entry
+  public: const std::vector<EntityHandle> &Handles() const;
+
+  /// \brief Get a counter that is incremented every time an entry is
+  /// inserted or erased. This can be used to invalidate data derived from
+  /// the entries.
+  /// \return Modification counter
+  public: std::size_t Version() const;
+
+  /// \brief Get whether the entries report their pose changes to this map.
+  /// This is true for maps that entities are inserted into, and false for
+  /// copies and maps built from a std::map.
+  /// \return True if PoseDirtyIds holds every entry whose pose is dirty
+  public: bool TracksPoseChanges() const;
+
+  /// \brief Get the ids of the entries whose pose was set since the last
+  /// call to ClearPoseDirty. Each id is listed once. An entry is listed
+  /// until ClearPoseDirty is called, even if its pose dirty flag is reset
+  /// on its own, so check Entity::PoseDirty before treating it as moved.
+  /// \return Ids of entries whose pose may have changed
+  public: const std::vector<std::size_t> &PoseDirtyIds() const;
+
+  /// \brief Reset the pose dirty flag of the entries listed in
+  /// PoseDirtyIds and clear the list.
+  public: void ClearPoseDirty();
+
+  /// \brief Record that the pose of an entry became dirty. Entities of a
+  /// world are moved in parallel, so this is thread safe.
+  /// \param[in] _id Id of the entity
+  private: void MarkPoseDirty(std::size_t _id);
+
+  /// \brief Update the name index after an entry was renamed
+  /// \param[in] _id Id of the entity
+  /// \param[in] _oldName Name of the entity before it was renamed
+  /// \param[in] _newName Name of the entity
+  private: void Rename(std::size_t _id, const std::string &_oldName,
+      const std::string &_newName);
+
+  /// \brief Add an entry to the name index
+  /// \param[in] _id Id of the entity
+  /// \param[in] _name Name of the entity
+  private: void IndexName(std::size_t _id, const std::string &_name);
+
+  /// \brief Remove an entry from the name index. If other entries have the
+  /// same name, the first of them takes its place.
+  /// \param[in] _id Id of the entity
+  /// \param[in] _name Name that the entity is indexed by
+  private: void UnindexName(std::size_t _id, const std::string &_name);
+
+  /// \brief Stop the entries that report to this map from doing so
+  private: void ReleaseEntries();
+
+  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Entries sorted by id
+  private: std::vector<value_type> entries;
+
+  /// \brief Store handle of each entry
+  private: std::vector<EntityHandle> handles;
+
+  /// \brief Ids of entries whose pose became dirty
+  private: std::vector<std::size_t> poseDirtyIds;
+
+  /// \brief Mutex that protects poseDirtyIds
+  private: std::mutex poseDirtyMutex;
+
+  /// \brief Id of the first entry with a given name. Only kept by maps that
+  /// track the changes of their entries, and only changed by the calls that
+  /// modify the map, so concurrent lookups are safe.
+  private: std::unordered_map<std::string, std::size_t> nameIndex;
+  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief Modification counter
+  private: std::size_t version = 0u;
+
+  /// \brief True if the entries report their pose changes to this map
+  private: bool tracksPoseChanges = true;
+
+  friend class Entity;
+  friend class EntityStore;
+};
+
+/// \brief Entity class. The data of an entity that is visited while
+/// stepping and checking collisions lives in the EntityStore, and the entity
+/// is a view over its slot in the store. Other data, such as the name and
+/// the child map, is kept by the entity itself.
 class IGNITION_PHYSICS_TPELIB_VISIBLE Entity
 {
   /// \brief Constructor
@@ -59,6 +275,15 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Entity
   /// \param[in] _id Id to set the entity to
   protected: explicit Entity(std::size_t _id);
 
+  /// \brief Constructor of a derived entity type
+  /// \param[in] _type Type of the entity
+  protected: explicit Entity(EntityType _type);
+
+  /// \brief Constructor of a derived entity type with id
+  /// \param[in] _id Id to set the entity to
+  /// \param[in] _type Type of the entity
+  protected: Entity(std::size_t _id, EntityType _type);
+
   /// \brief Destructor
   public: virtual ~Entity();
 
@@ -94,6 +319,14 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Entity
   /// \return Entity id
   public: virtual std::size_t GetId() const;
 
+  /// \brief Get the handle of the entity in the EntityStore
+  /// \return Entity handle
+  public: EntityHandle GetHandle() const;
+
+  /// \brief Get the type of the entity
+  /// \return Entity type
+  public: EntityType GetType() const;
+
   /// \brief Set the pose of the entity
   /// \param[in] _pose Pose of entity to set to
   public: virtual void SetPose(const math::Pose3d &_pose);
@@ -171,11 +404,17 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Entity
   /// entity is added or removed, or child entity properties changed.
   public: void ChildrenChanged();
 
-  /// \brief Get number of children
+  /// \brief Get the child entities. The map is a copy of the children
+  /// that is rebuilt when children are added or removed, so changes made to
+  /// it are not applied to the entity. Prefer GetChildMap.
   /// \return Map of child id's to child entities
   public: std::map<std::size_t, std::shared_ptr<Entity>> &GetChildren()
       const;
 
+  /// \brief Get the child entities
+  /// \return Flat map of child id's to child entities
+  public: EntityMap &GetChildMap() const;
+
   /// \brief Update the entity bounding box
   /// \param[in] _force True to force update children's bounding box
   private: virtual void UpdateBoundingBox(bool _force = false);
@@ -192,6 +431,8 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Entity
 
   /// \brief Pointer to private data class
   private: EntityPrivate *dataPtr = nullptr;
+
+  friend class EntityMap;
 };
 
 }
@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <mutex>
+#include <vector>
+
+#include "Entity.hh"
+#include "EntityStore.hh"
+
+/// \brief Private data class for EntityStore. Each vector holds one field
+/// of every slot.
+class ignition::physics::tpelib::EntityStorePrivate
+{
+  /// \brief Entity ids
+  public: std::vector<std::size_t> ids;
+
+  /// \brief Entity types
+  public: std::vector<EntityType> types;
+
+  /// \brief Entity flags, see the flag constants of EntityStore
+  public: std::vector<std::uint8_t> flags;
+
+  /// \brief Poses relative to the parent
+  public: std::vector<math::Pose3d> poses;
+
+  /// \brief Linear velocities relative to the parent
+  public: std::vector<math::Vector3d> linearVelocities;
+
+  /// \brief Angular velocities relative to the parent
+  public: std::vector<math::Vector3d> angularVelocities;
+
+  /// \brief Bounding boxes in the frame of each entity
+  public: std::vector<math::AxisAlignedBox> boundingBoxes;
+
+  /// \brief Collide bitmasks
+  public: std::vector<std::uint16_t> collideBitmasks;
+
+  /// \brief Number of consecutive steps that each model has been at rest
+  public: std::vector<std::uint32_t> idleSteps;
+
+  /// \brief Parent of each entity
+  public: std::vector<EntityHandle> parents;
+
+  /// \brief First child of each entity
+  public: std::vector<EntityHandle> firstChildren;
+
+  /// \brief Next child of the parent of each entity
+  public: std::vector<EntityHandle> nextSiblings;
+
+  /// \brief Map that each entity reports its pose changes to
+  public: std::vector<EntityMap *> containers;
+
+  /// \brief Handles of removed entities, reused by Add
+  public: std::vector<EntityHandle> freeHandles;
+
+  /// \brief Mutex that protects adding and removing entities
+  public: std::mutex mutex;
+
+  /// \brief Take an entity out of the children of its parent
+  /// \param[in] _handle Handle of the entity
+  public: void Unlink(EntityHandle _handle);
+};
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+//////////////////////////////////////////////////
+EntityStore &EntityStore::Instance()
+{
+  static EntityStore store;
+  return store;
+}
+
+//////////////////////////////////////////////////
+EntityStore::EntityStore()
+  : dataPtr(new EntityStorePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+EntityStore::~EntityStore() = default;
+
+//////////////////////////////////////////////////
+EntityHandle EntityStore::Add(std::size_t _id, EntityType _type)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  EntityStorePrivate &d = *this->dataPtr;
+
+  const std::uint8_t flags =
+      EntityStore::kBoundingBoxDirty | EntityStore::kCollideBitmaskDirty;
+  if (!d.freeHandles.empty())
+  {
+    const EntityHandle handle = d.freeHandles.back();
+    d.freeHandles.pop_back();
+    d.ids[handle] = _id;
+    d.types[handle] = _type;
+    d.flags[handle] = flags;
+    d.poses[handle] = math::Pose3d::Zero;
+    d.linearVelocities[handle] = math::Vector3d::Zero;
+    d.angularVelocities[handle] = math::Vector3d::Zero;
+    d.boundingBoxes[handle] = math::AxisAlignedBox();
+    d.collideBitmasks[handle] = 0xFF;
+    d.idleSteps[handle] = 0u;
+    d.parents[handle] = kNullEntityHandle;
+    d.firstChildren[handle] = kNullEntityHandle;
+    d.nextSiblings[handle] = kNullEntityHandle;
+    d.containers[handle] = nullptr;
+    return handle;
+  }
+
+  const EntityHandle handle = static_cast<EntityHandle>(d.ids.size());
+  d.ids.push_back(_id);
+  d.types.push_back(_type);
+  d.flags.push_back(flags);
+  d.poses.push_back(math::Pose3d::Zero);
+  d.linearVelocities.push_back(math::Vector3d::Zero);
+  d.angularVelocities.push_back(math::Vector3d::Zero);
+  d.boundingBoxes.emplace_back();
+  d.collideBitmasks.push_back(0xFF);
+  d.idleSteps.push_back(0u);
+  d.parents.push_back(kNullEntityHandle);
+  d.firstChildren.push_back(kNullEntityHandle);
+  d.nextSiblings.push_back(kNullEntityHandle);
+  d.containers.push_back(nullptr);
+  return handle;
+}
+
+//////////////////////////////////////////////////
+void EntityStore::Remove(EntityHandle _handle)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  EntityStorePrivate &d = *this->dataPtr;
+
+  d.Unlink(_handle);
+  EntityHandle child = d.firstChildren[_handle];
+  while (child != kNullEntityHandle)
+  {
+    const EntityHandle next = d.nextSiblings[child];
+    d.parents[child] = kNullEntityHandle;
+    d.nextSiblings[child] = kNullEntityHandle;
+    child = next;
+  }
+  d.firstChildren[_handle] = kNullEntityHandle;
+  d.containers[_handle] = nullptr;
+  d.freeHandles.push_back(_handle);
+}
+
+//////////////////////////////////////////////////
+std::size_t EntityStore::Count() const
+{
+  return this->dataPtr->ids.size() - this->dataPtr->freeHandles.size();
+}
+
+//////////////////////////////////////////////////
+std::size_t EntityStore::Id(EntityHandle _handle) const
+{
+  return this->dataPtr->ids[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetId(EntityHandle _handle, std::size_t _id)
+{
+  this->dataPtr->ids[_handle] = _id;
+}
+
+//////////////////////////////////////////////////
+EntityType EntityStore::Type(EntityHandle _handle) const
+{
+  return this->dataPtr->types[_handle];
+}
+
+//////////////////////////////////////////////////
+bool EntityStore::Flag(EntityHandle _handle, std::uint8_t _flag) const
+{
+  return (this->dataPtr->flags[_handle] & _flag) != 0u;
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetFlag(EntityHandle _handle, std::uint8_t _flag,
+    bool _value)
+{
+  std::uint8_t &flags = this->dataPtr->flags[_handle];
+  flags = static_cast<std::uint8_t>(
+      _value ? (flags | _flag) : (flags & ~_flag));
+}
+
+//////////////////////////////////////////////////
+const math::Pose3d &EntityStore::Pose(EntityHandle _handle) const
+{
+  return this->dataPtr->poses[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetPose(EntityHandle _handle, const math::Pose3d &_pose)
+{
+  this->dataPtr->poses[_handle] = _pose;
+  this->MarkPoseDirty(_handle);
+}
+
+//////////////////////////////////////////////////
+math::Pose3d EntityStore::WorldPose(EntityHandle _handle) const
+{
+  math::Pose3d pose = this->dataPtr->poses[_handle];
+  for (EntityHandle parent = this->dataPtr->parents[_handle];
+       parent != kNullEntityHandle; parent = this->dataPtr->parents[parent])
+  {
+    pose = this->dataPtr->poses[parent] * pose;
+  }
+  return pose;
+}
+
+//////////////////////////////////////////////////
+void EntityStore::MarkPoseDirty(EntityHandle _handle)
+{
+  std::uint8_t &flags = this->dataPtr->flags[_handle];
+  flags |= EntityStore::kPoseDirty;
+
+  // only the first change since the map was last cleared is reported
+  EntityMap *container = this->dataPtr->containers[_handle];
+  if (container && !(flags & EntityStore::kPoseDirtyListed))
+  {
+    flags |= EntityStore::kPoseDirtyListed;
+    container->MarkPoseDirty(this->dataPtr->ids[_handle]);
+  }
+}
+
+//////////////////////////////////////////////////
+const math::Vector3d &EntityStore::LinearVelocity(EntityHandle _handle) const
+{
+  return this->dataPtr->linearVelocities[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetLinearVelocity(EntityHandle _handle,
+    const math::Vector3d &_velocity)
+{
+  this->dataPtr->linearVelocities[_handle] = _velocity;
+}
+
+//////////////////////////////////////////////////
+const math::Vector3d &EntityStore::AngularVelocity(
+    EntityHandle _handle) const
+{
+  return this->dataPtr->angularVelocities[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetAngularVelocity(EntityHandle _handle,
+    const math::Vector3d &_velocity)
+{
+  this->dataPtr->angularVelocities[_handle] = _velocity;
+}
+
+//////////////////////////////////////////////////
+const math::AxisAlignedBox &EntityStore::BoundingBox(
+    EntityHandle _handle) const
+{
+  return this->dataPtr->boundingBoxes[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetBoundingBox(EntityHandle _handle,
+    const math::AxisAlignedBox &_box)
+{
+  this->dataPtr->boundingBoxes[_handle] = _box;
+}
+
+//////////////////////////////////////////////////
+std::uint16_t EntityStore::CollideBitmask(EntityHandle _handle) const
+{
+  return this->dataPtr->collideBitmasks[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetCollideBitmask(EntityHandle _handle,
+    std::uint16_t _mask)
+{
+  this->dataPtr->collideBitmasks[_handle] = _mask;
+}
+
+//////////////////////////////////////////////////
+EntityHandle EntityStore::Parent(EntityHandle _handle) const
+{
+  return this->dataPtr->parents[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetParent(EntityHandle _handle, EntityHandle _parent)
+{
+  EntityStorePrivate &d = *this->dataPtr;
+  if (d.parents[_handle] == _parent)
+    return;
+
+  d.Unlink(_handle);
+  d.parents[_handle] = _parent;
+  if (_parent != kNullEntityHandle)
+  {
+    d.nextSiblings[_handle] = d.firstChildren[_parent];
+    d.firstChildren[_parent] = _handle;
+  }
+}
+
+//////////////////////////////////////////////////
+EntityHandle EntityStore::FirstChild(EntityHandle _handle) const
+{
+  return this->dataPtr->firstChildren[_handle];
+}
+
+//////////////////////////////////////////////////
+EntityHandle EntityStore::NextSibling(EntityHandle _handle) const
+{
+  return this->dataPtr->nextSiblings[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::SetContainer(EntityHandle _handle, EntityMap *_container)
+{
+  this->dataPtr->containers[_handle] = _container;
+  this->SetFlag(_handle, EntityStore::kPoseDirtyListed, false);
+}
+
+//////////////////////////////////////////////////
+EntityMap *EntityStore::Container(EntityHandle _handle) const
+{
+  return this->dataPtr->containers[_handle];
+}
+
+//////////////////////////////////////////////////
+void EntityStore::ChildrenChanged(EntityHandle _handle)
+{
+  for (EntityHandle handle = _handle; handle != kNullEntityHandle;
+       handle = this->dataPtr->parents[handle])
+  {
+    this->dataPtr->flags[handle] |=
+        EntityStore::kBoundingBoxDirty | EntityStore::kCollideBitmaskDirty;
+  }
+}
+
+//////////////////////////////////////////////////
+bool EntityStore::IntegratePose(EntityHandle _handle, double _timeStep)
+{
+  const math::Vector3d &linear = this->dataPtr->linearVelocities[_handle];
+  const math::Vector3d &angular = this->dataPtr->angularVelocities[_handle];
+  if (linear == math::Vector3d::Zero && angular == math::Vector3d::Zero)
+    return false;
+
+  math::Pose3d &pose = this->dataPtr->poses[_handle];
+  pose = math::Pose3d(pose.Pos() + linear * _timeStep,
+      pose.Rot().Integrate(angular, _timeStep));
+  this->MarkPoseDirty(_handle);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void EntityStore::StepModel(EntityHandle _handle, double _timeStep,
+    std::size_t _sleepSteps)
+{
+  // sleeping models don't move
+  if (_sleepSteps > 0u &&
+      (this->dataPtr->flags[_handle] & EntityStore::kSleeping))
+  {
+    return;
+  }
+
+  // a model whose pose is set is woken up, and so is the model of a link
+  bool moved = this->IntegratePose(_handle, _timeStep);
+  for (EntityHandle child = this->dataPtr->firstChildren[_handle];
+       child != kNullEntityHandle; child = this->dataPtr->nextSiblings[child])
+  {
+    if (this->dataPtr->types[child] == EntityType::LINK)
+      moved = this->IntegratePose(child, _timeStep) || moved;
+  }
+  if (moved)
+    this->Wake(_handle);
+
+  this->UpdateSleepState(_handle, _sleepSteps);
+}
+
+//////////////////////////////////////////////////
+void EntityStore::Wake(EntityHandle _handle)
+{
+  // the parent of a model is usually nothing or the model it is nested in,
+  // but any entity may be set as the parent
+  for (EntityHandle handle = _handle; handle != kNullEntityHandle &&
+       this->dataPtr->types[handle] == EntityType::MODEL;
+       handle = this->dataPtr->parents[handle])
+  {
+    this->dataPtr->idleSteps[handle] = 0u;
+    this->dataPtr->flags[handle] &=
+        static_cast<std::uint8_t>(~EntityStore::kSleeping);
+  }
+}
+
+//////////////////////////////////////////////////
+bool EntityStore::UpdateSleepState(EntityHandle _handle,
+    std::size_t _sleepSteps)
+{
+  if (_sleepSteps == 0u)
+  {
+    this->Wake(_handle);
+    return false;
+  }
+
+  std::uint8_t &flags = this->dataPtr->flags[_handle];
+  if (flags & EntityStore::kSleeping)
+    return true;
+
+  bool atRest =
+      this->dataPtr->linearVelocities[_handle] == math::Vector3d::Zero &&
+      this->dataPtr->angularVelocities[_handle] == math::Vector3d::Zero;
+  for (EntityHandle child = this->dataPtr->firstChildren[_handle];
+       atRest && child != kNullEntityHandle;
+       child = this->dataPtr->nextSiblings[child])
+  {
+    if (this->dataPtr->types[child] != EntityType::LINK)
+      continue;
+    atRest = this->dataPtr->linearVelocities[child] == math::Vector3d::Zero &&
+        this->dataPtr->angularVelocities[child] == math::Vector3d::Zero;
+  }
+
+  std::uint32_t &idleSteps = this->dataPtr->idleSteps[_handle];
+  if (!atRest)
+  {
+    idleSteps = 0u;
+    return false;
+  }
+
+  if (++idleSteps >= _sleepSteps)
+    flags |= EntityStore::kSleeping;
+  return (flags & EntityStore::kSleeping) != 0u;
+}
+
+//////////////////////////////////////////////////
+void EntityStorePrivate::Unlink(EntityHandle _handle)
+{
+  const EntityHandle parent = this->parents[_handle];
+  if (parent == kNullEntityHandle)
+    return;
+
+  EntityHandle *link = &this->firstChildren[parent];
+  while (*link != kNullEntityHandle && *link != _handle)
+    link = &this->nextSiblings[*link];
+  if (*link == _handle)
+    *link = this->nextSiblings[_handle];
+  this->nextSiblings[_handle] = kNullEntityHandle;
+  this->parents[_handle] = kNullEntityHandle;
+}
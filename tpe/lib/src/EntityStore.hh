@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_TPE_LIB_SRC_ENTITYSTORE_HH_
+#define IGNITION_PHYSICS_TPE_LIB_SRC_ENTITYSTORE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/utils/SuppressWarning.hh>
+
+#include "ignition/physics/tpelib/Export.hh"
+
+namespace ignition {
+namespace physics {
+namespace tpelib {
+
+// forward declaration
+class EntityMap;
+class EntityStorePrivate;
+
+/// \brief Handle of an entity in the EntityStore. A handle stays the same
+/// for the lifetime of the entity, and is reused once the entity is gone.
+using EntityHandle = std::uint32_t;
+
+/// \brief Represents an invalid handle.
+static const EntityHandle kNullEntityHandle =
+    std::numeric_limits<EntityHandle>::max();
+
+/// \enum EntityType
+/// \brief The set of entity types.
+enum class IGNITION_PHYSICS_TPELIB_VISIBLE EntityType : std::uint8_t
+{
+  /// \brief Plain entity
+  ENTITY = 0,
+
+  /// \brief A world
+  WORLD = 1,
+
+  /// \brief A model
+  MODEL = 2,
+
+  /// \brief A link
+  LINK = 3,
+
+  /// \brief A collision
+  COLLISION = 4
+};
+
+/// \brief Storage of the data of all entities that is visited while
+/// stepping and checking collisions. Each field is kept in its own dense
+/// array indexed by the entity handle, so that passes over many entities
+/// read contiguous memory instead of chasing a pointer to each entity.
+/// Parents and children are linked by handle, so the links of a model are
+/// integrated without visiting the model's child map.
+///
+/// Entities are views over their slot in the store, see Entity. Adding and
+/// removing entities may move the arrays, so entities must not be created or
+/// destroyed while a world is stepped on another thread. Entities that are
+/// stepped in parallel only touch their own slots and those of their
+/// descendants.
+class IGNITION_PHYSICS_TPELIB_VISIBLE EntityStore
+{
+  /// \brief The entity is static
+  public: static const std::uint8_t kStatic = 0x01;
+
+  /// \brief The pose of the entity was set since the flag was last reset
+  public: static const std::uint8_t kPoseDirty = 0x02;
+
+  /// \brief The entity is listed in the pose dirty ids of its container
+  public: static const std::uint8_t kPoseDirtyListed = 0x04;
+
+  /// \brief The bounding box of the entity needs to be recomputed
+  public: static const std::uint8_t kBoundingBoxDirty = 0x08;
+
+  /// \brief The collide bitmask of the entity needs to be recomputed
+  public: static const std::uint8_t kCollideBitmaskDirty = 0x10;
+
+  /// \brief The model is sleeping
+  public: static const std::uint8_t kSleeping = 0x20;
+
+  /// \brief Get the store that holds all entities
+  /// \return The entity store
+  public: static EntityStore &Instance();
+
+  /// \brief Destructor
+  public: ~EntityStore();
+
+  /// \brief Add an entity. The slot is reset to an identity pose, zero
+  /// velocities, an empty bounding box and a collide bitmask of 0xFF.
+  /// \param[in] _id Id of the entity
+  /// \param[in] _type Type of the entity
+  /// \return Handle of the entity
+  public: EntityHandle Add(std::size_t _id, EntityType _type);
+
+  /// \brief Remove an entity. Its children no longer have a parent, and
+  /// its handle may be returned by a later call to Add.
+  /// \param[in] _handle Handle of the entity
+  public: void Remove(EntityHandle _handle);
+
+  /// \brief Get the number of live entities
+  /// \return Number of entities
+  public: std::size_t Count() const;
+
+  /// \brief Get the id of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \return Entity id
+  public: std::size_t Id(EntityHandle _handle) const;
+
+  /// \brief Set the id of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _id Entity id
+  public: void SetId(EntityHandle _handle, std::size_t _id);
+
+  /// \brief Get the type of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \return Entity type
+  public: EntityType Type(EntityHandle _handle) const;
+
+  /// \brief Get whether a flag of an entity is set
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _flag One of the flag constants of this class
+  /// \return True if the flag is set
+  public: bool Flag(EntityHandle _handle, std::uint8_t _flag) const;
+
+  /// \brief Set or reset a flag of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _flag One of the flag constants of this class
+  /// \param[in] _value True to set the flag
+  public: void SetFlag(EntityHandle _handle, std::uint8_t _flag,
+      bool _value);
+
+  /// \brief Get the pose of an entity relative to its parent
+  /// \param[in] _handle Handle of the entity
+  /// \return Pose of the entity
+  public: const math::Pose3d &Pose(EntityHandle _handle) const;
+
+  /// \brief Set the pose of an entity relative to its parent and mark it
+  /// dirty, see MarkPoseDirty.
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _pose Pose of the entity
+  public: void SetPose(EntityHandle _handle, const math::Pose3d &_pose);
+
+  /// \brief Get the world pose of an entity by composing the poses of its
+  /// ancestors
+  /// \param[in] _handle Handle of the entity
+  /// \return World pose of the entity
+  public: math::Pose3d WorldPose(EntityHandle _handle) const;
+
+  /// \brief Set the pose dirty flag of an entity. The first time this
+  /// happens since the container of the entity last cleared its dirty
+  /// poses, the entity is reported to the container.
+  /// \param[in] _handle Handle of the entity
+  public: void MarkPoseDirty(EntityHandle _handle);
+
+  /// \brief Get the linear velocity of an entity relative to its parent
+  /// \param[in] _handle Handle of the entity
+  /// \return Linear velocity in meters per second
+  public: const math::Vector3d &LinearVelocity(EntityHandle _handle) const;
+
+  /// \brief Set the linear velocity of an entity relative to its parent
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _velocity Linear velocity in meters per second
+  public: void SetLinearVelocity(EntityHandle _handle,
+      const math::Vector3d &_velocity);
+
+  /// \brief Get the angular velocity of an entity relative to its parent
+  /// \param[in] _handle Handle of the entity
+  /// \return Angular velocity in radians per second
+  public: const math::Vector3d &AngularVelocity(EntityHandle _handle) const;
+
+  /// \brief Set the angular velocity of an entity relative to its parent
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _velocity Angular velocity in radians per second
+  public: void SetAngularVelocity(EntityHandle _handle,
+      const math::Vector3d &_velocity);
+
+  /// \brief Get the bounding box of an entity in its own frame, as last
+  /// computed by the entity
+  /// \param[in] _handle Handle of the entity
+  /// \return Bounding box
+  public: const math::AxisAlignedBox &BoundingBox(EntityHandle _handle) const;
+
+  /// \brief Set the bounding box of an entity in its own frame
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _box Bounding box
+  public: void SetBoundingBox(EntityHandle _handle,
+      const math::AxisAlignedBox &_box);
+
+  /// \brief Get the collide bitmask of an entity, as last computed by the
+  /// entity
+  /// \param[in] _handle Handle of the entity
+  /// \return Collide bitmask
+  public: std::uint16_t CollideBitmask(EntityHandle _handle) const;
+
+  /// \brief Set the collide bitmask of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _mask Collide bitmask
+  public: void SetCollideBitmask(EntityHandle _handle, std::uint16_t _mask);
+
+  /// \brief Get the parent of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \return Handle of the parent, or kNullEntityHandle
+  public: EntityHandle Parent(EntityHandle _handle) const;
+
+  /// \brief Set the parent of an entity. The entity is moved to the
+  /// children of the new parent.
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _parent Handle of the parent, or kNullEntityHandle
+  public: void SetParent(EntityHandle _handle, EntityHandle _parent);
+
+  /// \brief Get the first child of an entity. The children are not in a
+  /// particular order.
+  /// \param[in] _handle Handle of the entity
+  /// \return Handle of the first child, or kNullEntityHandle
+  public: EntityHandle FirstChild(EntityHandle _handle) const;
+
+  /// \brief Get the next child of the parent of an entity
+  /// \param[in] _handle Handle of the entity
+  /// \return Handle of the next sibling, or kNullEntityHandle
+  public: EntityHandle NextSibling(EntityHandle _handle) const;
+
+  /// \brief Set the map that an entity reports its pose changes to
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _container Map that holds the entity, or nullptr
+  public: void SetContainer(EntityHandle _handle, EntityMap *_container);
+
+  /// \brief Get the map that an entity reports its pose changes to
+  /// \param[in] _handle Handle of the entity
+  /// \return Map that holds the entity, or nullptr
+  public: EntityMap *Container(EntityHandle _handle) const;
+
+  /// \brief Mark the bounding box and collide bitmask of an entity and its
+  /// ancestors as dirty
+  /// \param[in] _handle Handle of the entity
+  public: void ChildrenChanged(EntityHandle _handle);
+
+  /// \brief Integrate the pose of an entity over a time step with its
+  /// velocities. The pose is only set if a velocity is not zero.
+  /// \param[in] _handle Handle of the entity
+  /// \param[in] _timeStep Time step in seconds
+  /// \return True if the pose was set
+  public: bool IntegratePose(EntityHandle _handle, double _timeStep);
+
+  /// \brief Integrate the pose of a model and of its links over a time
+  /// step, then update its sleep state. Nested models are not integrated.
+  /// Sleeping models are skipped if sleeping is enabled.
+  /// \param[in] _handle Handle of the model
+  /// \param[in] _timeStep Time step in seconds
+  /// \param[in] _sleepSteps Number of steps at rest after which the model
+  /// goes to sleep. 0 disables sleeping.
+  public: void StepModel(EntityHandle _handle, double _timeStep,
+      std::size_t _sleepSteps);
+
+  /// \brief Wake up a model and the models it is nested in, and restart
+  /// counting the steps that they have been at rest. Entities that are not
+  /// models are ignored.
+  /// \param[in] _handle Handle of the model
+  public: void Wake(EntityHandle _handle);
+
+  /// \brief Count the steps that a model and its links have been at rest
+  /// and put the model to sleep when the count reaches a threshold.
+  /// \param[in] _handle Handle of the model
+  /// \param[in] _sleepSteps Number of steps at rest after which the model
+  /// goes to sleep. 0 disables sleeping.
+  /// \return True if the model is sleeping
+  public: bool UpdateSleepState(EntityHandle _handle,
+      std::size_t _sleepSteps);
+
+  /// \brief Constructor
+  private: EntityStore();
+
+  /// \brief Pointer to private data
+  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  private: std::unique_ptr<EntityStorePrivate> dataPtr;
+  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
+}
+}
+}
+
+#endif
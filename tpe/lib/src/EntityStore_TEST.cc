@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "EntityStore.hh"
+#include "Link.hh"
+#include "Model.hh"
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+/////////////////////////////////////////////////
+TEST(EntityStore, Handles)
+{
+  EntityStore &store = EntityStore::Instance();
+  const std::size_t count = store.Count();
+
+  EntityHandle handle = kNullEntityHandle;
+  {
+    Model model;
+    handle = model.GetHandle();
+    EXPECT_NE(kNullEntityHandle, handle);
+    EXPECT_EQ(count + 1u, store.Count());
+    EXPECT_EQ(EntityType::MODEL, model.GetType());
+    EXPECT_EQ(model.GetId(), store.Id(handle));
+
+    // the entity is a view over its slot in the store
+    model.SetPose(math::Pose3d(1, 2, 3, 0, 0, 0));
+    EXPECT_EQ(math::Pose3d(1, 2, 3, 0, 0, 0), store.Pose(handle));
+    EXPECT_TRUE(store.Flag(handle, EntityStore::kPoseDirty));
+    model.SetLinearVelocity(math::Vector3d(1, 0, 0));
+    EXPECT_EQ(math::Vector3d(1, 0, 0), store.LinearVelocity(handle));
+    model.SetStatic(true);
+    EXPECT_TRUE(store.Flag(handle, EntityStore::kStatic));
+  }
+  EXPECT_EQ(count, store.Count());
+
+  // the slot of a removed entity is reused and reset
+  Link link;
+  EXPECT_EQ(handle, link.GetHandle());
+  EXPECT_EQ(EntityType::LINK, link.GetType());
+  EXPECT_EQ(math::Pose3d::Zero, link.GetPose());
+  EXPECT_EQ(math::Vector3d::Zero, link.GetLinearVelocity());
+  EXPECT_FALSE(link.GetStatic());
+  EXPECT_FALSE(link.PoseDirty());
+}
+
+/////////////////////////////////////////////////
+TEST(EntityStore, ParentLinks)
+{
+  EntityStore &store = EntityStore::Instance();
+  Model model;
+  Model &nested = static_cast<Model &>(model.AddModel());
+  Entity &link = nested.AddLink();
+  Entity &collision = static_cast<Link &>(link).AddCollision();
+
+  EXPECT_EQ(model.GetHandle(), store.Parent(nested.GetHandle()));
+  EXPECT_EQ(nested.GetHandle(), store.Parent(link.GetHandle()));
+  EXPECT_EQ(link.GetHandle(), store.FirstChild(nested.GetHandle()));
+  EXPECT_EQ(kNullEntityHandle, store.NextSibling(link.GetHandle()));
+
+  // world poses compose the poses of the ancestors
+  model.SetPose(math::Pose3d(1, 0, 0, 0, 0, 0));
+  nested.SetPose(math::Pose3d(0, 1, 0, 0, 0, 0));
+  link.SetPose(math::Pose3d(0, 0, 1, 0, 0, 0));
+  EXPECT_EQ(math::Pose3d(1, 1, 1, 0, 0, 0), collision.GetWorldPose());
+
+  // removed children no longer have a parent
+  const std::size_t linkId = link.GetId();
+  auto linkPtr = nested.GetChildMap().at(linkId);
+  EXPECT_TRUE(nested.RemoveChildById(linkId));
+  EXPECT_EQ(kNullEntityHandle, store.Parent(linkPtr->GetHandle()));
+  EXPECT_EQ(kNullEntityHandle, store.FirstChild(nested.GetHandle()));
+  EXPECT_EQ(nullptr, linkPtr->GetParent());
+}
+
+/////////////////////////////////////////////////
+TEST(EntityStore, StepModel)
+{
+  EntityStore &store = EntityStore::Instance();
+  Model model;
+  Link &link = static_cast<Link &>(model.AddLink());
+  Model &nested = static_cast<Model &>(model.AddModel());
+  Link &nestedLink = static_cast<Link &>(nested.AddLink());
+
+  // the model and its links are integrated, but not nested models
+  model.SetLinearVelocity(math::Vector3d(1, 0, 0));
+  link.SetLinearVelocity(math::Vector3d(0, 1, 0));
+  nested.SetLinearVelocity(math::Vector3d(0, 0, 1));
+  nestedLink.SetLinearVelocity(math::Vector3d(0, 0, 1));
+  store.StepModel(model.GetHandle(), 0.5, 2u);
+  EXPECT_EQ(math::Pose3d(0.5, 0, 0, 0, 0, 0), model.GetPose());
+  EXPECT_EQ(math::Pose3d(0, 0.5, 0, 0, 0, 0), link.GetPose());
+  EXPECT_EQ(math::Pose3d::Zero, nested.GetPose());
+  EXPECT_EQ(math::Pose3d::Zero, nestedLink.GetPose());
+
+  // the model goes to sleep once it is at rest, and is then skipped
+  model.SetLinearVelocity(math::Vector3d::Zero);
+  link.SetLinearVelocity(math::Vector3d::Zero);
+  store.StepModel(model.GetHandle(), 0.5, 2u);
+  EXPECT_FALSE(model.GetSleeping());
+  store.StepModel(model.GetHandle(), 0.5, 2u);
+  EXPECT_TRUE(model.GetSleeping());
+  store.SetLinearVelocity(model.GetHandle(), math::Vector3d(1, 0, 0));
+  store.StepModel(model.GetHandle(), 0.5, 2u);
+  EXPECT_EQ(math::Pose3d(0.5, 0, 0, 0, 0, 0), model.GetPose());
+
+  // waking a nested model wakes the model it is nested in
+  nested.Wake();
+  EXPECT_FALSE(model.GetSleeping());
+}
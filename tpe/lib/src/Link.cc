@@ -23,12 +23,12 @@ using namespace physics;
 using namespace tpelib;
 
 //////////////////////////////////////////////////
-Link::Link() : Entity()
+Link::Link() : Entity(EntityType::LINK)
 {
 }
 
 //////////////////////////////////////////////////
-Link::Link(std::size_t _id) : Entity(_id)
+Link::Link(std::size_t _id) : Entity(_id, EntityType::LINK)
 {
 }
 
@@ -36,47 +36,63 @@ Link::Link(std::size_t _id) : Entity(_id)
 Entity &Link::AddCollision()
 {
   std::size_t collisionId = Entity::GetNextId();
-  const auto[it, success] = this->GetChildren().insert(
+  const auto[it, success] = this->GetChildMap().insert(
     {collisionId, std::make_shared<Collision>(collisionId)});
   it->second->SetParent(this);
   this->ChildrenChanged();
+  this->WakeModel();
   return *it->second.get();
 }
 
 //////////////////////////////////////////////////
 void Link::SetLinearVelocity(const math::Vector3d &_velocity)
 {
-  this->linearVelocity = _velocity;
+  EntityStore::Instance().SetLinearVelocity(this->GetHandle(), _velocity);
+  if (_velocity != math::Vector3d::Zero)
+    this->WakeModel();
 }
 
 //////////////////////////////////////////////////
 math::Vector3d Link::GetLinearVelocity() const
 {
-  return this->linearVelocity;
+  return EntityStore::Instance().LinearVelocity(this->GetHandle());
 }
 
 //////////////////////////////////////////////////
 void Link::SetAngularVelocity(const math::Vector3d &_velocity)
 {
-  this->angularVelocity = _velocity;
+  EntityStore::Instance().SetAngularVelocity(this->GetHandle(), _velocity);
+  if (_velocity != math::Vector3d::Zero)
+    this->WakeModel();
 }
 
 //////////////////////////////////////////////////
 math::Vector3d Link::GetAngularVelocity() const
 {
-  return this->angularVelocity;
+  return EntityStore::Instance().AngularVelocity(this->GetHandle());
 }
 
 //////////////////////////////////////////////////
 void Link::UpdatePose(double _timeStep)
 {
-  if (this->linearVelocity == math::Vector3d::Zero &&
-      this->angularVelocity == math::Vector3d::Zero)
-    return;
+  if (EntityStore::Instance().IntegratePose(this->GetHandle(), _timeStep))
+    this->WakeModel();
+}
 
-  math::Pose3d currentPose = this->GetPose();
-  math::Pose3d nextPose(
-    currentPose.Pos() + this->linearVelocity * _timeStep,
-    currentPose.Rot().Integrate(this->angularVelocity, _timeStep));
-  this->SetPose(nextPose);
+//////////////////////////////////////////////////
+void Link::SetPose(const math::Pose3d &_pose)
+{
+  Entity::SetPose(_pose);
+  this->WakeModel();
+}
+
+//////////////////////////////////////////////////
+void Link::WakeModel()
+{
+  // links are added to models, but any entity may be set as the parent.
+  // Entities that are not models are not woken up.
+  EntityStore &store = EntityStore::Instance();
+  const EntityHandle parent = store.Parent(this->GetHandle());
+  if (parent != kNullEntityHandle)
+    store.Wake(parent);
 }
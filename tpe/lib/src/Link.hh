@@ -28,7 +28,8 @@ namespace ignition {
 namespace physics {
 namespace tpelib {
 
-/// \brief Link class
+/// \brief Link class. The velocities of the link are kept in the
+/// EntityStore.
 class IGNITION_PHYSICS_TPELIB_VISIBLE Link : public Entity
 {
   /// \brief Constructor
@@ -65,13 +66,12 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Link : public Entity
   /// \param[in] _timeStep current world timestep in seconds
   public: virtual void UpdatePose(double _timeStep);
 
-  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
-  /// \brief linear velocity of link
-  protected: math::Vector3d linearVelocity;
+  /// \brief Set the pose of the link. This wakes up the parent model.
+  /// \param[in] _pose Pose of link to set to
+  public: void SetPose(const math::Pose3d &_pose) override;
 
-  /// \brief angular velocity of link
-  protected: math::Vector3d angularVelocity;
-  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+  /// \brief Wake up the parent model, if any
+  private: void WakeModel();
 };
 
 }
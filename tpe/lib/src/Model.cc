@@ -48,13 +48,13 @@ using namespace tpelib;
 
 //////////////////////////////////////////////////
 Model::Model()
-    : Entity(), dataPtr(new ModelPrivate)
+    : Entity(EntityType::MODEL), dataPtr(new ModelPrivate)
 {
 }
 
 //////////////////////////////////////////////////
 Model::Model(std::size_t _id)
-    : Entity(_id), dataPtr(new ModelPrivate)
+    : Entity(_id, EntityType::MODEL), dataPtr(new ModelPrivate)
 {
 }
 
@@ -76,12 +76,13 @@ Entity &Model::AddLink()
     this->dataPtr->canonicalLinkId = linkId;
   }
 
-  const auto[it, success]  = this->GetChildren().insert(
+  const auto[it, success]  = this->GetChildMap().insert(
       {linkId, std::make_shared<Link>(linkId)});
   this->dataPtr->linkIds.push_back(linkId);
 
   it->second->SetParent(this);
   this->ChildrenChanged();
+  this->Wake();
   return *it->second.get();
 }
 
@@ -95,12 +96,13 @@ std::size_t Model::GetLinkCount() const
 Entity &Model::AddModel()
 {
   std::size_t modelId = Entity::GetNextId();
-  const auto[it, success]  = this->GetChildren().insert(
+  const auto[it, success]  = this->GetChildMap().insert(
       {modelId, std::make_shared<Model>(modelId)});
   this->dataPtr->nestedModelIds.push_back(modelId);
 
   it->second->SetParent(this);
   this->ChildrenChanged();
+  this->Wake();
   return *it->second.get();
 }
 
@@ -132,13 +134,12 @@ Entity &Model::GetCanonicalLink()
   }
   else
   {
-    for (auto &child : this->GetChildren())
+    for (auto &child : this->GetChildMap())
     {
-      Entity childEnt = *(child.second);
-      Model *nestedModel = static_cast<Model *>(&childEnt);
-      if (nestedModel != nullptr)
+      if (child.second->GetType() == EntityType::MODEL)
       {
-        Entity &ent = nestedModel->GetChildById(this->dataPtr->canonicalLinkId);
+        Entity &ent =
+            child.second->GetChildById(this->dataPtr->canonicalLinkId);
         if (ent.GetId() != kNullEntityId)
         {
           return ent;
@@ -152,27 +153,32 @@ Entity &Model::GetCanonicalLink()
 //////////////////////////////////////////////////
 void Model::SetLinearVelocity(const math::Vector3d &_velocity)
 {
-  this->linearVelocity = _velocity;
+  EntityStore::Instance().SetLinearVelocity(this->GetHandle(), _velocity);
+  // a model at rest stays at rest when its velocity is set to zero
+  if (_velocity != math::Vector3d::Zero)
+    this->Wake();
 }
 
 //////////////////////////////////////////////////
 math::Vector3d Model::GetLinearVelocity() const
 {
   IGN_PROFILE("tpelib::Model::GetLinearVelocity");
-  return this->linearVelocity;
+  return EntityStore::Instance().LinearVelocity(this->GetHandle());
 }
 
 //////////////////////////////////////////////////
 void Model::SetAngularVelocity(const math::Vector3d &_velocity)
 {
-  this->angularVelocity = _velocity;
+  EntityStore::Instance().SetAngularVelocity(this->GetHandle(), _velocity);
+  if (_velocity != math::Vector3d::Zero)
+    this->Wake();
 }
 
 //////////////////////////////////////////////////
 math::Vector3d Model::GetAngularVelocity() const
 {
   IGN_PROFILE("tpelib::Model::GetAngularVelocity");
-  return this->angularVelocity;
+  return EntityStore::Instance().AngularVelocity(this->GetHandle());
 }
 
 //////////////////////////////////////////////////
@@ -180,15 +186,52 @@ void Model::UpdatePose(double _timeStep)
 {
   IGN_PROFILE("tpelib::Model::UpdatePose");
 
-  if (this->linearVelocity == math::Vector3d::Zero &&
-      this->angularVelocity == math::Vector3d::Zero)
-    return;
+  EntityStore &store = EntityStore::Instance();
+  if (store.IntegratePose(this->GetHandle(), _timeStep))
+    store.Wake(this->GetHandle());
+}
+
+//////////////////////////////////////////////////
+void Model::UpdateLinkPoses(double _timeStep)
+{
+  // the links are found by walking the children of the model in the store
+  EntityStore &store = EntityStore::Instance();
+  bool moved = false;
+  for (EntityHandle child = store.FirstChild(this->GetHandle());
+       child != kNullEntityHandle; child = store.NextSibling(child))
+  {
+    if (store.Type(child) == EntityType::LINK)
+      moved = store.IntegratePose(child, _timeStep) || moved;
+  }
+  if (moved)
+    store.Wake(this->GetHandle());
+}
+
+//////////////////////////////////////////////////
+void Model::SetPose(const math::Pose3d &_pose)
+{
+  Entity::SetPose(_pose);
+  this->Wake();
+}
 
-  math::Pose3d currentPose = this->GetPose();
-  math::Pose3d nextPose(
-    currentPose.Pos() + this->linearVelocity * _timeStep,
-    currentPose.Rot().Integrate(this->angularVelocity, _timeStep));
-  this->SetPose(nextPose);
+//////////////////////////////////////////////////
+void Model::Wake()
+{
+  EntityStore::Instance().Wake(this->GetHandle());
+}
+
+//////////////////////////////////////////////////
+bool Model::GetSleeping() const
+{
+  return EntityStore::Instance().Flag(
+      this->GetHandle(), EntityStore::kSleeping);
+}
+
+//////////////////////////////////////////////////
+bool Model::UpdateSleepState(std::size_t _sleepSteps)
+{
+  return EntityStore::Instance().UpdateSleepState(
+      this->GetHandle(), _sleepSteps);
 }
 
 //////////////////////////////////////////////////
@@ -238,7 +281,7 @@ bool Model::RemoveChildEntityBasedOnType(const Entity *_ent)
     return false;
 
   bool result = true;
-  if (nullptr != dynamic_cast<const Model *>(_ent))
+  if (_ent->GetType() == EntityType::MODEL)
   {
     result &= this->RemoveModelById(_ent->GetId());
   }
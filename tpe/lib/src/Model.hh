@@ -31,7 +31,8 @@ namespace tpelib {
 // forward declaration
 class ModelPrivate;
 
-/// \brief Model class
+/// \brief Model class. The velocities and sleep state of the model are
+/// kept in the EntityStore.
 class IGNITION_PHYSICS_TPELIB_VISIBLE Model : public Entity
 {
   /// \brief Constructor
@@ -88,6 +89,32 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Model : public Entity
   /// \param[in] _timeStep current world timestep in seconds
   public: virtual void UpdatePose(double _timeStep);
 
+  /// \brief Update the pose of each link in the model by integrating its
+  /// velocity. Nested models are not updated.
+  /// \param[in] _timeStep Time step in seconds
+  public: void UpdateLinkPoses(double _timeStep);
+
+  /// \brief Set the pose of the model. This wakes up the model.
+  /// \param[in] _pose Pose of model to set to
+  public: void SetPose(const math::Pose3d &_pose) override;
+
+  /// \brief Wake up the model, and its parent model if it is nested, and
+  /// restart counting the steps that it has been at rest.
+  public: void Wake();
+
+  /// \brief Get whether the model is sleeping. A sleeping model is not
+  /// integrated and does not move until it is woken up.
+  /// \return True if the model is sleeping
+  public: bool GetSleeping() const;
+
+  /// \internal
+  /// \brief Count the steps that the model and its links have been at rest
+  /// and put the model to sleep when the count reaches a threshold.
+  /// \param[in] _sleepSteps Number of steps at rest after which the model
+  /// goes to sleep. 0 disables sleeping.
+  /// \return True if the model is sleeping
+  public: bool UpdateSleepState(std::size_t _sleepSteps);
+
   /// \brief Removes a child entity (either a link or model) from the
   /// appropriate child entity containers
   /// \param[in] _ent Pointer to entity
@@ -103,14 +130,6 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE Model : public Entity
   /// \return True if child entity was removed, false otherwise
   public: bool RemoveChildByName(const std::string &_name) override;
 
-  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
-  /// \brief linear velocity of model
-  protected: math::Vector3d linearVelocity;
-
-  /// \brief angular velocity of model
-  protected: math::Vector3d angularVelocity;
-  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
-
   /// \brief Remove a model entity by id
   /// \param[in] _id Id of model entity to remove
   private: bool RemoveModelById(std::size_t _id);
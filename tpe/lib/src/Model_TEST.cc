@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "Collision.hh"
 #include "Link.hh"
 #include "Model.hh"
@@ -344,3 +348,125 @@ TEST(Model, NestedModel)
   m2->SetCanonicalLink();
   EXPECT_EQ(linkEnt2.GetId(), m2->GetCanonicalLink().GetId());
 }
+
+/////////////////////////////////////////////////
+TEST(Model, ChildLookup)
+{
+  Model model;
+  std::vector<std::size_t> linkIds;
+  for (unsigned int i = 0; i < 5u; ++i)
+  {
+    Entity &linkEnt = model.AddLink();
+    linkEnt.SetName("link_" + std::to_string(i));
+    linkIds.push_back(linkEnt.GetId());
+  }
+  ASSERT_EQ(5u, model.GetChildCount());
+
+  // children are ordered by id
+  for (unsigned int i = 0; i < 5u; ++i)
+  {
+    EXPECT_EQ(linkIds[i], model.GetChildByIndex(i).GetId());
+    EXPECT_EQ(linkIds[i],
+        model.GetChildByName("link_" + std::to_string(i)).GetId());
+  }
+  EXPECT_EQ(kNullEntityId, model.GetChildByIndex(5u).GetId());
+  EXPECT_EQ(kNullEntityId, model.GetChildByName("link_5").GetId());
+
+  // renaming a child updates the name lookup
+  model.GetChildById(linkIds[2]).SetName("renamed");
+  EXPECT_EQ(kNullEntityId, model.GetChildByName("link_2").GetId());
+  EXPECT_EQ(linkIds[2], model.GetChildByName("renamed").GetId());
+
+  // the first child with a given name is returned
+  model.GetChildById(linkIds[4]).SetName("link_1");
+  EXPECT_EQ(linkIds[1], model.GetChildByName("link_1").GetId());
+
+  // removing children keeps index and name lookups consistent
+  EXPECT_TRUE(model.RemoveChildByName("link_1"));
+  EXPECT_EQ(linkIds[4], model.GetChildByName("link_1").GetId());
+  EXPECT_TRUE(model.RemoveChildById(linkIds[0]));
+  ASSERT_EQ(3u, model.GetChildCount());
+  EXPECT_EQ(3u, model.GetLinkCount());
+  EXPECT_EQ(linkIds[2], model.GetChildByIndex(0u).GetId());
+  EXPECT_EQ(linkIds[3], model.GetChildByIndex(1u).GetId());
+  EXPECT_EQ(linkIds[4], model.GetChildByIndex(2u).GetId());
+  EXPECT_EQ(kNullEntityId, model.GetChildByName("link_0").GetId());
+
+  // children can be looked up through the flat map
+  auto &children = model.GetChildMap();
+  EXPECT_EQ(1u, children.count(linkIds[3]));
+  EXPECT_EQ(0u, children.count(linkIds[0]));
+  EXPECT_EQ(linkIds[3], children.at(linkIds[3])->GetId());
+  EXPECT_EQ(children.end(), children.find(linkIds[1]));
+
+  // inserting out of order keeps the entries sorted by id
+  auto [it, inserted] = children.insert(
+      {linkIds[1], std::make_shared<Link>()});
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(linkIds[1], it->first);
+  EXPECT_EQ(linkIds[1], children[0u].first);
+  EXPECT_FALSE(children.insert({linkIds[1], std::make_shared<Link>()}).second);
+  EXPECT_EQ(4u, children.size());
+}
+
+/////////////////////////////////////////////////
+TEST(Model, RenameInOtherParent)
+{
+  // two models with links of the same names
+  Model model1;
+  Model model2;
+  Entity &link1 = model1.AddLink();
+  link1.SetName("link");
+  Entity &link2 = model2.AddLink();
+  link2.SetName("link");
+
+  // renaming a link of one model leaves the names of the other untouched
+  link1.SetName("renamed");
+  EXPECT_EQ(link1.GetId(), model1.GetChildByName("renamed").GetId());
+  EXPECT_EQ(kNullEntityId, model1.GetChildByName("link").GetId());
+  EXPECT_EQ(link2.GetId(), model2.GetChildByName("link").GetId());
+
+  // a copy of the children is searched linearly, so it sees renames too
+  EntityMap copy(model2.GetChildren());
+  link2.SetName("copied");
+  EXPECT_EQ(link2.GetId(), copy.FindByName("copied")->first);
+  EXPECT_EQ(copy.end(), copy.FindByName("link"));
+}
+
+/////////////////////////////////////////////////
+TEST(Model, NonModelParent)
+{
+  // waking the model of a link or nested model checks the parent type
+  Entity parent;
+  Link link;
+  link.SetParent(&parent);
+  link.SetLinearVelocity(math::Vector3d(1, 0, 0));
+  link.SetPose(math::Pose3d(1, 0, 0, 0, 0, 0));
+  EXPECT_EQ(math::Pose3d(1, 0, 0, 0, 0, 0), link.GetPose());
+
+  Model model;
+  model.SetParent(&parent);
+  model.SetPose(math::Pose3d(0, 1, 0, 0, 0, 0));
+  EXPECT_FALSE(model.GetSleeping());
+}
+
+/////////////////////////////////////////////////
+TEST(Model, ChildrenCopy)
+{
+  Model model;
+  const std::size_t linkId = model.AddLink().GetId();
+
+  // the std::map of the children is a copy that is kept until children are
+  // added or removed
+  auto &children = model.GetChildren();
+  ASSERT_EQ(1u, children.size());
+  EXPECT_EQ(linkId, children.at(linkId)->GetId());
+  EXPECT_EQ(&children, &model.GetChildren());
+
+  const std::size_t link2Id = model.AddLink().GetId();
+  EXPECT_EQ(2u, model.GetChildren().size());
+  EXPECT_TRUE(model.RemoveChildById(linkId));
+  ASSERT_EQ(1u, model.GetChildren().size());
+  EXPECT_EQ(1u, model.GetChildren().count(link2Id));
+  EXPECT_EQ(model.GetChildMap().size(), model.GetChildren().size());
+}
@@ -0,0 +1,721 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "Narrowphase.hh"
+#include "Utils.hh"
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+namespace
+{
+/// \brief Tolerance for degenerate directions and lengths
+const double kEpsilon = 1e-12;
+
+/// \brief Convergence tolerance of EPA in meters
+const double kEpaTolerance = 1e-8;
+
+/// \brief Maximum number of GJK and EPA iterations
+const unsigned int kMaxIterations = 64u;
+
+/// \brief Vertex of the Minkowski difference of two shapes, together with
+/// the points on each shape that it was computed from
+struct SupportVertex
+{
+  /// \brief Point of the Minkowski difference, a - b
+  math::Vector3d v;
+
+  /// \brief Support point on the first shape
+  math::Vector3d a;
+
+  /// \brief Support point on the second shape
+  math::Vector3d b;
+};
+
+/// \brief Face of the EPA polytope
+struct Face
+{
+  /// \brief Vertex indices, counter clockwise when seen from outside
+  std::array<std::size_t, 3> v;
+
+  /// \brief Outward unit normal
+  math::Vector3d normal;
+
+  /// \brief Distance of the face plane from the origin
+  double distance = 0.0;
+};
+
+/// \brief Get the support vertex of the Minkowski difference _s1 - _s2
+SupportVertex minkowskiSupport(const ConvexShape &_s1, const ConvexShape &_s2,
+    const math::Vector3d &_dir)
+{
+  SupportVertex s;
+  s.a = supportPoint(_s1, _dir);
+  s.b = supportPoint(_s2, -_dir);
+  s.v = s.a - s.b;
+  return s;
+}
+
+/// \brief Compute (_a x _b) x _c
+math::Vector3d tripleCross(const math::Vector3d &_a, const math::Vector3d &_b,
+    const math::Vector3d &_c)
+{
+  return _a.Cross(_b).Cross(_c);
+}
+
+/// \brief Update a line simplex, the newest vertex is first
+/// \return True if the origin is on the line
+bool lineCase(std::array<SupportVertex, 4> &_s, std::size_t &_n,
+    math::Vector3d &_dir)
+{
+  const math::Vector3d ab = _s[1].v - _s[0].v;
+  const math::Vector3d ao = -_s[0].v;
+  if (ab.Dot(ao) > 0.0)
+  {
+    _dir = tripleCross(ab, ao, ab);
+    return _dir.SquaredLength() < kEpsilon * ab.SquaredLength();
+  }
+  _n = 1u;
+  _dir = ao;
+  return false;
+}
+
+/// \brief Update a triangle simplex, the newest vertex is first
+/// \return True if the origin is on the triangle
+bool triangleCase(std::array<SupportVertex, 4> &_s, std::size_t &_n,
+    math::Vector3d &_dir)
+{
+  const math::Vector3d ab = _s[1].v - _s[0].v;
+  const math::Vector3d ac = _s[2].v - _s[0].v;
+  const math::Vector3d ao = -_s[0].v;
+  const math::Vector3d abc = ab.Cross(ac);
+
+  if (abc.Cross(ac).Dot(ao) > 0.0)
+  {
+    if (ac.Dot(ao) > 0.0)
+    {
+      _s[1] = _s[2];
+      _n = 2u;
+      _dir = tripleCross(ac, ao, ac);
+      return _dir.SquaredLength() < kEpsilon * ac.SquaredLength();
+    }
+    _n = 2u;
+    return lineCase(_s, _n, _dir);
+  }
+
+  if (ab.Cross(abc).Dot(ao) > 0.0)
+  {
+    _n = 2u;
+    return lineCase(_s, _n, _dir);
+  }
+
+  const double side = abc.Dot(ao);
+  if (side * side <= kEpsilon * abc.SquaredLength())
+    return true;
+
+  if (side > 0.0)
+  {
+    _dir = abc;
+  }
+  else
+  {
+    std::swap(_s[1], _s[2]);
+    _dir = -abc;
+  }
+  return false;
+}
+
+/// \brief Update a tetrahedron simplex, the newest vertex is first
+/// \return True if the origin is inside the tetrahedron
+bool tetrahedronCase(std::array<SupportVertex, 4> &_s, std::size_t &_n,
+    math::Vector3d &_dir)
+{
+  const math::Vector3d ab = _s[1].v - _s[0].v;
+  const math::Vector3d ac = _s[2].v - _s[0].v;
+  const math::Vector3d ad = _s[3].v - _s[0].v;
+  const math::Vector3d ao = -_s[0].v;
+
+  if (ab.Cross(ac).Dot(ao) > 0.0)
+  {
+    _n = 3u;
+    return triangleCase(_s, _n, _dir);
+  }
+  if (ac.Cross(ad).Dot(ao) > 0.0)
+  {
+    _s[1] = _s[2];
+    _s[2] = _s[3];
+    _n = 3u;
+    return triangleCase(_s, _n, _dir);
+  }
+  if (ad.Cross(ab).Dot(ao) > 0.0)
+  {
+    _s[2] = _s[1];
+    _s[1] = _s[3];
+    _n = 3u;
+    return triangleCase(_s, _n, _dir);
+  }
+  return true;
+}
+
+/// \brief Run GJK to check whether two convex shapes intersect
+/// \param[out] _s Final simplex, which encloses the origin if the shapes
+/// intersect
+/// \param[out] _n Number of vertices in the simplex
+/// \return True if the shapes intersect
+bool gjk(const ConvexShape &_s1, const ConvexShape &_s2,
+    std::array<SupportVertex, 4> &_s, std::size_t &_n)
+{
+  math::Vector3d dir = _s2.pose.Pos() - _s1.pose.Pos();
+  if (dir.SquaredLength() < kEpsilon)
+    dir.Set(1, 0, 0);
+
+  _s[0] = minkowskiSupport(_s1, _s2, dir);
+  _n = 1u;
+  dir = -_s[0].v;
+
+  for (unsigned int i = 0; i < kMaxIterations; ++i)
+  {
+    // the origin is on the simplex
+    if (dir.SquaredLength() < kEpsilon)
+      return true;
+
+    SupportVertex p = minkowskiSupport(_s1, _s2, dir);
+    if (p.v.Dot(dir) < 0.0)
+      return false;
+
+    for (std::size_t k = _n; k > 0u; --k)
+      _s[k] = _s[k - 1u];
+    _s[0] = p;
+    ++_n;
+
+    bool enclosed = false;
+    if (_n == 2u)
+      enclosed = lineCase(_s, _n, dir);
+    else if (_n == 3u)
+      enclosed = triangleCase(_s, _n, dir);
+    else
+      enclosed = tetrahedronCase(_s, _n, dir);
+
+    if (enclosed)
+      return true;
+  }
+  return false;
+}
+
+/// \brief Grow a simplex that touches the origin into a tetrahedron
+/// \return False if the Minkowski difference is flat
+bool expandSimplex(const ConvexShape &_s1, const ConvexShape &_s2,
+    std::array<SupportVertex, 4> &_s, std::size_t &_n)
+{
+  static const math::Vector3d axes[6] = {
+      {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+  if (_n == 1u)
+  {
+    for (const auto &axis : axes)
+    {
+      SupportVertex p = minkowskiSupport(_s1, _s2, axis);
+      if ((p.v - _s[0].v).SquaredLength() > kEpsilon)
+      {
+        _s[_n++] = p;
+        break;
+      }
+    }
+    if (_n < 2u)
+      return false;
+  }
+
+  if (_n == 2u)
+  {
+    const math::Vector3d line = _s[1].v - _s[0].v;
+    for (const auto &axis : axes)
+    {
+      const math::Vector3d dir = line.Cross(axis);
+      if (dir.SquaredLength() < kEpsilon)
+        continue;
+      SupportVertex p = minkowskiSupport(_s1, _s2, dir);
+      if (line.Cross(p.v - _s[0].v).SquaredLength() > kEpsilon)
+      {
+        _s[_n++] = p;
+        break;
+      }
+    }
+    if (_n < 3u)
+      return false;
+  }
+
+  if (_n == 3u)
+  {
+    const math::Vector3d normal =
+        (_s[1].v - _s[0].v).Cross(_s[2].v - _s[0].v);
+    for (const auto &dir : {normal, -normal})
+    {
+      SupportVertex p = minkowskiSupport(_s1, _s2, dir);
+      if (std::fabs(normal.Dot(p.v - _s[0].v)) >
+          std::sqrt(kEpsilon) * normal.Length())
+      {
+        _s[_n++] = p;
+        break;
+      }
+    }
+    if (_n < 4u)
+      return false;
+  }
+  return true;
+}
+
+/// \brief Create an EPA face with its normal pointing away from _inside
+/// \return False if the face is degenerate
+bool makeFace(const std::vector<SupportVertex> &_vertices, std::size_t _a,
+    std::size_t _b, std::size_t _c, const math::Vector3d &_inside, Face &_face)
+{
+  _face.v = {_a, _b, _c};
+  math::Vector3d normal = (_vertices[_b].v - _vertices[_a].v).Cross(
+      _vertices[_c].v - _vertices[_a].v);
+  const double length = normal.Length();
+  if (length < kEpsilon)
+    return false;
+  normal = normal / length;
+  if (normal.Dot(_vertices[_a].v - _inside) < 0.0)
+  {
+    std::swap(_face.v[1], _face.v[2]);
+    normal = -normal;
+  }
+  _face.normal = normal;
+  _face.distance = normal.Dot(_vertices[_a].v);
+  return true;
+}
+
+/// \brief Compute the barycentric coordinates of point _p in triangle
+/// _a, _b, _c
+std::array<double, 3> barycentric(const math::Vector3d &_p,
+    const math::Vector3d &_a, const math::Vector3d &_b,
+    const math::Vector3d &_c)
+{
+  const math::Vector3d v0 = _b - _a;
+  const math::Vector3d v1 = _c - _a;
+  const math::Vector3d v2 = _p - _a;
+  const double d00 = v0.Dot(v0);
+  const double d01 = v0.Dot(v1);
+  const double d11 = v1.Dot(v1);
+  const double d20 = v2.Dot(v0);
+  const double d21 = v2.Dot(v1);
+  const double denom = d00 * d11 - d01 * d01;
+  if (std::fabs(denom) < kEpsilon)
+    return {1.0, 0.0, 0.0};
+  const double v = (d11 * d20 - d01 * d21) / denom;
+  const double w = (d00 * d21 - d01 * d20) / denom;
+  return {1.0 - v - w, v, w};
+}
+
+/// \brief Run EPA on a tetrahedron that encloses the origin to find the
+/// penetration normal and depth
+/// \return False if the tetrahedron is degenerate
+bool epa(const ConvexShape &_s1, const ConvexShape &_s2,
+    const std::array<SupportVertex, 4> &_s, ShapeContact &_contact)
+{
+  std::vector<SupportVertex> vertices(_s.begin(), _s.end());
+  const math::Vector3d inside =
+      (_s[0].v + _s[1].v + _s[2].v + _s[3].v) * 0.25;
+
+  std::vector<Face> faces;
+  const std::size_t tetrahedron[4][3] =
+      {{0, 1, 2}, {0, 3, 1}, {0, 2, 3}, {1, 3, 2}};
+  for (const auto &f : tetrahedron)
+  {
+    Face face;
+    if (makeFace(vertices, f[0], f[1], f[2], inside, face))
+      faces.push_back(face);
+  }
+  if (faces.size() < 4u)
+    return false;
+
+  Face closest;
+  std::vector<std::pair<std::size_t, std::size_t>> edges;
+  for (unsigned int i = 0; i < kMaxIterations && !faces.empty(); ++i)
+  {
+    closest = *std::min_element(faces.begin(), faces.end(),
+        [](const Face &_f1, const Face &_f2)
+        {
+          return _f1.distance < _f2.distance;
+        });
+
+    SupportVertex p = minkowskiSupport(_s1, _s2, closest.normal);
+    if (p.v.Dot(closest.normal) - closest.distance < kEpaTolerance)
+      break;
+
+    // remove the faces that can see the new vertex and keep the edges of
+    // the hole
+    edges.clear();
+    for (auto it = faces.begin(); it != faces.end();)
+    {
+      if (it->normal.Dot(p.v - vertices[it->v[0]].v) > 0.0)
+      {
+        for (std::size_t k = 0; k < 3u; ++k)
+        {
+          std::pair<std::size_t, std::size_t> edge(
+              it->v[k], it->v[(k + 1u) % 3u]);
+          auto shared = std::find(edges.begin(), edges.end(),
+              std::make_pair(edge.second, edge.first));
+          if (shared != edges.end())
+            edges.erase(shared);
+          else
+            edges.push_back(edge);
+        }
+        it = faces.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    if (edges.empty())
+      break;
+
+    // fill the hole with faces connected to the new vertex
+    vertices.push_back(p);
+    for (const auto &edge : edges)
+    {
+      Face face;
+      if (makeFace(vertices, edge.first, edge.second, vertices.size() - 1u,
+          inside, face))
+      {
+        faces.push_back(face);
+      }
+    }
+  }
+
+  const math::Vector3d &a = vertices[closest.v[0]].v;
+  const math::Vector3d &b = vertices[closest.v[1]].v;
+  const math::Vector3d &c = vertices[closest.v[2]].v;
+  const auto w = barycentric(closest.normal * closest.distance, a, b, c);
+  const math::Vector3d p1 = vertices[closest.v[0]].a * w[0] +
+      vertices[closest.v[1]].a * w[1] + vertices[closest.v[2]].a * w[2];
+  const math::Vector3d p2 = vertices[closest.v[0]].b * w[0] +
+      vertices[closest.v[1]].b * w[1] + vertices[closest.v[2]].b * w[2];
+
+  _contact.normal = closest.normal;
+  _contact.depth = std::max(0.0, closest.distance);
+  _contact.point = (p1 + p2) * 0.5;
+  return true;
+}
+
+/// \brief Contact between two spheres
+bool collideSpheres(const math::Vector3d &_c1, double _r1,
+    const math::Vector3d &_c2, double _r2, ShapeContact &_contact)
+{
+  const math::Vector3d d = _c2 - _c1;
+  const double dist2 = d.SquaredLength();
+  const double r = _r1 + _r2;
+  if (dist2 > r * r)
+    return false;
+
+  const double dist = std::sqrt(dist2);
+  _contact.normal = dist > kEpsilon ? d / dist : math::Vector3d(0, 0, 1);
+  _contact.depth = r - dist;
+  _contact.point = _c1 + _contact.normal * (_r1 - 0.5 * _contact.depth);
+  return true;
+}
+
+/// \brief Get the end points of the axis of a sphere or capsule. A sphere
+/// is a capsule with an axis of zero length.
+void segment(const ConvexShape &_shape, math::Vector3d &_p,
+    math::Vector3d &_q)
+{
+  const math::Vector3d axis =
+      _shape.pose.Rot().RotateVector(math::Vector3d(0, 0, _shape.halfLength));
+  _p = _shape.pose.Pos() - axis;
+  _q = _shape.pose.Pos() + axis;
+}
+
+/// \brief Compute the closest points between two segments
+void closestPoints(const math::Vector3d &_p1, const math::Vector3d &_q1,
+    const math::Vector3d &_p2, const math::Vector3d &_q2,
+    math::Vector3d &_c1, math::Vector3d &_c2)
+{
+  const math::Vector3d d1 = _q1 - _p1;
+  const math::Vector3d d2 = _q2 - _p2;
+  const math::Vector3d r = _p1 - _p2;
+  const double a = d1.Dot(d1);
+  const double e = d2.Dot(d2);
+  const double f = d2.Dot(r);
+  double s = 0.0;
+  double t = 0.0;
+
+  if (a <= kEpsilon && e <= kEpsilon)
+  {
+    _c1 = _p1;
+    _c2 = _p2;
+    return;
+  }
+
+  if (a <= kEpsilon)
+  {
+    t = std::clamp(f / e, 0.0, 1.0);
+  }
+  else
+  {
+    const double c = d1.Dot(r);
+    if (e <= kEpsilon)
+    {
+      s = std::clamp(-c / a, 0.0, 1.0);
+    }
+    else
+    {
+      const double b = d1.Dot(d2);
+      const double denom = a * e - b * b;
+      if (denom > kEpsilon)
+        s = std::clamp((b * f - c * e) / denom, 0.0, 1.0);
+      t = (b * s + f) / e;
+      if (t < 0.0)
+      {
+        t = 0.0;
+        s = std::clamp(-c / a, 0.0, 1.0);
+      }
+      else if (t > 1.0)
+      {
+        t = 1.0;
+        s = std::clamp((b - c) / a, 0.0, 1.0);
+      }
+    }
+  }
+
+  _c1 = _p1 + d1 * s;
+  _c2 = _p2 + d2 * t;
+}
+
+/// \brief Contact between a sphere and a box, the normal points from the
+/// sphere to the box
+bool collideSphereBox(const math::Vector3d &_center, double _radius,
+    const ConvexShape &_box, ShapeContact &_contact)
+{
+  const math::Vector3d c =
+      _box.pose.Rot().RotateVectorReverse(_center - _box.pose.Pos());
+  const math::Vector3d &h = _box.halfSize;
+  math::Vector3d q(std::clamp(c.X(), -h.X(), h.X()),
+                   std::clamp(c.Y(), -h.Y(), h.Y()),
+                   std::clamp(c.Z(), -h.Z(), h.Z()));
+
+  const math::Vector3d diff = c - q;
+  const double dist2 = diff.SquaredLength();
+  if (dist2 > _radius * _radius)
+    return false;
+
+  // normal from the box to the sphere in the box frame
+  math::Vector3d normal;
+  if (dist2 > kEpsilon)
+  {
+    const double dist = std::sqrt(dist2);
+    normal = diff / dist;
+    _contact.depth = _radius - dist;
+  }
+  else
+  {
+    // the center is inside the box, push it out through the closest face
+    std::size_t axis = 0u;
+    double faceDist = h[0] - std::fabs(c[0]);
+    for (std::size_t i = 1u; i < 3u; ++i)
+    {
+      const double dist = h[i] - std::fabs(c[i]);
+      if (dist < faceDist)
+      {
+        faceDist = dist;
+        axis = i;
+      }
+    }
+    const double sign = c[axis] < 0.0 ? -1.0 : 1.0;
+    normal[axis] = sign;
+    q = c;
+    q[axis] = sign * h[axis];
+    _contact.depth = _radius + faceDist;
+  }
+
+  const math::Vector3d worldNormal = _box.pose.Rot().RotateVector(normal);
+  const math::Vector3d boxPoint = _box.pose.CoordPositionAdd(q);
+  const math::Vector3d spherePoint = _center - worldNormal * _radius;
+  _contact.normal = -worldNormal;
+  _contact.point = (boxPoint + spherePoint) * 0.5;
+  return true;
+}
+
+/// \brief Check whether a shape is a sphere or a capsule
+bool isRound(const ConvexShape &_shape)
+{
+  return _shape.type == ShapeType::SPHERE ||
+      _shape.type == ShapeType::CAPSULE;
+}
+}
+
+//////////////////////////////////////////////////
+bool tpelib::makeConvexShape(Shape &_shape, const math::Pose3d &_pose,
+    ConvexShape &_result)
+{
+  _result.type = _shape.GetType();
+  _result.pose = _pose;
+  _result.halfSize = math::Vector3d::Zero;
+  _result.radius = 0.0;
+  _result.halfLength = 0.0;
+
+  math::AxisAlignedBox box = _shape.GetBoundingBox();
+  switch (_result.type)
+  {
+    case ShapeType::BOX:
+      _result.halfSize = static_cast<BoxShape &>(_shape).GetSize() * 0.5;
+      break;
+    case ShapeType::SPHERE:
+      _result.radius = static_cast<SphereShape &>(_shape).GetRadius();
+      break;
+    case ShapeType::CAPSULE:
+    {
+      auto &capsule = static_cast<CapsuleShape &>(_shape);
+      _result.radius = capsule.GetRadius();
+      _result.halfLength = capsule.GetLength() * 0.5;
+      break;
+    }
+    case ShapeType::CYLINDER:
+    {
+      auto &cylinder = static_cast<CylinderShape &>(_shape);
+      _result.radius = cylinder.GetRadius();
+      _result.halfLength = cylinder.GetLength() * 0.5;
+      break;
+    }
+    case ShapeType::ELLIPSOID:
+      _result.halfSize = static_cast<EllipsoidShape &>(_shape).GetRadii();
+      break;
+    case ShapeType::MESH:
+      // meshes are approximated by their bounding box, which does not need
+      // to be centered at the origin of the mesh
+      if (box == math::AxisAlignedBox())
+        return false;
+      _result.type = ShapeType::BOX;
+      _result.halfSize = box.Size() * 0.5;
+      _result.pose = _pose * math::Pose3d(box.Center(), math::Quaterniond());
+      break;
+    default:
+      return false;
+  }
+
+  _result.box = transformAxisAlignedBox(box, _pose);
+  return true;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d tpelib::supportPoint(const ConvexShape &_shape,
+    const math::Vector3d &_dir)
+{
+  const math::Vector3d d = _shape.pose.Rot().RotateVectorReverse(_dir);
+  const double length = d.Length();
+  math::Vector3d s;
+  switch (_shape.type)
+  {
+    case ShapeType::BOX:
+      s.Set(d.X() < 0.0 ? -_shape.halfSize.X() : _shape.halfSize.X(),
+            d.Y() < 0.0 ? -_shape.halfSize.Y() : _shape.halfSize.Y(),
+            d.Z() < 0.0 ? -_shape.halfSize.Z() : _shape.halfSize.Z());
+      break;
+    case ShapeType::SPHERE:
+    case ShapeType::CAPSULE:
+      if (length > kEpsilon)
+        s = d * (_shape.radius / length);
+      s.Z() += d.Z() < 0.0 ? -_shape.halfLength : _shape.halfLength;
+      break;
+    case ShapeType::CYLINDER:
+    {
+      const double radial = std::sqrt(d.X() * d.X() + d.Y() * d.Y());
+      if (radial > kEpsilon)
+      {
+        s.X() = d.X() * _shape.radius / radial;
+        s.Y() = d.Y() * _shape.radius / radial;
+      }
+      s.Z() = d.Z() < 0.0 ? -_shape.halfLength : _shape.halfLength;
+      break;
+    }
+    case ShapeType::ELLIPSOID:
+    {
+      const math::Vector3d &r = _shape.halfSize;
+      const math::Vector3d scaled(r.X() * d.X(), r.Y() * d.Y(), r.Z() * d.Z());
+      const double scaledLength = scaled.Length();
+      if (scaledLength > kEpsilon)
+      {
+        s.Set(r.X() * scaled.X() / scaledLength,
+              r.Y() * scaled.Y() / scaledLength,
+              r.Z() * scaled.Z() / scaledLength);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return _shape.pose.CoordPositionAdd(s);
+}
+
+//////////////////////////////////////////////////
+bool tpelib::collideShapes(const ConvexShape &_shape1,
+    const ConvexShape &_shape2, ShapeContact &_contact)
+{
+  if (isRound(_shape1) && isRound(_shape2))
+  {
+    math::Vector3d p1, q1, p2, q2, c1, c2;
+    segment(_shape1, p1, q1);
+    segment(_shape2, p2, q2);
+    closestPoints(p1, q1, p2, q2, c1, c2);
+    return collideSpheres(c1, _shape1.radius, c2, _shape2.radius, _contact);
+  }
+
+  if (_shape1.type == ShapeType::SPHERE && _shape2.type == ShapeType::BOX)
+  {
+    return collideSphereBox(
+        _shape1.pose.Pos(), _shape1.radius, _shape2, _contact);
+  }
+
+  if (_shape1.type == ShapeType::BOX && _shape2.type == ShapeType::SPHERE)
+  {
+    if (!collideSphereBox(
+        _shape2.pose.Pos(), _shape2.radius, _shape1, _contact))
+    {
+      return false;
+    }
+    _contact.normal = -_contact.normal;
+    return true;
+  }
+
+  std::array<SupportVertex, 4> simplex;
+  std::size_t n = 0u;
+  if (!gjk(_shape1, _shape2, simplex, n))
+    return false;
+
+  if ((n < 4u && !expandSimplex(_shape1, _shape2, simplex, n)) ||
+      !epa(_shape1, _shape2, simplex, _contact))
+  {
+    // the shapes touch but the Minkowski difference is flat
+    math::Vector3d normal = _shape2.pose.Pos() - _shape1.pose.Pos();
+    const double length = normal.Length();
+    _contact.normal = length > kEpsilon ? normal / length :
+        math::Vector3d(0, 0, 1);
+    _contact.depth = 0.0;
+    _contact.point = (simplex[0].a + simplex[0].b) * 0.5;
+    return true;
+  }
+  return true;
+}
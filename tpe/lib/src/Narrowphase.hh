@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_TPE_LIB_SRC_NARROWPHASE_HH_
+#define IGNITION_PHYSICS_TPE_LIB_SRC_NARROWPHASE_HH_
+
+#include <cstddef>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/utils/SuppressWarning.hh>
+
+#include "ignition/physics/tpelib/Export.hh"
+
+#include "Entity.hh"
+#include "Shape.hh"
+
+namespace ignition {
+namespace physics {
+namespace tpelib {
+
+/// \brief A convex shape placed in the world, used by the exact
+/// narrowphase. Mesh shapes are approximated by their bounding box.
+class IGNITION_PHYSICS_TPELIB_VISIBLE ConvexShape
+{
+  /// \brief Id of the collision entity that the shape belongs to
+  public: std::size_t id = kNullEntityId;
+
+  /// \brief Handle of the collision entity that the shape belongs to
+  public: EntityHandle handle = kNullEntityHandle;
+
+  /// \brief Type of shape. Box is also used for meshes.
+  public: ShapeType type = ShapeType::EMPTY;
+
+  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Half extents of a box or radii of an ellipsoid
+  public: math::Vector3d halfSize;
+
+  /// \brief World pose of the center of the shape
+  public: math::Pose3d pose;
+
+  /// \brief World axis aligned bounding box of the shape
+  public: math::AxisAlignedBox box;
+  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief Radius of a sphere, capsule or cylinder
+  public: double radius = 0.0;
+
+  /// \brief Half length of the axis of a capsule or cylinder. The axis is
+  /// the z axis of the shape.
+  public: double halfLength = 0.0;
+};
+
+/// \brief Contact between two convex shapes
+class IGNITION_PHYSICS_TPELIB_VISIBLE ShapeContact
+{
+  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Point of contact in world frame, halfway between the deepest
+  /// points of the two shapes
+  public: math::Vector3d point;
+
+  /// \brief Contact normal in world frame, pointing from the first shape
+  /// to the second shape
+  public: math::Vector3d normal;
+  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief Penetration depth along the normal
+  public: double depth = 0.0;
+};
+
+  /// \brief Create a convex shape from a tpelib shape
+  /// \param[in] _shape Shape geometry
+  /// \param[in] _pose World pose of the shape
+  /// \param[out] _result Convex shape with its world bounding box
+  /// \return False if the shape type is not supported
+  IGNITION_PHYSICS_TPELIB_VISIBLE
+  bool makeConvexShape(Shape &_shape, const math::Pose3d &_pose,
+      ConvexShape &_result);
+
+  /// \brief Get the point of a convex shape that is furthest along a
+  /// direction
+  /// \param[in] _shape Convex shape
+  /// \param[in] _dir Direction in world frame, does not need to be
+  /// normalized
+  /// \return Support point in world frame
+  IGNITION_PHYSICS_TPELIB_VISIBLE
+  math::Vector3d supportPoint(const ConvexShape &_shape,
+      const math::Vector3d &_dir);
+
+  /// \brief Check whether two convex shapes intersect and compute the
+  /// contact point, normal and penetration depth. Pairs of spheres and
+  /// capsules, and spheres against boxes, are handled analytically. All
+  /// other pairs use GJK and EPA. Touching shapes are in contact with zero
+  /// depth.
+  /// \param[in] _shape1 First shape
+  /// \param[in] _shape2 Second shape
+  /// \param[out] _contact Contact between the shapes
+  /// \return True if the shapes intersect
+  IGNITION_PHYSICS_TPELIB_VISIBLE
+  bool collideShapes(const ConvexShape &_shape1, const ConvexShape &_shape2,
+      ShapeContact &_contact);
+}
+}
+}
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <ignition/math/Helpers.hh>
+
+#include "Narrowphase.hh"
+#include "Shape.hh"
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+/////////////////////////////////////////////////
+ConvexShape makeBox(const math::Vector3d &_size, const math::Pose3d &_pose)
+{
+  BoxShape box;
+  box.SetSize(_size);
+  ConvexShape shape;
+  EXPECT_TRUE(makeConvexShape(box, _pose, shape));
+  return shape;
+}
+
+/////////////////////////////////////////////////
+ConvexShape makeSphere(double _radius, const math::Pose3d &_pose)
+{
+  SphereShape sphere;
+  sphere.SetRadius(_radius);
+  ConvexShape shape;
+  EXPECT_TRUE(makeConvexShape(sphere, _pose, shape));
+  return shape;
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, MakeConvexShape)
+{
+  ConvexShape box = makeBox(math::Vector3d(2, 4, 6),
+      math::Pose3d(1, 0, 0, 0, 0, 0));
+  EXPECT_EQ(ShapeType::BOX, box.type);
+  EXPECT_EQ(math::Vector3d(1, 2, 3), box.halfSize);
+  EXPECT_EQ(math::Vector3d(0, -2, -3), box.box.Min());
+  EXPECT_EQ(math::Vector3d(2, 2, 3), box.box.Max());
+
+  CylinderShape cylinder;
+  cylinder.SetRadius(0.5);
+  cylinder.SetLength(3.0);
+  ConvexShape shape;
+  EXPECT_TRUE(makeConvexShape(cylinder, math::Pose3d::Zero, shape));
+  EXPECT_EQ(ShapeType::CYLINDER, shape.type);
+  EXPECT_DOUBLE_EQ(0.5, shape.radius);
+  EXPECT_DOUBLE_EQ(1.5, shape.halfLength);
+
+  Shape empty;
+  EXPECT_FALSE(makeConvexShape(empty, math::Pose3d::Zero, shape));
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, SupportPoint)
+{
+  ConvexShape box = makeBox(math::Vector3d(2, 2, 2),
+      math::Pose3d(1, 0, 0, 0, 0, IGN_PI * 0.25));
+  math::Vector3d p = supportPoint(box, math::Vector3d(1, 0, 0));
+  EXPECT_NEAR(1.0 + std::sqrt(2.0), p.X(), 1e-9);
+
+  ConvexShape sphere = makeSphere(2.0, math::Pose3d(0, 0, 1, 0, 0, 0));
+  p = supportPoint(sphere, math::Vector3d(0, 0, -5));
+  EXPECT_EQ(math::Vector3d(0, 0, -1), p);
+
+  CapsuleShape capsule;
+  capsule.SetRadius(0.5);
+  capsule.SetLength(2.0);
+  ConvexShape shape;
+  ASSERT_TRUE(makeConvexShape(capsule, math::Pose3d::Zero, shape));
+  p = supportPoint(shape, math::Vector3d(0, 0, 1));
+  EXPECT_EQ(math::Vector3d(0, 0, 1.5), p);
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, Spheres)
+{
+  ConvexShape s1 = makeSphere(1.0, math::Pose3d::Zero);
+  ConvexShape s2 = makeSphere(0.5, math::Pose3d(1.4, 0, 0, 0, 0, 0));
+  ShapeContact contact;
+  ASSERT_TRUE(collideShapes(s1, s2, contact));
+  EXPECT_EQ(math::Vector3d(1, 0, 0), contact.normal);
+  EXPECT_NEAR(0.1, contact.depth, 1e-9);
+  EXPECT_NEAR(0.95, contact.point.X(), 1e-9);
+
+  s2.pose.Pos().X() = 1.6;
+  EXPECT_FALSE(collideShapes(s1, s2, contact));
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, SphereBox)
+{
+  ConvexShape box = makeBox(math::Vector3d(2, 2, 2), math::Pose3d::Zero);
+  ConvexShape sphere = makeSphere(0.5, math::Pose3d(0, 0, 1.3, 0, 0, 0));
+  ShapeContact contact;
+  ASSERT_TRUE(collideShapes(sphere, box, contact));
+  EXPECT_EQ(math::Vector3d(0, 0, -1), contact.normal);
+  EXPECT_NEAR(0.2, contact.depth, 1e-9);
+  EXPECT_NEAR(0.9, contact.point.Z(), 1e-9);
+
+  // same contact with the shapes swapped, but the normal is flipped
+  ASSERT_TRUE(collideShapes(box, sphere, contact));
+  EXPECT_EQ(math::Vector3d(0, 0, 1), contact.normal);
+  EXPECT_NEAR(0.2, contact.depth, 1e-9);
+
+  // sphere near a corner of the box, the bounding boxes overlap but the
+  // shapes don't
+  sphere.pose.Pos().Set(1.3, 1.3, 1.3);
+  EXPECT_FALSE(collideShapes(sphere, box, contact));
+
+  // sphere center inside the box
+  sphere.pose.Pos().Set(0.8, 0, 0);
+  ASSERT_TRUE(collideShapes(sphere, box, contact));
+  EXPECT_EQ(math::Vector3d(-1, 0, 0), contact.normal);
+  EXPECT_NEAR(0.7, contact.depth, 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, Capsules)
+{
+  CapsuleShape capsule;
+  capsule.SetRadius(0.25);
+  capsule.SetLength(2.0);
+  ConvexShape c1;
+  ConvexShape c2;
+  ASSERT_TRUE(makeConvexShape(capsule, math::Pose3d::Zero, c1));
+
+  // crossing capsule, rotated to lie along the y axis
+  ASSERT_TRUE(makeConvexShape(capsule,
+      math::Pose3d(0.4, 0, 0, IGN_PI * 0.5, 0, 0), c2));
+  ShapeContact contact;
+  ASSERT_TRUE(collideShapes(c1, c2, contact));
+  EXPECT_EQ(math::Vector3d(1, 0, 0), contact.normal);
+  EXPECT_NEAR(0.1, contact.depth, 1e-9);
+
+  // parallel capsules that are apart
+  ASSERT_TRUE(makeConvexShape(capsule, math::Pose3d(0.6, 0, 0, 0, 0, 0), c2));
+  EXPECT_FALSE(collideShapes(c1, c2, contact));
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, Boxes)
+{
+  // overlapping boxes
+  ConvexShape b1 = makeBox(math::Vector3d(1, 1, 1), math::Pose3d::Zero);
+  ConvexShape b2 = makeBox(math::Vector3d(1, 1, 1),
+      math::Pose3d(0.8, 0.1, 0, 0, 0, 0));
+  ShapeContact contact;
+  ASSERT_TRUE(collideShapes(b1, b2, contact));
+  EXPECT_EQ(math::Vector3d(1, 0, 0), contact.normal);
+  EXPECT_NEAR(0.2, contact.depth, 1e-6);
+  EXPECT_NEAR(0.4, contact.point.X(), 1e-6);
+
+  // a box rotated by 45 degrees next to another box. The bounding boxes
+  // overlap but the boxes don't.
+  b2 = makeBox(math::Vector3d(1, 1, 1),
+      math::Pose3d(1.1, 0.9, 0, 0, 0, IGN_PI * 0.25));
+  EXPECT_TRUE(b1.box.Intersects(b2.box));
+  EXPECT_FALSE(collideShapes(b1, b2, contact));
+
+  // move the rotated box closer so that its corner penetrates the first box
+  b2.pose.Pos().Set(0, 0, 0);
+  b2.pose.Pos().X() = 0.5 + std::sqrt(0.5) - 0.05;
+  ASSERT_TRUE(collideShapes(b1, b2, contact));
+  EXPECT_EQ(math::Vector3d(1, 0, 0), contact.normal);
+  EXPECT_NEAR(0.05, contact.depth, 1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST(Narrowphase, CurvedShapes)
+{
+  // cylinder against a box, along the radius of the cylinder
+  CylinderShape cylinder;
+  cylinder.SetRadius(0.5);
+  cylinder.SetLength(1.0);
+  ConvexShape c;
+  ASSERT_TRUE(makeConvexShape(cylinder, math::Pose3d::Zero, c));
+  ConvexShape box = makeBox(math::Vector3d(1, 1, 1),
+      math::Pose3d(0.9, 0, 0, 0, 0, 0));
+  ShapeContact contact;
+  ASSERT_TRUE(collideShapes(c, box, contact));
+  EXPECT_EQ(math::Vector3d(1, 0, 0), contact.normal);
+  EXPECT_NEAR(0.1, contact.depth, 1e-3);
+
+  // cylinder lying on its side on top of a box
+  ASSERT_TRUE(makeConvexShape(cylinder,
+      math::Pose3d(0, 0, 0.95, IGN_PI * 0.5, 0, 0), c));
+  box = makeBox(math::Vector3d(4, 4, 1), math::Pose3d(0, 0, 0, 0, 0, 0));
+  ASSERT_TRUE(collideShapes(c, box, contact));
+  EXPECT_EQ(math::Vector3d(0, 0, -1), contact.normal);
+  EXPECT_NEAR(0.05, contact.depth, 1e-3);
+
+  // the corner of a box next to a cylinder, inside the bounding box of the
+  // cylinder but outside the cylinder
+  box = makeBox(math::Vector3d(1, 1, 1), math::Pose3d(0.9, 0.9, 0, 0, 0, 0));
+  ASSERT_TRUE(makeConvexShape(cylinder, math::Pose3d::Zero, c));
+  EXPECT_TRUE(c.box.Intersects(box.box));
+  EXPECT_FALSE(collideShapes(c, box, contact));
+
+  // ellipsoid against a sphere along its longest axis
+  EllipsoidShape ellipsoid;
+  ellipsoid.SetRadii(math::Vector3d(2, 1, 1));
+  ConvexShape e;
+  ASSERT_TRUE(makeConvexShape(ellipsoid, math::Pose3d::Zero, e));
+  ConvexShape sphere = makeSphere(0.5, math::Pose3d(2.4, 0, 0, 0, 0, 0));
+  ASSERT_TRUE(collideShapes(e, sphere, contact));
+  // EPA approximates curved surfaces with a polytope
+  EXPECT_NEAR(1.0, contact.normal.X(), 1e-3);
+  EXPECT_NEAR(0.0, contact.normal.Y(), 1e-2);
+  EXPECT_NEAR(0.1, contact.depth, 1e-3);
+
+  sphere.pose.Pos().Set(1.6, 1.3, 0);
+  EXPECT_FALSE(collideShapes(e, sphere, contact));
+}
@@ -15,86 +15,174 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+
 #include "Utils.hh"
 
 namespace ignition {
 namespace physics {
 namespace tpelib {
 
+namespace
+{
+//////////////////////////////////////////////////
+/// \brief Get whether a box is empty, i.e. its min is greater than its max
+/// \param[in] _box Axis aligned box
+/// \return True if the box is empty
+bool isEmpty(const math::AxisAlignedBox &_box)
+{
+  return _box.Min().X() > _box.Max().X() || _box.Min().Y() > _box.Max().Y() ||
+      _box.Min().Z() > _box.Max().Z();
+}
+
+//////////////////////////////////////////////////
+/// \brief Transform the center and half size of a box by a pose, in place.
+/// The rotated box is enclosed by a box with the same center, transformed
+/// by the pose, and with half size |R| * h, which is the extent of the
+/// rotated box along each world axis. This avoids transforming all 8
+/// corners of the box.
+/// \param[in] _qw, _qx, _qy, _qz Unit quaternion of the pose
+/// \param[in] _px, _py, _pz Position of the pose
+/// \param[in,out] _cx, _cy, _cz Center of the box
+/// \param[in,out] _hx, _hy, _hz Half size of the box
+inline void transformCenterHalfSize(
+    const double _qw, const double _qx, const double _qy, const double _qz,
+    const double _px, const double _py, const double _pz,
+    double &_cx, double &_cy, double &_cz,
+    double &_hx, double &_hy, double &_hz)
+{
+  // rotation matrix of the unit quaternion
+  const double xx = _qx * _qx;
+  const double yy = _qy * _qy;
+  const double zz = _qz * _qz;
+  const double xy = _qx * _qy;
+  const double xz = _qx * _qz;
+  const double yz = _qy * _qz;
+  const double wx = _qw * _qx;
+  const double wy = _qw * _qy;
+  const double wz = _qw * _qz;
+
+  const double r00 = 1.0 - 2.0 * (yy + zz);
+  const double r01 = 2.0 * (xy - wz);
+  const double r02 = 2.0 * (xz + wy);
+  const double r10 = 2.0 * (xy + wz);
+  const double r11 = 1.0 - 2.0 * (xx + zz);
+  const double r12 = 2.0 * (yz - wx);
+  const double r20 = 2.0 * (xz - wy);
+  const double r21 = 2.0 * (yz + wx);
+  const double r22 = 1.0 - 2.0 * (xx + yy);
+
+  const double cx = r00 * _cx + r01 * _cy + r02 * _cz + _px;
+  const double cy = r10 * _cx + r11 * _cy + r12 * _cz + _py;
+  const double cz = r20 * _cx + r21 * _cy + r22 * _cz + _pz;
+
+  const double hx = std::abs(r00) * _hx + std::abs(r01) * _hy +
+      std::abs(r02) * _hz;
+  const double hy = std::abs(r10) * _hx + std::abs(r11) * _hy +
+      std::abs(r12) * _hz;
+  const double hz = std::abs(r20) * _hx + std::abs(r21) * _hy +
+      std::abs(r22) * _hz;
+
+  _cx = cx;
+  _cy = cy;
+  _cz = cz;
+  _hx = hx;
+  _hy = hy;
+  _hz = hz;
+}
+}
+
 //////////////////////////////////////////////////
 math::AxisAlignedBox transformAxisAlignedBox(
     const math::AxisAlignedBox &_box, const math::Pose3d &_pose)
 {
-  if (_box == math::AxisAlignedBox())
+  if (isEmpty(_box))
     return _box;
 
-  // Transform the original axis aligned box by applying the pose
-  // transformation to all 8 corners. This results in a rotated box, which
-  // we need to fit a new axis aligned box to. We can achieve this by creating
-  // an empty axis aligned box and merging it with each corner of the rotated
-  // box. The result is a larger axis aligned box that surrounds the rotated box
-
-  // old min and max of original axis aligned box
-  math::Vector3d oldMin = _box.Min();
-  math::Vector3d oldMax = _box.Max();
-
-  // empty min max of new axis aligned box
-  // we will merge the empty min and max values with each of the
-  //  transformed corners
-  math::Vector3d newMin(math::MAX_D, math::MAX_D, math::MAX_D);
-  math::Vector3d newMax(math::LOW_D, math::LOW_D, math::LOW_D);
-
-  // min min min
-  // transform corner
-  math::Vector3d corner = oldMin;
-  auto v = _pose.Rot() * corner + _pose.Pos();
-  // merge min/max with transformed corner
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // min min max
-  corner.Z() = oldMax.Z();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // min max max
-  corner.Y() = oldMax.Y();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // min max min
-  corner.Z() = oldMin.Z();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // max max min
-  corner.X() = oldMax.X();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // max max max
-  corner.Z() = oldMax.Z();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // max min max
-  corner.Y() = oldMin.Y();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  // max min min
-  corner.Z() = oldMin.Z();
-  v = _pose.Rot() * corner + _pose.Pos();
-  newMin.Min(v);
-  newMax.Max(v);
-
-  return math::AxisAlignedBox(newMin, newMax);
+  double cx = 0.5 * (_box.Min().X() + _box.Max().X());
+  double cy = 0.5 * (_box.Min().Y() + _box.Max().Y());
+  double cz = 0.5 * (_box.Min().Z() + _box.Max().Z());
+  double hx = 0.5 * (_box.Max().X() - _box.Min().X());
+  double hy = 0.5 * (_box.Max().Y() - _box.Min().Y());
+  double hz = 0.5 * (_box.Max().Z() - _box.Min().Z());
+  transformCenterHalfSize(_pose.Rot().W(), _pose.Rot().X(), _pose.Rot().Y(),
+      _pose.Rot().Z(), _pose.Pos().X(), _pose.Pos().Y(), _pose.Pos().Z(),
+      cx, cy, cz, hx, hy, hz);
+
+  return math::AxisAlignedBox(math::Vector3d(cx - hx, cy - hy, cz - hz),
+      math::Vector3d(cx + hx, cy + hy, cz + hz));
+}
+
+//////////////////////////////////////////////////
+void transformAxisAlignedBoxes(const math::AxisAlignedBox *_boxes,
+    const math::Pose3d *_poses, math::AxisAlignedBox *_result,
+    std::size_t _count)
+{
+  // Boxes are processed in fixed size blocks. Each block is gathered into a
+  // structure of arrays so that the arithmetic loop below has no branches or
+  // strided accesses, which lets the compiler vectorize it across boxes.
+  constexpr std::size_t kBlockSize = 64u;
+  alignas(64) double cx[kBlockSize] = {}, cy[kBlockSize] = {},
+      cz[kBlockSize] = {};
+  alignas(64) double hx[kBlockSize] = {}, hy[kBlockSize] = {},
+      hz[kBlockSize] = {};
+  alignas(64) double qw[kBlockSize] = {}, qx[kBlockSize] = {},
+      qy[kBlockSize] = {}, qz[kBlockSize] = {};
+  alignas(64) double px[kBlockSize] = {}, py[kBlockSize] = {},
+      pz[kBlockSize] = {};
+
+  for (std::size_t start = 0u; start < _count; start += kBlockSize)
+  {
+    const std::size_t n = std::min(kBlockSize, _count - start);
+
+    // gather
+    for (std::size_t k = 0u; k < n; ++k)
+    {
+      const math::AxisAlignedBox &box = _boxes[start + k];
+      const math::Pose3d &pose = _poses[start + k];
+      cx[k] = 0.5 * (box.Min().X() + box.Max().X());
+      cy[k] = 0.5 * (box.Min().Y() + box.Max().Y());
+      cz[k] = 0.5 * (box.Min().Z() + box.Max().Z());
+      hx[k] = 0.5 * (box.Max().X() - box.Min().X());
+      hy[k] = 0.5 * (box.Max().Y() - box.Min().Y());
+      hz[k] = 0.5 * (box.Max().Z() - box.Min().Z());
+      qw[k] = pose.Rot().W();
+      qx[k] = pose.Rot().X();
+      qy[k] = pose.Rot().Y();
+      qz[k] = pose.Rot().Z();
+      px[k] = pose.Pos().X();
+      py[k] = pose.Pos().Y();
+      pz[k] = pose.Pos().Z();
+    }
+
+    // transform. The results are written back over the centers and half
+    // sizes. The loop always runs over the full block, which has a constant
+    // trip count, so that it is vectorized even at -O2. Lanes past n hold
+    // values from a previous block, or zeros, and are ignored.
+    for (std::size_t k = 0u; k < kBlockSize; ++k)
+    {
+      transformCenterHalfSize(qw[k], qx[k], qy[k], qz[k], px[k], py[k], pz[k],
+          cx[k], cy[k], cz[k], hx[k], hy[k], hz[k]);
+    }
+
+    // scatter
+    for (std::size_t k = 0u; k < n; ++k)
+    {
+      const math::AxisAlignedBox &box = _boxes[start + k];
+      math::AxisAlignedBox &result = _result[start + k];
+
+      // an empty box has min > max and is copied unchanged
+      if (isEmpty(box))
+      {
+        result = box;
+        continue;
+      }
+
+      result.Min().Set(cx[k] - hx[k], cy[k] - hy[k], cz[k] - hz[k]);
+      result.Max().Set(cx[k] + hx[k], cy[k] + hy[k], cz[k] + hz[k]);
+    }
+  }
 }
 
 }
@@ -15,6 +15,8 @@
  *
 */
 
+#include <cstddef>
+
 #include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Pose3.hh>
 
@@ -32,6 +34,22 @@ namespace tpelib {
   IGNITION_PHYSICS_TPELIB_VISIBLE
   math::AxisAlignedBox transformAxisAlignedBox(
       const math::AxisAlignedBox &_box, const math::Pose3d &_pose);
+
+  /// \brief Transform a batch of axis aligned boxes by their poses. This
+  /// gives the same result as calling transformAxisAlignedBox on each box,
+  /// but the boxes are processed in blocks in a structure of arrays layout
+  /// so that the compiler can vectorize the transform across boxes. Each box
+  /// is transformed as center' = R * center + p and
+  /// half_size' = |R| * half_size, where |R| is the element-wise absolute
+  /// value of the rotation matrix. Empty boxes are copied unchanged.
+  /// \param[in] _boxes Axis aligned boxes to be transformed
+  /// \param[in] _poses Transform to be applied to each box
+  /// \param[out] _result Transformed boxes. May alias _boxes.
+  /// \param[in] _count Number of boxes
+  IGNITION_PHYSICS_TPELIB_VISIBLE
+  void transformAxisAlignedBoxes(const math::AxisAlignedBox *_boxes,
+      const math::Pose3d *_poses, math::AxisAlignedBox *_result,
+      std::size_t _count);
 }
 }
 }
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "Utils.hh"
 
 using namespace ignition;
@@ -53,3 +55,53 @@ TEST(Utils, TransformAxisAlignedBox)
   EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(-1, 0, 1),
       math::Vector3d(5, 4, 3)), box2TransformedRot);
 }
+
+/////////////////////////////////////////////////
+TEST(Utils, TransformAxisAlignedBoxes)
+{
+  // compare against transforming all 8 corners of each box. Use more boxes
+  // than fit in one block of the batched transform.
+  std::vector<math::AxisAlignedBox> boxes;
+  std::vector<math::Pose3d> poses;
+  for (int i = 0; i < 150; ++i)
+  {
+    const double d = 0.1 * i;
+    boxes.push_back(math::AxisAlignedBox(
+        math::Vector3d(-1 + d, -2, -3 - d), math::Vector3d(1 + 2 * d, 2, 3)));
+    poses.push_back(math::Pose3d(d, -d, 2 * d, 0.3 * d, -0.2 * d, 0.7 * d));
+  }
+  // empty boxes are copied unchanged
+  boxes[10] = math::AxisAlignedBox();
+
+  std::vector<math::AxisAlignedBox> result(boxes.size());
+  transformAxisAlignedBoxes(boxes.data(), poses.data(), result.data(),
+      boxes.size());
+
+  for (std::size_t i = 0; i < boxes.size(); ++i)
+  {
+    if (i == 10u)
+    {
+      EXPECT_EQ(math::AxisAlignedBox(), result[i]);
+      continue;
+    }
+
+    math::AxisAlignedBox expected;
+    for (int c = 0; c < 8; ++c)
+    {
+      math::Vector3d corner(
+          (c & 1) ? boxes[i].Max().X() : boxes[i].Min().X(),
+          (c & 2) ? boxes[i].Max().Y() : boxes[i].Min().Y(),
+          (c & 4) ? boxes[i].Max().Z() : boxes[i].Min().Z());
+      math::Vector3d v = poses[i].Rot() * corner + poses[i].Pos();
+      expected.Merge(math::AxisAlignedBox(v, v));
+    }
+    EXPECT_TRUE(expected.Min().Equal(result[i].Min(), 1e-9)) << i;
+    EXPECT_TRUE(expected.Max().Equal(result[i].Max(), 1e-9)) << i;
+  }
+
+  // transform in place
+  transformAxisAlignedBoxes(boxes.data(), poses.data(), boxes.data(),
+      boxes.size());
+  for (std::size_t i = 0; i < boxes.size(); ++i)
+    EXPECT_EQ(result[i], boxes[i]);
+}
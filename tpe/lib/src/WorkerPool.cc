@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "WorkerPool.hh"
+
+/// \brief Private data class for WorkerPool
+class ignition::physics::tpelib::WorkerPoolPrivate
+{
+  /// \brief Main loop of worker threads
+  /// \param[in] _index Index of the worker. The calling thread is index 0.
+  public: void Work(std::size_t _index);
+
+  /// \brief Worker threads
+  public: std::vector<std::thread> threads;
+
+  /// \brief Protects the job state below
+  public: std::mutex mutex;
+
+  /// \brief Signaled when a new job is available or the pool is stopping
+  public: std::condition_variable startCv;
+
+  /// \brief Signaled when a worker finishes its chunk
+  public: std::condition_variable doneCv;
+
+  /// \brief Incremented for each job so workers can tell jobs apart
+  public: std::size_t generation = 0u;
+
+  /// \brief Number of chunks of the current job still being processed by
+  /// worker threads
+  public: std::size_t pending = 0u;
+
+  /// \brief Function of the current job
+  public: const WorkerPool::ChunkFunction *func = nullptr;
+
+  /// \brief Number of indices in the current job
+  public: std::size_t count = 0u;
+
+  /// \brief Number of chunks in the current job
+  public: std::size_t chunkCount = 0u;
+
+  /// \brief True when the pool is being destroyed
+  public: bool stop = false;
+};
+
+using namespace ignition;
+using namespace physics;
+using namespace tpelib;
+
+//////////////////////////////////////////////////
+void WorkerPoolPrivate::Work(std::size_t _index)
+{
+  std::size_t seenGeneration = 0u;
+  while (true)
+  {
+    const WorkerPool::ChunkFunction *jobFunc = nullptr;
+    std::size_t jobCount = 0u;
+    std::size_t jobChunks = 0u;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->startCv.wait(lock, [&]
+      {
+        return this->stop || this->generation != seenGeneration;
+      });
+      if (this->stop)
+        return;
+      seenGeneration = this->generation;
+      jobFunc = this->func;
+      jobCount = this->count;
+      jobChunks = this->chunkCount;
+    }
+
+    // not every worker gets a chunk when the range is small
+    if (_index >= jobChunks)
+      continue;
+
+    (*jobFunc)(_index, jobCount * _index / jobChunks,
+        jobCount * (_index + 1) / jobChunks);
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      --this->pending;
+    }
+    this->doneCv.notify_one();
+  }
+}
+
+//////////////////////////////////////////////////
+WorkerPool::WorkerPool(std::size_t _threadCount)
+  : dataPtr(new WorkerPoolPrivate)
+{
+  if (_threadCount == 0u)
+    _threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  for (std::size_t i = 1u; i < _threadCount; ++i)
+  {
+    this->dataPtr->threads.emplace_back(
+        &WorkerPoolPrivate::Work, this->dataPtr.get(), i);
+  }
+}
+
+//////////////////////////////////////////////////
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->startCv.notify_all();
+  for (auto &thread : this->dataPtr->threads)
+    thread.join();
+}
+
+//////////////////////////////////////////////////
+std::size_t WorkerPool::ThreadCount() const
+{
+  return this->dataPtr->threads.size() + 1u;
+}
+
+//////////////////////////////////////////////////
+std::size_t WorkerPool::ChunkCount(std::size_t _count,
+    std::size_t _grainSize) const
+{
+  if (_count == 0u)
+    return 0u;
+
+  _grainSize = std::max<std::size_t>(1u, _grainSize);
+  const std::size_t maxChunks = (_count + _grainSize - 1u) / _grainSize;
+  return std::min(this->ThreadCount(), maxChunks);
+}
+
+//////////////////////////////////////////////////
+void WorkerPool::Run(std::size_t _count, std::size_t _grainSize,
+    const ChunkFunction &_func)
+{
+  const std::size_t chunks = this->ChunkCount(_count, _grainSize);
+  if (chunks == 0u)
+    return;
+
+  // run small jobs on the calling thread without waking up the workers
+  if (chunks == 1u)
+  {
+    _func(0u, 0u, _count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->func = &_func;
+    this->dataPtr->count = _count;
+    this->dataPtr->chunkCount = chunks;
+    this->dataPtr->pending = chunks - 1u;
+    ++this->dataPtr->generation;
+  }
+  this->dataPtr->startCv.notify_all();
+
+  // the calling thread processes the first chunk
+  _func(0u, 0u, _count / chunks);
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->doneCv.wait(lock, [&]
+  {
+    return this->dataPtr->pending == 0u;
+  });
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_TPE_LIB_SRC_WORKERPOOL_HH_
+#define IGNITION_PHYSICS_TPE_LIB_SRC_WORKERPOOL_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <ignition/utils/SuppressWarning.hh>
+
+#include "ignition/physics/tpelib/Export.hh"
+
+namespace ignition {
+namespace physics {
+namespace tpelib {
+
+// forward declaration
+class WorkerPoolPrivate;
+
+/// \brief A fixed set of worker threads that run a function over contiguous
+/// chunks of an index range. The calling thread processes the first chunk,
+/// so a pool with a thread count of N starts N - 1 threads.
+class IGNITION_PHYSICS_TPELIB_VISIBLE WorkerPool
+{
+  /// \brief Function called for each chunk
+  /// \param[in] _chunk Index of the chunk
+  /// \param[in] _begin First index of the chunk
+  /// \param[in] _end One past the last index of the chunk
+  public: using ChunkFunction =
+      std::function<void(std::size_t _chunk, std::size_t _begin,
+      std::size_t _end)>;
+
+  /// \brief Constructor
+  /// \param[in] _threadCount Number of threads, including the calling
+  /// thread. 0 uses the number of hardware threads.
+  public: explicit WorkerPool(std::size_t _threadCount);
+
+  /// \brief Destructor. Joins all worker threads.
+  public: ~WorkerPool();
+
+  /// \brief Get the number of threads, including the calling thread
+  /// \return Thread count
+  public: std::size_t ThreadCount() const;
+
+  /// \brief Get the number of chunks that Run splits a range into
+  /// \param[in] _count Number of indices in the range
+  /// \param[in] _grainSize Minimum number of indices per chunk
+  /// \return Number of chunks
+  public: std::size_t ChunkCount(std::size_t _count,
+      std::size_t _grainSize) const;
+
+  /// \brief Split [0, _count) into ChunkCount() contiguous chunks, in
+  /// increasing order, and run _func on each of them in parallel. Blocks
+  /// until all chunks are done. Run must not be called concurrently or from
+  /// inside _func.
+  /// \param[in] _count Number of indices in the range
+  /// \param[in] _grainSize Minimum number of indices per chunk
+  /// \param[in] _func Function to run on each chunk
+  public: void Run(std::size_t _count, std::size_t _grainSize,
+      const ChunkFunction &_func);
+
+  /// \brief Pointer to private data
+  IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  private: std::unique_ptr<WorkerPoolPrivate> dataPtr;
+  IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
+}
+}
+}
+
+#endif
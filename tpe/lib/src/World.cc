@@ -15,6 +15,7 @@
  *
 */
 
+#include <algorithm>
 #include <string>
 #include <memory>
 
@@ -30,8 +31,11 @@ using namespace physics;
 using namespace tpelib;
 
 /////////////////////////////////////////////////
-World::World() : Entity()
+World::World() : Entity(EntityType::WORLD)
 {
+  this->collisionDetector.SetMargin(0.05);
+  this->collisionDetector.SetPredictionTime(
+      this->predictionSteps * this->timeStep);
 }
 
 /////////////////////////////////////////////////
@@ -50,6 +54,8 @@ double World::GetTime() const
 void World::SetTimeStep(double _timeStep)
 {
   this->timeStep = _timeStep;
+  this->collisionDetector.SetPredictionTime(
+      this->predictionSteps * this->timeStep);
 }
 
 /////////////////////////////////////////////////
@@ -58,27 +64,106 @@ double World::GetTimeStep() const
   return this->timeStep;
 }
 
+/////////////////////////////////////////////////
+void World::SetCollisionMargin(double _margin)
+{
+  this->collisionDetector.SetMargin(_margin);
+}
+
+/////////////////////////////////////////////////
+double World::GetCollisionMargin() const
+{
+  return this->collisionDetector.Margin();
+}
+
+/////////////////////////////////////////////////
+void World::SetCollisionPredictionSteps(double _steps)
+{
+  this->predictionSteps = std::max(0.0, _steps);
+  this->collisionDetector.SetPredictionTime(
+      this->predictionSteps * this->timeStep);
+}
+
+/////////////////////////////////////////////////
+double World::GetCollisionPredictionSteps() const
+{
+  return this->predictionSteps;
+}
+
+/////////////////////////////////////////////////
+void World::SetExactNarrowphase(bool _exact)
+{
+  this->collisionDetector.SetExactNarrowphase(_exact);
+}
+
+/////////////////////////////////////////////////
+bool World::GetExactNarrowphase() const
+{
+  return this->collisionDetector.ExactNarrowphase();
+}
+
+/////////////////////////////////////////////////
+void World::SetThreadCount(std::size_t _count)
+{
+  if (_count == 1u)
+    this->workerPool.reset();
+  else
+    this->workerPool = std::make_shared<WorkerPool>(_count);
+
+  this->collisionDetector.SetWorkerPool(this->workerPool);
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetThreadCount() const
+{
+  return this->workerPool ? this->workerPool->ThreadCount() : 1u;
+}
+
+/////////////////////////////////////////////////
+void World::SetSleepSteps(std::size_t _steps)
+{
+  this->sleepSteps = _steps;
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetSleepSteps() const
+{
+  return this->sleepSteps;
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetSleepingModelCount() const
+{
+  const EntityStore &store = EntityStore::Instance();
+  std::size_t count = 0u;
+  for (const EntityHandle handle : this->GetChildMap().Handles())
+  {
+    if (store.Flag(handle, EntityStore::kSleeping))
+      ++count;
+  }
+  return count;
+}
+
 /////////////////////////////////////////////////
 void World::Step()
 {
   IGN_PROFILE("tpelib::World::Step");
-  // apply updates to each model
-  auto &children = this->GetChildren();
-  for (auto it = children.begin(); it != children.end(); ++it)
+  // apply updates to each model. Each model only updates itself and its own
+  // links, so models can be updated in parallel. The models are stepped in
+  // the entity store through their handles, without visiting the models.
+  auto &children = this->GetChildMap();
+  const std::vector<EntityHandle> &handles = children.Handles();
+  EntityStore &store = EntityStore::Instance();
+  auto updatePoses = [&](std::size_t, std::size_t _begin, std::size_t _end)
   {
-    auto model = std::dynamic_pointer_cast<Model>(it->second);
-    model->UpdatePose(this->timeStep);
-    auto &ents = model->GetChildren();
-    for (auto linkIt = ents.begin(); linkIt != ents.end(); ++linkIt)
-    {
-      // if child of model is link
-      auto link = std::dynamic_pointer_cast<Link>(linkIt->second);
-      if (link)
-      {
-        link->UpdatePose(this->timeStep);
-      }
-    }
-  }
+    // children of the world are only added by AddModel
+    for (std::size_t i = _begin; i < _end; ++i)
+      store.StepModel(handles[i], this->timeStep, this->sleepSteps);
+  };
+  if (this->workerPool)
+    this->workerPool->Run(children.size(), 256u, updatePoses);
+  else
+    updatePoses(0u, 0u, children.size());
 
   // check colliisions
   // the last bool arg tells the collision checker to return one single contact
@@ -86,8 +171,22 @@ void World::Step()
   this->contacts = std::move(
       this->collisionDetector.CheckCollisions(children, true));
 
-  for (auto it = children.begin(); it != children.end(); ++it)
-    it->second->ResetPoseDirty();
+  // wake up sleeping models that are touched by a moving model
+  if (this->sleepSteps > 0u)
+  {
+    for (const auto &contact : this->contacts)
+    {
+      auto model1 = static_cast<Model *>(children.at(contact.entity1).get());
+      auto model2 = static_cast<Model *>(children.at(contact.entity2).get());
+      if (model1->GetSleeping() && model2->PoseDirty())
+        model1->Wake();
+      else if (model2->GetSleeping() && model1->PoseDirty())
+        model2->Wake();
+    }
+  }
+
+  // only the models that moved need their pose dirty flag reset
+  children.ClearPoseDirty();
 
   // increment world time by step size
   this->time += this->timeStep;
@@ -97,13 +196,13 @@ void World::Step()
 Entity &World::AddModel()
 {
   std::size_t modelId = Entity::GetNextId();
-  const auto[it, success] = this->GetChildren().insert(
+  const auto[it, success] = this->GetChildMap().insert(
     {modelId, std::make_shared<Model>(modelId)});
   return *it->second.get();
 }
 
 /////////////////////////////////////////////////
-std::vector<Contact> World::GetContacts() const
+const std::vector<Contact> &World::GetContacts() const
 {
   return this->contacts;
 }
@@ -18,6 +18,7 @@
 #ifndef IGNITION_PHYSICS_TPE_LIB_SRC_WORLD_HH_
 #define IGNITION_PHYSICS_TPE_LIB_SRC_WORLD_HH_
 
+#include <memory>
 #include <vector>
 #include <ignition/utils/SuppressWarning.hh>
 
@@ -25,6 +26,7 @@
 
 #include "CollisionDetector.hh"
 #include "Entity.hh"
+#include "WorkerPool.hh"
 
 namespace ignition {
 namespace physics {
@@ -57,6 +59,71 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE World : public Entity
   /// \return double current timestep of the world
   public: double GetTimeStep() const;
 
+  /// \brief Set the margin that model bounding boxes are fattened by in the
+  /// broadphase AABB tree. Models that move less than the margin since their
+  /// last tree update do not restructure the tree. Moving models also have
+  /// their fattened box extended along their linear velocity. The margin does
+  /// not affect contacts.
+  /// \param[in] _margin Margin in meters. Default is 0.05.
+  public: void SetCollisionMargin(double _margin);
+
+  /// \brief Get the margin that model bounding boxes are fattened by
+  /// \return Margin in meters
+  public: double GetCollisionMargin() const;
+
+  /// \brief Set over how many steps of motion the fattened boxes of moving
+  /// models are extended along their linear velocity, so that models moving
+  /// at a constant velocity are not reinserted into the AABB tree every
+  /// step. The prediction time of the collision detector is set from this
+  /// and the time step whenever either of them changes.
+  /// \param[in] _steps Number of steps, 0 disables velocity prediction.
+  /// Default is 4.
+  public: void SetCollisionPredictionSteps(double _steps);
+
+  /// \brief Get over how many steps of motion fattened boxes are extended
+  /// \return Number of steps
+  public: double GetCollisionPredictionSteps() const;
+
+  /// \brief Set whether contacts are computed from the collision shapes
+  /// instead of the bounding boxes of the models. See
+  /// CollisionDetector::SetExactNarrowphase.
+  /// \param[in] _exact True to enable the exact narrowphase. Default is
+  /// false.
+  public: void SetExactNarrowphase(bool _exact);
+
+  /// \brief Get whether contacts are computed from the collision shapes
+  /// \return True if the exact narrowphase is enabled
+  public: bool GetExactNarrowphase() const;
+
+  /// \brief Set the number of threads used to step the world. Model poses
+  /// are integrated, and broadphase and contact generation are run, in
+  /// parallel chunks. Contacts are the same, and in the same order,
+  /// regardless of the number of threads.
+  /// \param[in] _count Number of threads, including the thread that calls
+  /// Step. 0 uses the number of hardware threads. Default is 1.
+  public: void SetThreadCount(std::size_t _count);
+
+  /// \brief Get the number of threads used to step the world
+  /// \return Number of threads, including the thread that calls Step
+  public: std::size_t GetThreadCount() const;
+
+  /// \brief Set the number of consecutive steps that a model has to be at
+  /// rest before it goes to sleep. A model is at rest when the model and
+  /// its links have zero velocity and their poses are not set. Sleeping
+  /// models are not integrated, and contacts between models that did not
+  /// move are reused instead of being recomputed. A model wakes up when its
+  /// pose or a non-zero velocity is set, or when a moving model touches it.
+  /// \param[in] _steps Number of steps. 0 disables sleeping. Default is 10.
+  public: void SetSleepSteps(std::size_t _steps);
+
+  /// \brief Get the number of steps at rest before a model goes to sleep
+  /// \return Number of steps, 0 if sleeping is disabled
+  public: std::size_t GetSleepSteps() const;
+
+  /// \brief Get the number of models in the world that are sleeping
+  /// \return Number of sleeping models
+  public: std::size_t GetSleepingModelCount() const;
+
   /// \brief Step forward at a constant timestep
   public: void Step();
 
@@ -65,8 +132,8 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE World : public Entity
   public: Entity &AddModel();
 
   /// \brief Get contacts from last step
-  /// \return Contacts from last step
-  public: std::vector<Contact> GetContacts() const;
+  /// \return Contacts from last step, valid until the next step
+  public: const std::vector<Contact> &GetContacts() const;
 
   /// \brief World time
   protected: double time{0.0};
@@ -74,12 +141,21 @@ class IGNITION_PHYSICS_TPELIB_VISIBLE World : public Entity
   /// \brief Time step size
   protected: double timeStep{0.1};
 
+  /// \brief Number of steps of motion that fattened boxes are extended by
+  protected: double predictionSteps{4.0};
+
+  /// \brief Number of steps at rest before a model goes to sleep
+  protected: std::size_t sleepSteps{10u};
+
   /// \brief Collision detector
   protected: CollisionDetector collisionDetector;
 
   IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
   /// \brief list of contacts
   protected: std::vector<Contact> contacts;
+
+  /// \brief Worker pool used when stepping with more than one thread
+  protected: std::shared_ptr<WorkerPool> workerPool;
   IGN_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
 };
 
@@ -17,8 +17,11 @@
 
 #include <gtest/gtest.h>
 
-#include "World.hh"
+#include "Collision.hh"
+#include "Link.hh"
 #include "Model.hh"
+#include "Shape.hh"
+#include "World.hh"
 
 using namespace ignition;
 using namespace physics;
@@ -43,6 +46,18 @@ TEST(World, BasicAPI)
   world.Step();
   EXPECT_NEAR(world.GetTime()-1.1, 0.0, 1e-6);
 
+  EXPECT_DOUBLE_EQ(0.05, world.GetCollisionMargin());
+  world.SetCollisionMargin(0.2);
+  EXPECT_DOUBLE_EQ(0.2, world.GetCollisionMargin());
+  world.SetCollisionMargin(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, world.GetCollisionMargin());
+
+  EXPECT_DOUBLE_EQ(4.0, world.GetCollisionPredictionSteps());
+  world.SetCollisionPredictionSteps(2.0);
+  EXPECT_DOUBLE_EQ(2.0, world.GetCollisionPredictionSteps());
+  world.SetCollisionPredictionSteps(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, world.GetCollisionPredictionSteps());
+
   World world2;
   EXPECT_NE(world.GetId(), world2.GetId());
 }
@@ -91,3 +106,147 @@ TEST(World, Model)
   Entity nullEnt = world.GetChildById(modelId);
   EXPECT_EQ(Entity::kNullEntity.GetId(), nullEnt.GetId());
 }
+
+/////////////////////////////////////////////////
+TEST(World, ThreadCount)
+{
+  // Create two worlds with the same models, step one of them on a single
+  // thread and the other one on multiple threads and compare the results.
+  World worlds[2];
+  EXPECT_EQ(1u, worlds[0].GetThreadCount());
+  worlds[1].SetThreadCount(4u);
+  EXPECT_EQ(4u, worlds[1].GetThreadCount());
+
+  // enough models to split the work into multiple chunks
+  const int count = 2000;
+  for (World &world : worlds)
+  {
+    world.SetTimeStep(0.01);
+    for (int i = 0; i < count; ++i)
+    {
+      Entity &modelEnt = world.AddModel();
+      Model *model = static_cast<Model *>(&modelEnt);
+      Entity &linkEnt = model->AddLink();
+      Link *link = static_cast<Link *>(&linkEnt);
+      Entity &collisionEnt = link->AddCollision();
+      Collision *collision = static_cast<Collision *>(&collisionEnt);
+      BoxShape boxShape;
+      boxShape.SetSize(math::Vector3d(1, 1, 1));
+      collision->SetShape(boxShape);
+
+      // models on a grid, moving towards their neighbors
+      model->SetPose(math::Pose3d(1.1 * (i % 50), 1.1 * (i / 50), 0, 0, 0, 0));
+      model->SetLinearVelocity(math::Vector3d((i % 2) ? 1.0 : -1.0, 0, 0));
+    }
+  }
+
+  for (int step = 0; step < 10; ++step)
+  {
+    worlds[0].Step();
+    worlds[1].Step();
+
+    std::vector<Contact> contacts = worlds[0].GetContacts();
+    std::vector<Contact> parallelContacts = worlds[1].GetContacts();
+    ASSERT_EQ(contacts.size(), parallelContacts.size());
+    for (std::size_t i = 0; i < contacts.size(); ++i)
+    {
+      // entity ids differ between the worlds by a constant offset
+      EXPECT_EQ(contacts[i].entity1 - contacts[0].entity1,
+          parallelContacts[i].entity1 - parallelContacts[0].entity1);
+      EXPECT_EQ(contacts[i].entity2 - contacts[0].entity1,
+          parallelContacts[i].entity2 - parallelContacts[0].entity1);
+      EXPECT_EQ(contacts[i].point, parallelContacts[i].point);
+    }
+  }
+  EXPECT_FALSE(worlds[0].GetContacts().empty());
+
+  worlds[1].SetThreadCount(1u);
+  EXPECT_EQ(1u, worlds[1].GetThreadCount());
+}
+
+/////////////////////////////////////////////////
+TEST(World, Sleep)
+{
+  World world;
+  world.SetTimeStep(0.1);
+  EXPECT_EQ(10u, world.GetSleepSteps());
+  world.SetSleepSteps(3u);
+  EXPECT_EQ(3u, world.GetSleepSteps());
+
+  auto addBox = [&world](const math::Pose3d &_pose) -> Model *
+  {
+    Entity &modelEnt = world.AddModel();
+    Model *model = static_cast<Model *>(&modelEnt);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    model->SetPose(_pose);
+    return model;
+  };
+
+  // model 1 moves towards model 2, model 3 is away from both
+  Model *model1 = addBox(math::Pose3d(0, 0, 0, 0, 0, 0));
+  Model *model2 = addBox(math::Pose3d(3, 0, 0, 0, 0, 0));
+  Model *model3 = addBox(math::Pose3d(0, 5, 0, 0, 0, 0));
+  model1->SetLinearVelocity(math::Vector3d(1, 0, 0));
+  EXPECT_EQ(0u, world.GetSleepingModelCount());
+
+  // models at rest go to sleep after 3 steps
+  world.Step();
+  world.Step();
+  EXPECT_EQ(0u, world.GetSleepingModelCount());
+  world.Step();
+  EXPECT_FALSE(model1->GetSleeping());
+  EXPECT_TRUE(model2->GetSleeping());
+  EXPECT_TRUE(model3->GetSleeping());
+  EXPECT_EQ(2u, world.GetSleepingModelCount());
+
+  // model 1 touches model 2 after moving 2m, which wakes up model 2
+  int steps = 3;
+  while (world.GetContacts().empty() && steps < 30)
+  {
+    EXPECT_TRUE(model2->GetSleeping());
+    world.Step();
+    ++steps;
+  }
+  EXPECT_EQ(20, steps);
+  EXPECT_FALSE(model2->GetSleeping());
+  EXPECT_TRUE(model3->GetSleeping());
+  EXPECT_EQ(math::Pose3d(3, 0, 0, 0, 0, 0), model2->GetPose());
+
+  // stop model 1, all models go to sleep and keep their contacts
+  model1->SetLinearVelocity(math::Vector3d::Zero);
+  for (int i = 0; i < 3; ++i)
+    world.Step();
+  EXPECT_EQ(3u, world.GetSleepingModelCount());
+  std::vector<Contact> contacts = world.GetContacts();
+  ASSERT_FALSE(contacts.empty());
+  world.Step();
+  std::vector<Contact> sleepingContacts = world.GetContacts();
+  ASSERT_EQ(contacts.size(), sleepingContacts.size());
+  for (std::size_t i = 0; i < contacts.size(); ++i)
+  {
+    EXPECT_EQ(contacts[i].entity1, sleepingContacts[i].entity1);
+    EXPECT_EQ(contacts[i].entity2, sleepingContacts[i].entity2);
+    EXPECT_EQ(contacts[i].point, sleepingContacts[i].point);
+  }
+
+  // setting the pose or the velocity of a link wakes up the model
+  model2->SetPose(math::Pose3d(3, 0, 0, 0, 0, 0));
+  EXPECT_FALSE(model2->GetSleeping());
+  Link *link3 = static_cast<Link *>(&model3->GetChildByIndex(0u));
+  link3->SetAngularVelocity(math::Vector3d(0, 0, 1));
+  EXPECT_FALSE(model3->GetSleeping());
+  EXPECT_EQ(1u, world.GetSleepingModelCount());
+  world.Step();
+  EXPECT_NE(math::Pose3d::Zero, link3->GetPose());
+
+  // disabling sleeping wakes up all models
+  world.SetSleepSteps(0u);
+  world.Step();
+  EXPECT_EQ(0u, world.GetSleepingModelCount());
+}
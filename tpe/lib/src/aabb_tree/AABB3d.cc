@@ -0,0 +1,788 @@
+/*
+  Copyright (c) 2009 Erin Catto http://www.box2d.org
+  Copyright (c) 2016-2018 Lester Hedges <lester.hedges+aabbcc@gmail.com>
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+
+  3. This notice may not be removed or altered from any source distribution.
+
+  This code was adapted from parts of the Box2D Physics Engine,
+  http://www.box2d.org
+
+  ALTERED SOURCE: three dimensional specialization of AABB.cc, see AABB3d.h.
+*/
+
+#include <cmath>
+#include "AABB3d.h"
+
+namespace aabb
+{
+    AABB3d::AABB3d(const double* lowerBound_, const double* upperBound_)
+    {
+        for (unsigned int i=0;i<3;i++)
+        {
+            // Validate the bound.
+            if (lowerBound_[i] > upperBound_[i])
+            {
+                throw std::invalid_argument("[ERROR]: AABB lower bound is greater than the upper bound!");
+            }
+
+            lowerBound[i] = lowerBound_[i];
+            upperBound[i] = upperBound_[i];
+        }
+
+        surfaceArea = computeSurfaceArea();
+    }
+
+    double AABB3d::computeSurfaceArea() const
+    {
+        double dx = upperBound[0] - lowerBound[0];
+        double dy = upperBound[1] - lowerBound[1];
+        double dz = upperBound[2] - lowerBound[2];
+
+        return 2.0 * (dx * dy + dy * dz + dz * dx);
+    }
+
+    void AABB3d::merge(const AABB3d& aabb1, const AABB3d& aabb2)
+    {
+        // Fixed trip count over all four lanes, so this vectorizes.
+        for (unsigned int i=0;i<4;i++)
+        {
+            lowerBound[i] = std::min(aabb1.lowerBound[i], aabb2.lowerBound[i]);
+            upperBound[i] = std::max(aabb1.upperBound[i], aabb2.upperBound[i]);
+        }
+
+        surfaceArea = computeSurfaceArea();
+    }
+
+    bool AABB3d::contains(const AABB3d& aabb) const
+    {
+        bool outside = false;
+        for (unsigned int i=0;i<4;i++)
+        {
+            outside |= (aabb.lowerBound[i] < lowerBound[i]) |
+                       (aabb.upperBound[i] > upperBound[i]);
+        }
+
+        return !outside;
+    }
+
+    Tree3d::Tree3d(double skinThickness_, unsigned int nParticles) :
+        skinThickness(skinThickness_)
+    {
+        if (nParticles == 0)
+            nParticles = 1;
+
+        // Initialise the tree.
+        root = NULL_NODE;
+        nodeCount = 0;
+        nodeCapacity = nParticles;
+        nodes.resize(nodeCapacity);
+
+        // Build a linked list for the list of free nodes.
+        for (unsigned int i=0;i<nodeCapacity-1;i++)
+        {
+            nodes[i].next = i + 1;
+            nodes[i].height = -1;
+        }
+        nodes[nodeCapacity-1].next = NULL_NODE;
+        nodes[nodeCapacity-1].height = -1;
+
+        // Assign the index of the first free node.
+        freeList = 0;
+    }
+
+    unsigned int Tree3d::allocateNode()
+    {
+        // Exand the node pool as needed.
+        if (freeList == NULL_NODE)
+        {
+            assert(nodeCount == nodeCapacity);
+
+            // The free list is empty. Rebuild a bigger pool.
+            nodeCapacity *= 2;
+            nodes.resize(nodeCapacity);
+
+            // Build a linked list for the list of free nodes.
+            for (unsigned int i=nodeCount;i<nodeCapacity-1;i++)
+            {
+                nodes[i].next = i + 1;
+                nodes[i].height = -1;
+            }
+            nodes[nodeCapacity-1].next = NULL_NODE;
+            nodes[nodeCapacity-1].height = -1;
+
+            // Assign the index of the first free node.
+            freeList = nodeCount;
+        }
+
+        // Peel a node off the free list.
+        unsigned int node = freeList;
+        freeList = nodes[node].next;
+        nodes[node].parent = NULL_NODE;
+        nodes[node].left = NULL_NODE;
+        nodes[node].right = NULL_NODE;
+        nodes[node].height = 0;
+        nodeCount++;
+
+        return node;
+    }
+
+    void Tree3d::freeNode(unsigned int node)
+    {
+        assert(node < nodeCapacity);
+        assert(0 < nodeCount);
+
+        nodes[node].next = freeList;
+        nodes[node].height = -1;
+        freeList = node;
+        nodeCount--;
+    }
+
+    void Tree3d::fattenAABB(unsigned int node)
+    {
+        AABB3d& aabb = nodes[node].aabb;
+        for (unsigned int i=0;i<4;i++)
+        {
+            double size = aabb.upperBound[i] - aabb.lowerBound[i];
+            aabb.lowerBound[i] -= skinThickness * size;
+            aabb.upperBound[i] += skinThickness * size;
+        }
+        aabb.surfaceArea = aabb.computeSurfaceArea();
+    }
+
+    void Tree3d::insertParticle(std::size_t particle, const double* lowerBound,
+        const double* upperBound)
+    {
+        // Make sure the particle doesn't already exist.
+        if (particleMap.count(particle) != 0)
+        {
+            throw std::invalid_argument("[ERROR]: Particle already exists in tree!");
+        }
+
+        // Validate the bounds before touching the tree.
+        AABB3d aabb(lowerBound, upperBound);
+
+        // Allocate a new node for the particle.
+        unsigned int node = allocateNode();
+        nodes[node].aabb = aabb;
+        fattenAABB(node);
+
+        // Zero the height.
+        nodes[node].height = 0;
+
+        // Insert a new leaf into the tree.
+        insertLeaf(node);
+
+        // Add the new particle to the map.
+        particleMap.emplace(particle, node);
+
+        // Store the particle index.
+        nodes[node].particle = particle;
+    }
+
+    std::size_t Tree3d::nParticles() const
+    {
+        return particleMap.size();
+    }
+
+    bool Tree3d::hasParticle(std::size_t particle) const
+    {
+        return particleMap.find(particle) != particleMap.end();
+    }
+
+    void Tree3d::removeParticle(std::size_t particle)
+    {
+        // Find the particle.
+        auto it = particleMap.find(particle);
+
+        // The particle doesn't exist.
+        if (it == particleMap.end())
+        {
+            throw std::invalid_argument("[ERROR]: Invalid particle index!");
+        }
+
+        // Extract the node index.
+        unsigned int node = it->second;
+
+        // Erase the particle from the map.
+        particleMap.erase(it);
+
+        assert(node < nodeCapacity);
+        assert(nodes[node].isLeaf());
+
+        removeLeaf(node);
+        freeNode(node);
+    }
+
+    void Tree3d::removeAll()
+    {
+        for (const auto& it : particleMap)
+        {
+            // Extract the node index.
+            unsigned int node = it.second;
+
+            assert(node < nodeCapacity);
+            assert(nodes[node].isLeaf());
+
+            removeLeaf(node);
+            freeNode(node);
+        }
+
+        // Clear the particle map.
+        particleMap.clear();
+    }
+
+    bool Tree3d::updateParticle(std::size_t particle, const double* lowerBound,
+        const double* upperBound, bool alwaysReinsert)
+    {
+        // Find the particle.
+        auto it = particleMap.find(particle);
+
+        // The particle doesn't exist.
+        if (it == particleMap.end())
+        {
+            throw std::invalid_argument("[ERROR]: Invalid particle index!");
+        }
+
+        // Extract the node index.
+        unsigned int node = it->second;
+
+        assert(node < nodeCapacity);
+        assert(nodes[node].isLeaf());
+
+        // Create the new AABB.
+        AABB3d aabb(lowerBound, upperBound);
+
+        // No need to update if the particle is still within its fattened AABB.
+        if (!alwaysReinsert && nodes[node].aabb.contains(aabb)) return false;
+
+        // Remove the current leaf.
+        removeLeaf(node);
+
+        // Assign and fatten the new AABB.
+        nodes[node].aabb = aabb;
+        fattenAABB(node);
+
+        // Insert a new leaf node.
+        insertLeaf(node);
+
+        return true;
+    }
+
+    bool Tree3d::updateParticle(std::size_t particle, const double* lowerBound,
+        const double* upperBound, const double* fatLowerBound,
+        const double* fatUpperBound)
+    {
+        // Find the particle.
+        auto it = particleMap.find(particle);
+
+        // The particle doesn't exist.
+        if (it == particleMap.end())
+        {
+            throw std::invalid_argument("[ERROR]: Invalid particle index!");
+        }
+
+        // Extract the node index.
+        unsigned int node = it->second;
+
+        assert(node < nodeCapacity);
+        assert(nodes[node].isLeaf());
+
+        // No need to update if the particle is still within its fattened AABB.
+        if (nodes[node].aabb.contains(AABB3d(lowerBound, upperBound)))
+            return false;
+
+        // Remove the current leaf.
+        removeLeaf(node);
+
+        // Assign the caller's fattened AABB.
+        nodes[node].aabb = AABB3d(fatLowerBound, fatUpperBound);
+
+        // Insert a new leaf node.
+        insertLeaf(node);
+
+        return true;
+    }
+
+    void Tree3d::query(std::size_t particle,
+        std::vector<std::size_t>& particles) const
+    {
+        auto it = particleMap.find(particle);
+
+        // Make sure that this is a valid particle.
+        if (it == particleMap.end())
+        {
+            throw std::invalid_argument("[ERROR]: Invalid particle index!");
+        }
+
+        // Test overlap of particle AABB against all other particles.
+        query(particle, nodes[it->second].aabb, particles);
+    }
+
+    void Tree3d::query(const AABB3d& aabb,
+        std::vector<std::size_t>& particles) const
+    {
+        // Make sure the tree isn't empty.
+        if (particleMap.size() == 0)
+        {
+            return;
+        }
+
+        // Test overlap of AABB against all particles.
+        query(std::numeric_limits<std::size_t>::max(), aabb, particles);
+    }
+
+    void Tree3d::query(std::size_t particle, const AABB3d& aabb,
+        std::vector<std::size_t>& particles) const
+    {
+        if (root == NULL_NODE) return;
+
+        // The tree is height balanced, so a depth first traversal that pushes
+        // both children never needs more than (height + 1) slots. Use a fixed
+        // buffer on the stack for all practical tree sizes and only fall back
+        // to the heap for pathological ones.
+        const unsigned int kStackSize = 128;
+        unsigned int fixedStack[kStackSize];
+        std::vector<unsigned int> heapStack;
+        unsigned int* stack = fixedStack;
+        if (static_cast<unsigned int>(nodes[root].height) + 1 > kStackSize)
+        {
+            heapStack.resize(nodes[root].height + 1);
+            stack = heapStack.data();
+        }
+
+        unsigned int stackSize = 0;
+        stack[stackSize++] = root;
+
+        while (stackSize > 0)
+        {
+            const Node3d& node = nodes[stack[--stackSize]];
+
+            // Test for overlap between the AABBs.
+            if (!aabb.overlaps(node.aabb)) continue;
+
+            // Check that we're at a leaf node.
+            if (node.isLeaf())
+            {
+                // Can't interact with itself.
+                if (node.particle != particle)
+                {
+                    particles.push_back(node.particle);
+                }
+            }
+            else
+            {
+                stack[stackSize++] = node.left;
+                stack[stackSize++] = node.right;
+            }
+        }
+    }
+
+    const AABB3d& Tree3d::getAABB(std::size_t particle) const
+    {
+        return nodes[particleMap.at(particle)].aabb;
+    }
+
+    void Tree3d::insertLeaf(unsigned int leaf)
+    {
+        if (root == NULL_NODE)
+        {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling for the node.
+
+        const AABB3d leafAABB = nodes[leaf].aabb;
+        unsigned int index = root;
+
+        while (!nodes[index].isLeaf())
+        {
+            // Extract the children of the node.
+            unsigned int left  = nodes[index].left;
+            unsigned int right = nodes[index].right;
+
+            double surfaceArea = nodes[index].aabb.surfaceArea;
+
+            AABB3d combinedAABB;
+            combinedAABB.merge(nodes[index].aabb, leafAABB);
+            double combinedSurfaceArea = combinedAABB.surfaceArea;
+
+            // Cost of creating a new parent for this node and the new leaf.
+            double cost = 2.0 * combinedSurfaceArea;
+
+            // Minimum cost of pushing the leaf further down the tree.
+            double inheritanceCost = 2.0 * (combinedSurfaceArea - surfaceArea);
+
+            // Cost of descending to the left.
+            double costLeft;
+            {
+                AABB3d aabb;
+                aabb.merge(leafAABB, nodes[left].aabb);
+                if (nodes[left].isLeaf())
+                    costLeft = aabb.surfaceArea + inheritanceCost;
+                else
+                    costLeft = (aabb.surfaceArea - nodes[left].aabb.surfaceArea)
+                        + inheritanceCost;
+            }
+
+            // Cost of descending to the right.
+            double costRight;
+            {
+                AABB3d aabb;
+                aabb.merge(leafAABB, nodes[right].aabb);
+                if (nodes[right].isLeaf())
+                    costRight = aabb.surfaceArea + inheritanceCost;
+                else
+                    costRight = (aabb.surfaceArea - nodes[right].aabb.surfaceArea)
+                        + inheritanceCost;
+            }
+
+            // Descend according to the minimum cost.
+            if ((cost < costLeft) && (cost < costRight)) break;
+
+            // Descend.
+            if (costLeft < costRight) index = left;
+            else                      index = right;
+        }
+
+        unsigned int sibling = index;
+
+        // Create a new parent.
+        unsigned int oldParent = nodes[sibling].parent;
+        unsigned int newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].aabb.merge(leafAABB, nodes[sibling].aabb);
+        nodes[newParent].height = nodes[sibling].height + 1;
+
+        // The sibling was not the root.
+        if (oldParent != NULL_NODE)
+        {
+            if (nodes[oldParent].left == sibling) nodes[oldParent].left = newParent;
+            else                                  nodes[oldParent].right = newParent;
+        }
+        // The sibling was the root.
+        else
+        {
+            root = newParent;
+        }
+
+        nodes[newParent].left = sibling;
+        nodes[newParent].right = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        // Walk back up the tree fixing heights and AABBs.
+        index = nodes[leaf].parent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            unsigned int left = nodes[index].left;
+            unsigned int right = nodes[index].right;
+
+            assert(left != NULL_NODE);
+            assert(right != NULL_NODE);
+
+            nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+            nodes[index].aabb.merge(nodes[left].aabb, nodes[right].aabb);
+
+            index = nodes[index].parent;
+        }
+    }
+
+    void Tree3d::removeLeaf(unsigned int leaf)
+    {
+        if (leaf == root)
+        {
+            root = NULL_NODE;
+            return;
+        }
+
+        unsigned int parent = nodes[leaf].parent;
+        unsigned int grandParent = nodes[parent].parent;
+        unsigned int sibling;
+
+        if (nodes[parent].left == leaf) sibling = nodes[parent].right;
+        else                            sibling = nodes[parent].left;
+
+        // Destroy the parent and connect the sibling to the grandparent.
+        if (grandParent != NULL_NODE)
+        {
+            if (nodes[grandParent].left == parent) nodes[grandParent].left = sibling;
+            else                                   nodes[grandParent].right = sibling;
+
+            nodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            // Adjust ancestor bounds.
+            unsigned int index = grandParent;
+            while (index != NULL_NODE)
+            {
+                index = balance(index);
+
+                unsigned int left = nodes[index].left;
+                unsigned int right = nodes[index].right;
+
+                nodes[index].aabb.merge(nodes[left].aabb, nodes[right].aabb);
+                nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+
+                index = nodes[index].parent;
+            }
+        }
+        else
+        {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+    }
+
+    unsigned int Tree3d::balance(unsigned int node)
+    {
+        assert(node != NULL_NODE);
+
+        if (nodes[node].isLeaf() || (nodes[node].height < 2))
+            return node;
+
+        unsigned int left = nodes[node].left;
+        unsigned int right = nodes[node].right;
+
+        assert(left < nodeCapacity);
+        assert(right < nodeCapacity);
+
+        int currentBalance = nodes[right].height - nodes[left].height;
+
+        // Rotate right branch up.
+        if (currentBalance > 1)
+        {
+            unsigned int rightLeft = nodes[right].left;
+            unsigned int rightRight = nodes[right].right;
+
+            assert(rightLeft < nodeCapacity);
+            assert(rightRight < nodeCapacity);
+
+            // Swap node and its right-hand child.
+            nodes[right].left = node;
+            nodes[right].parent = nodes[node].parent;
+            nodes[node].parent = right;
+
+            // The node's old parent should now point to its right-hand child.
+            if (nodes[right].parent != NULL_NODE)
+            {
+                if (nodes[nodes[right].parent].left == node) nodes[nodes[right].parent].left = right;
+                else
+                {
+                    assert(nodes[nodes[right].parent].right == node);
+                    nodes[nodes[right].parent].right = right;
+                }
+            }
+            else root = right;
+
+            // Rotate.
+            if (nodes[rightLeft].height > nodes[rightRight].height)
+            {
+                nodes[right].right = rightLeft;
+                nodes[node].right = rightRight;
+                nodes[rightRight].parent = node;
+                nodes[node].aabb.merge(nodes[left].aabb, nodes[rightRight].aabb);
+                nodes[right].aabb.merge(nodes[node].aabb, nodes[rightLeft].aabb);
+
+                nodes[node].height = 1 + std::max(nodes[left].height, nodes[rightRight].height);
+                nodes[right].height = 1 + std::max(nodes[node].height, nodes[rightLeft].height);
+            }
+            else
+            {
+                nodes[right].right = rightRight;
+                nodes[node].right = rightLeft;
+                nodes[rightLeft].parent = node;
+                nodes[node].aabb.merge(nodes[left].aabb, nodes[rightLeft].aabb);
+                nodes[right].aabb.merge(nodes[node].aabb, nodes[rightRight].aabb);
+
+                nodes[node].height = 1 + std::max(nodes[left].height, nodes[rightLeft].height);
+                nodes[right].height = 1 + std::max(nodes[node].height, nodes[rightRight].height);
+            }
+
+            return right;
+        }
+
+        // Rotate left branch up.
+        if (currentBalance < -1)
+        {
+            unsigned int leftLeft = nodes[left].left;
+            unsigned int leftRight = nodes[left].right;
+
+            assert(leftLeft < nodeCapacity);
+            assert(leftRight < nodeCapacity);
+
+            // Swap node and its left-hand child.
+            nodes[left].left = node;
+            nodes[left].parent = nodes[node].parent;
+            nodes[node].parent = left;
+
+            // The node's old parent should now point to its left-hand child.
+            if (nodes[left].parent != NULL_NODE)
+            {
+                if (nodes[nodes[left].parent].left == node) nodes[nodes[left].parent].left = left;
+                else
+                {
+                    assert(nodes[nodes[left].parent].right == node);
+                    nodes[nodes[left].parent].right = left;
+                }
+            }
+            else root = left;
+
+            // Rotate.
+            if (nodes[leftLeft].height > nodes[leftRight].height)
+            {
+                nodes[left].right = leftLeft;
+                nodes[node].left = leftRight;
+                nodes[leftRight].parent = node;
+                nodes[node].aabb.merge(nodes[right].aabb, nodes[leftRight].aabb);
+                nodes[left].aabb.merge(nodes[node].aabb, nodes[leftLeft].aabb);
+
+                nodes[node].height = 1 + std::max(nodes[right].height, nodes[leftRight].height);
+                nodes[left].height = 1 + std::max(nodes[node].height, nodes[leftLeft].height);
+            }
+            else
+            {
+                nodes[left].right = leftRight;
+                nodes[node].left = leftLeft;
+                nodes[leftLeft].parent = node;
+                nodes[node].aabb.merge(nodes[right].aabb, nodes[leftLeft].aabb);
+                nodes[left].aabb.merge(nodes[node].aabb, nodes[leftRight].aabb);
+
+                nodes[node].height = 1 + std::max(nodes[right].height, nodes[leftLeft].height);
+                nodes[left].height = 1 + std::max(nodes[node].height, nodes[leftRight].height);
+            }
+
+            return left;
+        }
+
+        return node;
+    }
+
+    unsigned int Tree3d::computeHeight(unsigned int node) const
+    {
+        assert(node < nodeCapacity);
+
+        if (nodes[node].isLeaf()) return 0;
+
+        unsigned int height1 = computeHeight(nodes[node].left);
+        unsigned int height2 = computeHeight(nodes[node].right);
+
+        return 1 + std::max(height1, height2);
+    }
+
+    unsigned int Tree3d::getHeight() const
+    {
+        if (root == NULL_NODE) return 0;
+        return nodes[root].height;
+    }
+
+    unsigned int Tree3d::getNodeCount() const
+    {
+        return nodeCount;
+    }
+
+    void Tree3d::validate() const
+    {
+#ifndef NDEBUG
+        validateStructure(root);
+        validateMetrics(root);
+
+        unsigned int freeCount = 0;
+        unsigned int freeIndex = freeList;
+
+        while (freeIndex != NULL_NODE)
+        {
+            assert(freeIndex < nodeCapacity);
+            freeIndex = nodes[freeIndex].next;
+            freeCount++;
+        }
+
+        assert(root == NULL_NODE || getHeight() == computeHeight(root));
+        assert((nodeCount + freeCount) == nodeCapacity);
+#endif
+    }
+
+    void Tree3d::validateStructure(unsigned int node) const
+    {
+        if (node == NULL_NODE) return;
+
+        if (node == root) assert(nodes[node].parent == NULL_NODE);
+
+        unsigned int left = nodes[node].left;
+        unsigned int right = nodes[node].right;
+
+        if (nodes[node].isLeaf())
+        {
+            assert(left == NULL_NODE);
+            assert(right == NULL_NODE);
+            assert(nodes[node].height == 0);
+            return;
+        }
+
+        assert(left < nodeCapacity);
+        assert(right < nodeCapacity);
+
+        assert(nodes[left].parent == node);
+        assert(nodes[right].parent == node);
+
+        validateStructure(left);
+        validateStructure(right);
+    }
+
+    void Tree3d::validateMetrics(unsigned int node) const
+    {
+        if (node == NULL_NODE) return;
+
+        unsigned int left = nodes[node].left;
+        unsigned int right = nodes[node].right;
+
+        if (nodes[node].isLeaf())
+        {
+            assert(left == NULL_NODE);
+            assert(right == NULL_NODE);
+            assert(nodes[node].height == 0);
+            return;
+        }
+
+        assert(left < nodeCapacity);
+        assert(right < nodeCapacity);
+
+        int height1 = nodes[left].height;
+        int height2 = nodes[right].height;
+        int height = 1 + std::max(height1, height2);
+        (void)height; // Unused variable in Release build
+        assert(nodes[node].height == height);
+
+        AABB3d aabb;
+        aabb.merge(nodes[left].aabb, nodes[right].aabb);
+
+        for (unsigned int i=0;i<3;i++)
+        {
+            assert(std::fabs(aabb.lowerBound[i] - nodes[node].aabb.lowerBound[i]) < 1e-6);
+            assert(std::fabs(aabb.upperBound[i] - nodes[node].aabb.upperBound[i]) < 1e-6);
+        }
+
+        validateMetrics(left);
+        validateMetrics(right);
+    }
+}
@@ -0,0 +1,417 @@
+/*
+  Copyright (c) 2009 Erin Catto http://www.box2d.org
+  Copyright (c) 2016-2018 Lester Hedges <lester.hedges+aabbcc@gmail.com>
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+
+  3. This notice may not be removed or altered from any source distribution.
+
+  This code was adapted from parts of the Box2D Physics Engine,
+  http://www.box2d.org
+
+  ALTERED SOURCE: this is a three dimensional specialization of the tree in
+  AABB.h. Bounds are stored inline in fixed-size, padded arrays instead of
+  std::vector<double>, periodic boundaries are not supported, and particle
+  indices are std::size_t.
+*/
+
+#ifndef _AABB3D_H
+#define _AABB3D_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "AABB.h"
+
+namespace aabb
+{
+    /*! \brief A three dimensional axis-aligned bounding box.
+
+        The lower and upper bounds are each padded to four lanes and the
+        struct is 32-byte aligned, so that one bound fills exactly one AVX
+        register (or two SSE2 registers). The fourth lane is always zero and
+        never affects the result of a test.
+     */
+    struct alignas(32) AABB3d
+    {
+        /// Constructor.
+        AABB3d() = default;
+
+        //! Constructor.
+        /*! \param lowerBound_
+                The lower bound in each dimension (3 values).
+
+            \param upperBound_
+                The upper bound in each dimension (3 values).
+         */
+        AABB3d(const double*, const double*);
+
+        /// Compute the surface area of the box.
+        double computeSurfaceArea() const;
+
+        //! Merge two AABBs into this one.
+        /*! \param aabb1
+                A reference to the first AABB.
+
+            \param aabb2
+                A reference to the second AABB.
+         */
+        void merge(const AABB3d&, const AABB3d&);
+
+        //! Test whether the AABB is contained within this one.
+        /*! \param aabb
+                A reference to the AABB.
+
+            \return
+                Whether the AABB is fully contained.
+         */
+        bool contains(const AABB3d&) const;
+
+        //! Test whether the AABB overlaps this one. Touching counts as an
+        //! overlap.
+        /*! \param aabb
+                A reference to the AABB.
+
+            \return
+                Whether the AABB overlaps.
+         */
+        inline bool overlaps(const AABB3d&) const;
+
+        /// Lower bound of AABB in each dimension, padded to four lanes.
+        double lowerBound[4] = {0.0, 0.0, 0.0, 0.0};
+
+        /// Upper bound of AABB in each dimension, padded to four lanes.
+        double upperBound[4] = {0.0, 0.0, 0.0, 0.0};
+
+        /// The AABB's surface area.
+        double surfaceArea = 0.0;
+    };
+
+    /*! \brief A node of the three dimensional AABB tree.
+
+        The bounds are stored inline, so a node is a fixed 128 bytes and the
+        node pool is a single contiguous allocation.
+     */
+    struct Node3d
+    {
+        /// The fattened axis-aligned bounding box.
+        AABB3d aabb;
+
+        /// Index of the parent node.
+        unsigned int parent = NULL_NODE;
+
+        /// Index of the next node.
+        unsigned int next = NULL_NODE;
+
+        /// Index of the left-hand child.
+        unsigned int left = NULL_NODE;
+
+        /// Index of the right-hand child.
+        unsigned int right = NULL_NODE;
+
+        /// Height of the node. This is 0 for a leaf and -1 for a free node.
+        int height = -1;
+
+        /// The index of the particle that the node contains (leaf nodes only).
+        std::size_t particle = 0;
+
+        //! Test whether the node is a leaf.
+        /*! \return
+                Whether the node is a leaf node.
+         */
+        bool isLeaf() const
+        {
+            return (left == NULL_NODE);
+        }
+    };
+
+    /*! \brief The three dimensional dynamic AABB tree.
+
+        Same algorithm as aabb::Tree (surface area heuristic insertion with
+        AVL style balancing), but without any per-operation heap allocation
+        on the insert, update and query paths.
+     */
+    class Tree3d
+    {
+    public:
+        //! Constructor.
+        /*! \param skinThickness_
+                The skin thickness for fattened AABBs, as a fraction
+                of the AABB base length.
+
+            \param nParticles
+                The initial node capacity.
+         */
+        explicit Tree3d(double skinThickness_ = 0.05,
+            unsigned int nParticles = 16);
+
+        //! Insert a particle into the tree.
+        /*! \param index
+                The index of the particle.
+
+            \param lowerBound
+                The lower bound in each dimension (3 values).
+
+            \param upperBound
+                The upper bound in each dimension (3 values).
+         */
+        void insertParticle(std::size_t, const double*, const double*);
+
+        /// Return the number of particles in the tree.
+        std::size_t nParticles() const;
+
+        //! Test whether a particle is in the tree.
+        /*! \param particle
+                The particle index.
+         */
+        bool hasParticle(std::size_t) const;
+
+        //! Remove a particle from the tree.
+        /*! \param particle
+                The particle index.
+         */
+        void removeParticle(std::size_t);
+
+        /// Remove all particles from the tree.
+        void removeAll();
+
+        //! Update the tree if a particle moves outside its fattened AABB.
+        /*! \param particle
+                The particle index.
+
+            \param lowerBound
+                The lower bound in each dimension (3 values).
+
+            \param upperBound
+                The upper bound in each dimension (3 values).
+
+            \param alwaysReinsert
+                Always reinsert the particle, even if it's within its old AABB
+                (default: false)
+
+            \return
+                Whether the particle was reinserted.
+         */
+        bool updateParticle(std::size_t, const double*, const double*,
+            bool alwaysReinsert=false);
+
+        //! Update the tree if a particle moves outside its fattened AABB,
+        //! using a fattened AABB computed by the caller.
+        /*! This allows the caller to use a margin that isn't proportional
+            to the size of the particle, e.g. one that is extended in the
+            direction of motion. The skin thickness is not applied.
+
+            \param particle
+                The particle index.
+
+            \param lowerBound
+                The lower bound in each dimension (3 values).
+
+            \param upperBound
+                The upper bound in each dimension (3 values).
+
+            \param fatLowerBound
+                The fattened lower bound to store if the particle is
+                reinserted (3 values).
+
+            \param fatUpperBound
+                The fattened upper bound to store if the particle is
+                reinserted (3 values).
+
+            \return
+                Whether the particle was reinserted.
+         */
+        bool updateParticle(std::size_t, const double*, const double*,
+            const double*, const double*);
+
+        //! Query the tree to find candidate interactions for a particle.
+        /*! \param particle
+                The particle index.
+
+            \param particles
+                Output vector that the overlapping particle indices are
+                appended to. The particle itself is not included.
+         */
+        void query(std::size_t, std::vector<std::size_t>&) const;
+
+        //! Query the tree to find candidate interactions for an AABB.
+        /*! \param aabb
+                The AABB.
+
+            \param particles
+                Output vector that the overlapping particle indices are
+                appended to.
+         */
+        void query(const AABB3d&, std::vector<std::size_t>&) const;
+
+        //! Get a particle AABB.
+        /*! \param particle
+                The particle index.
+         */
+        const AABB3d& getAABB(std::size_t) const;
+
+        //! Get the height of the tree.
+        /*! \return
+                The height of the binary tree.
+         */
+        unsigned int getHeight() const;
+
+        //! Get the number of nodes in the tree.
+        /*! \return
+                The number of nodes in the tree.
+         */
+        unsigned int getNodeCount() const;
+
+        /// Validate the tree.
+        void validate() const;
+
+    private:
+        //! Query the tree, skipping a particle.
+        /*! \param particle
+                The particle index to skip.
+
+            \param aabb
+                The AABB.
+
+            \param particles
+                Output vector of overlapping particle indices.
+         */
+        void query(std::size_t, const AABB3d&,
+            std::vector<std::size_t>&) const;
+
+        /// The index of the root node.
+        unsigned int root;
+
+        /// The dynamic tree.
+        std::vector<Node3d> nodes;
+
+        /// The current number of nodes in the tree.
+        unsigned int nodeCount;
+
+        /// The current node capacity.
+        unsigned int nodeCapacity;
+
+        /// The position of node at the top of the free list.
+        unsigned int freeList;
+
+        /// The skin thickness of the fattened AABBs, as a fraction of the AABB
+        /// base length.
+        double skinThickness;
+
+        /// A map between particle and node indices.
+        std::unordered_map<std::size_t, unsigned int> particleMap;
+
+        //! Allocate a new node.
+        /*! \return
+                The index of the allocated node.
+         */
+        unsigned int allocateNode();
+
+        //! Free an existing node.
+        /*! \param node
+                The index of the node to be freed.
+         */
+        void freeNode(unsigned int);
+
+        //! Fatten the AABB of a leaf node in place.
+        /*! \param node
+                The index of the node.
+         */
+        void fattenAABB(unsigned int);
+
+        //! Insert a leaf into the tree.
+        /*! \param leaf
+                The index of the leaf node.
+         */
+        void insertLeaf(unsigned int);
+
+        //! Remove a leaf from the tree.
+        /*! \param leaf
+                The index of the leaf node.
+         */
+        void removeLeaf(unsigned int);
+
+        //! Balance the tree.
+        /*! \param node
+                The index of the node.
+         */
+        unsigned int balance(unsigned int);
+
+        //! Compute the height of a sub-tree.
+        /*! \param node
+                The index of the root node.
+
+            \return
+                The height of the sub-tree.
+         */
+        unsigned int computeHeight(unsigned int) const;
+
+        //! Assert that the sub-tree has a valid structure.
+        /*! \param node
+                The index of the root node.
+         */
+        void validateStructure(unsigned int) const;
+
+        //! Assert that the sub-tree has valid metrics.
+        /*! \param node
+                The index of the root node.
+         */
+        void validateMetrics(unsigned int) const;
+    };
+
+    inline bool AABB3d::overlaps(const AABB3d& aabb) const
+    {
+#if defined(__AVX__)
+        const __m256d separated = _mm256_or_pd(
+            _mm256_cmp_pd(_mm256_load_pd(aabb.upperBound),
+                _mm256_load_pd(lowerBound), _CMP_LT_OQ),
+            _mm256_cmp_pd(_mm256_load_pd(aabb.lowerBound),
+                _mm256_load_pd(upperBound), _CMP_GT_OQ));
+        return _mm256_movemask_pd(separated) == 0;
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128d separatedXY = _mm_or_pd(
+            _mm_cmplt_pd(_mm_load_pd(aabb.upperBound),
+                _mm_load_pd(lowerBound)),
+            _mm_cmpgt_pd(_mm_load_pd(aabb.lowerBound),
+                _mm_load_pd(upperBound)));
+        const __m128d separatedZ = _mm_or_pd(
+            _mm_cmplt_pd(_mm_load_pd(aabb.upperBound + 2),
+                _mm_load_pd(lowerBound + 2)),
+            _mm_cmpgt_pd(_mm_load_pd(aabb.lowerBound + 2),
+                _mm_load_pd(upperBound + 2)));
+        return _mm_movemask_pd(_mm_or_pd(separatedXY, separatedZ)) == 0;
+#else
+        // Branch-free so that the compiler is free to vectorize it.
+        bool separated = false;
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            separated |= (aabb.upperBound[i] < lowerBound[i]) |
+                         (aabb.lowerBound[i] > upperBound[i]);
+        }
+        return !separated;
+#endif
+    }
+}
+
+#endif /* _AABB3D_H */
@@ -23,6 +23,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "lib/src/World.hh"
 #include "lib/src/Engine.hh"
@@ -163,12 +164,31 @@ class Base : public Implements3d<FeatureList<Feature>>
     collisionPtr->collision = &_collision;
     size_t collisionId = _collision.GetId();
     this->collisions.insert({collisionId, collisionPtr});
+    const tpelib::EntityHandle handle = _collision.GetHandle();
+    if (handle >= this->collisionsByHandle.size())
+      this->collisionsByHandle.resize(handle + 1u);
+    this->collisionsByHandle[handle] = collisionPtr;
     // keep track of collision's corresponding link
     this->childIdToParentId.insert({collisionId, _linkId});
 
     return this->GenerateIdentity(collisionId, collisionPtr);
   }
 
+  /// \brief Get a collision by its entity handle
+  /// \param[in] _handle Collision entity handle
+  /// \return Collision info, or nullptr if the handle is not a live
+  /// collision of this plugin
+  public: inline const std::shared_ptr<CollisionInfo> *CollisionByHandle(
+    tpelib::EntityHandle _handle) const
+  {
+    if (_handle >= this->collisionsByHandle.size() ||
+        !this->collisionsByHandle[_handle])
+    {
+      return nullptr;
+    }
+    return &this->collisionsByHandle[_handle];
+  }
+
   public: bool RemoveModelImpl(std::size_t _modelID)
   {
     auto parentIt = this->childIdToParentId.find(_modelID);
@@ -217,6 +237,28 @@ class Base : public Implements3d<FeatureList<Feature>>
   {
     if (nullptr == _parentEntity)
       return false;
+
+    // Forget the collisions of the model's links so that contacts from the
+    // last step do not resolve to collisions that are about to be destroyed
+    auto modelIt = this->models.find(_modelID);
+    if (modelIt != this->models.end())
+    {
+      tpelib::Model *model = modelIt->second->model;
+      for (std::size_t i = 0; i < model->GetChildCount(); ++i)
+      {
+        tpelib::Entity &link = model->GetChildByIndex(i);
+        if (link.GetType() != tpelib::EntityType::LINK)
+          continue;
+        for (std::size_t j = 0; j < link.GetChildCount(); ++j)
+        {
+          const tpelib::EntityHandle handle =
+              link.GetChildByIndex(j).GetHandle();
+          if (handle < this->collisionsByHandle.size())
+            this->collisionsByHandle[handle].reset();
+        }
+      }
+    }
+
     bool result = this->models.erase(_modelID) == 1;
     result &= this->childIdToParentId.erase(_modelID) == 1;
     result &= _parentEntity->RemoveChildById(_modelID);
@@ -227,6 +269,12 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: std::map<std::size_t, std::shared_ptr<ModelInfo>> models;
   public: std::map<std::size_t, std::shared_ptr<LinkInfo>> links;
   public: std::map<std::size_t, std::shared_ptr<CollisionInfo>> collisions;
+
+  /// \brief Collisions of this plugin indexed by their entity handle, so
+  /// that contacts can be converted without map lookups. Entries are reset
+  /// together with the model that owns the collision, before its handles
+  /// can be reused.
+  public: std::vector<std::shared_ptr<CollisionInfo>> collisionsByHandle;
   public: std::map<std::size_t, std::size_t> childIdToParentId;
 };
 
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <iterator>
+
+#include <Eigen/Geometry>
+
+#include <ignition/common/Console.hh>
+
+#include <ignition/math/eigen3/Conversions.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "BatchedWorldFeatures.hh"
+
+using namespace ignition;
+using namespace physics;
+using namespace tpeplugin;
+
+/// \brief Number of degrees of freedom of each model that is not static
+static const std::size_t kModelDofs = 6u;
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::GetBatchedWorldState(
+  const Identity &,
+  std::size_t _firstWorld, std::size_t _worldCount,
+  BatchMatrixType &_positions, BatchMatrixType &_velocities) const
+{
+  std::size_t dofs = 0u;
+  auto worldIt = this->CheckBatch(_firstWorld, _worldCount, dofs);
+  if (worldIt == this->worlds.end())
+    return false;
+
+  _positions.resize(_worldCount, dofs);
+  _velocities.resize(_worldCount, dofs);
+  for (Eigen::Index row = 0; row < _positions.rows(); ++row, ++worldIt)
+  {
+    Eigen::Index col = 0;
+    for (const auto &child : worldIt->second->world->GetChildMap())
+    {
+      // children of the world are only added by AddModel
+      auto model = static_cast<const tpelib::Model *>(child.second.get());
+      if (model->GetStatic())
+        continue;
+
+      const math::Pose3d pose = model->GetPose();
+      const Eigen::AngleAxisd rotation(math::eigen3::convert(pose.Rot()));
+      _positions.row(row).segment<3>(col) =
+          math::eigen3::convert(pose.Pos()).transpose();
+      _positions.row(row).segment<3>(col + 3) =
+          (rotation.angle() * rotation.axis()).transpose();
+      _velocities.row(row).segment<3>(col) =
+          math::eigen3::convert(model->GetLinearVelocity()).transpose();
+      _velocities.row(row).segment<3>(col + 3) =
+          math::eigen3::convert(model->GetAngularVelocity()).transpose();
+      col += kModelDofs;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BatchedWorldFeatures::SetBatchedWorldState(
+  const Identity &,
+  std::size_t _firstWorld, std::size_t _worldCount,
+  const BatchMatrixType &_positions, const BatchMatrixType &_velocities)
+{
+  std::size_t dofs = 0u;
+  auto worldIt = this->CheckBatch(_firstWorld, _worldCount, dofs);
+  if (worldIt == this->worlds.end())
+    return false;
+
+  for (const BatchMatrixType *matrix : {&_positions, &_velocities})
+  {
+    if (static_cast<std::size_t>(matrix->rows()) != _worldCount ||
+        static_cast<std::size_t>(matrix->cols()) != dofs)
+    {
+      ignerr << "Expected a [" << _worldCount << " x " << dofs
+             << "] batch matrix, but got a [" << matrix->rows() << " x "
+             << matrix->cols() << "] matrix." << std::endl;
+      return false;
+    }
+  }
+
+  for (Eigen::Index row = 0; row < _positions.rows(); ++row, ++worldIt)
+  {
+    Eigen::Index col = 0;
+    for (const auto &child : worldIt->second->world->GetChildMap())
+    {
+      auto model = static_cast<tpelib::Model *>(child.second.get());
+      if (model->GetStatic())
+        continue;
+
+      const Eigen::Vector3d rotation =
+          _positions.row(row).segment<3>(col + 3).transpose();
+      const double angle = rotation.norm();
+      Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+      if (angle > 0.0)
+        orientation = Eigen::AngleAxisd(angle, rotation / angle);
+
+      model->SetPose(math::Pose3d(
+          math::eigen3::convert(Eigen::Vector3d(
+              _positions.row(row).segment<3>(col).transpose())),
+          math::eigen3::convert(orientation)));
+      model->SetLinearVelocity(math::eigen3::convert(Eigen::Vector3d(
+          _velocities.row(row).segment<3>(col).transpose())));
+      model->SetAngularVelocity(math::eigen3::convert(Eigen::Vector3d(
+          _velocities.row(row).segment<3>(col + 3).transpose())));
+      col += kModelDofs;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::map<std::size_t, std::shared_ptr<WorldInfo>>::const_iterator
+BatchedWorldFeatures::CheckBatch(std::size_t _firstWorld,
+  std::size_t _worldCount, std::size_t &_dofs) const
+{
+  if (_firstWorld + _worldCount > this->worlds.size())
+  {
+    ignerr << "A batch of [" << _worldCount << "] worlds starting at index ["
+           << _firstWorld << "] was requested, but the engine only has ["
+           << this->worlds.size() << "] worlds." << std::endl;
+    return this->worlds.end();
+  }
+
+  // worlds are indexed in the order of their ids, like GetWorld
+  auto firstIt = std::next(this->worlds.begin(), _firstWorld);
+  auto worldIt = firstIt;
+  _dofs = 0u;
+  for (std::size_t k = 0; k < _worldCount; ++k, ++worldIt)
+  {
+    std::size_t dofs = 0u;
+    for (const auto &child : worldIt->second->world->GetChildMap())
+    {
+      if (!child.second->GetStatic())
+        dofs += kModelDofs;
+    }
+
+    if (k == 0u)
+    {
+      _dofs = dofs;
+    }
+    else if (dofs != _dofs)
+    {
+      ignerr << "World [" << worldIt->second->world->GetName() << "] has ["
+             << dofs << "] degrees of freedom, but the first world of the "
+             << "batch has [" << _dofs << "]." << std::endl;
+      return this->worlds.end();
+    }
+  }
+  return firstIt;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_PHYSICS_TPE_PLUGIN_SRC_BATCHEDWORLDFEATURES_HH_
+#define IGNITION_PHYSICS_TPE_PLUGIN_SRC_BATCHEDWORLDFEATURES_HH_
+
+#include <ignition/physics/BatchedWorlds.hh>
+
+#include "Base.hh"
+
+namespace ignition {
+namespace physics {
+namespace tpeplugin {
+
+struct BatchedWorldFeatureList : FeatureList<
+  BatchedWorldStateFeature
+> { };
+
+/// \brief Each model of a world that is not static has 6 degrees of freedom,
+/// in the order that the models were added to the world. The positions of a
+/// model are its world position followed by its world orientation as a
+/// rotation vector, and its velocities are its linear velocity followed by
+/// its angular velocity. TPE has no forces, so BatchedWorldForcesFeature is
+/// not provided.
+class BatchedWorldFeatures :
+  public virtual Base,
+  public virtual Implements3d<BatchedWorldFeatureList>
+{
+  public: bool GetBatchedWorldState(
+    const Identity &_engineID,
+    std::size_t _firstWorld, std::size_t _worldCount,
+    BatchMatrixType &_positions,
+    BatchMatrixType &_velocities) const override;
+
+  public: bool SetBatchedWorldState(
+    const Identity &_engineID,
+    std::size_t _firstWorld, std::size_t _worldCount,
+    const BatchMatrixType &_positions,
+    const BatchMatrixType &_velocities) override;
+
+  /// \brief Check that the worlds of a batch exist and have the same number
+  /// of degrees of freedom
+  /// \param[in] _firstWorld Index of the first world of the batch
+  /// \param[in] _worldCount Number of worlds in the batch
+  /// \param[out] _dofs Number of degrees of freedom of each world
+  /// \return Iterator to the first world of the batch, or the end of
+  /// this->worlds if the batch is not valid
+  private: std::map<std::size_t, std::shared_ptr<WorldInfo>>::const_iterator
+    CheckBatch(std::size_t _firstWorld, std::size_t _worldCount,
+    std::size_t &_dofs) const;
+};
+
+}
+}
+}
+
+#endif
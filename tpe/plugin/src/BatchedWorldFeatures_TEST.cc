@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <ignition/plugin/Loader.hh>
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
+
+#include "ignition/physics/BatchedWorlds.hh"
+#include "ignition/physics/ForwardStep.hh"
+#include "ignition/physics/GetEntities.hh"
+#include "ignition/physics/RequestEngine.hh"
+#include "ignition/physics/sdf/ConstructWorldReplicas.hh"
+#include "test/Utils.hh"
+
+struct TestFeatureList : ignition::physics::FeatureList<
+    ignition::physics::sdf::ConstructSdfWorldReplicas,
+    ignition::physics::BatchedWorldStateFeature,
+    ignition::physics::ForwardStepWorlds,
+    ignition::physics::GetEntities
+> { };
+
+using BatchMatrix =
+    ignition::physics::BatchMatrix<ignition::physics::FeaturePolicy3d>;
+
+/////////////////////////////////////////////////
+TEST(BatchedWorldFeatures, WorldReplicas)
+{
+  ignition::plugin::Loader loader;
+  loader.LoadLib(tpe_plugin_LIB);
+
+  ignition::plugin::PluginPtr tpe =
+      loader.Instantiate("ignition::physics::tpeplugin::Plugin");
+
+  auto engine =
+      ignition::physics::RequestEngine3d<TestFeatureList>::From(tpe);
+  ASSERT_NE(nullptr, engine);
+
+  sdf::Root root;
+  const sdf::Errors &errors = root.Load(TEST_WORLD_DIR "shapes.world");
+  ASSERT_EQ(0u, errors.size()) << errors;
+  const sdf::World *sdfWorld = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, sdfWorld);
+
+  const std::size_t replicaCount = 3u;
+  auto replicas = engine->ConstructWorldReplicas(*sdfWorld, replicaCount);
+  ASSERT_EQ(replicaCount, replicas.size());
+  ASSERT_EQ(replicaCount, engine->GetWorldCount());
+  for (std::size_t i = 0; i < replicaCount; ++i)
+  {
+    EXPECT_EQ("default_" + std::to_string(i), replicas[i]->GetName());
+    EXPECT_EQ(replicas[i]->EntityID(), engine->GetWorld(i)->EntityID());
+  }
+
+  // 4 models are not static. The sphere is the first one.
+  BatchMatrix positions;
+  BatchMatrix velocities;
+  ASSERT_TRUE(engine->GetBatchedWorldState(
+      0, replicaCount, positions, velocities));
+  ASSERT_EQ(3, positions.rows());
+  ASSERT_EQ(24, positions.cols());
+  EXPECT_EQ(3, velocities.rows());
+  EXPECT_EQ(24, velocities.cols());
+  for (Eigen::Index i = 0; i < positions.rows(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(0.0, positions(i, 0));
+    EXPECT_DOUBLE_EQ(1.5, positions(i, 1));
+    EXPECT_DOUBLE_EQ(0.5, positions(i, 2));
+    EXPECT_TRUE(velocities.row(i).isZero());
+  }
+
+  // move the sphere of the second replica only
+  velocities(1, 0) = 1.0;
+  ASSERT_TRUE(engine->SetBatchedWorldState(
+      0, replicaCount, positions, velocities));
+
+  std::vector<ignition::physics::ForwardStep::Output> outputs;
+  std::vector<ignition::physics::ForwardStep::State> states;
+  std::vector<ignition::physics::ForwardStep::Input> inputs(replicaCount);
+  for (auto &input : inputs)
+  {
+    input.Get<std::chrono::steady_clock::duration>() =
+        std::chrono::milliseconds(10);
+  }
+
+  // all link poses are new in the first step
+  engine->StepWorlds(outputs, states, inputs);
+  ASSERT_EQ(replicaCount, outputs.size());
+  for (const auto &output : outputs)
+  {
+    EXPECT_FALSE(
+        output.Get<ignition::physics::ChangedWorldPoses>().entries.empty());
+  }
+
+  // afterwards only the moving sphere is reported, in the output of its world
+  const std::size_t sphereLinkId =
+      replicas[1]->GetModel("sphere")->GetLink(0)->EntityID();
+  for (std::size_t step = 1; step < 10; ++step)
+  {
+    engine->StepWorlds(outputs, states, inputs);
+    EXPECT_TRUE(outputs[0].Get<ignition::physics::ChangedWorldPoses>()
+        .entries.empty());
+    EXPECT_TRUE(outputs[2].Get<ignition::physics::ChangedWorldPoses>()
+        .entries.empty());
+    const auto &entries =
+        outputs[1].Get<ignition::physics::ChangedWorldPoses>().entries;
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(sphereLinkId, entries[0].body);
+  }
+
+  BatchMatrix newPositions;
+  BatchMatrix newVelocities;
+  ASSERT_TRUE(engine->GetBatchedWorldState(
+      0, replicaCount, newPositions, newVelocities));
+  EXPECT_NEAR(0.0, newPositions(0, 0), 1e-6);
+  EXPECT_NEAR(0.1, newPositions(1, 0), 1e-6);
+  EXPECT_NEAR(0.0, newPositions(2, 0), 1e-6);
+  EXPECT_TRUE(newPositions.rightCols(21).isApprox(positions.rightCols(21)));
+
+  // orientations are set as rotation vectors
+  positions(2, 5) = 0.5;
+  ASSERT_TRUE(engine->SetBatchedWorldState(
+      0, replicaCount, positions, velocities));
+  ASSERT_TRUE(engine->GetBatchedWorldState(
+      0, replicaCount, newPositions, newVelocities));
+  EXPECT_NEAR(0.5, newPositions(2, 5), 1e-6);
+  EXPECT_NEAR(0.0, newPositions(1, 3), 1e-6);
+
+  // matrices that don't match the batch and batches that don't exist
+  EXPECT_FALSE(engine->SetBatchedWorldState(
+      0, replicaCount, positions.leftCols(6), velocities.leftCols(6)));
+  EXPECT_FALSE(engine->GetBatchedWorldState(
+      1, replicaCount, positions, velocities));
+}
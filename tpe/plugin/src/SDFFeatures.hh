@@ -23,6 +23,7 @@
 #include <ignition/physics/sdf/ConstructModel.hh>
 #include <ignition/physics/sdf/ConstructNestedModel.hh>
 #include <ignition/physics/sdf/ConstructWorld.hh>
+#include <ignition/physics/sdf/ConstructWorldReplicas.hh>
 
 #include <ignition/physics/Implements.hh>
 
@@ -34,6 +35,7 @@ namespace tpeplugin {
 
 using SDFFeatureList = FeatureList<
   sdf::ConstructSdfWorld,
+  sdf::ConstructSdfWorldReplicas,
   sdf::ConstructSdfModel,
   sdf::ConstructSdfNestedModel,
   sdf::ConstructSdfLink,
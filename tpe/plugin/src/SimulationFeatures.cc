@@ -15,8 +15,10 @@
  *
 */
 
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
@@ -46,23 +48,87 @@ void SimulationFeatures::WorldForwardStep(
       << std::endl;
     return;
   }
-  std::shared_ptr<tpelib::World> world = it->second->world;
+  this->StepWorld(*it->second->world, _u);
+  this->Write(_h.Get<ChangedWorldPoses>());
+}
+
+void SimulationFeatures::EngineForwardStepWorlds(
+  const Identity &/*_engineID*/,
+  std::vector<ForwardStep::Output> &_h,
+  std::vector<ForwardStep::State> &_x,
+  const std::vector<ForwardStep::Input> &_u)
+{
+  IGN_PROFILE("SimulationFeatures::EngineForwardStepWorlds");
+  _h.resize(this->worlds.size());
+  _x.resize(this->worlds.size());
+
+  // worlds are indexed in the order of their ids, like GetWorld
+  std::vector<tpelib::World *> worldPtrs;
+  std::unordered_map<std::size_t, std::size_t> worldIndices;
+  worldPtrs.reserve(this->worlds.size());
+  for (const auto &[id, info] : this->worlds)
+  {
+    worldIndices[id] = worldPtrs.size();
+    worldPtrs.push_back(info->world.get());
+  }
+
+  // tpelib worlds share no state, so they can step in parallel
+  const ForwardStep::Input defaultInput;
+  auto stepWorlds = [&](std::size_t, std::size_t _begin, std::size_t _end)
+  {
+    for (std::size_t i = _begin; i < _end; ++i)
+      this->StepWorld(*worldPtrs[i], i < _u.size() ? _u[i] : defaultInput);
+  };
+  if (worldPtrs.size() > 1u)
+  {
+    if (!this->workerPool)
+      this->workerPool = std::make_unique<tpelib::WorkerPool>(0u);
+    this->workerPool->Run(worldPtrs.size(), 1u, stepWorlds);
+  }
+  else
+  {
+    stepWorlds(0u, 0u, worldPtrs.size());
+  }
+
+  // split the changed poses of all the worlds by world
+  for (auto &output : _h)
+    output.Get<ChangedWorldPoses>().entries.clear();
+  this->Write(this->changedPoses);
+  for (const WorldPose &wp : this->changedPoses.entries)
+  {
+    // walk up from the link to its world
+    auto parentIt = this->childIdToParentId.find(wp.body);
+    while (parentIt != this->childIdToParentId.end() &&
+           worldIndices.find(parentIt->second) == worldIndices.end())
+    {
+      parentIt = this->childIdToParentId.find(parentIt->second);
+    }
+    if (parentIt != this->childIdToParentId.end())
+    {
+      _h[worldIndices[parentIt->second]].Get<ChangedWorldPoses>()
+          .entries.push_back(wp);
+    }
+  }
+}
+
+void SimulationFeatures::StepWorld(tpelib::World &_world,
+  const ForwardStep::Input &_u) const
+{
   auto *dtDur =
     _u.Query<std::chrono::steady_clock::duration>();
   const double tol = 1e-6;
   if (dtDur)
   {
     std::chrono::duration<double> dt = *dtDur;
-    if (std::fabs(dt.count() - world->GetTimeStep()) > tol)
+    if (std::fabs(dt.count() - _world.GetTimeStep()) > tol)
     {
-      world->SetTimeStep(dt.count());
+      _world.SetTimeStep(dt.count());
       igndbg << "Simulation timestep set to: "
-        << world->GetTimeStep()
+        << _world.GetTimeStep()
         << std::endl;
     }
   }
-  world->Step();
-  this->Write(_h.Get<ChangedWorldPoses>());
+  _world.Step();
 }
 
 void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
@@ -121,7 +187,7 @@ void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
           !iter->second.Pos().Equal(nextPose.Pos(), 1e-6) ||
           !iter->second.Rot().Equal(nextPose.Rot(), 1e-6))
       {
-        for (const auto &linkEnt : info->model->GetChildren())
+        for (const auto &linkEnt : info->model->GetChildMap())
         {
           // Avoid pushing if the link was already updated in the previous loop
           auto linkId = linkEnt.second->GetId();
@@ -153,36 +219,79 @@ SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
   IGN_PROFILE("SimulationFeatures::GetContactFromLastStep");
   std::vector<SimulationFeatures::ContactInternal> outContacts;
   auto const world = this->ReferenceInterface<WorldInfo>(_worldID)->world;
-  const auto contacts = world->GetContacts();
+  const auto &contacts = world->GetContacts();
+  const bool exact = world->GetExactNarrowphase();
 
+  // Contacts carry the handles of the collisions in contact, which index
+  // the collisions of this plugin directly. The contacts of a pair of
+  // collisions are consecutive, so each collision is only resolved once.
+  outContacts.reserve(contacts.size());
+  tpelib::EntityHandle handle1 = tpelib::kNullEntityHandle;
+  tpelib::EntityHandle handle2 = tpelib::kNullEntityHandle;
+  const std::shared_ptr<CollisionInfo> *collision1 = nullptr;
+  const std::shared_ptr<CollisionInfo> *collision2 = nullptr;
   for (const auto &c : contacts)
   {
+    if (c.collisionHandle1 != handle1)
+    {
+      handle1 = c.collisionHandle1;
+      collision1 = this->CollisionByHandle(handle1);
+    }
+    if (c.collisionHandle2 != handle2)
+    {
+      handle2 = c.collisionHandle2;
+      collision2 = this->CollisionByHandle(handle2);
+    }
+    if (!collision1 || !collision2)
+      continue;
+
     CompositeData extraData;
 
-    // Contact expects identity to be associated with shapes not models
-    // but tpe computes collisions between models
-    // Workaround is to return the first shape of a model
-    auto s1 = this->GetModelCollision(c.entity1);
-    auto s2 = this->GetModelCollision(c.entity2);
+    // The exact narrowphase also computes the normal and depth
+    if (exact)
+    {
+      auto &extraContactData =
+        extraData.Get<SimulationFeatures::ExtraContactData>();
+      extraContactData.normal = math::eigen3::convert(c.normal);
+      extraContactData.depth = c.depth;
+    }
 
     outContacts.push_back(
-        {this->GenerateIdentity(s1.GetId(), this->collisions.at(s1.GetId())),
-         this->GenerateIdentity(s2.GetId(), this->collisions.at(s2.GetId())),
+        {this->GenerateIdentity(c.collision1, *collision1),
+         this->GenerateIdentity(c.collision2, *collision2),
          math::eigen3::convert(c.point), extraData});
   }
 
   return outContacts;
 }
 
-tpelib::Entity &SimulationFeatures::GetModelCollision(std::size_t _id) const
+void SimulationFeatures::GetContactBufferFromLastStep(
+  const Identity &_worldID, std::vector<ContactData> &_contacts) const
 {
-  auto m = this->models.at(_id);
-  if (!m || !m->model)
-    return tpelib::Entity::kNullEntity;
+  IGN_PROFILE("SimulationFeatures::GetContactBufferFromLastStep");
+  _contacts.clear();
+  auto const world = this->ReferenceInterface<WorldInfo>(_worldID)->world;
+  const auto &contacts = world->GetContacts();
+  const bool exact = world->GetExactNarrowphase();
+  _contacts.reserve(contacts.size());
 
-  tpelib::Entity &link = m->model->GetCanonicalLink();
-  if (link.GetChildCount() == 0u)
-    return tpelib::Entity::kNullEntity;
+  for (const auto &c : contacts)
+  {
+    if (!this->CollisionByHandle(c.collisionHandle1) ||
+        !this->CollisionByHandle(c.collisionHandle2))
+    {
+      continue;
+    }
 
-  return link.GetChildByIndex(0u);
+    // tpe does not compute contact forces
+    auto &contact = _contacts.emplace_back();
+    contact.shape1 = c.collision1;
+    contact.shape2 = c.collision2;
+    contact.point = math::eigen3::convert(c.point);
+    if (exact)
+    {
+      contact.normal = math::eigen3::convert(c.normal);
+      contact.depth = c.depth;
+    }
+  }
 }
@@ -18,6 +18,7 @@
 #ifndef IGNITION_PHYSICS_TPE_PLUGIN_SRC_SIMULATIONFEATURES_HH_
 #define IGNITION_PHYSICS_TPE_PLUGIN_SRC_SIMULATIONFEATURES_HH_
 
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -29,6 +30,7 @@
 #include <ignition/physics/SpecifyData.hh>
 
 #include "Base.hh"
+#include "lib/src/WorkerPool.hh"
 
 namespace ignition {
 namespace physics {
@@ -36,7 +38,9 @@ namespace tpeplugin {
 
 struct SimulationFeatureList : FeatureList<
   ForwardStep,
-  GetContactsFromLastStepFeature
+  ForwardStepWorlds,
+  GetContactsFromLastStepFeature,
+  GetContactBufferFromLastStepFeature
 > { };
 
 class SimulationFeatures :
@@ -51,15 +55,34 @@ class SimulationFeatures :
     ForwardStep::State &_x,
     const ForwardStep::Input &_u) override;
 
+  public: void EngineForwardStepWorlds(
+    const Identity &_engineID,
+    std::vector<ForwardStep::Output> &_h,
+    std::vector<ForwardStep::State> &_x,
+    const std::vector<ForwardStep::Input> &_u) override;
+
   public: void Write(ChangedWorldPoses &_changedPoses) const;
 
   public: std::vector<ContactInternal> GetContactsFromLastStep(
     const Identity &_worldID) const override;
 
-  /// \brief Get a collision from the canonical link of a model
-  /// \param[in] _id Model ID
-  /// \return Collision entity
-  private: tpelib::Entity &GetModelCollision(std::size_t _id) const;
+  public: void GetContactBufferFromLastStep(
+    const Identity &_worldID,
+    std::vector<ContactData> &_contacts) const override;
+
+  /// \brief Apply the time step of an input and step a world
+  /// \param[in] _world World to step
+  /// \param[in] _u Input of the world
+  private: void StepWorld(tpelib::World &_world,
+    const ForwardStep::Input &_u) const;
+
+  /// \brief Changed poses of all the worlds, reused by
+  /// EngineForwardStepWorlds before they are split by world
+  private: ChangedWorldPoses changedPoses;
+
+  /// \brief Worker pool used to step worlds in parallel, created the first
+  /// time more than one world is stepped
+  private: std::unique_ptr<tpelib::WorkerPool> workerPool;
 
   /// \brief entity poses from the most recent pose change/update.
   /// The key is the entity's ID, and the value is the entity's pose
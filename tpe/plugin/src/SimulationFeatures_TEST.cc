@@ -665,6 +665,20 @@ TEST_P(SimulationFeatures_TEST, RetrieveContacts)
     EXPECT_EQ(1u, contactBoxCapsule);
     EXPECT_EQ(1u, contactBoxEllipsoid);
 
+    // the contact buffer holds the same contacts, in the same order
+    std::vector<ignition::physics::World3d<TestFeatureList>::ContactData>
+        contactBuffer;
+    world->GetContactBufferFromLastStep(contactBuffer);
+    ASSERT_EQ(contacts.size(), contactBuffer.size());
+    for (std::size_t i = 0; i < contacts.size(); ++i)
+    {
+      const auto &contactPoint = contacts[i].Get<TestContactPoint>();
+      EXPECT_EQ(contactPoint.collision1->EntityID(), contactBuffer[i].shape1);
+      EXPECT_EQ(contactPoint.collision2->EntityID(), contactBuffer[i].shape2);
+      EXPECT_TRUE(ignition::physics::test::Equal(contactPoint.point,
+          contactBuffer[i].point, 1e-6));
+    }
+
     // move sphere away
     sphereFreeGroup->SetWorldPose(ignition::math::eigen3::convert(
         ignition::math::Pose3d(0, 100, 0.5, 0, 0, 0)));
@@ -19,6 +19,7 @@
 
 #include "Base.hh"
 
+#include "BatchedWorldFeatures.hh"
 #include "CustomFeatures.hh"
 #include "EntityManagementFeatures.hh"
 #include "FreeGroupFeatures.hh"
@@ -32,6 +33,7 @@ namespace physics {
 namespace tpeplugin {
 
 struct TpePluginFeatures : FeatureList<
+  BatchedWorldFeatureList,
   CustomFeatureList,
   EntityManagementFeatureList,
   FreeGroupFeatureList,
@@ -44,6 +46,7 @@ struct TpePluginFeatures : FeatureList<
 class Plugin :
   public virtual Implements3d<TpePluginFeatures>,
   public virtual Base,
+  public virtual BatchedWorldFeatures,
   public virtual CustomFeatures,
   public virtual EntityManagementFeatures,
   public virtual FreeGroupFeatures,